@@ -0,0 +1,163 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Data cache simulator for emulator builds (HAL_CACHE_SIM)
+ *
+ * Stands in for the board cache maintenance functions and checks the
+ * cache operations issued by the pipeline at the CPU/device handoffs.
+ * Each cache line keeps the version of its memory content and of its
+ * cached copy, the accesses reported by HAL_CACHE_SIM_Access() are checked
+ * against them: a CPU access to a line older than the memory, a device
+ * access to memory older than a dirty line, or dirty data discarded by an
+ * invalidation are coherency errors. Lines are never evicted.
+ */
+
+#include <string.h>
+#include <stdbool.h>
+#include "hal.h"
+#include "hal_debug.h"
+
+#if defined(EMULATOR) && defined(HAL_CACHE_SIM)
+
+#define SIM_LINE_SIZE   32U
+#define SIM_LINES       (1U << 16)  /* lines tracked */
+
+typedef struct {
+    uint32_t addr;          /* line address, 0: free entry */
+    uint32_t mem_ver;       /* version of the memory content */
+    uint32_t cache_ver;     /* version of the cached copy */
+    bool valid;
+    bool dirty;
+} sim_line_t;
+
+static sim_line_t sim_lines[SIM_LINES];
+static uint32_t sim_version;
+static unsigned int sim_errors;
+
+static sim_line_t *sim_line(uint32_t addr)
+{
+    uint32_t h = (addr / SIM_LINE_SIZE) * 2654435761U;
+    unsigned int i, n;
+
+    for (n = 0; n < SIM_LINES; n++) {
+        i = (h + n) & (SIM_LINES - 1);
+        if (sim_lines[i].addr == addr)
+            return &sim_lines[i];
+        if (sim_lines[i].addr == 0) {
+            memset(&sim_lines[i], 0, sizeof(sim_line_t));
+            sim_lines[i].addr = addr;
+            return &sim_lines[i];
+        }
+    }
+    HAL_LOGE("cache simulator full\n");
+    return NULL;
+}
+
+static void sim_error(const char *what, uint32_t addr)
+{
+    sim_errors++;
+    HAL_LOGE("cache coherency error: %s, line 0x%x\n", what, (unsigned int)addr);
+}
+
+typedef void (*sim_op_t)(sim_line_t *line, bool dev, bool write);
+
+static void sim_range(uint32_t addr, uint32_t size, sim_op_t op, bool dev, bool write)
+{
+    uint32_t first = addr & ~(SIM_LINE_SIZE - 1);
+    uint32_t last = (addr + size - 1) & ~(SIM_LINE_SIZE - 1);
+    sim_line_t *line;
+
+    if (size == 0)
+        return;
+    for (uint32_t a = first; ; a += SIM_LINE_SIZE) {
+        line = sim_line(a);
+        if (line != NULL)
+            op(line, dev, write);
+        if (a == last)
+            break;
+    }
+}
+
+static void sim_access(sim_line_t *line, bool dev, bool write)
+{
+    bool stale = line->valid && !line->dirty && (line->cache_ver != line->mem_ver);
+
+    if (dev) {
+        if (line->valid && line->dirty)
+            sim_error(write ? "device write under a dirty line" : "device reads memory older than the cache", line->addr);
+        if (write)
+            line->mem_ver = ++sim_version;
+        return;
+    }
+    if (stale)
+        sim_error(write ? "CPU writes a stale line" : "CPU reads a stale line", line->addr);
+    if (!line->valid) {
+        /* line fill */
+        line->valid = true;
+        line->cache_ver = line->mem_ver;
+    }
+    if (write) {
+        line->dirty = true;
+        line->cache_ver = ++sim_version;
+    }
+}
+
+static void sim_clean(sim_line_t *line, bool dev, bool write)
+{
+    if (line->valid && line->dirty) {
+        line->mem_ver = line->cache_ver;
+        line->dirty = false;
+    }
+}
+
+static void sim_invalidate(sim_line_t *line, bool dev, bool write)
+{
+    if (line->valid && line->dirty)
+        sim_error("CPU data discarded", line->addr);
+    line->valid = false;
+    line->dirty = false;
+}
+
+void HAL_DCACHE_CleanByRange(uint32_t addr, uint32_t size)
+{
+    sim_range(addr, size, sim_clean, false, false);
+}
+
+void HAL_DCACHE_InvalidateByRange(uint32_t addr, uint32_t size)
+{
+    sim_range(addr, size, sim_invalidate, false, false);
+}
+
+void HAL_DCACHE_CleanInvalidateByRange(uint32_t addr, uint32_t size)
+{
+    sim_range(addr, size, sim_clean, false, false);
+    sim_range(addr, size, sim_invalidate, false, false);
+}
+
+void HAL_CACHE_SIM_Access(uint32_t addr, uint32_t size, bool dev, bool write)
+{
+    sim_range(addr, size, sim_access, dev, write);
+}
+
+unsigned int HAL_CACHE_SIM_Errors(void)
+{
+    return sim_errors;
+}
+
+#endif /* EMULATOR && HAL_CACHE_SIM */
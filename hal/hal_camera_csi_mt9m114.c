@@ -32,6 +32,7 @@
 #include "fsl_debug_console.h"
 #include "camera_support.h"
 #include "hal.h"
+#include "hal_os.h"
 #include "hal_utils.h"
 
 #if defined(__cplusplus)
@@ -179,6 +180,13 @@ hal_camera_status_t HAL_CameraDev_CsiMt9m114_Deinit(camera_dev_t *dev)
 
 static uint32_t gCurrentBufferAddr = 0;
 
+/* completion time of the frames queued in the receiver */
+#define CAPTURE_TS_RING 4
+static uint32_t gCaptureTsRing[CAPTURE_TS_RING];
+static volatile uint32_t gCaptureTsWr = 0;
+static uint32_t gCaptureTsRd = 0;
+static uint32_t gCaptureTs = 0;
+
 hal_camera_status_t HAL_CameraDev_CsiMt9m114_Start(const camera_dev_t *dev)
 {
     hal_camera_status_t ret = kStatus_HAL_CameraSuccess;
@@ -196,6 +204,7 @@ hal_camera_status_t HAL_CameraDev_CsiMt9m114_Start(const camera_dev_t *dev)
         gCurrentBufferAddr = 0;
     }
 
+    gCaptureTsRd = gCaptureTsWr;
     status = CAMERA_RECEIVER_Start(&cameraReceiver);
     if (status != kStatus_Success) {
         HAL_LOGE("Error with status=%d\n", (int)status);
@@ -235,6 +244,8 @@ hal_camera_status_t HAL_CameraDev_CsiMt9m114_Dequeue(const camera_dev_t *dev, vo
     while (kStatus_Success != CAMERA_RECEIVER_GetFullBuffer(&cameraReceiver, &gCurrentBufferAddr))
     {
     }
+    /* full buffers are returned in the order they were completed */
+    gCaptureTs = gCaptureTsRing[gCaptureTsRd++ % CAPTURE_TS_RING];
 
     *data   = (void *)gCurrentBufferAddr;
     *stripe = 0;
@@ -242,6 +253,12 @@ hal_camera_status_t HAL_CameraDev_CsiMt9m114_Dequeue(const camera_dev_t *dev, vo
     return ret;
 }
 
+hal_camera_status_t HAL_CameraDev_CsiMt9m114_GetTimestamp(const camera_dev_t *dev, uint32_t *ts_us)
+{
+    *ts_us = gCaptureTs;
+    return kStatus_HAL_CameraSuccess;
+}
+
 const static camera_dev_operator_t camera_dev_csi_mt9m114_ops = {
     .init        = HAL_CameraDev_CsiMt9m114_Init,
     .deinit      = HAL_CameraDev_CsiMt9m114_Deinit,
@@ -250,6 +267,7 @@ const static camera_dev_operator_t camera_dev_csi_mt9m114_ops = {
     .enqueue     = HAL_CameraDev_CsiMt9m114_Enqueue,
     .dequeue     = HAL_CameraDev_CsiMt9m114_Dequeue,
     .get_buf_desc = HAL_CameraDev_CsiMt9m114_Getbufdesc,
+    .get_timestamp = HAL_CameraDev_CsiMt9m114_GetTimestamp,
 };
 
 static camera_dev_t camera_dev_csi_mt9m114 = {
@@ -267,6 +285,9 @@ static camera_dev_t camera_dev_csi_mt9m114 = {
 
 void HAL_CameraDev_CsiMt9m114_ReceiverCallback(camera_receiver_handle_t *handle, status_t status, void *userData)
 {
+    gCaptureTsRing[gCaptureTsWr % CAPTURE_TS_RING] = hal_get_time_us();
+    gCaptureTsWr++;
+
     if (camera_dev_csi_mt9m114.cap.callback != NULL)
     {
         uint8_t fromISR = __get_IPSR();
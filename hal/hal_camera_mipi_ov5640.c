@@ -380,6 +380,13 @@ hal_camera_status_t HAL_CameraDev_MipiOv5640_Deinit(camera_dev_t *dev)
 
 static uint32_t gCurrentBufferAddr = 0;
 
+/* completion time of the frames queued in the receiver */
+#define CAPTURE_TS_RING 4
+static uint32_t gCaptureTsRing[CAPTURE_TS_RING];
+static volatile uint32_t gCaptureTsWr = 0;
+static uint32_t gCaptureTsRd = 0;
+static uint32_t gCaptureTs = 0;
+
 hal_camera_status_t HAL_CameraDev_MipiOv5640_Start(const camera_dev_t *dev)
 {
     hal_camera_status_t ret = kStatus_HAL_CameraSuccess;
@@ -397,6 +404,7 @@ hal_camera_status_t HAL_CameraDev_MipiOv5640_Start(const camera_dev_t *dev)
         gCurrentBufferAddr = 0;
     }
 
+    gCaptureTsRd = gCaptureTsWr;
     status = CAMERA_RECEIVER_Start(&cameraReceiver);
     if (status != kStatus_Success) {
         HAL_LOGE("Error with status=%d\n", (int)status);
@@ -436,6 +444,8 @@ hal_camera_status_t HAL_CameraDev_MipiOv5640_Dequeue(const camera_dev_t *dev, vo
     while (kStatus_Success != CAMERA_RECEIVER_GetFullBuffer(&cameraReceiver, &gCurrentBufferAddr))
     {
     }
+    /* full buffers are returned in the order they were completed */
+    gCaptureTs = gCaptureTsRing[gCaptureTsRd++ % CAPTURE_TS_RING];
 
     *data   = (void *)gCurrentBufferAddr;
     *stripe = 0;
@@ -443,6 +453,12 @@ hal_camera_status_t HAL_CameraDev_MipiOv5640_Dequeue(const camera_dev_t *dev, vo
     return ret;
 }
 
+hal_camera_status_t HAL_CameraDev_MipiOv5640_GetTimestamp(const camera_dev_t *dev, uint32_t *ts_us)
+{
+    *ts_us = gCaptureTs;
+    return kStatus_HAL_CameraSuccess;
+}
+
 const static camera_dev_operator_t camera_dev_mipi_ov5640_ops = {
     .init        = HAL_CameraDev_MipiOv5640_Init,
     .deinit      = HAL_CameraDev_MipiOv5640_Deinit,
@@ -451,6 +467,7 @@ const static camera_dev_operator_t camera_dev_mipi_ov5640_ops = {
     .enqueue     = HAL_CameraDev_MipiOv5640_Enqueue,
     .dequeue     = HAL_CameraDev_MipiOv5640_Dequeue,
     .get_buf_desc = HAL_CameraDev_MipiOv5640_Getbufdesc,
+    .get_timestamp = HAL_CameraDev_MipiOv5640_GetTimestamp,
 };
 
 static camera_dev_t camera_dev_mipi_ov5640 = {
@@ -468,6 +485,9 @@ static camera_dev_t camera_dev_mipi_ov5640 = {
 
 void HAL_CameraDev_MipiOv5640_ReceiverCallback(camera_receiver_handle_t *handle, status_t status, void *userData)
 {
+    gCaptureTsRing[gCaptureTsWr % CAPTURE_TS_RING] = hal_get_time_us();
+    gCaptureTsWr++;
+
     if (camera_dev_mipi_ov5640.cap.callback != NULL)
     {
         uint8_t fromISR = __get_IPSR();
@@ -78,3 +78,15 @@ void HAL_DCACHE_CleanInvalidateByRange(uint32_t addr, uint32_t size)
     /* no cache in NCX-N */
     return;
 }
+
+void HAL_DCACHE_CleanByRange(uint32_t addr, uint32_t size)
+{
+    /* no cache in NCX-N */
+    return;
+}
+
+void HAL_DCACHE_InvalidateByRange(uint32_t addr, uint32_t size)
+{
+    /* no cache in NCX-N */
+    return;
+}
@@ -21,6 +21,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stddef.h>
+#ifdef EMULATOR
+#include <time.h>
+#endif
 #include "atomic.h"
 #include "task.h"
 #include "semphr.h"
@@ -150,6 +153,90 @@ uint32_t hal_get_exec_time()
     return runtime_ms - tasks_time;
 }
 
+#if defined(EMULATOR)
+uint32_t hal_get_time_us()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000U + ts.tv_nsec / 1000);
+}
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__) \
+        || defined(__ARM_ARCH_8_1M_MAIN__)
+/* DWT cycle counter */
+#define HAL_DEMCR               (*(volatile uint32_t *)0xE000EDFCU)
+#define HAL_DEMCR_TRCENA        (1UL << 24)
+#define HAL_DWT_CTRL            (*(volatile uint32_t *)0xE0001000U)
+#define HAL_DWT_CTRL_CYCCNTENA  (1UL << 0)
+#define HAL_DWT_CTRL_NOCYCCNT   (1UL << 25)
+#define HAL_DWT_CYCCNT          (*(volatile uint32_t *)0xE0001004U)
+#define HAL_DWT_LAR             (*(volatile uint32_t *)0xE0001FB0U)
+#define HAL_DWT_LAR_KEY         0xC5ACCE55U
+
+static bool dwt_ready;
+static uint32_t dwt_last;   /* cycle count at the last call */
+static uint32_t dwt_tick;   /* OS tick at the last call */
+static uint32_t dwt_rem;    /* cycles not yet accounted in dwt_us */
+static uint32_t dwt_us;
+
+/* The 32-bit cycle counter is extended at each call (one wrap is ~4s at 1GHz).
+ * Wraps missed between calls, e.g. across idle periods, are counted from the OS tick.
+ */
+uint32_t hal_get_time_us()
+{
+    const uint32_t cycles_us = configCPU_CLOCK_HZ / 1000000U;
+    const uint32_t wrap_us = (uint32_t)((1ULL << 32) / cycles_us);
+    uint32_t now, delta, us, tick;
+    uint64_t tick_us;
+
+    if (__builtin_expect(!dwt_ready, 0)) {
+        HAL_DEMCR |= HAL_DEMCR_TRCENA;
+        if (HAL_DWT_CTRL & HAL_DWT_CTRL_NOCYCCNT)
+            /* no cycle counter: fall back to the OS tick */
+            return hal_get_ostick() * portTICK_PERIOD_MS * 1000U;
+#if defined(__ARM_ARCH_7EM__)
+        HAL_DWT_LAR = HAL_DWT_LAR_KEY;
+#endif
+        HAL_DWT_CTRL |= HAL_DWT_CTRL_CYCCNTENA;
+        dwt_last = HAL_DWT_CYCCNT;
+        dwt_tick = hal_get_ostick();
+        dwt_ready = true;
+    }
+
+    hal_atomic_enter();
+    now = HAL_DWT_CYCCNT;
+    tick = hal_get_ostick();
+    delta = now - dwt_last;
+    tick_us = (uint64_t)(tick - dwt_tick) * portTICK_PERIOD_MS * 1000U;
+    dwt_last = now;
+    dwt_tick = tick;
+    if (__builtin_expect(tick_us > delta / cycles_us + wrap_us / 2, 0)) {
+        /* the tick is accurate to a few ms, far below a counter wrap */
+        uint64_t missed = (tick_us - delta / cycles_us + wrap_us / 2) / wrap_us;
+        uint64_t cycles = delta + (missed << 32);
+
+        dwt_us += (uint32_t)(cycles / cycles_us);
+        dwt_rem += (uint32_t)(cycles % cycles_us);
+    } else {
+        dwt_us += delta / cycles_us;
+        dwt_rem += delta % cycles_us;
+    }
+    if (dwt_rem >= cycles_us) {
+        dwt_us++;
+        dwt_rem -= cycles_us;
+    }
+    us = dwt_us;
+    hal_atomic_exit();
+
+    return us;
+}
+#else
+uint32_t hal_get_time_us()
+{
+    return hal_get_ostick() * portTICK_PERIOD_MS * 1000U;
+}
+#endif
+
 void *hal_malloc(uint32_t size)
 {
     return pvPortMalloc(size);
@@ -171,6 +258,12 @@ hal_sema_t hal_sema_create_binary()
     return xSemaphoreCreateBinary();
 }
 
+void hal_sema_delete(hal_sema_t handle)
+{
+    if (handle != NULL)
+        vSemaphoreDelete((SemaphoreHandle_t)handle);
+}
+
 bool hal_sema_give(hal_sema_t handle)
 {
     SemaphoreHandle_t h = handle;
@@ -231,15 +324,21 @@ uint32_t hal_get_tick_rate_hz()
     return configTICK_RATE_HZ;
 }
 
-UBaseType_t uxCriticalSectionType;
+/* nested sections restore the interrupt mask saved by the outermost one */
+static UBaseType_t uxCriticalSectionType;
+static volatile uint32_t uxCriticalNesting;
 void hal_atomic_enter()
 {
-    uxCriticalSectionType = portSET_INTERRUPT_MASK_FROM_ISR();
+    UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    if (uxCriticalNesting++ == 0)
+        uxCriticalSectionType = mask;
 }
 
 void hal_atomic_exit()
 {
-    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxCriticalSectionType );
+    if (--uxCriticalNesting == 0)
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxCriticalSectionType );
 }
 
 uint32_t hal_tick_to_ms(uint32_t os_tick)
@@ -277,6 +376,16 @@ void hal_task_resume(hal_task_t task)
     vTaskResume((TaskHandle_t) task);
 }
 
+hal_task_t hal_task_current()
+{
+    return (hal_task_t) xTaskGetCurrentTaskHandle();
+}
+
+const char *hal_task_name(hal_task_t task)
+{
+    return pcTaskGetName((TaskHandle_t) task);
+}
+
 void hal_task_delay(uint32_t ticks)
 {
     vTaskDelay(ticks);
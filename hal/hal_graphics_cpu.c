@@ -23,6 +23,7 @@
 #if (defined HAL_ENABLE_2D_IMGPROC) && (HAL_ENABLE_GFX_DEV_Cpu == 1)
 #include "fsl_common.h"
 #include "hal_utils.h"
+#include "hal_os.h"
 
 typedef struct
 {
@@ -1248,9 +1249,373 @@ static int HAL_GfxDev_any_OP(
     return error;
 }
 
+/*******************************************************************************
+ * Crop and resize of several regions in a single pass over the source
+ *
+ * Each source line needed by at least one region is converted once to RGB888
+ * into a two-line cache covering the horizontal span of all the regions.
+ * Every region then interpolates its destination rows from the cached lines.
+ * Interpolation coefficients are computed per region and shared between
+ * regions with identical source and destination sizes.
+ ******************************************************************************/
+#define CROP_MAX_REGIONS 32
+
+typedef struct
+{
+    uint16_t pos;   /* source position relative to the region origin */
+    uint8_t frac;   /* weight of the next source position in 1/SUBPIXINC */
+} crop_coef_t;
+
+typedef struct
+{
+    const gfx_crop_t *crop;
+    int src_w;          /* region size in the source */
+    int src_h;
+    int out_x;          /* resized content window in the destination */
+    int out_y;
+    int out_w;
+    int out_h;
+    int dst_bpp;        /* destination bytes per pixel */
+    write_pixel f_write;
+    crop_coef_t *hcoef;
+    crop_coef_t *vcoef;
+    int next_row;       /* next destination row to produce */
+} crop_region_t;
+
+static inline void write_gray8(void *pixel, uint8_t red, uint8_t green, uint8_t blue)
+{
+    *(uint8_t *)pixel = (uint8_t)((77 * red + 150 * green + 29 * blue) >> 8);
+}
+
+static void crop_fill_coefs(crop_coef_t *coef, int src_len, int dst_len)
+{
+    int incr = (dst_len > 1) ? ((src_len - 1) * SUBPIXINC / (dst_len - 1)) : 0;
+    int sub = 0;
+
+    for (int i = 0; i < dst_len; i++, sub += incr)
+    {
+        coef[i].pos = sub >> SUBPIXPOW;
+        coef[i].frac = sub & (SUBPIXINC - 1);
+        if (coef[i].pos >= src_len - 1)
+        {
+            coef[i].pos = src_len - 1;
+            coef[i].frac = 0;
+        }
+    }
+}
+
+/* convert source line 'y' from column x0 to x1 into RGB888 */
+static int crop_read_line(const gfx_surface_t *pSrc, int y, int x0, int x1, uint8_t *line)
+{
+    uint8_t *row = (uint8_t *)pSrc->buf + y * pSrc->pitch;
+    const hal_gfx_cpu_yuv_ops *yuv = NULL;
+    int yuv_bpp = 2;
+    int x;
+
+    switch (pSrc->format)
+    {
+    case MPP_PIXEL_RGB:
+        memcpy(line, row + x0 * 3, (x1 - x0 + 1) * 3);
+        return 0;
+    case MPP_PIXEL_BGR:
+        for (x = x0; x <= x1; x++, line += 3)
+            write_bgr888(line, row[x * 3], row[x * 3 + 1], row[x * 3 + 2]);
+        return 0;
+    case MPP_PIXEL_RGB565:
+        for (x = x0; x <= x1; x++, line += 3)
+        {
+            uint16_t pix = ((uint16_t *)row)[x];
+            if (pSrc->swapByte)
+                pix = (pix >> 8) | (pix << 8);
+            line[0] = ((pix >> RGB565_RSHIFT) & RGB565_RMASK) << 3;
+            line[1] = ((pix >> RGB565_GSHIFT) & RGB565_GMASK) << 2;
+            line[2] = ((pix >> RGB565_BSHIFT) & RGB565_BMASK) << 3;
+        }
+        return 0;
+    case MPP_PIXEL_GRAY:
+        for (x = x0; x <= x1; x++, line += 3)
+            line[0] = line[1] = line[2] = row[x];
+        return 0;
+    case MPP_PIXEL_UYVY1P422:
+        yuv = &s_GfxDevCpuOps_UYVY422;
+        break;
+    case MPP_PIXEL_VYUY1P422:
+        yuv = &s_GfxDevCpuOps_VYUY422;
+        break;
+    case MPP_PIXEL_YUV1P444:
+        yuv = &s_GfxDevCpuOps_VUYX444;
+        yuv_bpp = 4;
+        break;
+    default:
+        return -1;
+    }
+
+    for (x = x0; x <= x1; x++, line += 3)
+    {
+        uint8_t *pix;
+        int pix_id, c, d, e;
+
+        if (yuv_bpp == 2)
+        {
+            /* 2 pixels share 4 bytes */
+            pix = row + (x & ~1) * 2;
+            pix_id = x & 1;
+        }
+        else
+        {
+            pix = row + x * 4;
+            pix_id = 0;
+        }
+        c = yuv->c_from_yuv(pix, pix_id);
+        d = yuv->d_from_yuv(pix);
+        e = yuv->e_from_yuv(pix);
+        line[0] = YUV2R(c, d, e);
+        line[1] = YUV2G(c, d, e);
+        line[2] = YUV2B(c, d, e);
+    }
+    return 0;
+}
+
+/* fill the destination window of a region outside of its resized content */
+static void crop_fill_bands(const crop_region_t *reg)
+{
+    const gfx_surface_t *dst = reg->crop->dst;
+    uint8_t pad = reg->crop->pad_value;
+
+    for (int y = dst->top; y <= dst->bottom; y++)
+    {
+        uint8_t *row = (uint8_t *)dst->buf + y * dst->pitch;
+        bool content_row = (y >= reg->out_y) && (y < reg->out_y + reg->out_h);
+
+        for (int x = dst->left; x <= dst->right; x++)
+        {
+            if (content_row && (x >= reg->out_x) && (x < reg->out_x + reg->out_w))
+            {
+                /* skip to the right band */
+                x = reg->out_x + reg->out_w - 1;
+                continue;
+            }
+            reg->f_write(row + x * reg->dst_bpp, pad, pad, pad);
+        }
+    }
+}
+
+/* interpolate destination row 'j' of a region from cached lines l0 and l1 */
+static void crop_write_row(const crop_region_t *reg, int j, const uint8_t *l0, const uint8_t *l1)
+{
+    const gfx_surface_t *dst = reg->crop->dst;
+    uint8_t *out = (uint8_t *)dst->buf + (reg->out_y + j) * dst->pitch + reg->out_x * reg->dst_bpp;
+    int fy = reg->vcoef[j].frac;
+    int last = reg->src_w - 1;
+    uint8_t rgb[3];
+
+    for (int i = 0; i < reg->out_w; i++, out += reg->dst_bpp)
+    {
+        int p0 = reg->hcoef[i].pos;
+        int p1 = (p0 < last) ? p0 + 1 : p0;
+        int fx = reg->hcoef[i].frac;
+
+        for (int k = 0; k < 3; k++)
+        {
+            int top = l0[p0 * 3 + k] * (SUBPIXINC - fx) + l0[p1 * 3 + k] * fx;
+            int bot = l1[p0 * 3 + k] * (SUBPIXINC - fx) + l1[p1 * 3 + k] * fx;
+            rgb[k] = (top * (SUBPIXINC - fy) + bot * fy) >> (2 * SUBPIXPOW);
+        }
+        reg->f_write(out, rgb[0], rgb[1], rgb[2]);
+    }
+}
+
+static int HAL_GfxDev_Cpu_CropAndResize(const gfx_dev_t *dev, const gfx_surface_t *pSrc,
+        const gfx_crop_t *crops, int nb_crops)
+{
+    int error = 0;
+    crop_region_t *regs = NULL;
+    uint8_t *lines[2];
+    uint8_t *mem = NULL;
+    int span_l, span_r, row_t, row_b;
+    size_t size, line_size;
+    int i, y;
+
+    do {
+        if ((pSrc == NULL) || (crops == NULL) || (nb_crops <= 0) || (nb_crops > CROP_MAX_REGIONS))
+        {
+            HAL_LOGE("Invalid crop and resize parameters\n");
+            error = -1;
+            break;
+        }
+
+        /* validate the regions and size the work memory */
+        span_l = pSrc->width;
+        span_r = -1;
+        row_t = pSrc->height;
+        row_b = -1;
+        size = nb_crops * sizeof(crop_region_t);
+        for (i = 0; i < nb_crops; i++)
+        {
+            const gfx_crop_t *c = &crops[i];
+
+            if ((c->dst == NULL) || (c->left < 0) || (c->top < 0)
+                || (c->right >= pSrc->width) || (c->bottom >= pSrc->height)
+                || (c->left > c->right) || (c->top > c->bottom)
+                || (c->dst->left > c->dst->right) || (c->dst->top > c->dst->bottom))
+            {
+                HAL_LOGE("Invalid crop region %d\n", i);
+                error = -1;
+                break;
+            }
+            if (c->left < span_l) span_l = c->left;
+            if (c->right > span_r) span_r = c->right;
+            if (c->top < row_t) row_t = c->top;
+            if (c->bottom > row_b) row_b = c->bottom;
+            size += (c->dst->right - c->dst->left + 1 + c->dst->bottom - c->dst->top + 1) * sizeof(crop_coef_t);
+        }
+        if (error) break;
+
+        line_size = (span_r - span_l + 1) * 3;
+        size += 2 * line_size;
+        mem = hal_malloc(size);
+        if (mem == NULL)
+        {
+            HAL_LOGE("Failed to allocate crop and resize memory\n");
+            error = -1;
+            break;
+        }
+        regs = (crop_region_t *)mem;
+        lines[0] = mem + nb_crops * sizeof(crop_region_t);
+        lines[1] = lines[0] + line_size;
+        crop_coef_t *coefs = (crop_coef_t *)(lines[1] + line_size);
+
+        /* compute the output window and coefficients of each region */
+        for (i = 0; i < nb_crops; i++)
+        {
+            const gfx_crop_t *c = &crops[i];
+            crop_region_t *reg = &regs[i];
+            int dst_w = c->dst->right - c->dst->left + 1;
+            int dst_h = c->dst->bottom - c->dst->top + 1;
+
+            reg->crop = c;
+            reg->src_w = c->right - c->left + 1;
+            reg->src_h = c->bottom - c->top + 1;
+            reg->out_w = dst_w;
+            reg->out_h = dst_h;
+            if (c->letterbox)
+            {
+                /* largest window with the source aspect ratio */
+                if (reg->src_w * dst_h > reg->src_h * dst_w)
+                    reg->out_h = (reg->src_h * dst_w + reg->src_w / 2) / reg->src_w;
+                else
+                    reg->out_w = (reg->src_w * dst_h + reg->src_h / 2) / reg->src_h;
+                if (reg->out_w < 1) reg->out_w = 1;
+                if (reg->out_h < 1) reg->out_h = 1;
+            }
+            reg->out_x = c->dst->left + (dst_w - reg->out_w) / 2;
+            reg->out_y = c->dst->top + (dst_h - reg->out_h) / 2;
+            reg->next_row = 0;
+
+            switch (c->dst->format)
+            {
+            case MPP_PIXEL_RGB:
+                reg->f_write = write_rgb888;
+                break;
+            case MPP_PIXEL_BGR:
+                reg->f_write = write_bgr888;
+                break;
+            case MPP_PIXEL_RGB565:
+                reg->f_write = write_rgb565;
+                break;
+            case MPP_PIXEL_GRAY:
+                reg->f_write = write_gray8;
+                break;
+            default:
+                HAL_LOGE("Unsupported crop destination format [%d]\n", c->dst->format);
+                error = -1;
+                break;
+            }
+            if (error) break;
+            reg->dst_bpp = get_bitpp(c->dst->format) / 8;
+
+            /* share the coefficient tables with an identical previous region */
+            reg->hcoef = NULL;
+            reg->vcoef = NULL;
+            for (int k = 0; k < i; k++)
+            {
+                if ((regs[k].src_w == reg->src_w) && (regs[k].out_w == reg->out_w))
+                    reg->hcoef = regs[k].hcoef;
+                if ((regs[k].src_h == reg->src_h) && (regs[k].out_h == reg->out_h))
+                    reg->vcoef = regs[k].vcoef;
+            }
+            if (reg->hcoef == NULL)
+            {
+                reg->hcoef = coefs;
+                crop_fill_coefs(reg->hcoef, reg->src_w, reg->out_w);
+                coefs += reg->out_w;
+            }
+            if (reg->vcoef == NULL)
+            {
+                reg->vcoef = coefs;
+                crop_fill_coefs(reg->vcoef, reg->src_h, reg->out_h);
+                coefs += reg->out_h;
+            }
+            if (c->letterbox)
+                crop_fill_bands(reg);
+        }
+        if (error) break;
+
+        /* single pass over the source lines */
+        for (y = row_t; y <= row_b; y++)
+        {
+            const uint8_t *l0 = lines[(y - 1) & 1];
+            const uint8_t *l1 = lines[y & 1];
+            bool needed = false;
+
+            for (i = 0; i < nb_crops; i++)
+            {
+                if ((y >= crops[i].top) && (y <= crops[i].bottom))
+                {
+                    needed = true;
+                    break;
+                }
+            }
+            if (!needed) continue;
+
+            if (crop_read_line(pSrc, y, span_l, span_r, lines[y & 1]) != 0)
+            {
+                HAL_LOGE("Unsupported crop source format [%d]\n", pSrc->format);
+                error = -1;
+                break;
+            }
+
+            /* produce the rows whose lower source line is 'y' */
+            for (i = 0; i < nb_crops; i++)
+            {
+                crop_region_t *reg = &regs[i];
+                int top = reg->crop->top;
+                int off = (reg->crop->left - span_l);
+
+                while (reg->next_row < reg->out_h)
+                {
+                    int y0 = top + reg->vcoef[reg->next_row].pos;
+                    int y1 = (y0 < reg->crop->bottom) ? y0 + 1 : y0;
+
+                    if (y1 != y) break;
+                    crop_write_row(reg, reg->next_row,
+                            ((y0 == y) ? l1 : l0) + off * 3, l1 + off * 3);
+                    reg->next_row++;
+                }
+            }
+        }
+    } while (false);
+
+    if (mem != NULL)
+        hal_free(mem);
+
+    return error;
+}
+
 const static gfx_dev_operator_t s_GfxDevCpuOps = {
     .blit         = HAL_GfxDev_Cpu_Blit,
     .get_buf_desc = HAL_GfxDev_Cpu_Getbufdesc,
+    .crop_and_resize = HAL_GfxDev_Cpu_CropAndResize,
 };
 
 int HAL_GfxDev_CPU_Register(gfx_dev_t *dev)
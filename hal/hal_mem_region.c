@@ -0,0 +1,227 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Memory region placement allocator
+ *
+ * The application registers memory regions (e.g. DTCM, OCRAM, SDRAM sections
+ * reserved by the linker), each region is managed by a first-fit allocator
+ * with an address-ordered free list, coalesced on free.
+ * hal_malloc_placed() tries the regions in the order given by the placement
+ * hint and falls back to the OS heap.
+ */
+
+#include <stddef.h>
+#include "hal_os.h"
+#include "hal_debug.h"
+
+#define MEM_ALIGN       8U
+#define MEM_ALIGN_UP(x) (((x) + MEM_ALIGN - 1U) & ~(uintptr_t)(MEM_ALIGN - 1U))
+
+typedef struct _mem_blk {
+    uint32_t size;              /* block size including header */
+    struct _mem_blk *next;      /* next free block (free list only) */
+} mem_blk_t;
+
+#define BLK_HDR_SIZE    ((uint32_t)MEM_ALIGN_UP(sizeof(mem_blk_t)))
+#define BLK_MIN_SIZE    (2U * BLK_HDR_SIZE)
+
+typedef struct {
+    mpp_memory_region_t desc;
+    uintptr_t start;            /* aligned start of the managed range */
+    uintptr_t end;
+    mem_blk_t *free_lst;
+} mem_region_t;
+
+static mem_region_t s_regions[HAL_MEM_REGION_MAX];
+static unsigned int s_nb_regions;
+static hal_mutex_t s_region_mutex;
+
+int hal_mem_region_add(const mpp_memory_region_t *region)
+{
+    mem_region_t *r;
+    uintptr_t start, end;
+    unsigned int i;
+
+    if ((region == NULL) || (region->size == 0))
+        return -1;
+    if (s_nb_regions >= HAL_MEM_REGION_MAX) {
+        HAL_LOGE("too many memory regions (max %d)\n", HAL_MEM_REGION_MAX);
+        return -1;
+    }
+    start = MEM_ALIGN_UP(region->base);
+    end = (region->base + region->size) & ~(uintptr_t)(MEM_ALIGN - 1U);
+    if ((end <= start) || (end - start < BLK_MIN_SIZE)) {
+        HAL_LOGE("memory region %s too small\n", region->name ? region->name : "");
+        return -1;
+    }
+    for (i = 0; i < s_nb_regions; i++) {
+        if ((start < s_regions[i].end) && (s_regions[i].start < end)) {
+            HAL_LOGE("memory region %s overlaps %s\n", region->name ? region->name : "", s_regions[i].desc.name);
+            return -1;
+        }
+    }
+    if ((s_region_mutex == NULL) && (hal_mutex_create(&s_region_mutex) != 0))
+        return -1;
+
+    r = &s_regions[s_nb_regions];
+    r->desc = *region;
+    if (r->desc.name == NULL)
+        r->desc.name = "region";
+    r->start = start;
+    r->end = end;
+    r->free_lst = (mem_blk_t *)start;
+    r->free_lst->size = (uint32_t)(end - start);
+    r->free_lst->next = NULL;
+    s_nb_regions++;
+    return 0;
+}
+
+static void *region_alloc(mem_region_t *r, uint32_t size)
+{
+    mem_blk_t **prev = &r->free_lst;
+    mem_blk_t *blk;
+    uint32_t need = (uint32_t)MEM_ALIGN_UP(size) + BLK_HDR_SIZE;
+
+    for (blk = r->free_lst; blk != NULL; prev = &blk->next, blk = blk->next) {
+        if (blk->size < need)
+            continue;
+        if (blk->size - need >= BLK_MIN_SIZE) {
+            /* split: the remainder stays in the free list */
+            mem_blk_t *rem = (mem_blk_t *)((uintptr_t)blk + need);
+            rem->size = blk->size - need;
+            rem->next = blk->next;
+            *prev = rem;
+            blk->size = need;
+        } else {
+            *prev = blk->next;
+        }
+        blk->next = NULL;
+        return (void *)((uintptr_t)blk + BLK_HDR_SIZE);
+    }
+    return NULL;
+}
+
+static void region_free(mem_region_t *r, void *pointer)
+{
+    mem_blk_t *blk = (mem_blk_t *)((uintptr_t)pointer - BLK_HDR_SIZE);
+    mem_blk_t *prev = NULL, *cur = r->free_lst;
+
+    /* keep the free list ordered by address */
+    while ((cur != NULL) && (cur < blk)) {
+        prev = cur;
+        cur = cur->next;
+    }
+    blk->next = cur;
+    if ((cur != NULL) && ((uintptr_t)blk + blk->size == (uintptr_t)cur)) {
+        blk->size += cur->size;
+        blk->next = cur->next;
+    }
+    if (prev == NULL) {
+        r->free_lst = blk;
+    } else if ((uintptr_t)prev + prev->size == (uintptr_t)blk) {
+        prev->size += blk->size;
+        prev->next = blk->next;
+    } else {
+        prev->next = blk;
+    }
+}
+
+static mem_region_t *region_of(const void *pointer)
+{
+    unsigned int i;
+
+    for (i = 0; i < s_nb_regions; i++) {
+        if (((uintptr_t)pointer >= s_regions[i].start) && ((uintptr_t)pointer < s_regions[i].end))
+            return &s_regions[i];
+    }
+    return NULL;
+}
+
+/* try the regions by bandwidth class, from the highest if 'fast_first' */
+static void *regions_alloc(uint32_t size, bool fast_first, bool noncacheable_only, const mpp_memory_region_t **placed)
+{
+    void *p = NULL;
+    int bw, i;
+
+    for (bw = 0; (bw <= MPP_MEM_BW_HIGH) && (p == NULL); bw++) {
+        int cls = fast_first ? (MPP_MEM_BW_HIGH - bw) : bw;
+        for (i = 0; (i < (int)s_nb_regions) && (p == NULL); i++) {
+            mem_region_t *r = &s_regions[i];
+            if (((int)r->desc.bw != cls) || (noncacheable_only && r->desc.cacheable))
+                continue;
+            p = region_alloc(r, size);
+            if ((p != NULL) && (placed != NULL))
+                *placed = &r->desc;
+        }
+    }
+    return p;
+}
+
+void *hal_malloc_placed(uint32_t size, mpp_memory_placement_t hint, const mpp_memory_region_t **placed)
+{
+    void *p = NULL;
+
+    if (placed != NULL)
+        *placed = NULL;
+
+    /* no region or no preference: heap first, keep the regions for hinted buffers */
+    if ((s_nb_regions == 0) || (hint == MPP_MEM_PLACE_ANY)) {
+        p = hal_malloc(size);
+        if ((p != NULL) || (s_nb_regions == 0))
+            return p;
+    }
+
+    hal_mutex_lock(s_region_mutex);
+    switch (hint) {
+    case MPP_MEM_PLACE_FAST:
+        p = regions_alloc(size, true, false, placed);
+        break;
+    case MPP_MEM_PLACE_NONCACHEABLE:
+        p = regions_alloc(size, true, true, placed);
+        break;
+    case MPP_MEM_PLACE_BULK:
+    case MPP_MEM_PLACE_ANY:
+    default:
+        p = regions_alloc(size, false, false, placed);
+        break;
+    }
+    hal_mutex_unlock(s_region_mutex);
+
+    if ((p == NULL) && (hint != MPP_MEM_PLACE_ANY)) {
+        HAL_LOGD("no region for %u bytes (hint %d), using heap\n", (unsigned int)size, hint);
+        p = hal_malloc(size);
+    }
+    return p;
+}
+
+void hal_free_placed(void *pointer)
+{
+    mem_region_t *r;
+
+    if (pointer == NULL)
+        return;
+    r = region_of(pointer);
+    if (r == NULL) {
+        hal_free(pointer);
+        return;
+    }
+    hal_mutex_lock(s_region_mutex);
+    region_free(r, pointer);
+    hal_mutex_unlock(s_region_mutex);
+}
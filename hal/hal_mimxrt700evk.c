@@ -77,6 +77,18 @@ void HAL_DCACHE_CleanInvalidateByRange(uint32_t addr, uint32_t size)
     return;
 }
 
+void HAL_DCACHE_CleanByRange(uint32_t addr, uint32_t size)
+{
+    XCACHE_CleanCacheByRange(addr, size);
+    return;
+}
+
+void HAL_DCACHE_InvalidateByRange(uint32_t addr, uint32_t size)
+{
+    XCACHE_InvalidateCacheByRange(addr, size);
+    return;
+}
+
 /* perform cache maintenance if tensor arena is cacheable */
 #if defined(HAL_TENSOR_ARENA_NCACHE) && (HAL_TENSOR_ARENA_NCACHE == 0)
 void cleanCache(void)
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Model input tensor conversion
+ *
+ * The normalization and quantization are folded into one multiply-add per
+ * channel (value = pixel * a[c] + b[c]). Pixels are processed by blocks of
+ * TENSOR_BLK with the coefficients expanded over the block, so the inner
+ * loops are straight and free of divisions and channel modulos: the compiler
+ * keeps them in FPU/vector registers.
+ * In-place NHWC conversions widen the data: blocks are processed from the
+ * end of the image, each block being read before it is written.
+ */
+
+#include <string.h>
+#include "hal_tensor.h"
+
+#define TENSOR_BLK  8   /* pixels per block */
+
+typedef struct {
+    float a[TENSOR_BLK * MPP_INFERENCE_MAX_CHANNELS];
+    float b[TENSOR_BLK * MPP_INFERENCE_MAX_CHANNELS];
+    float lo, hi;       /* saturation of integer types */
+} tensor_coef_t;
+
+void hal_tensor_norm_init(hal_tensor_norm_t *norm, float mean, float std, const float *ch_mean, const float *ch_std)
+{
+    bool per_ch = (ch_std != NULL) && (ch_std[0] != 0);
+    int c;
+
+    for (c = 0; c < MPP_INFERENCE_MAX_CHANNELS; c++) {
+        norm->mean[c] = per_ch ? ((ch_mean != NULL) ? ch_mean[c] : 0) : mean;
+        norm->std[c] = per_ch ? ch_std[c] : std;
+    }
+    norm->scale = 0;
+    norm->zero_point = 0;
+}
+
+static void tensor_coef(tensor_coef_t *k, int channels, mpp_tensor_type_t type, const hal_tensor_norm_t *norm)
+{
+    int c, i;
+
+    for (c = 0; c < channels; c++) {
+        float std = (norm->std[c] != 0) ? norm->std[c] : 1.0f;
+        float q = ((type != MPP_TENSOR_TYPE_FLOAT32) && (norm->scale != 0)) ? norm->scale : 1.0f;
+        float zp = (type != MPP_TENSOR_TYPE_FLOAT32) ? (float)norm->zero_point : 0.0f;
+
+        k->a[c] = 1.0f / (std * q);
+        k->b[c] = zp - norm->mean[c] / (std * q);
+    }
+    for (i = channels; i < TENSOR_BLK * channels; i++) {
+        k->a[i] = k->a[i % channels];
+        k->b[i] = k->b[i % channels];
+    }
+    k->lo = (type == MPP_TENSOR_TYPE_INT16) ? -32768.0f : -128.0f;
+    k->hi = (type == MPP_TENSOR_TYPE_INT16) ? 32767.0f : 127.0f;
+}
+
+/* round to nearest and saturate */
+static inline int32_t tensor_round(float v, float lo, float hi)
+{
+    v = (v < lo) ? lo : ((v > hi) ? hi : v);
+    return (int32_t)((v >= 0) ? (v + 0.5f) : (v - 0.5f));
+}
+
+/* convert 'n' interleaved elements starting at a pixel boundary, n <= TENSOR_BLK * channels */
+static void tensor_blk(void *dst, const uint8_t *src, int n, mpp_tensor_type_t type, const tensor_coef_t *k)
+{
+    uint8_t in[TENSOR_BLK * MPP_INFERENCE_MAX_CHANNELS];
+    int i;
+
+    /* read the whole block first: the destination may overlap it */
+    memcpy(in, src, n);
+    switch (type) {
+    case MPP_TENSOR_TYPE_FLOAT32:
+        for (i = 0; i < n; i++)
+            ((float *)dst)[i] = in[i] * k->a[i] + k->b[i];
+        break;
+    case MPP_TENSOR_TYPE_INT16:
+        for (i = 0; i < n; i++)
+            ((int16_t *)dst)[i] = (int16_t)tensor_round(in[i] * k->a[i] + k->b[i], k->lo, k->hi);
+        break;
+    case MPP_TENSOR_TYPE_INT8:
+        for (i = 0; i < n; i++)
+            ((int8_t *)dst)[i] = (int8_t)tensor_round(in[i] * k->a[i] + k->b[i], k->lo, k->hi);
+        break;
+    default:
+        memmove(dst, in, n);
+        break;
+    }
+}
+
+static int tensor_elem_size(mpp_tensor_type_t type)
+{
+    switch (type) {
+    case MPP_TENSOR_TYPE_FLOAT32:
+        return 4;
+    case MPP_TENSOR_TYPE_INT16:
+        return 2;
+    case MPP_TENSOR_TYPE_INT8:
+    case MPP_TENSOR_TYPE_UINT8:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* interleaved destination, possibly in place: blocks from the end */
+static void tensor_nhwc(uint8_t *dst, const uint8_t *src, int pixels, int channels,
+                        mpp_tensor_type_t type, const tensor_coef_t *k)
+{
+    int esize = tensor_elem_size(type);
+    int blk = TENSOR_BLK * channels;
+    int head = (pixels % TENSOR_BLK) * channels;
+    int i;
+
+    for (i = pixels * channels - blk; i >= head; i -= blk)
+        tensor_blk(dst + i * esize, src + i, blk, type, k);
+    if (head > 0)
+        tensor_blk(dst, src, head, type, k);
+}
+
+/* planar destination: one plane per channel, the source is not overwritten */
+static void tensor_nchw(uint8_t *dst, const uint8_t *src, int pixels, int channels,
+                        mpp_tensor_type_t type, const tensor_coef_t *k)
+{
+    int c, i;
+
+    for (c = 0; c < channels; c++) {
+        const uint8_t *s = src + c;
+        float a = k->a[c], b = k->b[c];
+
+        switch (type) {
+        case MPP_TENSOR_TYPE_FLOAT32: {
+            float *d = (float *)dst + c * pixels;
+            for (i = 0; i < pixels; i++)
+                d[i] = s[i * channels] * a + b;
+            break;
+        }
+        case MPP_TENSOR_TYPE_INT16: {
+            int16_t *d = (int16_t *)dst + c * pixels;
+            for (i = 0; i < pixels; i++)
+                d[i] = (int16_t)tensor_round(s[i * channels] * a + b, k->lo, k->hi);
+            break;
+        }
+        case MPP_TENSOR_TYPE_INT8: {
+            int8_t *d = (int8_t *)dst + c * pixels;
+            for (i = 0; i < pixels; i++)
+                d[i] = (int8_t)tensor_round(s[i * channels] * a + b, k->lo, k->hi);
+            break;
+        }
+        default: {
+            uint8_t *d = dst + c * pixels;
+            for (i = 0; i < pixels; i++)
+                d[i] = s[i * channels];
+            break;
+        }
+        }
+    }
+}
+
+int hal_tensor_from_u8(void *dst, const uint8_t *src, int width, int height, int channels,
+                       mpp_tensor_type_t type, mpp_tensor_order_t order, const hal_tensor_norm_t *norm)
+{
+    tensor_coef_t k;
+    int pixels = width * height;
+
+    if ((dst == NULL) || (src == NULL) || (norm == NULL) || (channels <= 0)
+            || (channels > MPP_INFERENCE_MAX_CHANNELS) || (tensor_elem_size(type) == 0))
+        return -1;
+
+    tensor_coef(&k, channels, type, norm);
+    if (order == MPP_TENSOR_ORDER_NCHW) {
+        tensor_nchw(dst, src, pixels, channels, type, &k);
+    } else if (order == MPP_TENSOR_ORDER_NHWC) {
+        if ((type != MPP_TENSOR_TYPE_UINT8) || (dst != src))
+            tensor_nhwc(dst, src, pixels, channels, type, &k);
+    } else {
+        return -1;
+    }
+    return 0;
+}
@@ -42,9 +42,9 @@ extern "C" {
 #define HAL_LOG_LEVEL LOG_DEFAULT_LEVEL
 #endif
 
-static void LOG_STR(const char* module, const char* func, int line, const char* lvl_str, const char* str)
+static void LOG_STR(const char* module, const char* func, int line, uint32_t tick, const char* lvl_str, const char* str)
 {
-    PRINTF("\r[%u]", (unsigned int)hal_get_ostick());
+    PRINTF("\r[%u]", (unsigned int)tick);
     PRINTF(":%s:%s:(%s:%u)", module, lvl_str, func, line);
     PRINTF(":%s", str);
 }
@@ -56,7 +56,7 @@ void LOGE(const char* module, const char* func, int line, const char* format, ..
     va_list args;
     va_start(args, format);
     vsprintf(args_buffer, format, args);
-    LOG_STR(module, func, line, "ERR", args_buffer);
+    LOG_STR(module, func, line, hal_get_ostick(), "ERR", args_buffer);
     va_end(args);
 }
 #else
@@ -73,7 +73,7 @@ void LOGI(const char* module, const char* func, int line, const char* format, ..
     va_list args;
     va_start(args, format);
     vsprintf(args_buffer, format, args);
-    LOG_STR(module, func, line, "INFO", args_buffer);
+    LOG_STR(module, func, line, hal_get_ostick(), "INFO", args_buffer);
     va_end(args);
 }
 #else
@@ -90,7 +90,7 @@ void LOGD(const char* module, const char* func, int line, const char* format, ..
     va_list args;
     va_start(args, format);
     vsprintf(args_buffer, format, args);
-    LOG_STR(module, func, line, "DBG", args_buffer);
+    LOG_STR(module, func, line, hal_get_ostick(), "DBG", args_buffer);
     va_end(args);
 }
 #else
@@ -100,6 +100,17 @@ void LOGD(const char* module, const char* func, int line, const char* format, ..
 }
 #endif
 
+void LOG_AT(const char* module, const char* func, int line, int level, uint32_t tick, const char* format, ...)
+{
+    static const char *lvl_str[] = {"ERR", "INFO", "DBG"};
+    char args_buffer[LOG_STRING_MAX_SIZE];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(args_buffer, sizeof(args_buffer), format, args);
+    LOG_STR(module, func, line, tick, lvl_str[(level > LOG_LVL_DEBUG) ? LOG_LVL_DEBUG : level], args_buffer);
+    va_end(args);
+}
+
 int setup_graphic_dev(hal_graphics_setup_t gfx_setup[], int graphic_nb,
                       const char *name, gfx_dev_t *dev)
 {
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Inference backends registry
+ *
+ * Elements select their vision algo device by model type or backend name at
+ * run time. The backends built in the HAL register on first use, others may
+ * be added by the application with hal_valgo_register().
+ */
+
+#include <string.h>
+#include "mpp_config.h"
+#include "hal.h"
+#include "hal_valgo_dev.h"
+#include "hal_debug.h"
+
+#define HAL_VALGO_BACKEND_MAX 8
+
+#define TYPE_BIT(t)     (1U << (t))
+
+#if (HAL_ENABLE_INFERENCE_TFLITE == 1)
+static const hal_valgo_backend_t s_tflite_backend = {
+    .caps = {
+        .name = "tflite",
+        .type = MPP_INFERENCE_TYPE_TFLITE,
+        .tensor_types = TYPE_BIT(MPP_TENSOR_TYPE_UINT8) | TYPE_BIT(MPP_TENSOR_TYPE_INT8)
+                      | TYPE_BIT(MPP_TENSOR_TYPE_INT16) | TYPE_BIT(MPP_TENSOR_TYPE_FLOAT32),
+        .tensor_orders = TYPE_BIT(MPP_TENSOR_ORDER_NHWC) | TYPE_BIT(MPP_TENSOR_ORDER_NCHW),
+        .max_inputs = MPP_INFERENCE_MAX_INPUTS,
+        .multi_instance = true,
+        .async = false,
+    },
+    .setup = hal_inference_tflite_setup,
+};
+#endif
+
+#if (HAL_ENABLE_INFERENCE_GLOW == 1)
+static const hal_valgo_backend_t s_glow_backend = {
+    .caps = {
+        .name = "glow",
+        .type = MPP_INFERENCE_TYPE_GLOW,
+        .tensor_types = TYPE_BIT(MPP_TENSOR_TYPE_UINT8) | TYPE_BIT(MPP_TENSOR_TYPE_INT8)
+                      | TYPE_BIT(MPP_TENSOR_TYPE_FLOAT32),
+        .tensor_orders = TYPE_BIT(MPP_TENSOR_ORDER_NHWC),
+        .max_inputs = 1,
+        .multi_instance = true,
+        .async = false,
+    },
+    .setup = hal_inference_glow_setup,
+};
+#endif
+
+static const hal_valgo_backend_t s_ref_backend = {
+    .caps = {
+        .name = "reference",
+        .type = MPP_INFERENCE_TYPE_REFERENCE,
+        .tensor_types = TYPE_BIT(MPP_TENSOR_TYPE_UINT8) | TYPE_BIT(MPP_TENSOR_TYPE_INT8)
+                      | TYPE_BIT(MPP_TENSOR_TYPE_INT16) | TYPE_BIT(MPP_TENSOR_TYPE_FLOAT32),
+        .tensor_orders = TYPE_BIT(MPP_TENSOR_ORDER_NHWC),
+        .max_inputs = 1,
+        .multi_instance = true,
+        .async = false,
+    },
+    .setup = hal_inference_ref_setup,
+};
+
+static struct {
+    const hal_valgo_backend_t *backend;
+    int users;
+} s_backends[HAL_VALGO_BACKEND_MAX];
+static int s_nb_backends;
+static bool s_builtins;
+
+static int valgo_add(const hal_valgo_backend_t *backend)
+{
+    int i;
+
+    if ((backend == NULL) || (backend->setup == NULL) || (backend->caps.name == NULL))
+        return -1;
+    for (i = 0; i < s_nb_backends; i++)
+    {
+        if (strcmp(s_backends[i].backend->caps.name, backend->caps.name) == 0)
+        {
+            HAL_LOGE("inference backend %s already registered\n", backend->caps.name);
+            return -1;
+        }
+    }
+    if (s_nb_backends >= HAL_VALGO_BACKEND_MAX)
+    {
+        HAL_LOGE("too many inference backends (max %d)\n", HAL_VALGO_BACKEND_MAX);
+        return -1;
+    }
+    s_backends[s_nb_backends].backend = backend;
+    s_backends[s_nb_backends].users = 0;
+    s_nb_backends++;
+    return 0;
+}
+
+/* built-in backends come first: they are the defaults of their type */
+static void valgo_builtins(void)
+{
+    if (s_builtins)
+        return;
+    s_builtins = true;
+#if (HAL_ENABLE_INFERENCE_TFLITE == 1)
+    valgo_add(&s_tflite_backend);
+#endif
+#if (HAL_ENABLE_INFERENCE_GLOW == 1)
+    valgo_add(&s_glow_backend);
+#endif
+    valgo_add(&s_ref_backend);
+}
+
+int hal_valgo_register(const hal_valgo_backend_t *backend)
+{
+    valgo_builtins();
+    return valgo_add(backend);
+}
+
+int hal_valgo_setup(vision_algo_dev_t *dev, mpp_inference_type_t type, const char *name, const hal_valgo_caps_t **caps)
+{
+    const hal_valgo_caps_t *c;
+    int i;
+
+    valgo_builtins();
+    for (i = 0; i < s_nb_backends; i++)
+    {
+        c = &s_backends[i].backend->caps;
+        if ((name != NULL) ? (strcmp(c->name, name) == 0) : (c->type == type))
+            break;
+    }
+    if (i == s_nb_backends)
+    {
+        HAL_LOGE("no inference backend %s for type %d\n", name ? name : "", type);
+        return -1;
+    }
+    if (c->type != type)
+    {
+        HAL_LOGE("inference backend %s does not run models of type %d\n", c->name, type);
+        return -1;
+    }
+    if (!c->multi_instance && (s_backends[i].users > 0))
+    {
+        HAL_LOGE("inference backend %s supports a single instance\n", c->name);
+        return -1;
+    }
+    if (s_backends[i].backend->setup(dev) != 0)
+        return -1;
+
+    /* the device remembers its backend for the release */
+    dev->id = i;
+    strncpy(dev->name, c->name, sizeof(dev->name) - 1);
+    dev->name[sizeof(dev->name) - 1] = '\0';
+    s_backends[i].users++;
+    if (caps != NULL)
+        *caps = c;
+    return 0;
+}
+
+void hal_valgo_release(vision_algo_dev_t *dev)
+{
+    if ((dev == NULL) || (dev->ops == NULL) || (dev->id < 0) || (dev->id >= s_nb_backends))
+        return;
+    if (s_backends[dev->id].users > 0)
+        s_backends[dev->id].users--;
+    dev->ops = NULL;
+}
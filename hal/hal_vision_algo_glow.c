@@ -0,0 +1,322 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * @brief vision algorithm Glow HAL driver implementation for the MCU Media Processing Pipeline.
+ *
+ * Runs models compiled ahead of time by the Glow compiler into a bundle: the bundle entry point
+ * takes three memory areas, the constant weights (read-only, used in place from the model data),
+ * the mutable weights holding the input/output placeholders, and the activations scratch memory.
+ */
+
+#include "mpp_config.h"
+#include "hal_valgo_dev.h"
+#include "hal_debug.h"
+#include "hal.h"
+#include "hal_os.h"
+
+#if (HAL_ENABLE_INFERENCE_GLOW == 1)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "mpp_api_types.h"
+#include "hal_utils.h"
+#include "hal_tensor.h"
+
+/* bundles memory alignment (GLOW_MEM_ALIGN of the generated headers) */
+#ifndef HAL_GLOW_BUFFER_ALIGN
+#define HAL_GLOW_BUFFER_ALIGN 64
+#endif
+
+/* Glow bundle error code for correct execution */
+#define HAL_GLOW_SUCCESS 0
+
+typedef struct _glow_model_param
+{
+    model_param_t user_params;
+    uint8_t *constant_weight;   /* constant weights, from the model data */
+    uint8_t *mutable_weight;    /* input/output placeholders */
+    uint8_t *activations;       /* scratch memory */
+    uint8_t *mutable_heap;      /* allocations to free */
+    uint8_t *activations_heap;
+    mpp_inference_tensor_params_t input_tensor;
+    mpp_inference_tensor_params_t *out_tensors[MPP_INFERENCE_MAX_OUTPUTS];
+    mpp_inference_cb_param_t out_param;
+} glow_model_param_t;
+
+static uint8_t *glow_align(uint8_t *p)
+{
+    return (uint8_t *)(((uintptr_t)p + HAL_GLOW_BUFFER_ALIGN - 1) & ~(uintptr_t)(HAL_GLOW_BUFFER_ALIGN - 1));
+}
+
+static hal_valgo_status_t HAL_VisionAlgoDev_Glow_Deinit(vision_algo_dev_t *dev);
+
+static hal_valgo_status_t HAL_VisionAlgoDev_Glow_Init(vision_algo_dev_t *dev, model_param_t *param)
+{
+    hal_valgo_status_t ret = kStatus_HAL_ValgoSuccess;
+    mpp_inference_params_t *infer = &param->inference_params;
+    glow_model_param_t *glow_model_param;
+    int i;
+
+    HAL_LOGD("++HAL_VisionAlgoDev_Glow_Init\n");
+
+    if ((infer->model_entry_point == NULL) || (param->model_data == NULL))
+    {
+        HAL_LOGE("Glow bundle entry point and constant weights are required\n");
+        return kStatus_HAL_ValgoInitError;
+    }
+    if (((uintptr_t)param->model_data % HAL_GLOW_BUFFER_ALIGN) != 0)
+    {
+        HAL_LOGE("Glow constant weights should be %d bytes aligned\n", HAL_GLOW_BUFFER_ALIGN);
+        return kStatus_HAL_ValgoInitError;
+    }
+    if ((infer->num_inputs != 1) || (infer->num_outputs < 1) || (infer->num_outputs > MPP_INFERENCE_MAX_OUTPUTS))
+    {
+        HAL_LOGE("Glow bundle with %d inputs and %d outputs not supported\n", infer->num_inputs, infer->num_outputs);
+        return kStatus_HAL_ValgoInitError;
+    }
+    if ((infer->inputs_offsets[0] >= infer->mutable_weight_MemSize)
+            || (param->width * param->height * get_bitpp(param->format) / 8
+                + infer->inputs_offsets[0] > infer->mutable_weight_MemSize))
+    {
+        HAL_LOGE("Glow input placeholder does not fit the mutable weights\n");
+        return kStatus_HAL_ValgoInitError;
+    }
+
+    memset(&dev->cap, 0, sizeof(dev->cap));
+    dev->priv_data = hal_malloc(sizeof(glow_model_param_t));
+    if (dev->priv_data == NULL)
+    {
+        HAL_LOGE("NULL pointer\n");
+        return kStatus_HAL_ValgoMallocError;
+    }
+    glow_model_param = (glow_model_param_t *)dev->priv_data;
+    memset(glow_model_param, 0, sizeof(glow_model_param_t));
+    memcpy(&glow_model_param->user_params, param, sizeof(model_param_t));
+
+    do {
+        /* activations are read and written by every layer: fast memory first */
+        glow_model_param->constant_weight = (uint8_t *)param->model_data;
+        glow_model_param->mutable_heap = hal_malloc_placed(infer->mutable_weight_MemSize + HAL_GLOW_BUFFER_ALIGN,
+                MPP_MEM_PLACE_ANY, NULL);
+        glow_model_param->activations_heap = hal_malloc_placed(infer->activations_MemSize + HAL_GLOW_BUFFER_ALIGN,
+                MPP_MEM_PLACE_FAST, NULL);
+        if ((glow_model_param->mutable_heap == NULL) || (glow_model_param->activations_heap == NULL))
+        {
+            HAL_LOGE("Glow bundle memory allocation failed\n");
+            ret = kStatus_HAL_ValgoMallocError;
+            break;
+        }
+        glow_model_param->mutable_weight = glow_align(glow_model_param->mutable_heap);
+        glow_model_param->activations = glow_align(glow_model_param->activations_heap);
+
+        /* placeholders are located in the mutable weights,
+         * bundles do not describe their dimensions: the input is the frame */
+        glow_model_param->input_tensor.data = glow_model_param->mutable_weight + infer->inputs_offsets[0];
+        glow_model_param->input_tensor.type = infer->model_input_tensors_type;
+        param->input_types = 1U << infer->model_input_tensors_type;
+        glow_model_param->input_tensor.dims.size = 4;
+        glow_model_param->input_tensor.dims.data[0] = 1;
+        glow_model_param->input_tensor.dims.data[1] = param->height;
+        glow_model_param->input_tensor.dims.data[2] = param->width;
+        glow_model_param->input_tensor.dims.data[3] = get_bitpp(param->format) / 8;
+
+        for (i = 0; i < infer->num_outputs; i++)
+        {
+            if (infer->outputs_offsets[i] >= infer->mutable_weight_MemSize)
+            {
+                HAL_LOGE("Glow output placeholder %d out of the mutable weights\n", i);
+                ret = kStatus_HAL_ValgoInitError;
+                break;
+            }
+            glow_model_param->out_tensors[i] = hal_malloc(sizeof(mpp_inference_tensor_params_t));
+            if (glow_model_param->out_tensors[i] == NULL)
+            {
+                HAL_LOGE("NULL pointer\n");
+                ret = kStatus_HAL_ValgoMallocError;
+                break;
+            }
+            /* bundles do not describe their outputs: dimensions and type are those of the bundle header,
+             * when the application does not report them dims.size is 0 */
+            memset(glow_model_param->out_tensors[i], 0, sizeof(mpp_inference_tensor_params_t));
+            glow_model_param->out_tensors[i]->data = glow_model_param->mutable_weight + infer->outputs_offsets[i];
+            glow_model_param->out_tensors[i]->dims = infer->outputs_dims[i];
+            glow_model_param->out_tensors[i]->type = infer->outputs_types[i];
+            if (infer->outputs_dims[i].size == 0)
+                param->outputs_unsized = true;
+        }
+        if (ret != kStatus_HAL_ValgoSuccess)
+            break;
+        glow_model_param->out_param.out_tensors = glow_model_param->out_tensors;
+        glow_model_param->out_param.num_outputs = infer->num_outputs;
+
+        switch (glow_model_param->input_tensor.type) {
+        case MPP_TENSOR_TYPE_UINT8:
+        case MPP_TENSOR_TYPE_INT8:
+            break;
+        case MPP_TENSOR_TYPE_FLOAT32:
+            if (infer->inputs_offsets[0] + (uint64_t)param->width * param->height * get_bitpp(param->format) / 8 * sizeof(float)
+                    > infer->mutable_weight_MemSize)
+            {
+                HAL_LOGE("Glow float input placeholder does not fit the mutable weights\n");
+                ret = kStatus_HAL_ValgoInitError;
+            }
+            break;
+        default:
+            HAL_LOGE("Glow input tensor type not supported\n");
+            ret = kStatus_HAL_ValgoInitError;
+            break;
+        }
+    } while (false);
+
+    if (ret != kStatus_HAL_ValgoSuccess)
+    {
+        HAL_VisionAlgoDev_Glow_Deinit(dev);
+        return ret;
+    }
+
+    HAL_LOGI("Glow bundle: %u bytes constant, %u bytes mutable, %u bytes activations",
+             (unsigned int)infer->constant_weight_MemSize, (unsigned int)infer->mutable_weight_MemSize,
+             (unsigned int)infer->activations_MemSize);
+    HAL_LOGD("--HAL_VisionAlgoDev_Glow_Init\n");
+    return ret;
+}
+
+// deinitialize the dev
+static hal_valgo_status_t HAL_VisionAlgoDev_Glow_Deinit(vision_algo_dev_t *dev)
+{
+    glow_model_param_t *glow_model_param = (glow_model_param_t *)dev->priv_data;
+    int i;
+
+    HAL_LOGD("++HAL_VisionAlgoDev_Glow_Deinit\n");
+    if (glow_model_param == NULL)
+        return kStatus_HAL_ValgoSuccess;
+
+    for (i = 0; i < MPP_INFERENCE_MAX_OUTPUTS; i++)
+    {
+        if (glow_model_param->out_tensors[i] != NULL)
+            hal_free(glow_model_param->out_tensors[i]);
+    }
+    hal_free_placed(glow_model_param->mutable_heap);
+    hal_free_placed(glow_model_param->activations_heap);
+    hal_free(dev->priv_data);
+    dev->priv_data = NULL;
+
+    HAL_LOGD("--HAL_VisionAlgoDev_Glow_Deinit\n");
+    return kStatus_HAL_ValgoSuccess;
+}
+
+/* convert the image in place into the bundle input placeholder type */
+static void glow_convert_input(glow_model_param_t *glow_model_param)
+{
+    mpp_inference_params_t *infer = &glow_model_param->user_params.inference_params;
+    mpp_tensor_dims_t *dims = &glow_model_param->input_tensor.dims;
+    hal_tensor_norm_t norm;
+
+    hal_tensor_norm_init(&norm, glow_model_param->user_params.model_input_mean,
+            glow_model_param->user_params.model_input_std,
+            glow_model_param->user_params.model_input_ch_mean,
+            glow_model_param->user_params.model_input_ch_std);
+    /* integer placeholders use the bundle quantization,
+     * by default they are centered on the 8-bit range (zero point -128) */
+    norm.scale = infer->model_input_scale;
+    norm.zero_point = (infer->model_input_scale != 0) ? infer->model_input_zero_point : -128;
+    /* the float placeholder overlaps the 8-bit image: converted in place */
+    hal_tensor_from_u8((void *)glow_model_param->input_tensor.data, glow_model_param->input_tensor.data,
+            dims->data[2], dims->data[1], dims->data[3], glow_model_param->input_tensor.type,
+            MPP_TENSOR_ORDER_NHWC, &norm);
+}
+
+// start the dev
+static hal_valgo_status_t HAL_VisionAlgoDev_Glow_Run(const vision_algo_dev_t *dev, void *data)
+{
+    glow_model_param_t *glow_model_param = (glow_model_param_t *)dev->priv_data;
+    int status;
+
+    HAL_LOGD("++HAL_VisionAlgoDev_Glow_Run\n");
+
+    glow_convert_input(glow_model_param);
+
+    uint32_t startTime = hal_get_time_us();
+    status = glow_model_param->user_params.inference_params.model_entry_point(
+            glow_model_param->constant_weight,
+            glow_model_param->mutable_weight,
+            glow_model_param->activations);
+    if (status != HAL_GLOW_SUCCESS) {
+        HAL_LOGE("ERROR: Glow bundle inference failed with %d\n", status);
+        return kStatus_HAL_ValgoError;
+    }
+    glow_model_param->out_param.inference_time_ms = (hal_get_time_us() - startTime) / 1000;
+    glow_model_param->out_param.inference_type = MPP_INFERENCE_TYPE_GLOW;
+
+    glow_model_param->user_params.evt_callback_f(
+            NULL,
+            MPP_EVENT_INFERENCE_OUTPUT_READY,
+            (void *)&glow_model_param->out_param,
+            glow_model_param->user_params.cb_userdata);
+
+    HAL_LOGD("--HAL_VisionAlgoDev_Glow_Run\n");
+    return kStatus_HAL_ValgoSuccess;
+}
+
+static hal_valgo_status_t HAL_VisionAlgoDev_Glow_getBufDesc(const vision_algo_dev_t *dev, hw_buf_desc_t *in_buf, mpp_memory_policy_t *policy)
+{
+    glow_model_param_t *glow_model_param;
+    HAL_LOGD("++HAL_VisionAlgoDev_Glow_getBufDesc\n");
+
+    if ((in_buf == NULL) || (policy == NULL))
+    {
+        HAL_LOGE("\nNULL pointer\n");
+        return kStatus_HAL_ValgoError;
+    }
+    /* the input placeholder is in the bundle mutable weights */
+    *policy = HAL_MEM_ALLOC_BOTH;
+
+    glow_model_param = (glow_model_param_t *)dev->priv_data;
+    in_buf->alignment = HAL_GLOW_BUFFER_ALIGN;
+    in_buf->nb_lines = glow_model_param->input_tensor.dims.data[1];
+    in_buf->cacheable = true;
+    in_buf->stride = glow_model_param->input_tensor.dims.data[2] * glow_model_param->input_tensor.dims.data[3];
+    in_buf->addr = (unsigned char *)glow_model_param->input_tensor.data;
+
+    HAL_LOGD("--HAL_VisionAlgoDev_Glow_getBufDesc\n");
+    return kStatus_HAL_ValgoSuccess;
+}
+
+const static vision_algo_dev_operator_t s_VisionAlgoDev_GlowOps = {
+    .init        = HAL_VisionAlgoDev_Glow_Init,
+    .deinit      = HAL_VisionAlgoDev_Glow_Deinit,
+    .run         = HAL_VisionAlgoDev_Glow_Run,
+    .get_buf_desc   = HAL_VisionAlgoDev_Glow_getBufDesc,
+};
+
+int hal_inference_glow_setup(vision_algo_dev_t *dev)
+{
+    dev->id = 0;
+    dev->ops = &s_VisionAlgoDev_GlowOps;
+
+    return 0;
+}
+#else  /* (HAL_ENABLE_INFERENCE_GLOW != 1) */
+int hal_inference_glow_setup(vision_algo_dev_t *dev)
+{
+    HAL_LOGE("Inference Glow not enabled\n");
+    return -1;
+}
+#endif /* (HAL_ENABLE_INFERENCE_GLOW == 1) */
@@ -0,0 +1,242 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * @brief vision algorithm reference C backend for the MCU Media Processing Pipeline.
+ *
+ * Runs the C function of a mpp_ref_model_t without any inference library:
+ * the pipeline can be tested on the host or compared with the other backends.
+ */
+
+#include <string.h>
+#include "mpp_config.h"
+#include "hal_valgo_dev.h"
+#include "hal_debug.h"
+#include "hal.h"
+#include "hal_os.h"
+#include "hal_tensor.h"
+
+#define HAL_REF_BUFFER_ALIGN 16
+
+typedef struct _ref_model_param
+{
+    model_param_t user_params;
+    const mpp_ref_model_t *model;
+    uint8_t *input_heap;
+    mpp_inference_tensor_params_t input_tensor;
+    mpp_inference_tensor_params_t outputs[MPP_INFERENCE_MAX_OUTPUTS];
+    mpp_inference_tensor_params_t *out_tensors[MPP_INFERENCE_MAX_OUTPUTS];
+    mpp_inference_cb_param_t out_param;
+} ref_model_param_t;
+
+static uint32_t ref_tensor_size(const mpp_tensor_dims_t *dims, mpp_tensor_type_t type)
+{
+    uint32_t size = (type == MPP_TENSOR_TYPE_FLOAT32) ? sizeof(float) :
+                    ((type == MPP_TENSOR_TYPE_INT16) ? sizeof(int16_t) : 1);
+
+    for (uint32_t i = 0; i < dims->size; i++)
+        size *= dims->data[i];
+    return (dims->size == 0) ? 0 : size;
+}
+
+static hal_valgo_status_t HAL_VisionAlgoDev_Ref_Deinit(vision_algo_dev_t *dev);
+
+static hal_valgo_status_t HAL_VisionAlgoDev_Ref_Init(vision_algo_dev_t *dev, model_param_t *param)
+{
+    const mpp_ref_model_t *model = (const mpp_ref_model_t *)param->model_data;
+    ref_model_param_t *ref;
+    uint32_t in_size;
+    int i;
+
+    HAL_LOGD("++HAL_VisionAlgoDev_Ref_Init\n");
+
+    if ((model == NULL) || (model->width <= 0) || (model->height <= 0) || (model->channels <= 0)
+            || (model->num_outputs < 1) || (model->num_outputs > MPP_INFERENCE_MAX_OUTPUTS))
+    {
+        HAL_LOGE("Invalid reference model\n");
+        return kStatus_HAL_ValgoInitError;
+    }
+    /* the default model function writes the channel means */
+    if ((model->run == NULL) && ((model->out_type[0] != MPP_TENSOR_TYPE_FLOAT32)
+            || (ref_tensor_size(&model->out_dims[0], MPP_TENSOR_TYPE_FLOAT32) != model->channels * sizeof(float))))
+    {
+        HAL_LOGE("Reference model without function requires a FLOAT32 output of %d elements\n", model->channels);
+        return kStatus_HAL_ValgoInitError;
+    }
+
+    memset(&dev->cap, 0, sizeof(dev->cap));
+    dev->priv_data = hal_malloc(sizeof(ref_model_param_t));
+    if (dev->priv_data == NULL)
+    {
+        HAL_LOGE("NULL pointer\n");
+        return kStatus_HAL_ValgoMallocError;
+    }
+    ref = (ref_model_param_t *)dev->priv_data;
+    memset(ref, 0, sizeof(ref_model_param_t));
+    memcpy(&ref->user_params, param, sizeof(model_param_t));
+    ref->model = model;
+
+    /* input, then outputs, in one allocation */
+    mpp_tensor_dims_t in_dims = { 1, { model->width * model->height * model->channels } };
+    in_size = ref_tensor_size(&in_dims, model->input_type);
+    uint32_t size = in_size + HAL_REF_BUFFER_ALIGN;
+    for (i = 0; i < model->num_outputs; i++)
+        size += ref_tensor_size(&model->out_dims[i], model->out_type[i]) + sizeof(float);
+    ref->input_heap = hal_malloc(size);
+    if (ref->input_heap == NULL)
+    {
+        HAL_LOGE("Reference model memory allocation failed\n");
+        HAL_VisionAlgoDev_Ref_Deinit(dev);
+        return kStatus_HAL_ValgoMallocError;
+    }
+    uint8_t *p = (uint8_t *)(((uintptr_t)ref->input_heap + HAL_REF_BUFFER_ALIGN - 1) & ~(uintptr_t)(HAL_REF_BUFFER_ALIGN - 1));
+
+    ref->input_tensor.data = p;
+    ref->input_tensor.type = model->input_type;
+    param->input_types = 1U << model->input_type;
+    ref->input_tensor.dims.size = 4;
+    ref->input_tensor.dims.data[0] = 1;
+    ref->input_tensor.dims.data[1] = model->height;
+    ref->input_tensor.dims.data[2] = model->width;
+    ref->input_tensor.dims.data[3] = model->channels;
+    p += in_size;
+    for (i = 0; i < model->num_outputs; i++)
+    {
+        p = (uint8_t *)(((uintptr_t)p + sizeof(float) - 1) & ~(uintptr_t)(sizeof(float) - 1));
+        ref->outputs[i].data = p;
+        ref->outputs[i].dims = model->out_dims[i];
+        ref->outputs[i].type = model->out_type[i];
+        ref->out_tensors[i] = &ref->outputs[i];
+        p += ref_tensor_size(&model->out_dims[i], model->out_type[i]);
+    }
+    ref->out_param.out_tensors = ref->out_tensors;
+    ref->out_param.num_outputs = model->num_outputs;
+
+    HAL_LOGD("--HAL_VisionAlgoDev_Ref_Init\n");
+    return kStatus_HAL_ValgoSuccess;
+}
+
+static hal_valgo_status_t HAL_VisionAlgoDev_Ref_Deinit(vision_algo_dev_t *dev)
+{
+    ref_model_param_t *ref = (ref_model_param_t *)dev->priv_data;
+
+    if (ref == NULL)
+        return kStatus_HAL_ValgoSuccess;
+    if (ref->input_heap != NULL)
+        hal_free(ref->input_heap);
+    hal_free(ref);
+    dev->priv_data = NULL;
+    return kStatus_HAL_ValgoSuccess;
+}
+
+/* default model function: per-channel mean */
+static int ref_channel_mean(const ref_model_param_t *ref)
+{
+    const uint8_t *in = ref->input_tensor.data;
+    float *out = (float *)ref->outputs[0].data;
+    int c, i, n = ref->model->width * ref->model->height;
+
+    for (c = 0; c < ref->model->channels; c++)
+    {
+        float sum = 0;
+        for (i = 0; i < n; i++)
+        {
+            int idx = i * ref->model->channels + c;
+            switch (ref->input_tensor.type)
+            {
+            case MPP_TENSOR_TYPE_FLOAT32:
+                sum += ((const float *)in)[idx];
+                break;
+            case MPP_TENSOR_TYPE_INT16:
+                sum += ((const int16_t *)in)[idx];
+                break;
+            case MPP_TENSOR_TYPE_INT8:
+                sum += (int8_t)in[idx];
+                break;
+            default:
+                sum += in[idx];
+                break;
+            }
+        }
+        out[c] = sum / n;
+    }
+    return 0;
+}
+
+static hal_valgo_status_t HAL_VisionAlgoDev_Ref_Run(const vision_algo_dev_t *dev, void *data)
+{
+    ref_model_param_t *ref = (ref_model_param_t *)dev->priv_data;
+    int status;
+
+    /* integer inputs are centered on the 8-bit range (zero point -128) */
+    hal_tensor_norm_t norm;
+    hal_tensor_norm_init(&norm, ref->user_params.model_input_mean, ref->user_params.model_input_std,
+            ref->user_params.model_input_ch_mean, ref->user_params.model_input_ch_std);
+    if (ref->input_tensor.type != MPP_TENSOR_TYPE_FLOAT32)
+        norm.zero_point = -128;
+    hal_tensor_from_u8((void *)ref->input_tensor.data, ref->input_tensor.data, ref->model->width, ref->model->height,
+            ref->model->channels, ref->input_tensor.type, MPP_TENSOR_ORDER_NHWC, &norm);
+
+    uint32_t startTime = hal_get_time_us();
+    if (ref->model->run != NULL)
+        status = ref->model->run(&ref->input_tensor, ref->out_param.out_tensors, ref->model->arg);
+    else
+        status = ref_channel_mean(ref);
+    if (status != 0)
+    {
+        HAL_LOGE("ERROR: reference model failed with %d\n", status);
+        return kStatus_HAL_ValgoError;
+    }
+    ref->out_param.inference_time_ms = (hal_get_time_us() - startTime) / 1000;
+    ref->out_param.inference_type = MPP_INFERENCE_TYPE_REFERENCE;
+
+    ref->user_params.evt_callback_f(NULL, MPP_EVENT_INFERENCE_OUTPUT_READY,
+            (void *)&ref->out_param, ref->user_params.cb_userdata);
+    return kStatus_HAL_ValgoSuccess;
+}
+
+static hal_valgo_status_t HAL_VisionAlgoDev_Ref_getBufDesc(const vision_algo_dev_t *dev, hw_buf_desc_t *in_buf, mpp_memory_policy_t *policy)
+{
+    ref_model_param_t *ref = (ref_model_param_t *)dev->priv_data;
+
+    if ((in_buf == NULL) || (policy == NULL))
+    {
+        HAL_LOGE("\nNULL pointer\n");
+        return kStatus_HAL_ValgoError;
+    }
+    *policy = HAL_MEM_ALLOC_BOTH;
+    in_buf->alignment = HAL_REF_BUFFER_ALIGN;
+    in_buf->nb_lines = ref->model->height;
+    in_buf->cacheable = true;
+    in_buf->stride = ref->model->width * ref->model->channels;
+    in_buf->addr = (unsigned char *)ref->input_tensor.data;
+    return kStatus_HAL_ValgoSuccess;
+}
+
+const static vision_algo_dev_operator_t s_VisionAlgoDev_RefOps = {
+    .init        = HAL_VisionAlgoDev_Ref_Init,
+    .deinit      = HAL_VisionAlgoDev_Ref_Deinit,
+    .run         = HAL_VisionAlgoDev_Ref_Run,
+    .get_buf_desc   = HAL_VisionAlgoDev_Ref_getBufDesc,
+};
+
+int hal_inference_ref_setup(vision_algo_dev_t *dev)
+{
+    dev->ops = &s_VisionAlgoDev_RefOps;
+    return 0;
+}
@@ -33,23 +33,28 @@
 #include <stdio.h>
 #include "tflite/model.h"
 #include "mpp_api_types.h"
+#include "hal_tensor.h"
 
 typedef struct _tflite_model_param
 {
     model_param_t user_params;
-    mpp_inference_tensor_params_t input_tensor;
+    void *model;    /* model instance */
+    int num_inputs;
+    mpp_inference_tensor_params_t input_tensor[MPP_INFERENCE_MAX_INPUTS];
+    uint8_t *stage[MPP_INFERENCE_MAX_INPUTS];  /* interleaved image staging for NCHW models (NULL: converted in place) */
     mpp_inference_cb_param_t out_param;
+    mpp_inference_tensor_params_t *out_tensors; /* output tensors descriptions, sized from the model */
 } tflite_model_param_t;
 
 /* returns true if ok, false in case of issue */
-static bool check_model_input_dims(tflite_model_param_t *param)
+static bool check_model_input_dims(tflite_model_param_t *param, int idx)
 {
     if (param == NULL)
     {
         HAL_LOGE("Model parameters is NULL pointer\n");
         return false;
     }
-    if (param->input_tensor.dims.size != 4)
+    if (param->input_tensor[idx].dims.size != 4)
     {
         HAL_LOGE("Input Tensor not supported, expected 4 dimensions\n");
         return false;
@@ -57,17 +62,17 @@ static bool check_model_input_dims(tflite_model_param_t *param)
     return true;
 }
 
-static int get_model_input_width(tflite_model_param_t *param)
+static int get_model_input_width(tflite_model_param_t *param, int idx)
 {
-    if (!check_model_input_dims(param)) return 0;
+    if (!check_model_input_dims(param, idx)) return 0;
 
     if (param->user_params.tensor_order == MPP_TENSOR_ORDER_NCHW)
     {
-        return param->input_tensor.dims.data[3];
+        return param->input_tensor[idx].dims.data[3];
     }
     else if (param->user_params.tensor_order == MPP_TENSOR_ORDER_NHWC)
     {
-        return param->input_tensor.dims.data[2];
+        return param->input_tensor[idx].dims.data[2];
     }
     else
     {
@@ -76,17 +81,17 @@ static int get_model_input_width(tflite_model_param_t *param)
     }
 }
 
-static int get_model_input_height(tflite_model_param_t *param)
+static int get_model_input_height(tflite_model_param_t *param, int idx)
 {
-    if (!check_model_input_dims(param)) return 0;
+    if (!check_model_input_dims(param, idx)) return 0;
 
     if (param->user_params.tensor_order == MPP_TENSOR_ORDER_NCHW)
     {
-        return param->input_tensor.dims.data[2];
+        return param->input_tensor[idx].dims.data[2];
     }
     else if (param->user_params.tensor_order == MPP_TENSOR_ORDER_NHWC)
     {
-        return param->input_tensor.dims.data[1];
+        return param->input_tensor[idx].dims.data[1];
     }
     else
     {
@@ -95,17 +100,17 @@ static int get_model_input_height(tflite_model_param_t *param)
     }
 }
 
-static int get_model_input_channels(tflite_model_param_t *param)
+static int get_model_input_channels(tflite_model_param_t *param, int idx)
 {
-    if (!check_model_input_dims(param)) return 0;
+    if (!check_model_input_dims(param, idx)) return 0;
 
     if (param->user_params.tensor_order == MPP_TENSOR_ORDER_NCHW)
     {
-        return param->input_tensor.dims.data[1];
+        return param->input_tensor[idx].dims.data[1];
     }
     else if (param->user_params.tensor_order == MPP_TENSOR_ORDER_NHWC)
     {
-        return param->input_tensor.dims.data[3];
+        return param->input_tensor[idx].dims.data[3];
     }
     else
     {
@@ -114,6 +119,61 @@ static int get_model_input_channels(tflite_model_param_t *param)
     }
 }
 
+/* aligned address of the staging buffer */
+static uint8_t *tflite_input_stage(tflite_model_param_t *param, int idx)
+{
+    return (uint8_t *)(((uintptr_t)param->stage[idx] + HAL_TFLITE_BUFFER_ALIGN - 1) & ~(uintptr_t)(HAL_TFLITE_BUFFER_ALIGN - 1));
+}
+
+/* describe model input 'idx', allocate its staging buffer for NCHW models */
+static hal_valgo_status_t tflite_input_init(tflite_model_param_t *tflite_model_param, int idx)
+{
+    hal_valgo_status_t ret = kStatus_HAL_ValgoSuccess;
+
+    if (kStatus_Success != MODEL_GetInputTensor(tflite_model_param->model, idx, &tflite_model_param->input_tensor[idx]))
+    {
+        HAL_LOGE("ERROR: MODEL_GetInputTensor(%d) failed\n", idx);
+        return kStatus_HAL_ValgoInitError;
+    }
+
+    /* display model input format info */
+    HAL_LOGI("Model input %d expects width = %d", idx, get_model_input_width(tflite_model_param, idx));
+    HAL_LOGI("Model input %d expects height = %d", idx, get_model_input_height(tflite_model_param, idx));
+
+    switch(tflite_model_param->input_tensor[idx].type) {
+    case MPP_TENSOR_TYPE_UINT8:
+    case MPP_TENSOR_TYPE_INT8:
+    case MPP_TENSOR_TYPE_INT16:
+    case MPP_TENSOR_TYPE_FLOAT32:
+        if (get_model_input_channels(tflite_model_param, idx) == 3) {
+            HAL_LOGI("Model expects format = MPP_PIXEL_RGB");
+        } else if (get_model_input_channels(tflite_model_param, idx) == 1) {
+            HAL_LOGI("Model expects format = MPP_PIXEL_GRAY");
+        } else {
+            HAL_LOGE("--HAL_VisionAlgoDev_TFLite_getInput: invalid number of channels\n");
+            ret = kStatus_HAL_ValgoError;
+        }
+        break;
+    default:
+        HAL_LOGE("--HAL_VisionAlgoDev_TFLite_getInput: input tensor format not supported\n");
+        ret = kStatus_HAL_ValgoError;
+        break;
+    }
+
+    /* planar models: the pipeline writes the interleaved image to a staging buffer */
+    if ((ret == kStatus_HAL_ValgoSuccess) && (tflite_model_param->user_params.tensor_order == MPP_TENSOR_ORDER_NCHW))
+    {
+        tflite_model_param->stage[idx] = hal_malloc_placed(get_model_input_width(tflite_model_param, idx)
+                * get_model_input_height(tflite_model_param, idx) * get_model_input_channels(tflite_model_param, idx)
+                + HAL_TFLITE_BUFFER_ALIGN, MPP_MEM_PLACE_FAST, NULL);
+        if (tflite_model_param->stage[idx] == NULL) {
+            HAL_LOGE("NCHW staging buffer allocation failed\n");
+            ret = kStatus_HAL_ValgoMallocError;
+        }
+    }
+    return ret;
+}
+
 static hal_valgo_status_t HAL_VisionAlgoDev_TFLite_Init(vision_algo_dev_t *dev, model_param_t *param)
 {
     hal_valgo_status_t ret = kStatus_HAL_ValgoSuccess;
@@ -129,58 +189,55 @@ static hal_valgo_status_t HAL_VisionAlgoDev_TFLite_Init(vision_algo_dev_t *dev,
         HAL_LOGE("NULL pointer\n");
         return kStatus_HAL_ValgoMallocError ;
     }
-    memset(dev->priv_data, 0, sizeof(tflite_model_param));
+    memset(dev->priv_data, 0, sizeof(tflite_model_param_t));
     // get parameters from user passed to HAL
     memcpy(&tflite_model_param->user_params, param, sizeof(model_param_t));
 
-    // allocate output tensors description
-    int i;
-    for(i = 0; i < MPP_INFERENCE_MAX_OUTPUTS; i++)
+    // initialize TFLite with model
+    if (kStatus_Success != MODEL_Init(param->model_data, &tflite_model_param->model))
     {
-        if (i >= param->inference_params.num_outputs)
-        {   /* set to null unused output tensors descriptions */
-            tflite_model_param->out_param.out_tensors[i] = NULL;
-            continue;
-        }
-        tflite_model_param->out_param.out_tensors[i] = hal_malloc(sizeof(mpp_inference_tensor_params_t));
-        if(tflite_model_param->out_param.out_tensors[i] == NULL){
-            HAL_LOGE("NULL pointer\n");
-            return kStatus_HAL_ValgoMallocError ;
-        }
-        memset(tflite_model_param->out_param.out_tensors[i], 0, sizeof(mpp_inference_tensor_params_t));
+        HAL_LOGE("ERROR: MODEL_Init() failed\n");
+        return kStatus_HAL_ValgoInitError;
     }
 
-    // initialize TFLite with model and get missing in/out tensor info
-    if (kStatus_Success != MODEL_Init(param->model_data,
-            &tflite_model_param->input_tensor,
-            tflite_model_param->out_param.out_tensors,
-            param->inference_params.num_outputs))
+    // one input port per model input
+    tflite_model_param->num_inputs = MODEL_GetInputsCount(tflite_model_param->model);
+    if ((tflite_model_param->num_inputs != param->inference_params.num_inputs)
+            || (tflite_model_param->num_inputs > MPP_INFERENCE_MAX_INPUTS))
     {
-        HAL_LOGE("ERROR: MODEL_Init() failed\n");
+        HAL_LOGE("Model has %d inputs, %d input ports connected\n",
+                tflite_model_param->num_inputs, param->inference_params.num_inputs);
         return kStatus_HAL_ValgoInitError;
     }
 
-    /* display model input format info */
-    HAL_LOGI("Model expects width = %d", get_model_input_width(tflite_model_param));
-    HAL_LOGI("Model expects height = %d", get_model_input_height(tflite_model_param));
+    // output tensors descriptions, all the model outputs unless the user limits them
+    int i, num_outputs = MODEL_GetOutputsCount(tflite_model_param->model);
+    if (param->inference_params.num_outputs > num_outputs)
+    {
+        HAL_LOGE("Model has %d outputs, %d expected\n", num_outputs, param->inference_params.num_outputs);
+        return kStatus_HAL_ValgoInitError;
+    }
+    if (param->inference_params.num_outputs > 0)
+        num_outputs = param->inference_params.num_outputs;
+    tflite_model_param->out_tensors = hal_malloc(num_outputs * sizeof(mpp_inference_tensor_params_t));
+    tflite_model_param->out_param.out_tensors = hal_malloc(num_outputs * sizeof(mpp_inference_tensor_params_t *));
+    if ((tflite_model_param->out_tensors == NULL) || (tflite_model_param->out_param.out_tensors == NULL)) {
+        HAL_LOGE("NULL pointer\n");
+        return kStatus_HAL_ValgoMallocError ;
+    }
+    memset(tflite_model_param->out_tensors, 0, num_outputs * sizeof(mpp_inference_tensor_params_t));
+    tflite_model_param->out_param.num_outputs = num_outputs;
+    for(i = 0; i < num_outputs; i++)
+    {
+        MODEL_GetOutputTensor(tflite_model_param->model, i, &tflite_model_param->out_tensors[i]);
+        tflite_model_param->out_param.out_tensors[i] = &tflite_model_param->out_tensors[i];
+    }
 
-    switch(tflite_model_param->input_tensor.type) {
-    case MPP_TENSOR_TYPE_UINT8:
-    case MPP_TENSOR_TYPE_INT8:
-        if (get_model_input_channels(tflite_model_param) == 3) {
-            HAL_LOGI("Model expects format = MPP_PIXEL_RGB");
-        } else if (get_model_input_channels(tflite_model_param) == 1) {
-            HAL_LOGI("Model expects format = MPP_PIXEL_GRAY");
-        } else {
-            HAL_LOGE("--HAL_VisionAlgoDev_TFLite_getInput: invalid number of channels\n");
-            ret = kStatus_HAL_ValgoError;
-        }
-        break;
-    case MPP_TENSOR_TYPE_FLOAT32:
-    default:
-        HAL_LOGE("--HAL_VisionAlgoDev_TFLite_getInput: input tensor format not supported\n");
-        ret = kStatus_HAL_ValgoError;
-        break;
+    for(i = 0; (i < tflite_model_param->num_inputs) && (ret == kStatus_HAL_ValgoSuccess); i++)
+    {
+        ret = tflite_input_init(tflite_model_param, i);
+        if (ret == kStatus_HAL_ValgoSuccess)
+            param->input_types |= 1U << tflite_model_param->input_tensor[i].type;
     }
 
     HAL_LOGD("--HAL_VisionAlgoDev_TFLite_Init\n");
@@ -195,18 +252,18 @@ static hal_valgo_status_t HAL_VisionAlgoDev_TFLite_Deinit(vision_algo_dev_t *dev
 
     tflite_model_param_t *tflite_model_param = (tflite_model_param_t *)dev->priv_data;
 
-    MODEL_DeInit();
-
-    int i;
-    for(i = 0; i < tflite_model_param->user_params.inference_params.num_outputs; i++)
+    MODEL_DeInit(tflite_model_param->model);
+    for (int i = 0; i < MPP_INFERENCE_MAX_INPUTS; i++)
     {
-        if(tflite_model_param->out_param.out_tensors[i] != NULL)
-        {
-            hal_free(tflite_model_param->out_param.out_tensors[i]);
-            tflite_model_param->out_param.out_tensors[i] = NULL;
-        }
+        if (tflite_model_param->stage[i] != NULL)
+            hal_free_placed(tflite_model_param->stage[i]);
     }
 
+    if (tflite_model_param->out_tensors != NULL)
+        hal_free(tflite_model_param->out_tensors);
+    if (tflite_model_param->out_param.out_tensors != NULL)
+        hal_free(tflite_model_param->out_param.out_tensors);
+
     if (dev->priv_data != NULL) {
         hal_free(dev->priv_data);
         dev->priv_data = NULL;
@@ -225,19 +282,33 @@ static hal_valgo_status_t HAL_VisionAlgoDev_TFLite_Run(const vision_algo_dev_t *
 
     tflite_model_param = (tflite_model_param_t *)dev->priv_data;
 
-    // TODO replace by a generic model->ConvertInput() call
-    MODEL_ConvertInput((uint8_t *) tflite_model_param->input_tensor.data,
-            &(tflite_model_param->input_tensor.dims),
-            tflite_model_param->input_tensor.type,  /* use type returned by model interpreter */
-            tflite_model_param->user_params.model_input_mean,
-            tflite_model_param->user_params.model_input_std);
+    /* normalize and quantize each image with its model input quantization */
+    for (int i = 0; i < tflite_model_param->num_inputs; i++)
+    {
+        mpp_inference_tensor_params_t *input = &tflite_model_param->input_tensor[i];
+        hal_tensor_norm_t norm;
+
+        hal_tensor_norm_init(&norm, tflite_model_param->user_params.model_input_mean,
+                tflite_model_param->user_params.model_input_std,
+                tflite_model_param->user_params.model_input_ch_mean,
+                tflite_model_param->user_params.model_input_ch_std);
+        norm.scale = input->scale;
+        norm.zero_point = input->zero_point;
+        hal_tensor_from_u8((void *)input->data,
+                (tflite_model_param->stage[i] != NULL) ? tflite_input_stage(tflite_model_param, i) : input->data,
+                get_model_input_width(tflite_model_param, i),
+                get_model_input_height(tflite_model_param, i),
+                get_model_input_channels(tflite_model_param, i),
+                input->type,  /* use type returned by model interpreter */
+                tflite_model_param->user_params.tensor_order, &norm);
+    }
 
-    int startTime = hal_get_exec_time();
-    if (kStatus_Success != MODEL_RunInference()) {
+    uint32_t startTime = hal_get_time_us();
+    if (kStatus_Success != MODEL_RunInference(tflite_model_param->model)) {
         HAL_LOGE("ERROR: MODEL_RunInference() failed\n");
         return kStatus_HAL_ValgoError;
     }
-    tflite_model_param->out_param.inference_time_ms = hal_get_exec_time() - startTime;
+    tflite_model_param->out_param.inference_time_ms = (hal_get_time_us() - startTime) / 1000;
     tflite_model_param->out_param.inference_type = MPP_INFERENCE_TYPE_TFLITE;
 
     tflite_model_param->user_params.evt_callback_f(
@@ -250,10 +321,23 @@ static hal_valgo_status_t HAL_VisionAlgoDev_TFLite_Run(const vision_algo_dev_t *
     return ret;
 }
 
+/* the pipeline writes an interleaved 8-bit image, converted to the tensor layout and type by run() */
+static void tflite_input_buf_desc(tflite_model_param_t *tflite_model_param, int idx, hw_buf_desc_t *in_buf)
+{
+    in_buf->alignment = HAL_TFLITE_BUFFER_ALIGN;
+    in_buf->nb_lines = get_model_input_height(tflite_model_param, idx);
+    in_buf->cacheable = true;
+    in_buf->placement = MPP_MEM_PLACE_FAST;  /* small and read by every operator of the first layer */
+    in_buf->stride = get_model_input_width(tflite_model_param, idx) * get_model_input_channels(tflite_model_param, idx);
+    if (tflite_model_param->stage[idx] != NULL)
+        in_buf->addr = tflite_input_stage(tflite_model_param, idx);
+    else
+        in_buf->addr = (unsigned char *)tflite_model_param->input_tensor[idx].data;
+}
+
 static hal_valgo_status_t HAL_VisionAlgoDev_TFLite_getBufDesc(const vision_algo_dev_t *dev, hw_buf_desc_t *in_buf, mpp_memory_policy_t *policy)
 {
     hal_valgo_status_t ret = kStatus_HAL_ValgoSuccess;
-    tflite_model_param_t *tflite_model_param;
     HAL_LOGD("++HAL_VisionAlgoDev_TFLite_getInput\n");
 
     if ((in_buf == NULL) || (policy == NULL))
@@ -264,26 +348,32 @@ static hal_valgo_status_t HAL_VisionAlgoDev_TFLite_getBufDesc(const vision_algo_
     /* TFlite allocates tensor arena */
     *policy = HAL_MEM_ALLOC_BOTH;
 
-    tflite_model_param = (tflite_model_param_t *)dev->priv_data;
-    /*
-     * TODO: add support for other TFlite models with different component order.
-     * For now, this is only assuming NHWC order.
-     */
-    in_buf->alignment = HAL_TFLITE_BUFFER_ALIGN;
-    in_buf->nb_lines = tflite_model_param->input_tensor.dims.data[1]; /* number of lines required is the input height */
-    in_buf->cacheable = true;
-    in_buf->stride = tflite_model_param->input_tensor.dims.data[2] * tflite_model_param->input_tensor.dims.data[3]; /* width * channels */
-    in_buf->addr = (unsigned char *)tflite_model_param->input_tensor.data;
+    tflite_input_buf_desc((tflite_model_param_t *)dev->priv_data, 0, in_buf);
 
     HAL_LOGD("--HAL_VisionAlgoDev_TFLite_getInput\n");
     return ret;
 }
 
+/* the other model inputs are written in place as well, no copy between the ports and the tensors */
+static hal_valgo_status_t HAL_VisionAlgoDev_TFLite_getInputBufDesc(const vision_algo_dev_t *dev, int idx, hw_buf_desc_t *in_buf)
+{
+    tflite_model_param_t *tflite_model_param = (tflite_model_param_t *)dev->priv_data;
+
+    if ((in_buf == NULL) || (idx < 0) || (idx >= tflite_model_param->num_inputs))
+    {
+        HAL_LOGE("Invalid model input %d\n", idx);
+        return kStatus_HAL_ValgoError;
+    }
+    tflite_input_buf_desc(tflite_model_param, idx, in_buf);
+    return kStatus_HAL_ValgoSuccess;
+}
+
 const static vision_algo_dev_operator_t s_VisionAlgoDev_TFLiteOps = {
     .init        = HAL_VisionAlgoDev_TFLite_Init,
     .deinit      = HAL_VisionAlgoDev_TFLite_Deinit,
     .run         = HAL_VisionAlgoDev_TFLite_Run,
     .get_buf_desc   = HAL_VisionAlgoDev_TFLite_getBufDesc,
+    .get_input_buf_desc = HAL_VisionAlgoDev_TFLite_getInputBufDesc,
 };
 
 int hal_inference_tflite_setup(vision_algo_dev_t *dev)
@@ -65,6 +65,55 @@ int hal_label_rectangle(uint8_t *frame, int width, int height, mpp_pixel_format_
  */
 int hal_inference_tflite_setup(vision_algo_dev_t *dev);
 
+/*!
+ * @brief Hal setup function for Glow ahead-of-time compiled bundles
+ *
+ * @param[in] dev vision algo device to register
+ * @return error code (0: success, otherwise: failure)
+ *
+ */
+int hal_inference_glow_setup(vision_algo_dev_t *dev);
+
+/*!
+ * @brief Hal setup function for the reference C inference backend
+ *
+ * @param[in] dev vision algo device to register
+ * @return error code (0: success, otherwise: failure)
+ *
+ */
+int hal_inference_ref_setup(vision_algo_dev_t *dev);
+
+/*!
+ * @brief Register an inference backend.
+ *        The built-in backends are registered on first use of the registry.
+ *
+ * @param[in] backend backend descriptor, must remain valid
+ * @return error code (0: success, otherwise: failure)
+ *
+ */
+int hal_valgo_register(const hal_valgo_backend_t *backend);
+
+/*!
+ * @brief Setup a vision algo device with a registered backend.
+ *        The backend is selected by name if not NULL, otherwise by type.
+ *
+ * @param[in] dev vision algo device to setup
+ * @param[in] type model format
+ * @param[in] name backend name (NULL: first backend registered for the type)
+ * @param[out] caps capabilities of the selected backend (may be NULL)
+ * @return error code (0: success, otherwise: failure)
+ *
+ */
+int hal_valgo_setup(vision_algo_dev_t *dev, mpp_inference_type_t type, const char *name, const hal_valgo_caps_t **caps);
+
+/*!
+ * @brief Release the backend of a vision algo device, after its deinit.
+ *
+ * @param[in] dev vision algo device
+ *
+ */
+void hal_valgo_release(vision_algo_dev_t *dev);
+
 /*!
  * @brief Register with a display device specified by name.
  *        If name is NULL, return error.
@@ -101,6 +150,48 @@ int hal_camera_setup(const char *name, camera_dev_t *dev);
  */
 int hal_gfx_setup(const char *name, gfx_dev_t *dev);
 
+/*!
+ * @brief Write back the dirty data cache lines of a memory range.
+ *
+ * @param[in] addr range start address
+ * @param[in] size range size in bytes
+ */
+void HAL_DCACHE_CleanByRange(uint32_t addr, uint32_t size);
+
+/*!
+ * @brief Discard the data cache lines of a memory range, dirty data are lost.
+ *
+ * @param[in] addr range start address
+ * @param[in] size range size in bytes
+ */
+void HAL_DCACHE_InvalidateByRange(uint32_t addr, uint32_t size);
+
+/*!
+ * @brief Write back then discard the data cache lines of a memory range.
+ *
+ * @param[in] addr range start address
+ * @param[in] size range size in bytes
+ */
+void HAL_DCACHE_CleanInvalidateByRange(uint32_t addr, uint32_t size);
+
+#if defined(EMULATOR) && defined(HAL_CACHE_SIM)
+/*!
+ * @brief Report a buffer access to the data cache simulator (emulator builds with HAL_CACHE_SIM).
+ *        Accesses that would read stale data or lose data are logged and counted.
+ *
+ * @param[in] addr range start address
+ * @param[in] size range size in bytes
+ * @param[in] dev true for a DMA master access, false for a CPU access
+ * @param[in] write true for a write access
+ */
+void HAL_CACHE_SIM_Access(uint32_t addr, uint32_t size, bool dev, bool write);
+
+/*!
+ * @brief Number of cache coherency errors detected by the simulator.
+ */
+unsigned int HAL_CACHE_SIM_Errors(void);
+#endif
+
 /** @} */
 
 #endif /* _HAL_H */
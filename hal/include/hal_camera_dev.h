@@ -86,6 +86,7 @@ typedef struct _camera_dev_operator
     hal_camera_status_t (*enqueue)(const camera_dev_t *dev, void *data); /*!< enqueue a buffer to the dev */
     hal_camera_status_t (*dequeue)(const camera_dev_t *dev, void **data, int *stripe); /*!< dequeue a buffer from the dev (blocking) */
     hal_camera_status_t (*get_buf_desc)(const camera_dev_t *dev, hw_buf_desc_t *out_buf, mpp_memory_policy_t *policy); /*!< get buffer descriptors and policy */
+    hal_camera_status_t (*get_timestamp)(const camera_dev_t *dev, uint32_t *ts_us); /*!< capture time (hal_get_time_us() clock) of the last dequeued frame, optional */
 } camera_dev_operator_t;
 
 /** @} */
@@ -23,6 +23,8 @@
 #ifndef _HAL_DEBUG_H
 #define _HAL_DEBUG_H
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -41,6 +43,8 @@ extern "C" {
 extern void LOGE(const char* module, const char* func, int line, const char* format, ...);
 extern void LOGI(const char* module, const char* func, int line, const char* format, ...);
 extern void LOGD(const char* module, const char* func, int line, const char* format, ...);
+/* print a log recorded earlier at 'tick' (deferred logs), not filtered */
+extern void LOG_AT(const char* module, const char* func, int line, int level, uint32_t tick, const char* format, ...);
 
 #define HAL_LOGE(format, ...) \
     LOGE("HAL", __func__, __LINE__, format, ##__VA_ARGS__)
@@ -66,6 +66,18 @@ typedef struct _gfx_rotate_config
     mpp_rotate_degree_t degree;
 } gfx_rotate_config_t;
 
+/** gfx crop and resize region */
+typedef struct _gfx_crop
+{
+    int left;                  /*!< left position of the region in the source surface */
+    int top;                   /*!< top position of the region in the source surface */
+    int right;                 /*!< right position of the region in the source surface */
+    int bottom;                /*!< bottom position of the region in the source surface */
+    const gfx_surface_t *dst;  /*!< destination surface, the region is resized into its window */
+    bool letterbox;            /*!< keep the region aspect ratio and pad the remaining bands */
+    uint8_t pad_value;         /*!< value written to each color channel of the padding bands */
+} gfx_crop_t;
+
 typedef struct _gfx_dev gfx_dev_t;
 
 /** @} */
@@ -109,6 +121,8 @@ typedef struct
                    gfx_surface_t *pDst,
                    gfx_rotate_config_t *pRotate,
                    mpp_flip_mode_t flip);
+    /* crop several regions of the source surface and resize each into its destination surface */
+    int (*crop_and_resize)(const gfx_dev_t *dev, const gfx_surface_t *pSrc, const gfx_crop_t *crops, int nb_crops);
 } gfx_dev_operator_t;
 
 
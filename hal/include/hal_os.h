@@ -25,6 +25,11 @@
 
 #include "stdbool.h"
 #include "stdint.h"
+#include "mpp_api_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 typedef void * hal_sema_t;                  /*!< semaphore handle */
 typedef void * hal_mutex_t;                 /*!< mutex handle */
@@ -53,12 +58,28 @@ void *hal_malloc(uint32_t size);
 /*! @brief free memory from heap */
 void hal_free(void *pointer);
 
+/*! @brief maximum number of memory regions */
+#define HAL_MEM_REGION_MAX 4
+
+/*! @brief add a memory region to the placement allocator */
+int hal_mem_region_add(const mpp_memory_region_t *region);
+
+/*! @brief allocate memory according to a placement hint, falls back to the heap.
+ * 'placed' returns the region used, NULL for the heap (may be NULL). */
+void *hal_malloc_placed(uint32_t size, mpp_memory_placement_t hint, const mpp_memory_region_t **placed);
+
+/*! @brief free memory allocated by hal_malloc_placed() */
+void hal_free_placed(void *pointer);
+
 /*! @brief create semaphore */
 hal_sema_t hal_sema_create();
 
 /*! @brief create binary semaphore */
 hal_sema_t hal_sema_create_binary();
 
+/*! @brief delete semaphore */
+void hal_sema_delete(hal_sema_t handle);
+
 /*! @brief give semaphore */
 bool hal_sema_give(hal_sema_t handle);
 
@@ -88,6 +109,12 @@ void hal_task_suspend(hal_task_t task);
 /*! @brief resume task */
 void hal_task_resume(hal_task_t task);
 
+/*! @brief get the running task */
+hal_task_t hal_task_current();
+
+/*! @brief get the name of a task */
+const char *hal_task_name(hal_task_t task);
+
 /*! @brief delay task */
 void hal_task_delay(uint32_t ticks);
 
@@ -120,6 +147,10 @@ uint32_t hal_tick_to_ms(uint32_t os_tick);
 /*! @brief Provides the exec time in ms of current task */
 uint32_t hal_get_exec_time();
 
+/*! @brief Provides a monotonic time in microseconds, wraps around after ~71 minutes.
+ *  Uses the cycle counter when available, reading it is O(1). */
+uint32_t hal_get_time_us();
+
 /*! @brief start suspending task switching */
 void hal_atomic_enter();
 
@@ -132,4 +163,8 @@ int hal_get_max_syscall_prio();
 /*! @brief get os max priority */
 int hal_get_os_max_prio();
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* _HAL_OS_H */
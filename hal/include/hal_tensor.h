@@ -0,0 +1,91 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * HAL model input tensor conversion
+ */
+
+#ifndef _HAL_TENSOR_H
+#define _HAL_TENSOR_H
+
+#include <stdint.h>
+#include "mpp_api_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \addtogroup HAL_TYPES
+*  @{
+*/
+
+/** @brief normalization and quantization of an 8-bit image into a model input tensor:
+ * value = (pixel - mean[c]) / std[c], stored as value / scale + zero_point for integer tensors */
+typedef struct
+{
+    float mean[MPP_INFERENCE_MAX_CHANNELS];   /*!< per-channel mean */
+    float std[MPP_INFERENCE_MAX_CHANNELS];    /*!< per-channel standard deviation (0 is taken as 1) */
+    float scale;                /*!< quantization scale of integer tensors (0: not quantized) */
+    int32_t zero_point;         /*!< quantization zero point */
+} hal_tensor_norm_t;
+
+/** @} */
+
+/*! \addtogroup HAL_OPERATIONS
+*  @{
+*/
+
+/*!
+ * @brief fill the normalization from scalar or per-channel parameters
+ *
+ * @param[out] norm normalization to fill, quantization is reset
+ * @param[in] mean scalar mean
+ * @param[in] std scalar standard deviation
+ * @param[in] ch_mean per-channel mean, used instead of the scalars when ch_std[0] is not 0 (may be NULL)
+ * @param[in] ch_std per-channel standard deviation (may be NULL)
+ */
+void hal_tensor_norm_init(hal_tensor_norm_t *norm, float mean, float std, const float *ch_mean, const float *ch_std);
+
+/*!
+ * @brief convert an interleaved 8-bit image into a model input tensor
+ *
+ * The source is interleaved (HWC). The destination is written in 'order' layout and 'type' format.
+ * NHWC destinations may start at the source address (in-place conversion, the tensor being at least
+ * as large as the image), NCHW destinations must not overlap the source.
+ * UINT8 tensors are copied (NCHW) or left unchanged (NHWC).
+ *
+ * @param[out] dst tensor data
+ * @param[in] src image, width * height * channels bytes
+ * @param[in] width image width
+ * @param[in] height image height
+ * @param[in] channels number of channels, up to MPP_INFERENCE_MAX_CHANNELS
+ * @param[in] type tensor type
+ * @param[in] order tensor order
+ * @param[in] norm normalization and quantization
+ * @return 0 on success, -1 on unsupported parameters
+ */
+int hal_tensor_from_u8(void *dst, const uint8_t *src, int width, int height, int channels,
+                       mpp_tensor_type_t type, mpp_tensor_order_t order, const hal_tensor_norm_t *norm);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HAL_TENSOR_H */
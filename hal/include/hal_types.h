@@ -54,6 +54,7 @@ typedef struct {
     bool cacheable;         /*!< if true, HW will require cache maintenance */
     unsigned char *addr;    /*!< the aligned buffer address */
     unsigned char *heap_p;  /*!< pointer to the heap that should be freed */
+    mpp_memory_placement_t placement;   /*!< placement hint when the pipeline allocates the buffer */
 } hw_buf_desc_t;
 
 /** maximum length of device name */
@@ -38,11 +38,21 @@ typedef struct _model_param_t {
     int model_size;                          /*!< model binary size */
     float model_input_mean;                  /*!< model 'mean' of input values, used for normalization */
     float model_input_std;                   /*!< model 'standard deviation' of input values, used for normalization */
+    float model_input_ch_mean[MPP_INFERENCE_MAX_CHANNELS]; /*!< per-channel 'mean', used when model_input_ch_std[0] is not 0 */
+    float model_input_ch_std[MPP_INFERENCE_MAX_CHANNELS];  /*!< per-channel 'standard deviation' */
     mpp_inference_params_t inference_params; /*!< inference parameters */
     int height;                              /*!< frame height */
     int width;                               /*!< frame width  */
     mpp_pixel_format_t format;               /*!< pixel format */
+    int num_frames;                          /*!< number of input frames (input ports), frame i feeds model input i */
+    struct {
+        int height;                          /*!< frame height */
+        int width;                           /*!< frame width */
+        mpp_pixel_format_t format;           /*!< pixel format */
+    } frames[MPP_INFERENCE_MAX_INPUTS];      /*!< input frames, frame 0 is also described by height/width/format */
     mpp_tensor_type_t inputType;             /*!< input type */
+    uint32_t input_types;                    /*!< set by init(): model inputs types, bit (1 << mpp_tensor_type_t) (0: not reported) */
+    bool outputs_unsized;                    /*!< set by init(): some output dimensions are unknown, outputs cannot be copied */
     mpp_tensor_order_t tensor_order;         /*!< tensor order */
     int (*evt_callback_f)(mpp_t mpp, mpp_evt_t evt, void *evt_data, void *user_data); /*!< the callback to be called when model output is ready */
     void *cb_userdata;                       /*!< pointer to user data, should be passed by callback */
@@ -91,6 +101,7 @@ typedef struct
     hal_valgo_status_t (*deinit)(vision_algo_dev_t *dev);                /*!< deinitialize the dev */
     hal_valgo_status_t (*run)(const vision_algo_dev_t *dev, void *data); /*!< start the dev */
     hal_valgo_status_t (*get_buf_desc)(const vision_algo_dev_t *dev, hw_buf_desc_t *in_buf, mpp_memory_policy_t *policy); /*!< read input parameters */
+    hal_valgo_status_t (*get_input_buf_desc)(const vision_algo_dev_t *dev, int idx, hw_buf_desc_t *in_buf); /*!< read parameters of input 'idx' (NULL: single input) */
 
 } vision_algo_dev_operator_t;
 
@@ -110,6 +121,25 @@ struct _vision_algo_dev
     vision_algo_private_data_t priv_data;  /*!< private data */
 };
 
+/** @brief Capabilities of an inference backend */
+typedef struct
+{
+    const char *name;               /*!< backend name, unique */
+    mpp_inference_type_t type;      /*!< model format run by the backend */
+    uint32_t tensor_types;          /*!< supported input tensor types, bit (1 << mpp_tensor_type_t) */
+    uint32_t tensor_orders;         /*!< supported input tensor orders, bit (1 << mpp_tensor_order_t) */
+    int max_inputs;                 /*!< maximum number of model inputs, each one read from an input port */
+    bool multi_instance;            /*!< several models may run at the same time */
+    bool async;                     /*!< run() returns before the outputs are ready, they are delivered by the callback */
+} hal_valgo_caps_t;
+
+/** @brief Inference backend registered in the vision algo registry */
+typedef struct
+{
+    hal_valgo_caps_t caps;                      /*!< capabilities */
+    int (*setup)(vision_algo_dev_t *dev);       /*!< sets the device operations, returns 0 on success */
+} hal_valgo_backend_t;
+
 /** @} */
 
 #endif /*_HAL_VALGO_DEV_H_*/
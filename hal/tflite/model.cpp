@@ -26,25 +26,26 @@ limitations under the License.
 #include <stdio.h>
 #include "hal_valgo_dev.h"
 #include "tensorflow/lite/micro/kernels/micro_ops.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
 #include "tensorflow/lite/micro/micro_op_resolver.h"
 #include "tensorflow/lite/schema/schema_generated.h"
 
 #include "model.h"
 
-/* trick to replace 'float division' with 'multiply by integer and bitshift'
-   integer is the inverse multiplied by factor to keep precision */
-#define FAST_DIV_BITS 16
-#define FAST_DIV_FACTOR (1 << FAST_DIV_BITS)
-
-/* TODO replace by dynamic object construction to allow multiple instances to run concurrently */
-static const tflite::Model* s_model = nullptr;
-static tflite::MicroInterpreter* s_interpreter = nullptr;
+/* model instance: each instance gets its own part of the tensor arena */
+typedef struct {
+    const tflite::Model* model;
+    tflite::MicroInterpreter* interpreter;
+    size_t arena_offset;
+    size_t arena_size;
+    size_t fast_offset;     /* part of the fast arena, fast_size is 0 if the model uses one arena */
+    size_t fast_size;
+} model_instance_t;
 
 extern tflite::MicroOpResolver &MODEL_GetOpsResolver();
 
-uint8_t* MODEL_GetInputTensorData(tflite::MicroInterpreter* interpreter, mpp_tensor_dims_t* dims, mpp_tensor_type_t* type);
-uint8_t* MODEL_GetOutputTensorData(tflite::MicroInterpreter* interpreter, mpp_tensor_dims_t* dims, mpp_tensor_type_t* type, int idx);
+uint8_t* GetTensorData(TfLiteTensor* tensor, mpp_tensor_dims_t* dims, mpp_tensor_type_t* type);
 
 // An area of memory to use for input, output, and intermediate arrays.
 // (Can be adjusted based on the model needs.)
@@ -57,19 +58,127 @@ static uint8_t s_tensorArena[kTensorArenaSize] __ALIGNED(HAL_TFLITE_BUFFER_ALIGN
 static uint8_t s_tensorArena[kTensorArenaSize] __ALIGNED(HAL_TFLITE_BUFFER_ALIGN);
 #endif
 
-status_t MODEL_Init(const void *model_data,
-        mpp_inference_tensor_params_t *inputTensor,
-        mpp_inference_tensor_params_t *outputTensor[],
-        int nb_out_tensor)
+/* tensor arena is partitioned between the instances */
+static size_t s_arenaUsed = 0;
+static int s_instances = 0;
+
+/* Tiered arena: the non-persistent part of the arena (activations and kernel
+ * scratch buffers, read and written by every layer at each inference) goes to
+ * a small fast arena taken from a FAST memory region, the persistent part
+ * (tensor descriptors, quantization and operator data, accessed once per layer)
+ * stays in s_tensorArena. Models whose activations do not fit use s_tensorArena only. */
+constexpr int kFastArenaSize = HAL_TFLM_FAST_ARENA_SIZE_KB * 1024;
+static uint8_t *s_fastArena = NULL;
+static uint8_t *s_fastArenaHeap = NULL;
+static size_t s_fastUsed = 0;
+
+static inline size_t arena_align(size_t size)
+{
+    return (size + HAL_TFLITE_BUFFER_ALIGN - 1) & ~((size_t)HAL_TFLITE_BUFFER_ALIGN - 1);
+}
+
+/* take the fast arena from a registered region, the heap would bring nothing */
+static void fast_arena_get(void)
+{
+    const mpp_memory_region_t *region = NULL;
+
+    if ((kFastArenaSize == 0) || (s_fastArena != NULL))
+        return;
+    s_fastArenaHeap = (uint8_t *)hal_malloc_placed(kFastArenaSize + HAL_TFLITE_BUFFER_ALIGN, MPP_MEM_PLACE_FAST, &region);
+    if ((s_fastArenaHeap != NULL) && (region == NULL))
+    {
+        hal_free_placed(s_fastArenaHeap);
+        s_fastArenaHeap = NULL;
+    }
+    if (s_fastArenaHeap == NULL)
+    {
+        HAL_LOGI("No fast memory region for the %d bytes fast tensor arena", kFastArenaSize);
+        return;
+    }
+    s_fastArena = (uint8_t *)arena_align((size_t)s_fastArenaHeap);
+    s_fastUsed = 0;
+    HAL_LOGI("Fast tensor arena in %s", region->name);
+}
+
+static void fast_arena_put(void)
+{
+    if (s_fastArenaHeap != NULL)
+        hal_free_placed(s_fastArenaHeap);
+    s_fastArenaHeap = NULL;
+    s_fastArena = NULL;
+    s_fastUsed = 0;
+}
+
+/* build an interpreter on the instance part of the arena(s) */
+static tflite::MicroInterpreter *model_interpreter(model_instance_t *inst, const tflite::MicroOpResolver &resolver,
+        size_t arena_size, size_t fast_size, tflite::MicroAllocator **allocator)
+{
+    *allocator = nullptr;
+    if (fast_size == 0)
+        return new tflite::MicroInterpreter(inst->model, resolver, s_tensorArena + inst->arena_offset, arena_size);
+
+    *allocator = tflite::MicroAllocator::Create(s_tensorArena + inst->arena_offset, arena_size,
+            s_fastArena + inst->fast_offset, fast_size);
+    if (*allocator == nullptr)
+        return nullptr;
+    return new tflite::MicroInterpreter(inst->model, resolver, *allocator);
+}
+
+/* size both parts of a tiered instance, 'false' if the activations do not fit the fast arena */
+static bool model_size_tiered(model_instance_t *inst, const tflite::MicroOpResolver &resolver)
+{
+    tflite::MicroAllocator *allocator;
+    tflite::MicroInterpreter *interpreter;
+    size_t arena_left = kTensorArenaSize - inst->arena_offset;
+    size_t fast_left = kFastArenaSize - inst->fast_offset;
+    size_t used, persistent;
+    uint8_t *tail;
+
+    if ((s_fastArena == NULL) || (fast_left < HAL_TFLITE_BUFFER_ALIGN))
+        return false;
+
+    interpreter = model_interpreter(inst, resolver, arena_left, fast_left, &allocator);
+    if (interpreter == nullptr)
+        return false;
+    if (interpreter->AllocateTensors() != kTfLiteOk)
+    {
+        delete interpreter;
+        return false;
+    }
+    /* persistent buffers are allocated from the end of their arena:
+     * a probe allocation gives the persistent part size */
+    used = interpreter->arena_used_bytes();
+    tail = (uint8_t *)allocator->AllocatePersistentBuffer(1);
+    delete interpreter;
+    if (tail == nullptr)
+        return false;
+    persistent = s_tensorArena + kTensorArenaSize - tail;
+    if (persistent > used)
+        persistent = used;
+
+    inst->arena_size = arena_align(persistent) + HAL_TFLITE_BUFFER_ALIGN;
+    inst->fast_size = arena_align(used - persistent) + HAL_TFLITE_BUFFER_ALIGN;
+    if (inst->arena_offset + inst->arena_size > kTensorArenaSize)
+        inst->arena_size = arena_left;
+    if (inst->fast_offset + inst->fast_size > kFastArenaSize)
+        inst->fast_size = fast_left;
+    return true;
+}
+
+status_t MODEL_Init(const void *model_data, void **handle)
 {
+    model_instance_t *inst;
+    tflite::MicroAllocator *allocator;
+    size_t used;
+
     // Map the model into a usable data structure. This doesn't involve any
     // copying or parsing, it's a very lightweight operation.
-    s_model = tflite::GetModel(model_data);
-    if (s_model->version() != TFLITE_SCHEMA_VERSION)
+    const tflite::Model* model = tflite::GetModel(model_data);
+    if (model->version() != TFLITE_SCHEMA_VERSION)
     {
         HAL_LOGE("Model provided is schema version %d not equal "
                "to supported version %d.",
-               s_model->version(), TFLITE_SCHEMA_VERSION);
+               model->version(), TFLITE_SCHEMA_VERSION);
         return kStatus_Fail;
     }
 
@@ -78,39 +187,95 @@ status_t MODEL_Init(const void *model_data,
     // NOLINTNEXTLINE(runtime-global-variables)
     static tflite::MicroOpResolver &s_micro_op_resolver = MODEL_GetOpsResolver();
 
+    inst = new model_instance_t;
+    inst->model = model;
+    inst->arena_offset = s_arenaUsed;
+    inst->fast_offset = s_fastUsed;
+    inst->fast_size = 0;
+
+    fast_arena_get();
+    if (!model_size_tiered(inst, s_micro_op_resolver))
+    {
+        if (s_fastArena != NULL)
+            HAL_LOGI("Activations do not fit the fast tensor arena, using the tensor arena only");
+        inst->fast_size = 0;
+
+        // Size the instance arena: allocate the tensors in the remaining arena,
+        // then build the interpreter again in the exact size used. Persistent
+        // buffers are allocated from the end of the arena given to the interpreter.
+        inst->interpreter = new tflite::MicroInterpreter(
+                model, s_micro_op_resolver, s_tensorArena + inst->arena_offset, kTensorArenaSize - inst->arena_offset);
+        if (inst->interpreter->AllocateTensors() != kTfLiteOk)
+        {
+            HAL_LOGE("AllocateTensors() failed, %d bytes of tensor arena left",
+                     (int)(kTensorArenaSize - inst->arena_offset));
+            delete inst->interpreter;
+            delete inst;
+            if (s_instances == 0)
+                fast_arena_put();
+            return kStatus_Fail;
+        }
+        used = inst->interpreter->arena_used_bytes();
+        delete inst->interpreter;
+
+        inst->arena_size = arena_align(used) + HAL_TFLITE_BUFFER_ALIGN;
+        if (inst->arena_offset + inst->arena_size > kTensorArenaSize)
+            inst->arena_size = kTensorArenaSize - inst->arena_offset;
+    }
+
     // Build an interpreter to run the model with.
-    s_interpreter = new tflite::MicroInterpreter(
-            s_model, s_micro_op_resolver, s_tensorArena, kTensorArenaSize);
+    inst->interpreter = model_interpreter(inst, s_micro_op_resolver, inst->arena_size, inst->fast_size, &allocator);
 
     // Allocate memory from the tensor_arena for the model's tensors.
-    TfLiteStatus allocate_status = s_interpreter->AllocateTensors();
-    if (allocate_status != kTfLiteOk)
+    if ((inst->interpreter == nullptr) || (inst->interpreter->AllocateTensors() != kTfLiteOk))
     {
     	HAL_LOGE("AllocateTensors() failed");
+        delete inst->interpreter;
+        delete inst;
+        if (s_instances == 0)
+            fast_arena_put();
         return kStatus_Fail;
     }
+    s_arenaUsed = inst->arena_offset + inst->arena_size;
+    s_fastUsed = inst->fast_offset + inst->fast_size;
+    s_instances++;
+    HAL_LOGI("Model uses %d bytes of tensor arena, %d bytes left",
+             (int)inst->arena_size, (int)(kTensorArenaSize - s_arenaUsed));
+    if (inst->fast_size != 0)
+        HAL_LOGI("Model uses %d bytes of fast tensor arena, %d bytes left",
+                 (int)inst->fast_size, (int)(kFastArenaSize - s_fastUsed));
+
+    *handle = inst;
+    return kStatus_Success;
+}
+
+status_t MODEL_DeInit(void *handle)
+{
+    model_instance_t *inst = (model_instance_t *)handle;
 
-    inputTensor->data = MODEL_GetInputTensorData(s_interpreter, &inputTensor->dims, &inputTensor->type);
+    inst->interpreter->Reset();
+    delete inst->interpreter;
 
-    for(int i = 0; i < nb_out_tensor; i++)
+    /* the arena space is reclaimed when it is at the end of the used part */
+    if (inst->arena_offset + inst->arena_size == s_arenaUsed)
+        s_arenaUsed = inst->arena_offset;
+    if ((inst->fast_size != 0) && (inst->fast_offset + inst->fast_size == s_fastUsed))
+        s_fastUsed = inst->fast_offset;
+    if (--s_instances == 0)
     {
-        outputTensor[i]->data = MODEL_GetOutputTensorData(s_interpreter, &outputTensor[i]->dims, &outputTensor[i]->type, i);
+        s_arenaUsed = 0;
+        fast_arena_put();
     }
+    delete inst;
 
     return kStatus_Success;
 }
 
-status_t MODEL_DeInit(void)
+status_t MODEL_RunInference(void *handle)
 {
-    s_interpreter->Reset();
-    delete s_interpreter;
-
-    return kStatus_Success;
-}
+    model_instance_t *inst = (model_instance_t *)handle;
 
-status_t MODEL_RunInference(void)
-{
-    if (s_interpreter->Invoke() != kTfLiteOk)
+    if (inst->interpreter->Invoke() != kTfLiteOk)
     {
         HAL_LOGE("Invoke failed!\r\n");
         return kStatus_Fail;
@@ -132,6 +297,9 @@ uint8_t* GetTensorData(TfLiteTensor* tensor, mpp_tensor_dims_t* dims, mpp_tensor
         case kTfLiteInt8:
             *type = MPP_TENSOR_TYPE_INT8;
             break;
+        case kTfLiteInt16:
+            *type = MPP_TENSOR_TYPE_INT16;
+            break;
         default:
             assert("Unknown input tensor data type");
     };
@@ -146,85 +314,42 @@ uint8_t* GetTensorData(TfLiteTensor* tensor, mpp_tensor_dims_t* dims, mpp_tensor
     return tensor->data.uint8;
 }
 
-uint8_t* MODEL_GetInputTensorData(tflite::MicroInterpreter* interpreter, mpp_tensor_dims_t* dims, mpp_tensor_type_t* type)
+static void model_tensor(TfLiteTensor* tensor, mpp_inference_tensor_params_t *params)
 {
-	TfLiteTensor* inputTensor = interpreter->input(0);
+    params->data = GetTensorData(tensor, &params->dims, &params->type);
+    params->scale = tensor->params.scale;
+    params->zero_point = tensor->params.zero_point;
+}
 
-    return GetTensorData(inputTensor, dims, type);
+int MODEL_GetInputsCount(void *handle)
+{
+    return (int)((model_instance_t *)handle)->interpreter->inputs_size();
 }
 
-uint8_t* MODEL_GetOutputTensorData(tflite::MicroInterpreter* interpreter, mpp_tensor_dims_t* dims, mpp_tensor_type_t* type, int idx)
+int MODEL_GetOutputsCount(void *handle)
 {
-    /* handles multiple outputs */
-    TfLiteTensor* outputTensor = interpreter->output(idx);
+    return (int)((model_instance_t *)handle)->interpreter->outputs_size();
+}
 
-    return GetTensorData(outputTensor, dims, type);
+status_t MODEL_GetInputTensor(void *handle, int idx, mpp_inference_tensor_params_t *tensor)
+{
+    model_instance_t *inst = (model_instance_t *)handle;
+
+    if ((idx < 0) || (idx >= MODEL_GetInputsCount(handle)))
+        return kStatus_InvalidArgument;
+    model_tensor(inst->interpreter->input(idx), tensor);
+    return kStatus_Success;
 }
 
-// Convert and normalize unsigned 8-bit image data to model input format in-place.
-void MODEL_ConvertInput(uint8_t* data, mpp_tensor_dims_t* dims, mpp_tensor_type_t type, int mean, int std)
+status_t MODEL_GetOutputTensor(void *handle, int idx, mpp_inference_tensor_params_t *tensor)
 {
-    int size = dims->data[2] * dims->data[1] * dims->data[3];
-    /* Quantization parameters:
-     * input_scale : model input scale.
-     * input_zero_point: model input zero point.
-     */
-    float input_scale = s_interpreter->input(0)->params.scale;
-    float input_zero_point = s_interpreter->input(0)->params.zero_point;
-    int inv_scale = 0;
-    int i_zero_point = input_zero_point;
-    switch (type)
-    {
-        case MPP_TENSOR_TYPE_UINT8:
-            break;
-        case MPP_TENSOR_TYPE_INT8:
-             /* to calculate quantized value:
-             * quantized_value = real_value / scale + zero_point
-             * to normalize the input data:
-             * normalized_value = (real_value - mean) / std
-             *
-             * these two formulas can be combined to perform both normalization and
-             * quantization in the same time:
-             * final_value = (real_value - mean) / (scale * std) + zero_point
-             */
-
-            /* check if normalization is needed. */
-            if ((mean != 0) || (std != 1))
-            {
-                if (std != 0)
-                {
-                    inv_scale = FAST_DIV_FACTOR / (input_scale * std);
-                    for (int i = size - 1; i >= 0; i--)
-                    {
-                        /* optimized form of: ((data[i] - i_mean) / scale) + zero_point */
-                        data[i] = (int8_t) ((data[i] - mean) * inv_scale >> FAST_DIV_BITS) + i_zero_point;
-                    }
-                 }
-                else
-                {
-                    HAL_LOGE("Standard deviation should be different of 0.");
-                    break;
-                }
-            }
-            else /* only quantization should be performed */
-            {
-                inv_scale = FAST_DIV_FACTOR / input_scale;
-                for (int i = size - 1; i >= 0; i--)
-                {
-                    /* optimized form of: (data[i] / scale) + zero_point */
-                    data[i] = (int8_t) (data[i] * inv_scale >> FAST_DIV_BITS) + i_zero_point;
-        	    }
-            }
-            break;
-        case MPP_TENSOR_TYPE_FLOAT32:
-            for (int i = size - 1; i >= 0; i--)
-            {
-                reinterpret_cast<float*>(data)[i] =
-                    (static_cast<int>(data[i]) - input_zero_point) / input_scale;
-            }
-            break;
-        default:
-            assert("Unknown input tensor data type");
-    }
+    model_instance_t *inst = (model_instance_t *)handle;
+
+    /* handles multiple outputs */
+    if ((idx < 0) || (idx >= MODEL_GetOutputsCount(handle)))
+        return kStatus_InvalidArgument;
+    model_tensor(inst->interpreter->output(idx), tensor);
+    return kStatus_Success;
 }
+
 #endif /* (HAL_ENABLE_INFERENCE_TFLITE == 1) */
@@ -35,13 +35,24 @@ extern "C" {
 #define HAL_TFLITE_BUFFER_ALIGN 16
 #endif
 
-status_t MODEL_Init(const void *model_data,
-        mpp_inference_tensor_params_t *inputTensor,
-        mpp_inference_tensor_params_t *outputTensor[],
-        int nb_out_tensor);
-status_t MODEL_DeInit(void);
-void MODEL_ConvertInput(uint8_t* data, mpp_tensor_dims_t* dims, mpp_tensor_type_t type, int mean, int std);
-status_t MODEL_RunInference(void);
+/* Size of the fast tensor arena holding the activations and scratch buffers,
+ * allocated from a memory region registered with MPP_MEM_PLACE_FAST placement
+ * (see mpp_memory_region_add()). 0 keeps the whole arena in the tensor arena. */
+#ifndef HAL_TFLM_FAST_ARENA_SIZE_KB
+#define HAL_TFLM_FAST_ARENA_SIZE_KB 0
+#endif
+
+/* several models may be initialized: each one gets an instance handle
+ * and its part of the tensor arena */
+status_t MODEL_Init(const void *model_data, void **handle);
+status_t MODEL_DeInit(void *handle);
+status_t MODEL_RunInference(void *handle);
+
+/* model tensors, described after MODEL_Init() */
+int MODEL_GetInputsCount(void *handle);
+int MODEL_GetOutputsCount(void *handle);
+status_t MODEL_GetInputTensor(void *handle, int idx, mpp_inference_tensor_params_t *tensor);
+status_t MODEL_GetOutputTensor(void *handle, int idx, mpp_inference_tensor_params_t *tensor);
 
 #if defined(__cplusplus)
 }
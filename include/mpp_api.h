@@ -22,6 +22,7 @@
 #ifndef _MPP_API_H
 #define _MPP_API_H
 
+#include <stddef.h>
 #include "mpp_api_types.h"
 
 /**
@@ -44,6 +45,21 @@
  */
 int mpp_api_init(mpp_api_params_t *params);
 
+/**
+ * Memory region registration
+ *
+ * This function adds a memory region to the pipeline buffer allocator. <br>
+ * Pipeline buffers are allocated from the regions according to their placement hint,
+ * and from the OS heap when no region fits. The region content is managed by the allocator
+ * and must not be used by the application. <br>
+ * It must be called after mpp_api_init() and before the pipelines are started, or before
+ * the inference elements are added for the TFLite fast tensor arena (HAL_TFLM_FAST_ARENA_SIZE_KB).
+ *
+ * @param [in] region region descriptor, copied by the function
+ * @return \ref return_codes
+ */
+int mpp_memory_region_add(const mpp_memory_region_t *region);
+
 /**
  * Basic pipeline creation
  *
@@ -140,6 +156,25 @@ int mpp_element_add(mpp_t mpp, mpp_element_id_t id, mpp_element_params_t *params
  */
 int mpp_split(mpp_t mpp, unsigned int num, mpp_params_t *params, mpp_t *out_list);
 
+/**
+ * Pipelines junction
+ *
+ * The outputs of the pipelines in _in_list_ become the input ports 1 to _num_ of the next element
+ * added to _mpp_, its input port 0 being the output of _mpp_.
+ * This is how a model with several inputs reads several frames (e.g. stereo cameras) without copy.
+ * The joined pipelines must have at least one element (their source), they are closed once the next
+ * element is added to _mpp_.
+ *
+ * @param [in] mpp pipeline receiving the next element
+ * @param [in] num number of joined pipelines
+ * @param [in] in_list list of joined pipelines
+ * @return \ref return_codes
+ *
+ * @pre
+ * - the next element added to _mpp_ must accept several inputs (ML inference).
+ */
+int mpp_join(mpp_t mpp, unsigned int num, mpp_t *in_list);
+
 /**
  * Put next elements processing in background
  *
@@ -160,6 +195,32 @@ int mpp_background(mpp_t mpp, mpp_params_t *params, mpp_t *out_mpp);
  */
 int mpp_element_update(mpp_t mpp, mpp_elem_handle_t elem_h, mpp_element_params_t *params);
 
+/**
+ * Get the geometric transform of a convert element
+ *
+ * Post-processing can use the transform to map positions from the output buffer,
+ * for instance boxes detected in a letterboxed model input, back to the input frame.
+ *
+ * @param [in]  mpp     input pipeline
+ * @param [in]  elem_h  convert element handle in the pipeline
+ * @param [out] xform   current transform of the element
+ * @return \ref return_codes
+ */
+int mpp_convert_get_transform(mpp_t mpp, mpp_elem_handle_t elem_h, mpp_convert_transform_t *xform);
+
+/**
+ * Set the load governor of a pipeline branch
+ *
+ * The governor sheds load from the branch when its execution time overruns the budget,
+ * and restores the nominal processing when headroom returns. <br>
+ * Level changes are reported with MPP_EVENT_GOVERNOR_LEVEL.
+ *
+ * @param [in] mpp      pipeline branch, must not be running
+ * @param [in] params   governor parameters, NULL or nb_levels=0 removes the governor
+ * @return \ref return_codes
+ */
+int mpp_governor_set(mpp_t mpp, const mpp_governor_params_t *params);
+
 /**
  * Start pipeline
  *
@@ -210,6 +271,62 @@ void mpp_stats_enable(mpp_stats_grp_t grp);
  */
 void mpp_stats_disable(mpp_stats_grp_t grp);
 
+/**
+ * Get latency percentiles
+ *
+ * Histograms are collected when the API is initialized with latency_hist set.
+ * The window covers the samples recorded since the previous reset.
+ * End-to-end latencies start at the frame capture: the camera receiver completion
+ * time when the HAL driver provides it, the source dequeue time otherwise.
+ *
+ * @param [in]  src     histogram source
+ * @param [in]  mpp     pipeline branch (not used for the cycle sources)
+ * @param [in]  elem_h  element handle (MPP_LATENCY_ELEMENT only)
+ * @param [out] lat     percentiles of the current window
+ * @param [in]  reset   if non-zero a new window starts with the next sample
+ * @return \ref return_codes
+ */
+int mpp_stats_get_latency(mpp_latency_src_t src, mpp_t mpp, mpp_elem_handle_t elem_h,
+                          mpp_latency_t *lat, int reset);
+
+
+/**
+ * Start the execution trace
+ *
+ * Events are recorded to a ring buffer when the library is built with MPP_TRACE,
+ * the oldest events are overwritten. Recording restarts from an empty buffer.
+ *
+ * @return \ref return_codes
+ */
+int mpp_trace_start(void);
+
+/**
+ * Stop the execution trace
+ *
+ * @return \ref return_codes
+ */
+int mpp_trace_stop(void);
+
+/**
+ * Dump the execution trace
+ *
+ * The binary dump can be converted with tools/mpp_trace_decode.py.
+ * The trace should be stopped while it is dumped.
+ *
+ * @param [out] dst     destination buffer
+ * @param [in]  size    destination buffer size
+ * @param [out] used    size of the dump, also set when dst is too small
+ * @return \ref return_codes
+ */
+int mpp_trace_dump(void *dst, size_t size, size_t *used);
+
+/**
+ * Trace a task switch
+ *
+ * To trace task switches, call this function from the FreeRTOS hook:
+ * "#define traceTASK_SWITCHED_IN() mpp_trace_task_switch()" in FreeRTOSConfig.h.
+ */
+void mpp_trace_task_switch(void);
 
 /**
  * Get MPP version
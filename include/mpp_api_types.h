@@ -34,8 +34,11 @@
  * @{
  */
 /** Maximum number of inference inputs and outputs **/
-#define MPP_INFERENCE_MAX_OUTPUTS 4 /*!< Maximum number of outputs supported by the pipeline */
-#define MPP_INFERENCE_MAX_INPUTS 1 /*!< Maximum number of inputs supported by the pipeline */
+#define MPP_INFERENCE_MAX_OUTPUTS 8 /*!< Maximum number of outputs of models described by the application (Glow, reference),
+                                        TFLite outputs are read from the model */
+#define MPP_INFERENCE_MAX_INPUTS 2 /*!< Maximum number of inputs, one input port each (see mpp_join()) */
+#define MPP_INFERENCE_MAX_OUT_POOL 4 /*!< Maximum number of inference output copies */
+#define MPP_INFERENCE_MAX_CHANNELS 4 /*!< Maximum number of model input channels with per-channel normalization */
 
 /** Pipeline handle type */
 typedef void* mpp_t ;
@@ -48,6 +51,10 @@ typedef uintptr_t mpp_elem_handle_t ;
 typedef enum {
     MPP_EVENT_INVALID,  /*!< invalid event */
     MPP_EVENT_INFERENCE_OUTPUT_READY,   /*!< inference out is ready */
+    MPP_EVENT_DETECTION_READY,          /*!< detection boxes are ready */
+    MPP_EVENT_CLASSIFICATION_READY,     /*!< classification results are ready */
+    MPP_EVENT_ROI_INFERENCE_OUTPUT_READY, /*!< inference out of one region of interest is ready */
+    MPP_EVENT_GOVERNOR_LEVEL,           /*!< load governor changed the degradation level of the branch */
     MPP_EVENT_INTERNAL_TEST_RESERVED,   /*!< INTERNAL: DO NOT USE */
     MPP_EVENT_NUM   /*!< DO NOT USE */
 } mpp_evt_t;
@@ -56,6 +63,14 @@ typedef enum {
 typedef unsigned int mpp_evt_mask_t;
 /** Bit mask to receive all Events */
 #define MPP_EVENT_ALL 0xffffffff
+/** Bit mask to receive a given Event */
+#define MPP_EVENT_MASK(evt) (1U << (evt))
+
+/** Events queue overflow policy */
+typedef enum {
+    MPP_EVT_OVERFLOW_DROP_OLDEST = 0,   /*!< oldest pending event is dropped */
+    MPP_EVT_OVERFLOW_BLOCK              /*!< pipeline task waits for the dispatch task */
+} mpp_evt_overflow_t;
 
 /**
  * Execution parameters
@@ -93,10 +108,12 @@ typedef union {
     struct {
         mpp_t mpp;
         unsigned int mpp_exec_time; /*!< pipeline execution time (ms) */
+        unsigned int mpp_exec_time_us; /*!< pipeline execution time (us) */
     } mpp; /*!< Pipeline execution performance counters */
     struct {
         mpp_elem_handle_t hnd;
         unsigned int elem_exec_time; /*!< element execution time (ms) */
+        unsigned int elem_exec_time_us; /*!< element execution time (us) */
     } elem; /*!< Element execution performance counters */
 } mpp_stats_t;
 
@@ -106,15 +123,55 @@ typedef struct {
     unsigned int rc_cycle_min;  /*!< minimum cycle duration for RC tasks (ms), 0: sets default value */
     unsigned int rc_cycle_inc;  /*!< time increment for RC tasks (ms),  0: sets default value */
     int pipeline_task_max_prio; /*!< pipeline tasks maximum priority. */
+    bool latency_hist;          /*!< collect latency histograms of the elements, branches and cycles (about 800 bytes each, 3 per branch) */
 } mpp_api_params_t;
 
-/** Pipeline creation parameters */
+/** Latency histogram sources */
+typedef enum {
+    MPP_LATENCY_ELEMENT = 0,    /*!< processing element execution time */
+    MPP_LATENCY_PIPELINE,       /*!< pipeline branch execution time, for frames processed by the branch */
+    MPP_LATENCY_RC_CYCLE,       /*!< run-to-completion (RC) cycle duration */
+    MPP_LATENCY_PR_CYCLE,       /*!< preemptable (PR) cycle duration, including preemption */
+    MPP_LATENCY_GLASS_TO_GLASS, /*!< frame capture to display or null sink flush completion, for the branch ending with the sink */
+    MPP_LATENCY_CAPTURE_TO_RESULT, /*!< frame capture to inference outputs delivery, for the branch holding the inference element */
+} mpp_latency_src_t;
+
+/**
+ * Latency percentiles
+ *
+ * Values are given in microseconds, percentiles with a relative error under 12.5%.
+ */
+typedef struct {
+    unsigned int count;     /*!< number of samples in the window */
+    uint32_t min;           /*!< minimum (us) */
+    uint32_t p50;           /*!< median (us) */
+    uint32_t p90;           /*!< 90th percentile (us) */
+    uint32_t p99;           /*!< 99th percentile (us) */
+    uint32_t max;           /*!< maximum (us) */
+} mpp_latency_t;
+
+/**
+ * Pipeline creation parameters
+ *
+ * Only the events selected by 'mask' are passed to evt_callback_f. <br>
+ * When evt_queue_len is non-zero, events are queued and evt_callback_f is called by
+ * a dispatch task instead of the pipeline task, so a slow callback does not delay the
+ * pipeline processing. Events whose data cannot outlive the pipeline processing
+ * (e.g. test events) are still delivered synchronously. <br>
+ * Branches created by mpp_split() and mpp_background() may process a subset of the frames
+ * reaching them: frames are dropped before the first element of the branch runs when
+ * 'decimation' or 'min_interval_ms' is set. Both are ignored by the branch holding the source.
+ */
 typedef struct {
         int (*evt_callback_f)(mpp_t mpp, mpp_evt_t evt, void *evt_data, void *user_data);
         mpp_evt_mask_t mask ;
         mpp_exec_flag_t exec_flag;
         void *cb_userdata;
         mpp_stats_t *stats;
+        unsigned int evt_queue_len;         /*!< events queue length, 0: synchronous delivery */
+        mpp_evt_overflow_t evt_overflow;    /*!< events queue overflow policy */
+        unsigned int decimation;            /*!< branch processes one frame every 'decimation' frames reaching it (0, 1: every frame) */
+        unsigned int min_interval_ms;       /*!< minimum interval between two frames processed by the branch (ms), 0: no limit */
 } mpp_params_t;
 
 /** Rotation value */
@@ -141,6 +198,7 @@ typedef enum {
     MPP_CONVERT_COLOR = (1 << 2),      /*!< frame color conversion */
     MPP_CONVERT_CROP = (1 << 3),       /*!< input frame crop */
     MPP_CONVERT_OUT_WINDOW = (1 << 4), /*!< output window */
+    MPP_CONVERT_LETTERBOX = (1 << 5),  /*!< scaling keeping the aspect ratio, the rest of the output window is padded */
 } mpp_convert_ops_t;
 
 /** Pixel format */
@@ -209,6 +267,12 @@ typedef enum {
     MPP_ELEMENT_TEST,       /*!< Test inplace element - NOT FOR USE */
     MPP_ELEMENT_INFERENCE,  /*!< Inference engine */
     MPP_ELEMENT_CONVERT,    /*!< Image conversion: resolution, orientation, color format */
+    MPP_ELEMENT_DETECTION,  /*!< Object detection post-processing of inference outputs */
+    MPP_ELEMENT_CLASSIFICATION, /*!< Classification post-processing of inference outputs */
+    MPP_ELEMENT_ROI_INFERENCE,  /*!< Inference on the regions of interest found by a DETECTION element,
+                                     must run in the same task as the source (not in a background branch) */
+    MPP_ELEMENT_TRACKER,    /*!< Tracking and per-frame prediction of the boxes of a DETECTION element */
+    MPP_ELEMENT_MOTION,     /*!< Motion gate: the next processing elements of the branch skip the frames without motion, the sink is still served */
     MPP_ELEMENT_NUM         /*!< DO NOT USE */
 } mpp_element_id_t;
 
@@ -227,7 +291,8 @@ typedef struct
 typedef enum {
     MPP_TENSOR_TYPE_FLOAT32 = 0,/*!< floating point 32 bits */
     MPP_TENSOR_TYPE_UINT8 = 1,  /*!< unsigned integer 8 bits */
-    MPP_TENSOR_TYPE_INT8 = 2    /*!< signed integer 8 bits */
+    MPP_TENSOR_TYPE_INT8 = 2,   /*!< signed integer 8 bits */
+    MPP_TENSOR_TYPE_INT16 = 3   /*!< signed integer 16 bits */
 } mpp_tensor_type_t;
 
 /** Inference input tensor order */
@@ -241,6 +306,8 @@ typedef enum {
 typedef enum
 {
     MPP_INFERENCE_TYPE_TFLITE = 0,      /*!< TensorFlow-Lite */
+    MPP_INFERENCE_TYPE_GLOW = 1,        /*!< Glow ahead-of-time compiled bundle, see mpp_inference_params_t */
+    MPP_INFERENCE_TYPE_REFERENCE = 2,   /*!< reference C backend, model_data points to a mpp_ref_model_t */
 } mpp_inference_type_t;
 
 /** tensor parameters */
@@ -248,16 +315,122 @@ typedef struct{
     const uint8_t* data;  /*!< data address */
     mpp_tensor_dims_t dims; /*!< tensor data dimensions */
     mpp_tensor_type_t type; /*!< tensor data type */
+    float scale;          /*!< quantization scale (0 if not quantized): real_value = scale * (quantized_value - zero_point) */
+    int32_t zero_point;   /*!< quantization zero point */
 } mpp_inference_tensor_params_t;
 
+/**
+ * Reference backend model
+ *
+ * The reference C backend (MPP_INFERENCE_TYPE_REFERENCE) has no dependency on an inference library,
+ * it runs the 'run' function on the NHWC input and is meant for tests on any target including the host.
+ */
+typedef struct {
+    int width;                      /*!< input width */
+    int height;                     /*!< input height */
+    int channels;                   /*!< input channels */
+    mpp_tensor_type_t input_type;   /*!< input tensor type */
+    int num_outputs;                /*!< number of outputs */
+    mpp_tensor_dims_t out_dims[MPP_INFERENCE_MAX_OUTPUTS];  /*!< outputs dimensions */
+    mpp_tensor_type_t out_type[MPP_INFERENCE_MAX_OUTPUTS];  /*!< outputs types */
+    /** model function, returns 0 on success.
+     * NULL: output 0 (FLOAT32, 'channels' elements) receives the per-channel mean of the input */
+    int (*run)(const mpp_inference_tensor_params_t *input, mpp_inference_tensor_params_t *outputs[], void *arg);
+    void *arg;                      /*!< passed to 'run' */
+} mpp_ref_model_t;
+
 /** Inference callback parameters */
 typedef struct {
     void *user_data;        /*!< callback will pass this pointer */
-    mpp_inference_tensor_params_t *out_tensors[MPP_INFERENCE_MAX_OUTPUTS]; /*!< output tensors parameters */
+    mpp_inference_tensor_params_t **out_tensors; /*!< output tensors parameters, num_outputs entries */
+    int num_outputs;        /*!< number of output tensors */
     int inference_time_ms;  /*!< inference run time measurement - output to user */
     mpp_inference_type_t inference_type; /*!< type of the inference */
 } mpp_inference_cb_param_t;
 
+/** Image area coordinates */
+typedef struct {
+    int top;
+    int left;
+    int bottom;
+    int right;
+} mpp_area_t;
+
+/** Image dimensions */
+typedef struct {
+    unsigned int width;
+    unsigned int height;
+} mpp_dims_t;
+
+/** Image position */
+typedef struct {
+    int top;
+    int left;
+} mpp_position_t;
+
+/** Geometric transform of a convert element, rotation and flip excepted:
+ *  output position = input position * scale + offset */
+typedef struct {
+    float scale_x;          /*!< horizontal scaling factor */
+    float scale_y;          /*!< vertical scaling factor */
+    float offset_x;         /*!< horizontal offset in output pixels */
+    float offset_y;         /*!< vertical offset in output pixels */
+    mpp_area_t window;      /*!< output buffer area holding the converted image, excluding letterbox padding */
+} mpp_convert_transform_t;
+
+/** Maximum number of boxes reported by the detection element */
+#define MPP_DETECTION_MAX_BOXES 32
+/** Maximum number of feature maps decoded by the detection element */
+#define MPP_DETECTION_MAX_STRIDES 4
+
+/** Detection output decoding method */
+typedef enum {
+    MPP_DETECTION_DECODER_CENTER_PRIOR = 0, /*!< anchor-free center priors per stride, box distances as distributions (e.g. NanoDet) */
+    MPP_DETECTION_DECODER_BOXES,            /*!< normalized box corners (left, top, right, bottom) per row (e.g. UltraFace) */
+    MPP_DETECTION_DECODER_ANCHORS,          /*!< box offsets (y, x, h, w) encoded against anchors (e.g. SSD) */
+} mpp_detection_decoder_t;
+
+/** Detected object box */
+typedef struct {
+    int16_t left;           /*!< box left position */
+    int16_t top;            /*!< box top position */
+    int16_t right;          /*!< box right position */
+    int16_t bottom;         /*!< box bottom position */
+    int16_t label;          /*!< object class index */
+    int16_t id;             /*!< object identifier, -1 if not tracked */
+    float score;            /*!< detection confidence [0..1] */
+} mpp_detection_box_t;
+
+/** Detection results */
+typedef struct {
+    unsigned int count;     /*!< number of boxes */
+    unsigned int width;     /*!< width of the boxes coordinates space */
+    unsigned int height;    /*!< height of the boxes coordinates space */
+    mpp_area_t window;      /*!< area of the coordinates space holding the image, smaller than width x height
+                                 when the model input is letterboxed */
+    mpp_detection_box_t boxes[MPP_DETECTION_MAX_BOXES]; /*!< boxes sorted by decreasing score */
+} mpp_detections_t;
+
+/** Maximum number of classes reported by the classification element */
+#define MPP_CLASSIFICATION_MAX_TOPK 5
+
+/** Classification results */
+typedef struct {
+    unsigned int count;     /*!< number of reported classes */
+    struct {
+        int16_t label;      /*!< class index */
+        float score;        /*!< class confidence [0..1], smoothed over frames if enabled */
+    } top[MPP_CLASSIFICATION_MAX_TOPK]; /*!< classes sorted by decreasing score */
+} mpp_classification_t;
+
+/** ROI inference output: event data of MPP_EVENT_ROI_INFERENCE_OUTPUT_READY, valid during the callback only */
+typedef struct {
+    unsigned int index;                 /*!< index of the ROI in the frame */
+    unsigned int count;                 /*!< number of ROIs processed in the frame */
+    mpp_detection_box_t box;            /*!< detection box of the ROI (detection coordinates space) */
+    const mpp_inference_cb_param_t *out; /*!< inference outputs of the ROI */
+} mpp_roi_inference_out_t;
+
 /** mpp color encoding */
 typedef union {
     uint32_t raw;   /*!< Raw color */
@@ -288,37 +461,21 @@ typedef struct {
     bool stripe;            /*!< stripe mode */
 } mpp_labeled_rect_t;
 
-/** Image area coordinates */
-typedef struct {
-    int top;
-    int left;
-    int bottom;
-    int right;
-} mpp_area_t;
-
-/** Image dimensions */
-typedef struct {
-    unsigned int width;
-    unsigned int height;
-} mpp_dims_t;
-
-/** Image position */
-typedef struct {
-    int top;
-    int left;
-} mpp_position_t;
-
 /** Model parameters */
 typedef struct {
     uint64_t constant_weight_MemSize;  /*!< model constant weights memory size */
     uint64_t mutable_weight_MemSize;   /*!< Defines the amount of memory required both input & output data buffers */
     uint64_t activations_MemSize;      /*!< Size of scratch memory used for intermediate computations needed by the model */
-    int num_inputs ;                   /*!< model's number of inputs */
-    int num_outputs ;                  /*!< model's number of outputs */
+    int num_inputs ;                   /*!< model's number of inputs, input i is read from the element input port i */
+    int num_outputs ;                  /*!< model's number of outputs (TFLite: 0 delivers all the model outputs) */
     uint64_t inputs_offsets[MPP_INFERENCE_MAX_INPUTS] ;  /*!< offset of each input */
     uint64_t outputs_offsets[MPP_INFERENCE_MAX_OUTPUTS]; /*!< offset of each output */
     inference_entry_point_t model_entry_point;                 /*!< function called to perform the inference */
     mpp_tensor_type_t model_input_tensors_type; /*!< type of input buffer */
+    float model_input_scale;           /*!< quantization scale of an integer input placeholder (0: zero point only) */
+    int32_t model_input_zero_point;    /*!< quantization offset of an integer input placeholder (with scale 0: -128) */
+    mpp_tensor_dims_t outputs_dims[MPP_INFERENCE_MAX_OUTPUTS];   /*!< dimensions of each output (size 0: unknown, outputs are not copied to the output pool) */
+    mpp_tensor_type_t outputs_types[MPP_INFERENCE_MAX_OUTPUTS];  /*!< type of each output */
 } mpp_inference_params_t;
 
 /** Processing element parameters */
@@ -334,6 +491,11 @@ union {
         uint32_t max_count;                 /*!< maximum number of rectangles */
         uint32_t detected_count;            /*!< detected rectangles */
         mpp_labeled_rect_t *rectangles;     /*!< array of rectangle data */
+        bool from_meta;                     /*!< also draw the boxes attached to the frame by an upstream DETECTION element,
+                                                 or to one of the few previous frames if the detection did not complete yet */
+        mpp_color_t meta_color;             /*!< line color of the boxes from metadata */
+        uint16_t meta_line_width;           /*!< line width of the boxes from metadata */
+        const char * const *meta_labels;    /*!< class names of the boxes from metadata (NULL: class index is printed) */
     } labels;
     /** Convert element's parameters */
     struct {
@@ -348,6 +510,7 @@ union {
         const char* dev_name;               /*!< device name used for graphics */
         bool stripe_in;                     /*!< input stripe mode */
         bool stripe_out;                    /*!< output stripe mode */
+        uint8_t pad_value;                  /*!< value of the letterbox padding color components */
     } convert;
     /** Resize element's parameters */
     struct {
@@ -374,16 +537,170 @@ union {
     struct {
         const void *model_data; /*!< pointer to model binary */
         mpp_inference_type_t type; /*!< inference type */
+        const char *backend;    /*!< inference backend name, to choose between backends of the same type (NULL: default backend) */
         int model_size;         /*!< model binary size */
         float model_input_mean; /*!< model 'mean' of input values, used for normalization */
         float model_input_std;  /*!< model 'standard deviation' of input values, used for normalization */
+        float model_input_ch_mean[MPP_INFERENCE_MAX_CHANNELS]; /*!< per-channel 'mean', replaces model_input_mean when model_input_ch_std[0] is not 0 */
+        float model_input_ch_std[MPP_INFERENCE_MAX_CHANNELS];  /*!< per-channel 'standard deviation', replaces model_input_std when [0] is not 0 */
         mpp_tensor_order_t tensor_order; /*!< model input tensor component order */
         mpp_inference_params_t inference_params; /*!< model specific parameters used by the inference */
+        unsigned int out_pool_size; /*!< number of output tensors copies (0: outputs are passed from the inference arena).
+                                         When non-zero, MPP_EVENT_INFERENCE_OUTPUT_READY is delivered by the events dispatch task
+                                         and the next inference may start while the application processes the outputs.
+                                         Defaults to 2 when the pipeline has an events queue. */
+        bool async;             /*!< the pipeline does not wait for the outputs, delivered by MPP_EVENT_INFERENCE_OUTPUT_READY only
+                                     (post-processing elements see no outputs). Required by, and only valid with, async backends. */
     } ml_inference;
+    /** Detection element's parameters */
+    struct {
+        mpp_detection_decoder_t decoder;    /*!< output tensors decoding method */
+        unsigned int num_classes;           /*!< number of object classes */
+        unsigned int cls_tensor;            /*!< index of the scores output tensor */
+        unsigned int cls_offset;            /*!< column of the first class score in a scores row */
+        unsigned int box_tensor;            /*!< index of the box regression output tensor */
+        unsigned int box_offset;            /*!< column of the first box value in a regression row */
+        unsigned int input_width;           /*!< model input width: boxes coordinates space */
+        unsigned int input_height;          /*!< model input height: boxes coordinates space */
+        unsigned int strides[MPP_DETECTION_MAX_STRIDES]; /*!< feature maps strides (MPP_DETECTION_DECODER_CENTER_PRIOR) */
+        unsigned int num_strides;           /*!< number of feature maps (MPP_DETECTION_DECODER_CENTER_PRIOR) */
+        unsigned int reg_max;               /*!< index of the last distance bin (MPP_DETECTION_DECODER_CENTER_PRIOR) */
+        const float *anchors;               /*!< anchors (ycenter, xcenter, height, width) normalized (MPP_DETECTION_DECODER_ANCHORS) */
+        unsigned int num_anchors;           /*!< number of anchors, at least the number of score rows (MPP_DETECTION_DECODER_ANCHORS) */
+        float box_scale[4];                 /*!< anchor encoding scales (y, x, h, w) (MPP_DETECTION_DECODER_ANCHORS) */
+        float score_threshold;              /*!< minimum score [0..1] of reported boxes */
+        float iou_threshold;                /*!< maximum IoU [0..1] between two reported boxes */
+        unsigned int max_boxes;             /*!< maximum number of reported boxes, up to MPP_DETECTION_MAX_BOXES */
+        bool class_agnostic;                /*!< when false, only boxes of the same class suppress each other */
+    } detection;
+    /** Classification element's parameters */
+    struct {
+        unsigned int out_tensor;            /*!< index of the scores output tensor */
+        unsigned int num_classes;           /*!< number of classes (scores in the last tensor dimension) */
+        unsigned int top_k;                 /*!< number of reported classes, up to MPP_CLASSIFICATION_MAX_TOPK */
+        float score_threshold;              /*!< minimum score [0..1] of reported classes */
+        float smoothing;                    /*!< weight [0..1[ of the past frames in the scores moving average, 0 disables smoothing */
+    } classification;
+    /** ROI inference element's parameters */
+    struct {
+        const char *dev_name;               /*!< graphics device cropping and resizing the ROIs (NULL: default device) */
+        mpp_pixel_format_t pixel_format;    /*!< ROI model input pixel format */
+        const void *model_data;             /*!< pointer to ROI model binary */
+        mpp_inference_type_t type;          /*!< inference type */
+        const char *backend;                /*!< inference backend name (NULL: default backend of the type) */
+        int model_size;                     /*!< model binary size */
+        float model_input_mean;             /*!< model 'mean' of input values, used for normalization */
+        float model_input_std;              /*!< model 'standard deviation' of input values, used for normalization */
+        float model_input_ch_mean[MPP_INFERENCE_MAX_CHANNELS]; /*!< per-channel 'mean', replaces model_input_mean when model_input_ch_std[0] is not 0 */
+        float model_input_ch_std[MPP_INFERENCE_MAX_CHANNELS];  /*!< per-channel 'standard deviation', replaces model_input_std when [0] is not 0 */
+        mpp_tensor_order_t tensor_order;    /*!< model input tensor component order */
+        mpp_inference_params_t inference_params; /*!< model specific parameters used by the inference */
+        unsigned int max_rois;              /*!< maximum number of ROIs processed per frame, up to MPP_DETECTION_MAX_BOXES */
+        int label;                          /*!< class of the processed boxes, -1 for all classes */
+        float min_score;                    /*!< minimum score [0..1] of the processed boxes */
+        unsigned int margin;                /*!< percentage of the box size added on each side of the ROI */
+        unsigned int batch;                 /*!< number of ROIs cropped in one pass over the source frame (0 or 1: one at a time),
+                                                 above 1 requires a graphics device supporting crop and resize */
+        bool letterbox;                     /*!< keep the ROI aspect ratio and pad the model input, requires a graphics device
+                                                 supporting crop and resize */
+        uint8_t pad_value;                  /*!< value of the letterbox padding color components */
+    } roi_inference;
+    /** Tracker element's parameters */
+    struct {
+        mpp_elem_handle_t detection;        /*!< DETECTION element providing the boxes, possibly in another branch */
+        float min_iou;                      /*!< minimum IoU [0..1] between a track and a box to associate them */
+        unsigned int min_hits;              /*!< number of associated boxes before a track is reported */
+        unsigned int max_misses;            /*!< number of detection results without associated box before a track is dropped */
+        unsigned int max_age;               /*!< number of frames without associated box before a track is dropped,
+                                                 also when the detection does not deliver results (0: 64) */
+        float position_noise;               /*!< standard deviation of the box position and size changes per frame in pixels (0: default) */
+        float velocity_noise;               /*!< standard deviation of the box velocity changes per frame in pixels per frame (0: default) */
+        float measure_noise;                /*!< standard deviation of the detected box coordinates in pixels (0: default) */
+    } tracker;
+    /** Motion gate element's parameters */
+    struct {
+        unsigned int thumb_width;           /*!< width of the grayscale thumbnail compared between frames (0: 32) */
+        unsigned int thumb_height;          /*!< height of the grayscale thumbnail compared between frames (0: 24) */
+        const uint8_t *mask;                /*!< thumbnail ROI mask, non-zero values mark the monitored pixels (NULL: whole frame) */
+        uint8_t pixel_threshold;            /*!< minimum luminance change of a changed thumbnail pixel */
+        float area_threshold;               /*!< minimum fraction [0..1] of changed monitored pixels detecting motion */
+        unsigned int background_shift;      /*!< background update rate 1/2^shift per frame, up to 7 (0: previous frame) */
+        unsigned int hold_frames;           /*!< number of frames still passed after motion stops */
+        unsigned int refresh_period;        /*!< a frame is passed at least every refresh_period frames (0: no forced refresh) */
+    } motion;
 };
     mpp_stats_t *stats;
 } mpp_element_params_t;
 
+/**
+ * Load governor degradation level
+ *
+ * Level 0 is the nominal processing, level n (n > 0) applies levels[n-1]
+ * of \ref mpp_governor_params_t. <br>
+ * Element updates are performed by the pipeline task, so only updates allowed while
+ * the branch runs can be declared (e.g. a CONVERT output window). Changes requiring a
+ * stopped branch, such as a lighter INFERENCE model, are done by the application upon
+ * MPP_EVENT_GOVERNOR_LEVEL.
+ */
+typedef struct {
+    unsigned int inference_period;          /*!< inference elements of the branch process one frame every inference_period frames (0, 1: every frame) */
+    mpp_elem_handle_t elem;                 /*!< element of the branch updated when entering the level (0: none) */
+    const mpp_element_params_t *elem_params;/*!< parameters of elem at this level, they must remain valid while the governor is set */
+} mpp_governor_level_t;
+
+/**
+ * Load governor parameters
+ *
+ * The governor filters the branch execution time and degrades the processing by one
+ * level after degrade_frames consecutive frames over budget_ms, or over a run-to-completion
+ * cycle overrun for MPP_EXEC_RC branches. It restores one level after restore_frames
+ * consecutive frames under headroom_pct percent of the budget.
+ */
+typedef struct {
+    unsigned int budget_ms;                 /*!< branch execution time budget per frame (ms) */
+    unsigned int headroom_pct;              /*!< quality is restored under this percentage of the budget (0: 70) */
+    unsigned int degrade_frames;            /*!< consecutive overloaded frames before degrading (0: 4) */
+    unsigned int restore_frames;            /*!< consecutive frames with headroom before restoring (0: 30) */
+    unsigned int nb_levels;                 /*!< number of degradation levels, 0 disables the governor */
+    const mpp_governor_level_t *levels;     /*!< degradation levels, from the lightest to the heaviest */
+} mpp_governor_params_t;
+
+/** Load governor level change: event data of MPP_EVENT_GOVERNOR_LEVEL */
+typedef struct {
+    unsigned int level;         /*!< new degradation level (0: nominal) */
+    unsigned int prev_level;    /*!< previous degradation level */
+    unsigned int exec_time;     /*!< filtered branch execution time (ms) */
+} mpp_governor_evt_t;
+
+/** Buffer placement hint */
+typedef enum {
+    MPP_MEM_PLACE_ANY = 0,      /*!< no preference: the OS heap, then any region */
+    MPP_MEM_PLACE_FAST,         /*!< highest bandwidth region first (e.g. DTCM/OCRAM), for small and hot buffers */
+    MPP_MEM_PLACE_BULK,         /*!< lowest bandwidth region first (e.g. SDRAM), for large and cold buffers */
+    MPP_MEM_PLACE_NONCACHEABLE, /*!< non-cacheable regions only, for buffers shared with devices */
+} mpp_memory_placement_t;
+
+/** Memory region bandwidth class */
+typedef enum {
+    MPP_MEM_BW_LOW = 0,         /*!< external memory (e.g. SDRAM, HyperRAM) */
+    MPP_MEM_BW_MEDIUM,          /*!< on-chip system memory (e.g. OCRAM) */
+    MPP_MEM_BW_HIGH,            /*!< tightly coupled memory (e.g. DTCM) */
+} mpp_memory_bandwidth_t;
+
+/**
+ * Memory region descriptor
+ *
+ * A region is a memory range reserved by the application (e.g. a linker section)
+ * that the pipeline may use for its buffers according to their placement hint.
+ */
+typedef struct {
+    const char *name;               /*!< region name, reported in placement logs (must remain valid) */
+    uintptr_t base;                 /*!< region start address */
+    uint32_t size;                  /*!< region size in bytes */
+    bool cacheable;                 /*!< true if the region is cached by the CPU */
+    mpp_memory_bandwidth_t bw;      /*!< bandwidth class */
+} mpp_memory_region_t;
+
 /** @}*/
 
 /** @defgroup return_codes
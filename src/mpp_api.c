@@ -21,6 +21,9 @@
 #include "mpp_heap.h"
 #include "mpp_version.h"
 #include "mpp_debug.h"
+#include "mpp_event.h"
+#include "mpp_governor.h"
+#include "mpp_trace.h"
 
 #include "hal_os.h"
 #include "string.h"
@@ -45,8 +48,40 @@ static hal_task_t hrcHeapTask = NULL;
 #define PR_TASK_STACK_SZ        1200
 static hal_task_t hprHeapTask = NULL;
 
+/* RC task is the second highest priority task in the pipeline. */
+static int rc_task_prio = MIN_CTL_TASK_PRIO - 1;
+/* PR task is the lowest-priority task in the pipeline. */
+static int pr_task_prio = MIN_CTL_TASK_PRIO - 2;
+
 /* rc heap execution time in ticks */
 static uint32_t rc_exec_ticks;
+/* last rc cycle overran its deadline */
+static volatile bool rc_overrun;
+/* latency histograms collection */
+static bool latency_hist;
+static _mpp_hist_t *rc_hist;
+static _mpp_hist_t *pr_hist;
+
+/* latency histograms of a branch */
+static void mpp_branch_hist_create(_mpp_t *m)
+{
+    m->hist = mpp_hist_create();
+    m->g2g_hist = mpp_hist_create();
+    m->c2r_hist = mpp_hist_create();
+}
+
+/* free a branch which failed to be created (not inserted in a heap yet) */
+static void mpp_branch_free(_mpp_t *m)
+{
+    hal_sema_delete(m->status_sema);
+    if (m->hist != NULL)
+        hal_free(m->hist);
+    if (m->g2g_hist != NULL)
+        hal_free(m->g2g_hist);
+    if (m->c2r_hist != NULL)
+        hal_free(m->c2r_hist);
+    hal_free(m);
+}
 /* max source frame rate (miliseconds)
    lower the value higher the rate */
 #define MAX_SRC_FRAME_MS     33
@@ -93,8 +128,13 @@ static void rcHeapTaskFunc(void *arg) {
             break;
         }
         start_ticks = hal_get_ostick();
+        mpp_coarse_tick = start_ticks;
+        uint32_t start_us = rc_hist ? hal_get_time_us() : 0;
         /* go and execute RC heap */
+        MPP_TRACE_EVT(MPP_TRACE_CYCLE_BEGIN, MPP_TRACE_HEAP_RC, 0, NULL);
         mpp_execute_heap(rc_prio_lst);
+        MPP_TRACE_EVT(MPP_TRACE_CYCLE_END, MPP_TRACE_HEAP_RC, 0, NULL);
+        if (rc_hist) mpp_hist_record(rc_hist, hal_get_time_us() - start_us);
         end_ticks = hal_get_ostick();
         rc_exec_ticks = end_ticks - start_ticks;
         /* set complete bit to resume controlling task*/
@@ -108,7 +148,11 @@ static void rcHeapTaskFunc(void *arg) {
 static void prHeapTaskFunc(void *arg) {
     MPP_LOGI("prHeapTask starting\n");
     for(;;) {
+        uint32_t start_us = pr_hist ? hal_get_time_us() : 0;
+        MPP_TRACE_EVT(MPP_TRACE_CYCLE_BEGIN, MPP_TRACE_HEAP_PR, 0, NULL);
         mpp_execute_heap(preempt_prio_lst);
+        MPP_TRACE_EVT(MPP_TRACE_CYCLE_END, MPP_TRACE_HEAP_PR, 0, NULL);
+        if (pr_hist) mpp_hist_record(pr_hist, hal_get_time_us() - start_us);
         /* flag round finished */
         hal_eventgrp_set_bits(xEventGroup3, PR_HEAP_TASK_DONE_BIT);
         /* suspend and wait for resume */
@@ -121,19 +165,6 @@ static void vPipelineCtlTask( void *params )
     int ret = MPP_ERROR;
     mpp_api_params_t *mpp_params = params;
     uint32_t tick_period_ms = hal_get_tick_period_ms();
-    /* RC task is the second highest priority task in the pipeline. */
-    static int rc_task_prio = MIN_CTL_TASK_PRIO - 1;
-    /* PR task is the lowest-priority task in the pipeline. */
-    static int pr_task_prio = MIN_CTL_TASK_PRIO - 2;
-
-    if (mpp_params)
-    {
-        if (mpp_params->pipeline_task_max_prio != 0)
-        {
-            rc_task_prio = mpp_params->pipeline_task_max_prio - 1;
-            pr_task_prio = mpp_params->pipeline_task_max_prio - 2;
-        }
-    }
 
     /* wait until application finished pipeline construction for the first start */
     ret = hal_sema_take(xCtlStartSem, HAL_MAX_TIMEOUT);
@@ -200,6 +231,8 @@ static void vPipelineCtlTask( void *params )
         uint32_t start_ticks, end_ticks;
         start_ticks = hal_get_ostick();
         unsigned int delay = (rc_exec_ticks >= max_rc_cycle_ticks)?1:(max_rc_cycle_ticks - rc_exec_ticks);
+        /* governors of RC branches shed load on overrun */
+        rc_overrun = (delay == 1);
         if (__builtin_expect((delay == 1), 0))
             max_rc_cycle_ticks += rc_cycle_inc;
         if ((delay > rc_cycle_inc) && (max_rc_cycle_ticks > min_rc_cycle_ticks))
@@ -295,9 +328,23 @@ int mpp_api_init(mpp_api_params_t *params)
             }
 
             pipeline_ctl_task_prio = params->pipeline_task_max_prio;
+            rc_task_prio = params->pipeline_task_max_prio - 1;
+            pr_task_prio = params->pipeline_task_max_prio - 2;
+        }
+        /* cycle histograms, branch and element ones are allocated at creation */
+        if (params->latency_hist)
+        {
+            latency_hist = true;
+            rc_hist = mpp_hist_create();
+            pr_hist = mpp_hist_create();
         }
     }
 
+    /* deferred logs formatting task (none if logs are not deferred) */
+    ret = mpp_log_start();
+    if (MPP_SUCCESS != ret)
+        return MPP_ERROR;
+
     /* create pipeline control task */
     /* task will not run until the xCtlStartSem is released
        by a last call to mpp_start*/
@@ -325,6 +372,26 @@ int mpp_api_init(mpp_api_params_t *params)
     return MPP_SUCCESS;
 }
 
+int mpp_memory_region_add(const mpp_memory_region_t *region)
+{
+    if ((region == NULL) || (region->size == 0))
+        return MPP_INVALID_PARAM;
+
+    if (hal_mem_region_add(region) != 0)
+    {
+        MPP_LOGE("Failed to add memory region %s\n", region->name ? region->name : "");
+        return MPP_ERROR;
+    }
+    MPP_LOGI("Memory region %s: 0x%x, %u bytes%s\n", region->name ? region->name : "",
+            (unsigned int)region->base, (unsigned int)region->size, region->cacheable ? ", cacheable" : "");
+    return MPP_SUCCESS;
+}
+
+int mpp_get_pr_task_prio(void)
+{
+    return pr_task_prio;
+}
+
 void mpp_stats_enable(mpp_stats_grp_t grp)
 {
     hal_sema_give(stats_lock[grp]);
@@ -367,6 +434,17 @@ mpp_t mpp_create(mpp_params_t *params, int *ret)
     m->status = MPP_CREATED;
     m->oper_status = MPP_NOT_STARTED;
     m->status_sema = hal_sema_create_binary();
+    if (latency_hist)
+        mpp_branch_hist_create(m);
+
+    /* asynchronous events delivery */
+    if (params->evt_queue_len > 0) {
+        *ret = mpp_event_queue_create(m, params->evt_queue_len);
+        if (*ret != MPP_SUCCESS) {
+            mpp_branch_free(m);
+            return NULL;
+        }
+    }
 
     /* select the heap */
     if (params->exec_flag == MPP_EXEC_RC)
@@ -462,6 +540,10 @@ int mpp_create_elem(_mpp_t *mpp, _elem_t **p_elem)
     /* backpointer to owning mpp */
     elem->mpp = mpp;
 
+    /* unknown accesses, elements refine them at setup */
+    elem->in_access = MPP_ACCESS_ANY;
+    elem->out_access = MPP_ACCESS_ANY;
+
     /* last added element */
     mpp->last_elem = elem;
     /* first added element ? */
@@ -505,6 +587,22 @@ int mpp_element_add(mpp_t mpp, mpp_element_id_t id, mpp_element_params_t *params
     elem->type = MPP_TYPE_PROC;
     elem->proc_typ = id;
 
+    /* pipelines joined into this element */
+    if (_mpp->join_cnt > 0) {
+        if (!can_join(id)) {
+            MPP_LOGE("Element %s has a single input, cannot follow mpp_join()\n", elem_name(id));
+            return MPP_ERROR;
+        }
+        for (int i = 0; i < _mpp->join_cnt; i++) {
+            if (_mpp->join[i]->status != MPP_OPENED) {
+                MPP_LOGE("Joined pipeline %d was closed\n", i);
+                return MPP_ERROR;
+            }
+            elem->join[i] = _mpp->join[i]->last_elem;
+        }
+        elem->join_cnt = _mpp->join_cnt;
+    }
+
     /* element specific instantiation function */
     elem_setup_func_t setup_func = get_setup_function(id);
     if (!setup_func)
@@ -513,6 +611,13 @@ int mpp_element_add(mpp_t mpp, mpp_element_id_t id, mpp_element_params_t *params
     if (ret != MPP_SUCCESS)
         return ret;
 
+    /* the joined pipelines end in this element */
+    for (int i = 0; i < _mpp->join_cnt; i++)
+        _mpp->join[i]->status = MPP_CLOSED;
+    _mpp->join_cnt = 0;
+    if (latency_hist)
+        elem->hist = mpp_hist_create();
+
     if (elem_h != MPP_INVALID) {
         *elem_h = mpp_scramble_h((mpp_elem_handle_t)elem);
     }
@@ -551,6 +656,15 @@ int mpp_split(mpp_t mpp, unsigned int num, mpp_params_t *params, mpp_t *out_list
         /* copy params*/
         m->params = params[i];
 
+        /* asynchronous events delivery */
+        if (params[i].evt_queue_len > 0) {
+            ret = mpp_event_queue_create(m, params[i].evt_queue_len);
+            if (ret != MPP_SUCCESS) {
+                mpp_branch_free(m);
+                return ret;
+            }
+        }
+
         /* link to parent mpp */
         m->hook = _mpp->last_elem;
 
@@ -569,6 +683,8 @@ int mpp_split(mpp_t mpp, unsigned int num, mpp_params_t *params, mpp_t *out_list
         m->status = MPP_OPENED;
         m->oper_status = MPP_NOT_STARTED;
         m->status_sema = hal_sema_create_binary();
+        if (latency_hist)
+            mpp_branch_hist_create(m);
 
         /* return the handle to user */
         out_list[i] = m;
@@ -577,6 +693,43 @@ int mpp_split(mpp_t mpp, unsigned int num, mpp_params_t *params, mpp_t *out_list
     return ret;
 }
 
+int mpp_join(mpp_t mpp, unsigned int num, mpp_t *in_list)
+{
+    if ((mpp == MPP_INVALID) || (in_list == NULL))
+        return MPP_INVALID_PARAM;
+    _mpp_t *_mpp = (_mpp_t *)mpp;
+    if (_mpp->status != MPP_OPENED)
+        return MPP_ERROR;
+    /* port 0 is the output of mpp */
+    if ((num == 0) || ((_mpp->join_cnt + num) > (MAX_INPUT_PORTS - 1))) {
+        MPP_LOGE("An element reads at most %d input ports\n", MAX_INPUT_PORTS);
+        return MPP_INVALID_PARAM;
+    }
+
+    int i, j;
+    for (i = 0; i < num; i++) {
+        _mpp_t *m = (_mpp_t *)in_list[i];
+        if ((m == NULL) || (m == _mpp) || (m->status != MPP_OPENED) || (m->last_elem == NULL)) {
+            MPP_LOGE("Pipeline %d cannot be joined\n", i);
+            return MPP_INVALID_PARAM;
+        }
+        /* each pipeline feeds a single input port */
+        bool dup = false;
+        for (j = 0; j < _mpp->join_cnt; j++)
+            dup |= (_mpp->join[j] == m);
+        for (j = 0; j < i; j++)
+            dup |= ((_mpp_t *)in_list[j] == m);
+        if (dup) {
+            MPP_LOGE("Pipeline %d is already joined\n", i);
+            return MPP_INVALID_PARAM;
+        }
+    }
+    /* the joined pipelines are closed once the next element of mpp is set up */
+    for (i = 0; i < num; i++)
+        _mpp->join[_mpp->join_cnt++] = (_mpp_t *)in_list[i];
+    return MPP_SUCCESS;
+}
+
 int mpp_background(mpp_t mpp, mpp_params_t *params, mpp_t *out_mpp)
 {
     int ret = MPP_SUCCESS;
@@ -585,6 +738,11 @@ int mpp_background(mpp_t mpp, mpp_params_t *params, mpp_t *out_mpp)
     _mpp_t *_mpp = (_mpp_t *)mpp;
     if (_mpp->status == MPP_CLOSED)
         return MPP_ERROR;
+    if (params->exec_flag != MPP_EXEC_PREEMPT)
+    {
+        MPP_LOGE("\n\rMPP in background must have exec_flag = MPP_EXEC_PREEMPT");
+        return MPP_ERROR;
+    }
 
     /* allocate output mpps */
     _mpp_t *m = hal_malloc(sizeof(_mpp_t));
@@ -597,11 +755,19 @@ int mpp_background(mpp_t mpp, mpp_params_t *params, mpp_t *out_mpp)
     /* link to parent mpp */
     m->hook = _mpp->last_elem;
 
-    if (params->exec_flag != MPP_EXEC_PREEMPT)
-    {
-        MPP_LOGE("\n\rMPP in background must have exec_flag = MPP_EXEC_PREEMPT");
-        return MPP_ERROR;
+    m->status_sema = hal_sema_create_binary();
+    if (latency_hist)
+        mpp_branch_hist_create(m);
+
+    /* asynchronous events delivery */
+    if (params->evt_queue_len > 0) {
+        ret = mpp_event_queue_create(m, params->evt_queue_len);
+        if (ret != MPP_SUCCESS) {
+            mpp_branch_free(m);
+            return ret;
+        }
     }
+
     /* insert split on the preemptable heap */
     mpp_heap_insert(m, preempt_prio_lst);
     m->exec_heap = preempt_prio_lst;
@@ -611,7 +777,6 @@ int mpp_background(mpp_t mpp, mpp_params_t *params, mpp_t *out_mpp)
     m->status = MPP_OPENED;
     m->oper_status = MPP_NOT_STARTED;
     _mpp->status = MPP_CLOSED;
-    m->status_sema = hal_sema_create_binary();
 
     /* return the handle to user */
     *out_mpp = (mpp_t) m;
@@ -823,6 +988,18 @@ int mpp_element_update(mpp_t mpp, mpp_elem_handle_t elem_h, mpp_element_params_t
         case MPP_ELEMENT_INFERENCE:
             ret = mpp_inference_update(elem, params);
             break;
+        case MPP_ELEMENT_DETECTION:
+            ret = mpp_detection_update(elem, params);
+            break;
+        case MPP_ELEMENT_CLASSIFICATION:
+            ret = mpp_classification_update(elem, params);
+            break;
+        case MPP_ELEMENT_TRACKER:
+            ret = mpp_tracker_update(elem, params);
+            break;
+        case MPP_ELEMENT_MOTION:
+            ret = mpp_motion_update(elem, params);
+            break;
         default:
             MPP_LOGI("Nothig to update for element %s\n", elem_name(elem->proc_typ));
             break;
@@ -833,6 +1010,106 @@ int mpp_element_update(mpp_t mpp, mpp_elem_handle_t elem_h, mpp_element_params_t
     return ret;
 }
 
+int mpp_convert_get_transform(mpp_t mpp, mpp_elem_handle_t elem_h, mpp_convert_transform_t *xform)
+{
+    _elem_t *elem = (_elem_t *)mpp_unscramble_h(elem_h);
+
+    if ((mpp == NULL) || (xform == NULL)) {
+        MPP_LOGE("invalid mpp pointer @%p or transform @%p\n", mpp, xform);
+        return MPP_INVALID_PARAM;
+    }
+    if ((elem == MPP_INVALID) || (elem->mpp != mpp)) {
+        MPP_LOGE("invalid element handle @%p\n", elem);
+        return MPP_INVALID_PARAM;
+    }
+    if ((elem->type != MPP_TYPE_PROC) || (elem->proc_typ != MPP_ELEMENT_CONVERT)) {
+        MPP_LOGE("invalid element %s (expected element CONVERT)\n", elem_name(elem->proc_typ));
+        return MPP_INVALID_PARAM;
+    }
+    mpp_convert_transform(elem, xform);
+
+    return MPP_SUCCESS;
+}
+
+int mpp_governor_set(mpp_t mpp, const mpp_governor_params_t *params)
+{
+    _mpp_t *m = (_mpp_t *)mpp;
+
+    if (m == NULL) {
+        MPP_LOGE("invalid mpp pointer @%p\n", mpp);
+        return MPP_INVALID_PARAM;
+    }
+    if (m->oper_status == MPP_RUNNING) {
+        MPP_LOGE("MPP branch must not be running to set the governor\n");
+        return MPP_INVALID_PARAM;
+    }
+
+    return mpp_governor_create(m, params);
+}
+
+int mpp_stats_get_latency(mpp_latency_src_t src, mpp_t mpp, mpp_elem_handle_t elem_h,
+                          mpp_latency_t *lat, int reset)
+{
+    _mpp_hist_t *hist = NULL;
+    _elem_t *elem;
+
+    if (lat == NULL)
+        return MPP_INVALID_PARAM;
+
+    switch (src) {
+    case MPP_LATENCY_ELEMENT:
+        elem = (elem_h == 0) ? NULL : (_elem_t *)mpp_unscramble_h(elem_h);
+        if ((mpp == NULL) || (elem == NULL) || (elem->mpp != mpp)) {
+            MPP_LOGE("invalid element handle @%p\n", elem);
+            return MPP_INVALID_PARAM;
+        }
+        hist = elem->hist;
+        break;
+    case MPP_LATENCY_PIPELINE:
+        if (mpp == NULL) {
+            MPP_LOGE("invalid mpp pointer @%p\n", mpp);
+            return MPP_INVALID_PARAM;
+        }
+        hist = ((_mpp_t *)mpp)->hist;
+        break;
+    case MPP_LATENCY_GLASS_TO_GLASS:
+    case MPP_LATENCY_CAPTURE_TO_RESULT:
+        if (mpp == NULL) {
+            MPP_LOGE("invalid mpp pointer @%p\n", mpp);
+            return MPP_INVALID_PARAM;
+        }
+        hist = (src == MPP_LATENCY_GLASS_TO_GLASS) ? ((_mpp_t *)mpp)->g2g_hist : ((_mpp_t *)mpp)->c2r_hist;
+        break;
+    case MPP_LATENCY_RC_CYCLE:
+        hist = rc_hist;
+        break;
+    case MPP_LATENCY_PR_CYCLE:
+        hist = pr_hist;
+        break;
+    default:
+        return MPP_INVALID_PARAM;
+    }
+    if (hist == NULL) {
+        MPP_LOGE("latency histogram not collected\n");
+        return MPP_ERROR;
+    }
+    mpp_hist_read(hist, lat, reset != 0);
+
+    return MPP_SUCCESS;
+}
+
+bool mpp_rc_overrun(void)
+{
+    return rc_overrun;
+}
+
+_elem_t *mpp_elem_from_handle(mpp_elem_handle_t elem_h)
+{
+    if (elem_h == 0)
+        return NULL;
+    return (_elem_t *)mpp_unscramble_h(elem_h);
+}
+
 char* mpp_get_version(void)
 {
     return (char*)mpp_version;
@@ -22,12 +22,14 @@
 #ifndef _MPP_API_TYPES_INTERNAL
 #define _MPP_API_TYPES_INTERNAL
 
+#include <stdatomic.h>
 #include "hal_camera_dev.h"
 #include "hal_display_dev.h"
 #include "hal_graphics_dev.h"
 #include "hal_valgo_dev.h"
 #include "hal_static_image.h"
 #include "hal_types.h"
+#include "mpp_histogram.h"
 #include "stddef.h"
 
 /** \internal */
@@ -53,6 +55,10 @@
 
 #define MPP_STRIPE_NUM   16
 
+/* element entry return code: the next processing elements of the branch skip the frame,
+ * distinct from the MPP and HAL error codes returned by other entries */
+#define MPP_ELEM_GATED   (1000)
+
 #define container_of(ptr, type, member)
 
 /* stringification */
@@ -71,6 +77,14 @@ _mpp_src_type_e {MPP_SRC_INVALID,
 				 MPP_SRC_NUM}
 _mpp_src_type_t;
 
+/* buffer image accessor (cache maintenance, see mpp_cache.h) */
+typedef enum {
+    MPP_ACCESS_NONE = 0,    /* image not accessed */
+    MPP_ACCESS_CPU,         /* through the data cache */
+    MPP_ACCESS_DEV,         /* by a DMA master */
+    MPP_ACCESS_ANY,         /* unknown: clean and invalidate around every access */
+} _mpp_access_t;
+
 /* sink type id */
 typedef enum
 _mpp_sink_type_e {MPP_SINK_INVALID,
@@ -134,17 +148,26 @@ typedef struct param_s
     void *param_addr;
 } param_t;
 
+/* forward declaration */
+struct _mpp_meta_s;
+typedef struct _mpp_meta_s _mpp_meta_t;
+
 typedef struct
 {
-    unsigned short frame_id;   /* the frame id */
+    atomic_uint state;  /* packed frame id, readers count and status, see mpp_buffer.h */
     mpp_pixel_format_t format;
     int width;      /* image height */
     int height;     /* image width */
     int stripe_num; /* stripe number. 0 means no stripe*/
-    int status;     /* status of the buffer */
     hw_buf_desc_t hw_req_prod;  /* buffer hw requirement from producer */
     hw_buf_desc_t hw_req_cons;  /* buffer hw requirement from consumer */
     hw_buf_desc_t *hw;          /* pointer to above producer/consumer buffer requirement finally selected */
+    const mpp_memory_region_t *region; /* memory region of a buffer allocated by the pipeline (NULL: heap) */
+    _mpp_meta_t *meta;          /* metadata of the source frame (NULL if none) */
+    uint32_t capture_ts;        /* capture time of the source frame (us) */
+    uint32_t dirty_off;         /* range written by the CPU, not cleaned yet */
+    uint32_t dirty_len;
+    bool stale;                 /* written by a device since the CPU cache was invalidated */
 } buf_desc_t;
 
 typedef struct
@@ -156,11 +179,17 @@ typedef struct
     buf_desc_t *in_buf[MAX_INPUT_PORTS]; /* input buffer descriptor (ignored if HAL_MEM_ALLOC_OUPUT/NONE) */
     buf_desc_t *out_buf[MAX_OUTPUT_PORTS]; /* output buffer descriptor (ignored if HAL_MEM_ALLOC_INPUT/NONE) */
     unsigned short last_frame_id[MAX_INPUT_PORTS]; /* frame id of the last processed input buffer(s) */
+    uint32_t out_written_off[MAX_OUTPUT_PORTS]; /* output range written by the processing, the whole */
+    uint32_t out_written_len[MAX_OUTPUT_PORTS]; /* image unless the element narrows it (0: none) */
 } io_desc_t;
 
 /* forward declaration */
 struct _elem_s;
 typedef struct _elem_s _elem_t;
+struct _mpp_evt_queue_s;
+typedef struct _mpp_evt_queue_s _mpp_evt_queue_t;
+struct _mpp_governor_s;
+typedef struct _mpp_governor_s _mpp_governor_t;
 
 struct _mpp_s {
 	/*creation params*/
@@ -185,6 +214,10 @@ struct _mpp_s {
     /* total number of splits */
     unsigned int split_cnt;
 
+    /* pipelines joined into the next element added (its input ports 1..), closed once it is set up */
+    _mpp_t *join[MAX_INPUT_PORTS - 1];
+    unsigned int join_cnt;
+
     /* execution heap (array of pointer to mpps) */
     _mpp_t **exec_heap;
 
@@ -192,6 +225,22 @@ struct _mpp_s {
     _elem_t *hook;
 
     mpp_stats_t *stats;
+
+    /* asynchronous events queue (NULL for synchronous delivery) */
+    _mpp_evt_queue_t *evt_queue;
+
+    /* load governor (NULL if none) */
+    _mpp_governor_t *gov;
+
+    /* frame decimation: frames reaching the branch, os tick of the last processed frame */
+    unsigned int decim_cnt;
+    uint32_t decim_tick;
+
+    /* execution time histogram (NULL if not collected) */
+    _mpp_hist_t *hist;
+    /* capture to sink flush and capture to inference result histograms (NULL if not collected) */
+    _mpp_hist_t *g2g_hist;
+    _mpp_hist_t *c2r_hist;
 };
 
 /* camera source */
@@ -261,12 +310,23 @@ struct _elem_s {
 
     /* the IO buffers descriptors */
     io_desc_t io;
+    /* how the element accesses the input and output images */
+    _mpp_access_t in_access;
+    _mpp_access_t out_access;
 
     /* owning mpp */
     _mpp_t *mpp;
 
+    /* element private context */
+    void *priv;
+
     _elem_t *prev;  /* previous element in pipeline */
     _elem_t *next[MPP_MAX_BRANCH_NUM];   /* next elements in pipeline */
+    _elem_t *join[MAX_INPUT_PORTS - 1];  /* last elements of the joined pipelines (input ports 1..) */
+    unsigned int join_cnt;
+
+    /* execution time histogram (NULL if not collected) */
+    _mpp_hist_t *hist;
 };
 
 typedef unsigned int (*elem_setup_func_t)(_elem_t *);
@@ -278,6 +338,22 @@ static inline int can_add(mpp_element_id_t id)
     case MPP_ELEMENT_LABELED_RECTANGLE:
     case MPP_ELEMENT_TEST:
     case MPP_ELEMENT_CONVERT:
+    case MPP_ELEMENT_INFERENCE:
+    case MPP_ELEMENT_DETECTION:
+    case MPP_ELEMENT_CLASSIFICATION:
+    case MPP_ELEMENT_ROI_INFERENCE:
+    case MPP_ELEMENT_TRACKER:
+    case MPP_ELEMENT_MOTION:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* elements reading several input ports (see mpp_join()) */
+static inline int can_join(mpp_element_id_t id)
+{
+    switch(id) {
     case MPP_ELEMENT_INFERENCE:
         return 1;
     default:
@@ -291,11 +367,57 @@ uint32_t mpp_lbl_rectangle_update (_elem_t *elem, mpp_element_params_t *params);
 /* image convert update function */
 unsigned int mpp_convert_update(_elem_t *elem, mpp_element_params_t *params);
 
+/* current geometric transform of a CONVERT element */
+void mpp_convert_transform(const _elem_t *elem, mpp_convert_transform_t *xform);
+
 /* inference update function */
 uint32_t mpp_inference_update(_elem_t *elem, mpp_element_params_t *params);
 
+/* outputs of the last inference run by an INFERENCE element (NULL if none) */
+const mpp_inference_cb_param_t *mpp_inference_get_outputs(_elem_t *elem);
+
+/* detection update function */
+uint32_t mpp_detection_update(_elem_t *elem, mpp_element_params_t *params);
+
+/* copy of the last results of a DETECTION element and their frame id,
+ * false if they are not newer than the results seen in '*seq' */
+bool mpp_detection_get_results(_elem_t *elem, uint32_t *seq, mpp_detections_t *res, unsigned short *frame_id);
+
+/* tracker update function */
+uint32_t mpp_tracker_update(_elem_t *elem, mpp_element_params_t *params);
+
+/* motion gate update function */
+uint32_t mpp_motion_update(_elem_t *elem, mpp_element_params_t *params);
+
+/* motion gate comparison: count the pixels of 'mask' changed more than 'thr'
+ * between the thumbnail 'cur' and the background 'bg', then move the background
+ * by 1/2^shift toward 'cur'. The SIMD version processes four pixels at a time
+ * ('size' multiple of 4) and gives the same results.
+ */
+#if defined(__ARM_FEATURE_SIMD32) && (__ARM_FEATURE_SIMD32 == 1)
+#define MPP_MOTION_SIMD 1
+#endif
+unsigned int mpp_motion_compare_ref(const uint8_t *cur, uint8_t *bg, const uint8_t *mask,
+                                    unsigned int size, uint8_t thr, unsigned int shift);
+#ifdef MPP_MOTION_SIMD
+unsigned int mpp_motion_compare_simd(const uint8_t *cur, uint8_t *bg, const uint8_t *mask,
+                                     unsigned int size, uint8_t thr, unsigned int shift);
+#endif
+
+/* element of a handle returned by mpp_element_add() */
+_elem_t *mpp_elem_from_handle(mpp_elem_handle_t elem_h);
+
+/* classification update function */
+uint32_t mpp_classification_update(_elem_t *elem, mpp_element_params_t *params);
+
 /* create element and link it to its mpp */
 int mpp_create_elem(_mpp_t *mpp, _elem_t **p_elem);
 
+/* priority of the preemptable (PR) heap task */
+int mpp_get_pr_task_prio(void);
+
+/* true if the last run-to-completion cycle overran its deadline */
+bool mpp_rc_overrun(void);
+
 /** \endinternal */
 #endif
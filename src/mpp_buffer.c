@@ -0,0 +1,156 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <assert.h>
+#include "mpp_api_types.h"
+#include "mpp_api_types_internal.h"
+#include "mpp_buffer.h"
+#include "mpp_debug.h"
+#include "mpp_trace.h"
+
+/* illegal transitions are reported, and trapped in debug builds */
+#define BUF_ILLEGAL(buf, state, op) do {                                    \
+    MPP_LOGE("buffer@%p: illegal %s in state 0x%x\n", (buf), (op), (state)); \
+    assert(0);                                                              \
+} while (0)
+
+#define BUF_STATUS(state)   ((_mpp_buf_status_t)((state) & MPP_BUF_STATUS_MASK))
+#define BUF_READERS(state)  (((state) & MPP_BUF_READERS_MASK) >> MPP_BUF_READERS_SHIFT)
+#define BUF_ID(state)       ((unsigned short)((state) >> MPP_BUF_ID_SHIFT))
+
+#define BUF_TRACE(buf, state) \
+    MPP_TRACE_EVT(MPP_TRACE_BUF_STATE, BUF_STATUS(state), BUF_ID(state), (buf))
+
+static inline bool buf_cas(buf_desc_t *buf, uint32_t *state, uint32_t next)
+{
+    return atomic_compare_exchange_weak_explicit(&buf->state, state, next,
+            memory_order_acq_rel, memory_order_acquire);
+}
+
+void mpp_buf_reset(buf_desc_t *buf)
+{
+    uint32_t state = atomic_load_explicit(&buf->state, memory_order_relaxed);
+
+    atomic_store_explicit(&buf->state, MPP_BUF_STATE(MPP_BUFFER_EMPTY, 0, BUF_ID(state)),
+                          memory_order_release);
+}
+
+bool mpp_buf_acquire_read(buf_desc_t *buf)
+{
+    uint32_t state = atomic_load_explicit(&buf->state, memory_order_acquire);
+    uint32_t next;
+
+    do {
+        switch (BUF_STATUS(state)) {
+        case MPP_BUFFER_WRITTING:
+            return false;
+        case MPP_BUFFER_READY:
+        case MPP_BUFFER_EMPTY:
+            next = MPP_BUF_STATE(MPP_BUFFER_READING, 1, BUF_ID(state));
+            break;
+        case MPP_BUFFER_READING:
+            if (BUF_READERS(state) == (MPP_BUF_READERS_MASK >> MPP_BUF_READERS_SHIFT)) {
+                BUF_ILLEGAL(buf, state, "read acquisition (too many readers)");
+                return false;
+            }
+            next = state + (1U << MPP_BUF_READERS_SHIFT);
+            break;
+        default:
+            BUF_ILLEGAL(buf, state, "read acquisition");
+            return false;
+        }
+    } while (!buf_cas(buf, &state, next));
+    BUF_TRACE(buf, next);
+
+    return true;
+}
+
+void mpp_buf_release_read(buf_desc_t *buf)
+{
+    uint32_t state = atomic_load_explicit(&buf->state, memory_order_acquire);
+    uint32_t next;
+
+    do {
+        if ((BUF_STATUS(state) != MPP_BUFFER_READING) || (BUF_READERS(state) == 0)) {
+            BUF_ILLEGAL(buf, state, "read release");
+            return;
+        }
+        if (BUF_READERS(state) == 1)
+            next = MPP_BUF_STATE(MPP_BUFFER_EMPTY, 0, BUF_ID(state));
+        else
+            next = state - (1U << MPP_BUF_READERS_SHIFT);
+    } while (!buf_cas(buf, &state, next));
+    BUF_TRACE(buf, next);
+}
+
+bool mpp_buf_acquire_write(buf_desc_t *buf, _mpp_buf_status_t *prev)
+{
+    uint32_t state = atomic_load_explicit(&buf->state, memory_order_acquire);
+
+    do {
+        switch (BUF_STATUS(state)) {
+        case MPP_BUFFER_READING:
+            return false;
+        case MPP_BUFFER_READY:
+        case MPP_BUFFER_EMPTY:
+            break;
+        default:
+            /* a buffer has a single writer */
+            BUF_ILLEGAL(buf, state, "write acquisition");
+            return false;
+        }
+    } while (!buf_cas(buf, &state, MPP_BUF_STATE(MPP_BUFFER_WRITTING, 0, BUF_ID(state))));
+    BUF_TRACE(buf, MPP_BUF_STATE(MPP_BUFFER_WRITTING, 0, BUF_ID(state)));
+
+    if (prev != NULL)
+        *prev = BUF_STATUS(state);
+    return true;
+}
+
+void mpp_buf_abort_write(buf_desc_t *buf, _mpp_buf_status_t prev)
+{
+    uint32_t state = atomic_load_explicit(&buf->state, memory_order_acquire);
+
+    do {
+        if (BUF_STATUS(state) != MPP_BUFFER_WRITTING) {
+            BUF_ILLEGAL(buf, state, "write abort");
+            return;
+        }
+    } while (!buf_cas(buf, &state, MPP_BUF_STATE(prev, 0, BUF_ID(state))));
+    BUF_TRACE(buf, MPP_BUF_STATE(prev, 0, BUF_ID(state)));
+}
+
+void mpp_buf_publish(buf_desc_t *buf, unsigned short frame_id)
+{
+    uint32_t state = atomic_load_explicit(&buf->state, memory_order_acquire);
+
+    do {
+        if (BUF_STATUS(state) != MPP_BUFFER_WRITTING) {
+            BUF_ILLEGAL(buf, state, "publish");
+            return;
+        }
+    } while (!buf_cas(buf, &state, MPP_BUF_STATE(MPP_BUFFER_READY, 0, frame_id)));
+    BUF_TRACE(buf, MPP_BUF_STATE(MPP_BUFFER_READY, 0, frame_id));
+}
+
+void mpp_buf_set_frame_id(buf_desc_t *buf, unsigned short frame_id)
+{
+    uint32_t state = atomic_load_explicit(&buf->state, memory_order_acquire);
+
+    while (!buf_cas(buf, &state, (state & ~(0xffffU << MPP_BUF_ID_SHIFT)) | ((uint32_t)frame_id << MPP_BUF_ID_SHIFT)));
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Buffer state machine
+ *
+ * The status, the number of readers and the frame id of a buffer are packed
+ * in one word updated with compare-and-swap, so that buffer transitions do not
+ * mask the interrupts and remain consistent between cores:
+ *
+ *   EMPTY/READY  --acquire_read-->   READING (readers + 1)
+ *   READING      --release_read-->   READING (readers - 1), EMPTY when no reader is left
+ *   EMPTY/READY  --acquire_write-->  WRITTING
+ *   WRITTING     --publish-->        READY (new frame id)
+ *   WRITTING     --abort_write-->    previous status
+ *
+ * Acquisitions of busy buffers fail, other transitions are illegal.
+ */
+
+#ifndef _MPP_BUFFER_H
+#define _MPP_BUFFER_H
+
+#include "mpp_api_types_internal.h"
+
+/* state word: | frame id (16) | readers (8) | status (8) | */
+#define MPP_BUF_STATUS_MASK     0xffU
+#define MPP_BUF_READERS_SHIFT   8
+#define MPP_BUF_READERS_MASK    (0xffU << MPP_BUF_READERS_SHIFT)
+#define MPP_BUF_ID_SHIFT        16
+
+#define MPP_BUF_STATE(status, readers, id) \
+    (((uint32_t)(id) << MPP_BUF_ID_SHIFT) | ((uint32_t)(readers) << MPP_BUF_READERS_SHIFT) | (uint32_t)(status))
+
+/* frame id of the buffer content */
+static inline unsigned short mpp_buf_frame_id(const buf_desc_t *buf)
+{
+    return atomic_load_explicit(&((buf_desc_t *)buf)->state, memory_order_acquire) >> MPP_BUF_ID_SHIFT;
+}
+
+/* current status of the buffer */
+static inline _mpp_buf_status_t mpp_buf_status(const buf_desc_t *buf)
+{
+    return atomic_load_explicit(&((buf_desc_t *)buf)->state, memory_order_acquire) & MPP_BUF_STATUS_MASK;
+}
+
+/* set an idle buffer to EMPTY, keeping its frame id */
+void mpp_buf_reset(buf_desc_t *buf);
+
+/* add a reader, false if the buffer is being written */
+bool mpp_buf_acquire_read(buf_desc_t *buf);
+
+/* remove a reader */
+void mpp_buf_release_read(buf_desc_t *buf);
+
+/* start writing, false if the buffer is being read.
+ * '*prev' receives the status restored by mpp_buf_abort_write() */
+bool mpp_buf_acquire_write(buf_desc_t *buf, _mpp_buf_status_t *prev);
+
+/* cancel a write which did not modify the buffer */
+void mpp_buf_abort_write(buf_desc_t *buf, _mpp_buf_status_t prev);
+
+/* end writing: the buffer content is frame 'frame_id' */
+void mpp_buf_publish(buf_desc_t *buf, unsigned short frame_id);
+
+/* change the frame id only, for sources overwriting a buffer still in use */
+void mpp_buf_set_frame_id(buf_desc_t *buf, unsigned short frame_id);
+
+#endif
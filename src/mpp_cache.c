@@ -0,0 +1,162 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "mpp_api_types_internal.h"
+#include "mpp_cache.h"
+#include "mpp_debug.h"
+#include "hal.h"
+#include "hal_os.h"
+
+uint32_t mpp_cache_buf_size(const buf_desc_t *buf)
+{
+    int lines = (buf->stripe_num > 0) ? buf->height / MPP_STRIPE_NUM : buf->height;
+
+    return (uint32_t)(buf->hw->stride * lines);
+}
+
+/* maintenance is needed for cacheable memory only */
+static inline bool cache_managed(const buf_desc_t *buf)
+{
+    return (buf->hw != NULL) && buf->hw->cacheable && (buf->hw->addr != NULL);
+}
+
+/* invalidate a buffer range, the partial lines at its edges may hold other data: clean them */
+static void cache_invalidate(uint32_t addr, uint32_t size)
+{
+    uint32_t end = addr + size;
+    uint32_t full_start = (addr + MPP_CACHE_LINE_SIZE - 1) & ~(MPP_CACHE_LINE_SIZE - 1);
+    uint32_t full_end = end & ~(MPP_CACHE_LINE_SIZE - 1);
+
+    if (size == 0)
+        return;
+    if (full_start > full_end) {
+        /* within a single line */
+        HAL_DCACHE_CleanInvalidateByRange(addr & ~(MPP_CACHE_LINE_SIZE - 1), MPP_CACHE_LINE_SIZE);
+        return;
+    }
+    if (addr != full_start)
+        HAL_DCACHE_CleanInvalidateByRange(full_start - MPP_CACHE_LINE_SIZE, MPP_CACHE_LINE_SIZE);
+    if (full_end > full_start)
+        HAL_DCACHE_InvalidateByRange(full_start, full_end - full_start);
+    if (end != full_end)
+        HAL_DCACHE_CleanInvalidateByRange(full_end, MPP_CACHE_LINE_SIZE);
+}
+
+void mpp_cache_before_read(buf_desc_t *buf, _mpp_access_t acc)
+{
+    uint32_t addr, off = 0, len = 0;
+    bool inval = false;
+
+    if ((acc == MPP_ACCESS_NONE) || !cache_managed(buf))
+        return;
+    addr = (uint32_t)(uintptr_t)buf->hw->addr;
+
+    hal_atomic_enter();
+    if ((acc != MPP_ACCESS_CPU) && (buf->dirty_len > 0)) {
+        /* the device reads memory: write back the CPU data */
+        off = buf->dirty_off;
+        len = buf->dirty_len;
+        buf->dirty_len = 0;
+    }
+    if ((acc != MPP_ACCESS_DEV) && buf->stale) {
+        /* the CPU reads the cache: drop the lines older than the device data */
+        inval = true;
+        buf->stale = false;
+    }
+    hal_atomic_exit();
+
+    if (len > 0)
+        HAL_DCACHE_CleanByRange(addr + off, len);
+    if (inval)
+        cache_invalidate(addr, mpp_cache_buf_size(buf));
+
+#if defined(EMULATOR) && defined(HAL_CACHE_SIM)
+    if (acc != MPP_ACCESS_ANY)
+        HAL_CACHE_SIM_Access(addr, mpp_cache_buf_size(buf), acc == MPP_ACCESS_DEV, false);
+#endif
+}
+
+void mpp_cache_before_write(buf_desc_t *buf, _mpp_access_t acc)
+{
+    uint32_t addr, off = 0, len = 0;
+    bool inval = false;
+
+    if ((acc == MPP_ACCESS_NONE) || !cache_managed(buf))
+        return;
+    addr = (uint32_t)(uintptr_t)buf->hw->addr;
+
+    hal_atomic_enter();
+    if ((acc != MPP_ACCESS_CPU) && (buf->dirty_len > 0)) {
+        /* dirty lines evicted later would overwrite the device data */
+        off = buf->dirty_off;
+        len = buf->dirty_len;
+        buf->dirty_len = 0;
+    }
+    if ((acc != MPP_ACCESS_DEV) && buf->stale) {
+        /* a partial CPU write of a stale line would write back stale bytes */
+        inval = true;
+        buf->stale = false;
+    }
+    hal_atomic_exit();
+
+    if (len > 0)
+        HAL_DCACHE_CleanByRange(addr + off, len);
+    if (inval)
+        cache_invalidate(addr, mpp_cache_buf_size(buf));
+}
+
+void mpp_cache_written(buf_desc_t *buf, _mpp_access_t acc, uint32_t off, uint32_t len)
+{
+    uint32_t addr, end;
+
+    if ((acc == MPP_ACCESS_NONE) || (len == 0) || !cache_managed(buf))
+        return;
+    addr = (uint32_t)(uintptr_t)buf->hw->addr;
+
+    switch (acc) {
+    case MPP_ACCESS_CPU:
+        hal_atomic_enter();
+        if (buf->dirty_len == 0) {
+            buf->dirty_off = off;
+            buf->dirty_len = len;
+        } else {
+            /* single range covering the writes */
+            end = (off + len > buf->dirty_off + buf->dirty_len) ? off + len : buf->dirty_off + buf->dirty_len;
+            buf->dirty_off = (off < buf->dirty_off) ? off : buf->dirty_off;
+            buf->dirty_len = end - buf->dirty_off;
+        }
+        hal_atomic_exit();
+        break;
+    case MPP_ACCESS_DEV:
+        buf->stale = true;
+        break;
+    default:
+        /* unknown writer: memory and cache agree once written */
+        HAL_DCACHE_CleanInvalidateByRange(addr + off, len);
+        hal_atomic_enter();
+        buf->dirty_len = 0;
+        buf->stale = false;
+        hal_atomic_exit();
+        break;
+    }
+
+#if defined(EMULATOR) && defined(HAL_CACHE_SIM)
+    if (acc != MPP_ACCESS_ANY)
+        HAL_CACHE_SIM_Access(addr + off, len, acc == MPP_ACCESS_DEV, true);
+#endif
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Buffer cache maintenance
+ *
+ * Each element declares how it accesses the image of its input and output
+ * buffers: through the CPU data cache or by a DMA master (camera, display,
+ * PXP, VGLite...). Buffers record the range written by the CPU and not
+ * cleaned yet, and whether a device wrote them since the CPU cache was last
+ * invalidated. Cache operations are then issued only when a buffer changes
+ * hands between the CPU and a device, over the buffer range concerned:
+ *
+ *   CPU wrote  --device reads/writes-->  clean the dirty range
+ *   device wrote  --CPU reads/writes-->  invalidate the buffer
+ *
+ * The state is updated by the buffer owner, under the buffer state machine
+ * (see mpp_buffer.h), concurrent readers are serialized by a critical section.
+ * Invalidations act on whole cache lines: buffers allocated by the pipeline
+ * own their lines, the partial lines at the edges of other buffers are
+ * cleaned before they are invalidated.
+ */
+
+#ifndef _MPP_CACHE_H
+#define _MPP_CACHE_H
+
+#include "mpp_api_types_internal.h"
+
+/* data cache line size */
+#ifndef MPP_CACHE_LINE_SIZE
+#define MPP_CACHE_LINE_SIZE     32U
+#endif
+
+/* size of the buffer image (stripe) in bytes */
+uint32_t mpp_cache_buf_size(const buf_desc_t *buf);
+
+/* cache operations before 'acc' reads the buffer */
+void mpp_cache_before_read(buf_desc_t *buf, _mpp_access_t acc);
+
+/* cache operations before 'acc' writes the buffer */
+void mpp_cache_before_write(buf_desc_t *buf, _mpp_access_t acc);
+
+/* record that 'acc' wrote bytes [off, off + len) of the buffer */
+void mpp_cache_written(buf_desc_t *buf, _mpp_access_t acc, uint32_t off, uint32_t len);
+
+#endif
@@ -20,6 +20,8 @@
 #include <sys/time.h>
 #include "mpp_api_types.h"
 
+volatile uint32_t mpp_coarse_tick;
+
 int tick_check_rate(uint32_t *last, int *curr, int max)
 {
 
@@ -29,7 +31,7 @@ int tick_check_rate(uint32_t *last, int *curr, int max)
      * lasttime.
      */
 
-    uint32_t now = hal_get_ostick();
+    uint32_t now = mpp_coarse_tick ? mpp_coarse_tick : hal_get_ostick();
     if (!*last || (unsigned int)(now - *last) >= hal_get_tick_rate_hz()) {
         *last= now;
         *curr = 1;
@@ -55,6 +57,21 @@ char * elem_name(mpp_element_id_t id)
     case MPP_ELEMENT_INFERENCE:
         str = "INFERENCE";
         break;
+    case MPP_ELEMENT_DETECTION:
+        str = "DETECTION";
+        break;
+    case MPP_ELEMENT_CLASSIFICATION:
+        str = "CLASSIFICATION";
+        break;
+    case MPP_ELEMENT_ROI_INFERENCE:
+        str = "ROI_INFERENCE";
+        break;
+    case MPP_ELEMENT_TRACKER:
+        str = "TRACKER";
+        break;
+    case MPP_ELEMENT_MOTION:
+        str = "MOTION";
+        break;
     case MPP_ELEMENT_INVALID:
         str = "INVALID";
         break;
@@ -20,6 +20,10 @@
 #define _MPP_DEBUG_H
 
 #include "hal_debug.h"
+#include "mpp_log.h"
+
+/* OS tick sampled once per RC cycle for the rate limited logs, 0 until the pipelines run */
+extern volatile uint32_t mpp_coarse_tick;
 
 int tick_check_rate(uint32_t *last, int *curr, int max);
 
@@ -27,12 +31,21 @@ int tick_check_rate(uint32_t *last, int *curr, int max);
 char * elem_name(mpp_element_id_t id);
 
 /* non-conditional logs */
+#if MPP_LOG_DEFERRED
+#define MPP_LOGE(format, ...) \
+    MPP_LOG_DEFER(LOG_LVL_ERR, format, ##__VA_ARGS__)
+#define MPP_LOGI(format, ...) \
+    MPP_LOG_DEFER(LOG_LVL_INFO, format, ##__VA_ARGS__)
+#define MPP_LOGD(format, ...) \
+    MPP_LOG_DEFER(LOG_LVL_DEBUG, format, ##__VA_ARGS__)
+#else
 #define MPP_LOGE(format, ...) \
     LOGE("MPP", __func__, __LINE__, format, ##__VA_ARGS__)
 #define MPP_LOGI(format, ...) \
     LOGI("MPP", __func__, __LINE__, format, ##__VA_ARGS__)
 #define MPP_LOGD(format, ...) \
     LOGD("MPP", __func__, __LINE__, format, ##__VA_ARGS__)
+#endif
 
 /* conditional logs */
 #define MPP_LOGE_IF(cond, format, ...)  \
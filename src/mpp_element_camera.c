@@ -23,6 +23,9 @@
 #include "string.h"
 #include "hal_utils.h"
 #include "mpp_debug.h"
+#include "mpp_meta.h"
+#include "mpp_buffer.h"
+#include "mpp_cache.h"
 
 #include "hal.h"
 
@@ -31,19 +34,32 @@ static inline int camera_dequeue(_mpp_t *mpp)
     int ret = MPP_SUCCESS;
     _elem_t *elem = mpp->first_elem;
     _camera_dev_t *cam = elem->dev.cam;
+    buf_desc_t *buf = elem->io.out_buf[0];
 
     /* check buffer status */
-    if (elem->io.out_buf[0]->status == MPP_BUFFER_READING)
+    bool owned = mpp_buf_acquire_write(buf, NULL);
+    if (!owned)
     {
         MPP_LOGI("Warning: camera may overwrite buffer in use.\n");
     }
-    elem->io.out_buf[0]->status = MPP_BUFFER_WRITTING;
 
-    ret = cam->dev.ops->dequeue(&cam->dev, (void **)(&elem->io.out_buf[0]->hw->addr), &elem->io.out_buf[0]->stripe_num);
+    /* the previous frame goes back to the camera */
+    mpp_cache_before_write(buf, MPP_ACCESS_DEV);
+    ret = cam->dev.ops->dequeue(&cam->dev, (void **)(&buf->hw->addr), &buf->stripe_num);
+    mpp_cache_written(buf, MPP_ACCESS_DEV, 0, mpp_cache_buf_size(buf));
 
+    /* capture time from the driver if it knows it, dequeue time otherwise */
+    if ((cam->dev.ops->get_timestamp == NULL)
+            || (cam->dev.ops->get_timestamp(&cam->dev, &buf->capture_ts) != kStatus_HAL_CameraSuccess))
+        buf->capture_ts = hal_get_time_us();
+
+    /* metadata is set before the frame is visible */
+    mpp_meta_begin(elem, mpp_buf_frame_id(buf) + 1);
     /* update buffer status */
-    elem->io.out_buf[0]->status = MPP_BUFFER_READY;
-    elem->io.out_buf[0]->frame_id++;
+    if (owned)
+        mpp_buf_publish(buf, mpp_buf_frame_id(buf) + 1);
+    else
+        mpp_buf_set_frame_id(buf, mpp_buf_frame_id(buf) + 1);
 
     return ret;
 }
@@ -101,6 +117,7 @@ int mpp_camera_add(mpp_t mpp, const char* name, mpp_camera_params_t *params)
         MPP_LOGE("\nAllocation failed\n");
         return MPP_MALLOC_ERROR;
     }
+    memset(elem->io.out_buf[0], 0, sizeof(buf_desc_t));
     elem->io.nb_out_buf = 1;
     elem->io.out_buf[0]->format = cam->params.format;
     elem->io.out_buf[0]->width = cam->params.width;
@@ -0,0 +1,261 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Classification element: reports the top classes of the previous INFERENCE
+ * element scores.
+ *
+ * Scores stay in the quantized domain: they are optionally smoothed over
+ * frames with an integer exponential moving average, and the top-K classes
+ * are selected in a single pass. Only the K reported scores are dequantized.
+ */
+
+#include <string.h>
+#include <math.h>
+#include "mpp_api.h"
+#include "mpp_api_types_internal.h"
+
+#include "mpp_debug.h"
+#include "mpp_event.h"
+#include "hal_os.h"
+
+/* fractional bits of the smoothed scores and of the smoothing weight */
+#define CLASSIFICATION_FRAC_BITS    8
+
+typedef struct {
+    uint16_t *avg;          /* smoothed scores, quantized value - qmin in Q8 */
+    bool primed;            /* avg holds at least one frame */
+    uint32_t past_w;        /* Q8 weight of the past frames */
+    mpp_classification_t result;
+} _classification_ctx_t;
+
+static inline uint32_t smoothing_weight(float smoothing)
+{
+    uint32_t w = (uint32_t)(smoothing * (1 << CLASSIFICATION_FRAC_BITS) + 0.5f);
+
+    /* a full weight would freeze the average */
+    return (w < (1 << CLASSIFICATION_FRAC_BITS)) ? w : (1 << CLASSIFICATION_FRAC_BITS) - 1;
+}
+
+/* insert a score in the sorted top list, returns the new list length */
+static inline unsigned int topk_insert(uint32_t *val, int16_t *lbl, unsigned int n,
+                                       unsigned int k, uint32_t v, int16_t label)
+{
+    unsigned int i = (n < k) ? n++ : k - 1;
+
+    while ((i > 0) && (val[i - 1] < v)) {
+        val[i] = val[i - 1];
+        lbl[i] = lbl[i - 1];
+        i--;
+    }
+    val[i] = v;
+    lbl[i] = label;
+    return n;
+}
+
+/* element processing function */
+static int classification_func(_elem_t *elem)
+{
+    _classification_ctx_t *ctx = elem->priv;
+    const mpp_element_params_t *params = &elem->params;
+    const mpp_inference_cb_param_t *out;
+    const mpp_inference_tensor_params_t *tensor;
+    unsigned int num_classes = params->classification.num_classes;
+    unsigned int k = params->classification.top_k;
+    uint32_t val[MPP_CLASSIFICATION_MAX_TOPK];
+    int16_t lbl[MPP_CLASSIFICATION_MAX_TOPK];
+    unsigned int n = 0;
+    uint32_t thr, past_w;
+    int qmin, q;
+
+    out = mpp_inference_get_outputs(elem->prev);
+    if (out == NULL)
+        return MPP_SUCCESS; /* no inference yet */
+
+    tensor = (params->classification.out_tensor < (unsigned int)out->num_outputs) ?
+            out->out_tensors[params->classification.out_tensor] : NULL;
+    if ((tensor == NULL) || (tensor->data == NULL) || (tensor->scale == 0)
+            || ((tensor->type != MPP_TENSOR_TYPE_INT8) && (tensor->type != MPP_TENSOR_TYPE_UINT8))) {
+        MPP_LOGE_IF(RLMT_CHECK(1), "Classification requires a quantized 8-bit output tensor\n");
+        return MPP_INVALID_PARAM;
+    }
+    if ((tensor->dims.size > 0) && (tensor->dims.data[tensor->dims.size - 1] < num_classes)) {
+        MPP_LOGE_IF(RLMT_CHECK(1), "Classification output tensor has less than %d classes\n", num_classes);
+        return MPP_INVALID_PARAM;
+    }
+
+    /* threshold as a Q8 shifted quantized value */
+    qmin = (tensor->type == MPP_TENSOR_TYPE_INT8) ? INT8_MIN : 0;
+    q = (int)ceilf(params->classification.score_threshold / tensor->scale) + tensor->zero_point - qmin;
+    if (q < 0)
+        q = 0;
+    thr = (q > UINT8_MAX) ? UINT32_MAX : (uint32_t)q << CLASSIFICATION_FRAC_BITS;
+
+    /* the first frame initializes the moving average */
+    past_w = ctx->primed ? ctx->past_w : 0;
+    ctx->primed = (ctx->past_w > 0);
+
+    for (unsigned int c = 0; c < num_classes; c++) {
+        uint32_t v;
+
+        if (tensor->type == MPP_TENSOR_TYPE_INT8)
+            v = (uint32_t)(((const int8_t *)tensor->data)[c] - INT8_MIN) << CLASSIFICATION_FRAC_BITS;
+        else
+            v = (uint32_t)tensor->data[c] << CLASSIFICATION_FRAC_BITS;
+        if (past_w > 0) {
+            v = (ctx->avg[c] * past_w + v * ((1 << CLASSIFICATION_FRAC_BITS) - past_w))
+                    >> CLASSIFICATION_FRAC_BITS;
+        }
+        ctx->avg[c] = v;
+
+        /* early reject below threshold or below the current K-th score */
+        if ((v < thr) || ((n == k) && (v <= val[k - 1])))
+            continue;
+        n = topk_insert(val, lbl, n, k, v, c);
+    }
+
+    /* only the reported scores are dequantized */
+    for (unsigned int i = 0; i < n; i++) {
+        float qv = (float)val[i] / (1 << CLASSIFICATION_FRAC_BITS) + qmin;
+        ctx->result.top[i].label = lbl[i];
+        ctx->result.top[i].score = (qv - tensor->zero_point) * tensor->scale;
+    }
+    ctx->result.count = n;
+
+    return mpp_event_post(elem->mpp, MPP_EVENT_CLASSIFICATION_READY, &ctx->result, NULL, NULL);
+}
+
+static unsigned int check_classification_params(const mpp_element_params_t *params)
+{
+    if (params->classification.num_classes == 0) {
+        MPP_LOGE("Classification requires the number of classes\n");
+        return MPP_INVALID_PARAM;
+    }
+    if ((params->classification.top_k == 0) || (params->classification.top_k > MPP_CLASSIFICATION_MAX_TOPK)
+            || (params->classification.top_k > params->classification.num_classes)) {
+        MPP_LOGE("Classification top_k should be in range [1..%d]\n", MPP_CLASSIFICATION_MAX_TOPK);
+        return MPP_INVALID_PARAM;
+    }
+    if ((params->classification.score_threshold < 0) || (params->classification.score_threshold > 1)) {
+        MPP_LOGE("Classification score threshold should be in range [0..1]\n");
+        return MPP_INVALID_PARAM;
+    }
+    if ((params->classification.smoothing < 0) || (params->classification.smoothing >= 1)) {
+        MPP_LOGE("Classification smoothing should be in range [0..1[\n");
+        return MPP_INVALID_PARAM;
+    }
+
+    return MPP_SUCCESS;
+}
+
+/* classification setup function */
+unsigned int elem_classification_setup(_elem_t *elem)
+{
+    unsigned int ret = MPP_SUCCESS;
+    _classification_ctx_t *ctx = NULL;
+
+    do {
+        /* sanity checks */
+        if (elem == NULL) {
+            MPP_LOGE("invalid input buffer - elem (0x%x)\n", ret);
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        if ((elem->proc_typ != MPP_ELEMENT_CLASSIFICATION) || (elem->type != MPP_TYPE_PROC))
+        {
+            MPP_LOGE("invalid element %s (expected element CLASSIFICATION)\n", elem_name(elem->proc_typ));
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        if ((elem->prev == NULL) || (elem->prev->type != MPP_TYPE_PROC)
+                || (elem->prev->proc_typ != MPP_ELEMENT_INFERENCE))
+        {
+            MPP_LOGE("CLASSIFICATION element must follow an INFERENCE element\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        ret = check_classification_params(&elem->params);
+        if (ret != MPP_SUCCESS)
+            break;
+
+        ctx = hal_malloc(sizeof(_classification_ctx_t)
+                         + elem->params.classification.num_classes * sizeof(uint16_t));
+        if (ctx == NULL) {
+            MPP_LOGE("malloc failed for classification context\n");
+            ret = MPP_MALLOC_ERROR;
+            break;
+        }
+        memset(ctx, 0, sizeof(_classification_ctx_t));
+        ctx->avg = (uint16_t *)(ctx + 1);
+        ctx->past_w = smoothing_weight(elem->params.classification.smoothing);
+        elem->priv = ctx;
+
+        /* assign element entry/function */
+        elem->entry = classification_func;
+
+        /* element does not access the image: in-place */
+        elem->io.inplace = true;
+        elem->io.nb_in_buf = 1;
+        elem->io.in_buf[0] = elem->prev->io.out_buf[0];
+        elem->io.nb_out_buf = 1;
+        elem->io.out_buf[0] = elem->io.in_buf[0];
+        /* the image is not accessed */
+        elem->in_access = MPP_ACCESS_NONE;
+        elem->out_access = MPP_ACCESS_NONE;
+    } while (false);
+
+    return ret;
+}
+
+/* classification update function: threshold, top_k and smoothing only */
+uint32_t mpp_classification_update(_elem_t *elem, mpp_element_params_t *params)
+{
+    uint32_t ret = MPP_SUCCESS;
+    _classification_ctx_t *ctx;
+
+    do {
+        if ((elem == NULL) || (params == NULL)) {
+            MPP_LOGE("invalid input parameters\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        if (elem->proc_typ != MPP_ELEMENT_CLASSIFICATION)
+        {
+            MPP_LOGE("invalid element %s (expected element CLASSIFICATION)\n", elem_name(elem->proc_typ));
+            ret = MPP_INVALID_ELEM;
+            break;
+        }
+        if ((params->classification.num_classes != elem->params.classification.num_classes)
+                || (params->classification.out_tensor != elem->params.classification.out_tensor)) {
+            MPP_LOGE("Classification output tensor cannot be changed\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        ret = check_classification_params(params);
+        if (ret != MPP_SUCCESS)
+            break;
+
+        ctx = elem->priv;
+        elem->params.classification.top_k = params->classification.top_k;
+        elem->params.classification.score_threshold = params->classification.score_threshold;
+        elem->params.classification.smoothing = params->classification.smoothing;
+        ctx->past_w = smoothing_weight(params->classification.smoothing);
+    } while (false);
+
+    return ret;
+}
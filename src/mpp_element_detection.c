@@ -0,0 +1,594 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Detection element: decodes the detection model outputs of the previous
+ * INFERENCE element into boxes.
+ *
+ * Scores are compared in the quantized domain and only the rows with a class
+ * above the threshold are kept as candidates. Candidates are ordered with a
+ * counting sort on their quantized score (one bucket per quantized value),
+ * then boxes are decoded and suppressed in score order with an integer IoU
+ * test, until the maximum number of boxes is reached.
+ * The boxes are attached to the frame metadata and posted to the application.
+ */
+
+#include <string.h>
+#include <math.h>
+#include "mpp_api.h"
+#include "mpp_api_types_internal.h"
+
+#include "mpp_debug.h"
+#include "mpp_event.h"
+#include "mpp_meta.h"
+#include "mpp_buffer.h"
+#include "hal_os.h"
+
+/* maximum number of rows above the score threshold */
+#define DETECTION_MAX_CANDIDATES    512
+/* one bucket per 8-bit quantized score */
+#define DETECTION_SCORE_BUCKETS     256
+/* fixed point precision of the IoU threshold */
+#define DETECTION_IOU_BITS          10
+
+typedef struct {
+    uint16_t row;       /* output row (prior or anchor index) */
+    uint8_t bucket;     /* quantized score shifted to [0..255] */
+    int16_t label;
+} _det_candidate_t;
+
+/* quantized 2-D view of an output tensor */
+typedef struct {
+    const uint8_t *data;
+    mpp_tensor_type_t type;
+    unsigned int rows;
+    unsigned int cols;
+    float scale;
+    int32_t zero_point;
+} _det_tensor_t;
+
+typedef struct {
+    unsigned int nb_cand;
+    unsigned int overflow;      /* rows dropped because the candidates array was full */
+    _det_candidate_t cand[DETECTION_MAX_CANDIDATES];
+    uint16_t order[DETECTION_MAX_CANDIDATES];   /* candidates by decreasing score */
+    uint16_t bucket_cnt[DETECTION_SCORE_BUCKETS];
+    int32_t area[MPP_DETECTION_MAX_BOXES];      /* area of the kept boxes */
+    const _elem_t *convert;     /* CONVERT element producing the model input */
+    mpp_detections_t result;
+    /* results shared with the elements of other branches */
+    mpp_detections_t published;
+    unsigned short published_frame;
+    uint32_t seq;
+} _detection_ctx_t;
+
+static bool get_tensor(const mpp_inference_cb_param_t *out, unsigned int idx, _det_tensor_t *t)
+{
+    const mpp_inference_tensor_params_t *tensor;
+
+    if (idx >= (unsigned int)out->num_outputs)
+        return false;
+    tensor = out->out_tensors[idx];
+    if ((tensor == NULL) || (tensor->data == NULL) || (tensor->dims.size == 0))
+        return false;
+    if ((tensor->type != MPP_TENSOR_TYPE_INT8) && (tensor->type != MPP_TENSOR_TYPE_UINT8))
+        return false;
+    if (tensor->scale == 0)
+        return false;
+
+    t->data = tensor->data;
+    t->type = tensor->type;
+    t->scale = tensor->scale;
+    t->zero_point = tensor->zero_point;
+    t->cols = tensor->dims.data[tensor->dims.size - 1];
+    t->rows = 1;
+    for (int i = 0; i < tensor->dims.size - 1; i++)
+        t->rows *= tensor->dims.data[i];
+
+    return true;
+}
+
+static inline int q_min(const _det_tensor_t *t)
+{
+    return (t->type == MPP_TENSOR_TYPE_INT8) ? INT8_MIN : 0;
+}
+
+static inline int q_value(const _det_tensor_t *t, unsigned int idx)
+{
+    return (t->type == MPP_TENSOR_TYPE_INT8) ? ((const int8_t *)t->data)[idx] : t->data[idx];
+}
+
+static inline float dequantize(const _det_tensor_t *t, int q)
+{
+    return (q - t->zero_point) * t->scale;
+}
+
+/* first quantized value whose real value reaches the threshold */
+static int quantize_threshold(const _det_tensor_t *t, float threshold)
+{
+    int q = (int)ceilf(threshold / t->scale) + t->zero_point;
+    int qmin = q_min(t);
+
+    if (q < qmin)
+        q = qmin;
+    if (q > qmin + DETECTION_SCORE_BUCKETS)
+        q = qmin + DETECTION_SCORE_BUCKETS;
+    return q;
+}
+
+/* keep the rows having a class score above threshold, best class only */
+static void collect_candidates(_detection_ctx_t *ctx, const _det_tensor_t *cls,
+                               unsigned int offset, unsigned int num_classes, int thr_q)
+{
+    int qmin = q_min(cls);
+
+    ctx->nb_cand = 0;
+    for (unsigned int row = 0; row < cls->rows; row++) {
+        unsigned int base = row * cls->cols + offset;
+        int best = thr_q - 1;
+        int label = -1;
+
+        if (cls->type == MPP_TENSOR_TYPE_INT8) {
+            const int8_t *p = (const int8_t *)cls->data + base;
+            for (int c = 0; c < num_classes; c++) {
+                if (p[c] > best) {
+                    best = p[c];
+                    label = c;
+                }
+            }
+        } else {
+            const uint8_t *p = cls->data + base;
+            for (int c = 0; c < num_classes; c++) {
+                if (p[c] > best) {
+                    best = p[c];
+                    label = c;
+                }
+            }
+        }
+        if (label < 0)
+            continue;
+        if (ctx->nb_cand == DETECTION_MAX_CANDIDATES) {
+            ctx->overflow++;
+            continue;
+        }
+        ctx->cand[ctx->nb_cand].row = row;
+        ctx->cand[ctx->nb_cand].bucket = best - qmin;
+        ctx->cand[ctx->nb_cand].label = label;
+        ctx->bucket_cnt[best - qmin]++;
+        ctx->nb_cand++;
+    }
+}
+
+/* counting sort of the candidates by decreasing score */
+static void order_candidates(_detection_ctx_t *ctx)
+{
+    uint16_t pos = 0;
+
+    for (int b = DETECTION_SCORE_BUCKETS - 1; b >= 0; b--) {
+        uint16_t cnt = ctx->bucket_cnt[b];
+        ctx->bucket_cnt[b] = pos;
+        pos += cnt;
+    }
+    for (unsigned int i = 0; i < ctx->nb_cand; i++)
+        ctx->order[ctx->bucket_cnt[ctx->cand[i].bucket]++] = i;
+}
+
+/* expected distance of a distribution of bins (softmax over the bins) */
+static float distribution_distance(const _det_tensor_t *reg, unsigned int base, unsigned int nb_bins)
+{
+    int qmax = q_value(reg, base);
+    float sum = 0, acc = 0;
+
+    for (int j = 1; j < nb_bins; j++) {
+        int q = q_value(reg, base + j);
+        if (q > qmax)
+            qmax = q;
+    }
+    for (int j = 0; j < nb_bins; j++) {
+        float e = expf((q_value(reg, base + j) - qmax) * reg->scale);
+        sum += e;
+        acc += j * e;
+    }
+    return acc / sum;
+}
+
+static inline int32_t overlap(int32_t a0, int32_t a1, int32_t b0, int32_t b1)
+{
+    return ((a1 < b1) ? a1 : b1) - ((a0 > b0) ? a0 : b0);
+}
+
+static inline int16_t clip(float v, unsigned int max)
+{
+    if (v < 0)
+        return 0;
+    if (v > max)
+        return max;
+    return (int16_t)v;
+}
+
+static bool decode_box(const mpp_element_params_t *params, const _det_tensor_t *reg,
+                       unsigned int row, mpp_detection_box_t *box)
+{
+    unsigned int w = params->detection.input_width;
+    unsigned int h = params->detection.input_height;
+    unsigned int base = row * reg->cols + params->detection.box_offset;
+    float left, top, right, bottom;
+
+    switch (params->detection.decoder) {
+    case MPP_DETECTION_DECODER_CENTER_PRIOR:
+    {
+        unsigned int nb_bins = params->detection.reg_max + 1;
+        unsigned int stride = 0, x = 0, y = 0;
+        float dist[4];
+
+        /* locate the center prior: feature maps are stored by stride, then line */
+        for (int l = 0; l < params->detection.num_strides; l++) {
+            unsigned int s = params->detection.strides[l];
+            unsigned int fw = (w + s - 1) / s;
+            unsigned int fh = (h + s - 1) / s;
+            if (row < fw * fh) {
+                stride = s;
+                x = row % fw;
+                y = row / fw;
+                break;
+            }
+            row -= fw * fh;
+        }
+        if (stride == 0)
+            return false;
+        for (int k = 0; k < 4; k++)
+            dist[k] = distribution_distance(reg, base + k * nb_bins, nb_bins) * stride;
+        left   = x * stride - dist[0];
+        top    = y * stride - dist[1];
+        right  = x * stride + dist[2];
+        bottom = y * stride + dist[3];
+        break;
+    }
+    case MPP_DETECTION_DECODER_BOXES:
+        left   = dequantize(reg, q_value(reg, base)) * w;
+        top    = dequantize(reg, q_value(reg, base + 1)) * h;
+        right  = dequantize(reg, q_value(reg, base + 2)) * w;
+        bottom = dequantize(reg, q_value(reg, base + 3)) * h;
+        break;
+    case MPP_DETECTION_DECODER_ANCHORS:
+    {
+        const float *anchor = &params->detection.anchors[4 * row];
+        const float *scale = params->detection.box_scale;
+        float yc = dequantize(reg, q_value(reg, base)) / scale[0] * anchor[2] + anchor[0];
+        float xc = dequantize(reg, q_value(reg, base + 1)) / scale[1] * anchor[3] + anchor[1];
+        float bh = expf(dequantize(reg, q_value(reg, base + 2)) / scale[2]) * anchor[2];
+        float bw = expf(dequantize(reg, q_value(reg, base + 3)) / scale[3]) * anchor[3];
+        left   = (xc - bw / 2) * w;
+        top    = (yc - bh / 2) * h;
+        right  = (xc + bw / 2) * w;
+        bottom = (yc + bh / 2) * h;
+        break;
+    }
+    default:
+        return false;
+    }
+
+    box->left = clip(left, w);
+    box->top = clip(top, h);
+    box->right = clip(right, w);
+    box->bottom = clip(bottom, h);
+    return true;
+}
+
+/* greedy suppression in decreasing score order */
+static void suppress(_detection_ctx_t *ctx, const mpp_element_params_t *params,
+                     const _det_tensor_t *cls, const _det_tensor_t *reg)
+{
+    mpp_detections_t *res = &ctx->result;
+    int32_t iou_thr = (int32_t)(params->detection.iou_threshold * (1 << DETECTION_IOU_BITS) + 0.5f);
+    int qmin = q_min(cls);
+
+    res->count = 0;
+    for (unsigned int k = 0; k < ctx->nb_cand; k++) {
+        _det_candidate_t *c = &ctx->cand[ctx->order[k]];
+        mpp_detection_box_t *box = &res->boxes[res->count];
+        bool keep = true;
+        int32_t area;
+
+        if (!decode_box(params, reg, c->row, box))
+            continue;
+        area = (box->right - box->left) * (box->bottom - box->top);
+        if (area <= 0)
+            continue;
+
+        for (unsigned int j = 0; j < res->count; j++) {
+            mpp_detection_box_t *kept = &res->boxes[j];
+            if (!params->detection.class_agnostic && (kept->label != c->label))
+                continue;
+            int32_t iw = overlap(box->left, box->right, kept->left, kept->right);
+            int32_t ih = overlap(box->top, box->bottom, kept->top, kept->bottom);
+            if ((iw <= 0) || (ih <= 0))
+                continue;
+            int64_t inter = iw * ih;
+            int64_t uni = area + ctx->area[j] - inter;
+            if ((inter << DETECTION_IOU_BITS) > iou_thr * uni) {
+                keep = false;
+                break;
+            }
+        }
+        if (!keep)
+            continue;
+
+        /* only the kept boxes are dequantized */
+        box->label = c->label;
+        box->id = -1;
+        box->score = dequantize(cls, c->bucket + qmin);
+        ctx->area[res->count] = area;
+        if (++res->count == params->detection.max_boxes)
+            break;
+    }
+}
+
+/* image area of the detection space, excluding the letterbox padding of the model input */
+static void set_window(_detection_ctx_t *ctx, const buf_desc_t *buf)
+{
+    mpp_detections_t *res = &ctx->result;
+    const mpp_convert_transform_t *xform = NULL;
+
+    if (ctx->convert != NULL)
+        xform = mpp_meta_find(buf, MPP_META_TRANSFORM, ctx->convert, NULL);
+    if ((xform == NULL) || (buf->width == 0) || (buf->height == 0)) {
+        res->window.left = 0;
+        res->window.top = 0;
+        res->window.right = res->width - 1;
+        res->window.bottom = res->height - 1;
+        return;
+    }
+    /* from model input buffer to detection coordinates */
+    res->window.left = xform->window.left * res->width / buf->width;
+    res->window.right = xform->window.right * res->width / buf->width;
+    res->window.top = xform->window.top * res->height / buf->height;
+    res->window.bottom = xform->window.bottom * res->height / buf->height;
+}
+
+/* element processing function */
+static int detection_func(_elem_t *elem)
+{
+    _detection_ctx_t *ctx = elem->priv;
+    const mpp_element_params_t *params = &elem->params;
+    const mpp_inference_cb_param_t *out;
+    _det_tensor_t cls, reg;
+    size_t size;
+
+    out = mpp_inference_get_outputs(elem->prev);
+    if (out == NULL)
+        return MPP_SUCCESS; /* no inference yet */
+
+    if (!get_tensor(out, params->detection.cls_tensor, &cls)
+            || !get_tensor(out, params->detection.box_tensor, &reg)) {
+        MPP_LOGE_IF(RLMT_CHECK(1), "Detection requires quantized 8-bit output tensors\n");
+        return MPP_INVALID_PARAM;
+    }
+    if ((cls.rows != reg.rows)
+            || (cls.cols < params->detection.cls_offset + params->detection.num_classes)) {
+        MPP_LOGE_IF(RLMT_CHECK(1), "Detection output tensors do not match the decoder\n");
+        return MPP_INVALID_PARAM;
+    }
+    /* each row is decoded against its anchor */
+    if ((params->detection.decoder == MPP_DETECTION_DECODER_ANCHORS) && (cls.rows > params->detection.num_anchors)) {
+        MPP_LOGE_IF(RLMT_CHECK(1), "Detection output tensors have %u rows for %u anchors\n",
+                    cls.rows, params->detection.num_anchors);
+        return MPP_INVALID_PARAM;
+    }
+
+    memset(ctx->bucket_cnt, 0, sizeof(ctx->bucket_cnt));
+    collect_candidates(ctx, &cls, params->detection.cls_offset, params->detection.num_classes,
+                       quantize_threshold(&cls, params->detection.score_threshold));
+    MPP_LOGI_IF((ctx->overflow > 0) && RLMT_CHECK(1),
+                "Detection candidates overflow (%d), score threshold may be too low\n", ctx->overflow);
+    ctx->overflow = 0;
+    order_candidates(ctx);
+    suppress(ctx, params, &cls, &reg);
+    set_window(ctx, elem->io.in_buf[0]);
+
+    /* attach the boxes to the frame for the downstream elements */
+    size = offsetof(mpp_detections_t, boxes) + ctx->result.count * sizeof(mpp_detection_box_t);
+    mpp_meta_add(elem->io.in_buf[0], MPP_META_DETECTIONS, elem, &ctx->result, size);
+
+    hal_atomic_enter();
+    memcpy(&ctx->published, &ctx->result, size);
+    ctx->published_frame = mpp_buf_frame_id(elem->io.in_buf[0]);
+    ctx->seq++;
+    hal_atomic_exit();
+
+    return mpp_event_post(elem->mpp, MPP_EVENT_DETECTION_READY, &ctx->result, NULL, NULL);
+}
+
+static unsigned int check_detection_params(const mpp_element_params_t *params)
+{
+    if ((params->detection.num_classes == 0)
+            || (params->detection.input_width == 0) || (params->detection.input_height == 0)) {
+        MPP_LOGE("Detection requires the number of classes and the model input dimensions\n");
+        return MPP_INVALID_PARAM;
+    }
+    if ((params->detection.max_boxes == 0) || (params->detection.max_boxes > MPP_DETECTION_MAX_BOXES)) {
+        MPP_LOGE("Detection max_boxes should be in range [1..%d]\n", MPP_DETECTION_MAX_BOXES);
+        return MPP_INVALID_PARAM;
+    }
+    if ((params->detection.score_threshold <= 0) || (params->detection.score_threshold > 1)
+            || (params->detection.iou_threshold <= 0) || (params->detection.iou_threshold > 1)) {
+        MPP_LOGE("Detection thresholds should be in range ]0..1]\n");
+        return MPP_INVALID_PARAM;
+    }
+
+    switch (params->detection.decoder) {
+    case MPP_DETECTION_DECODER_CENTER_PRIOR:
+        if ((params->detection.num_strides == 0)
+                || (params->detection.num_strides > MPP_DETECTION_MAX_STRIDES)
+                || (params->detection.reg_max == 0)) {
+            MPP_LOGE("Invalid center prior decoder strides or reg_max\n");
+            return MPP_INVALID_PARAM;
+        }
+        for (int l = 0; l < params->detection.num_strides; l++) {
+            if (params->detection.strides[l] == 0) {
+                MPP_LOGE("Invalid center prior decoder stride %d\n", l);
+                return MPP_INVALID_PARAM;
+            }
+        }
+        break;
+    case MPP_DETECTION_DECODER_BOXES:
+        break;
+    case MPP_DETECTION_DECODER_ANCHORS:
+        if ((params->detection.anchors == NULL) || (params->detection.num_anchors == 0)) {
+            MPP_LOGE("Anchors decoder requires anchors\n");
+            return MPP_INVALID_PARAM;
+        }
+        for (int k = 0; k < 4; k++) {
+            if (params->detection.box_scale[k] == 0) {
+                MPP_LOGE("Invalid anchors decoder box scale %d\n", k);
+                return MPP_INVALID_PARAM;
+            }
+        }
+        break;
+    default:
+        MPP_LOGE("Unknown detection decoder %d\n", params->detection.decoder);
+        return MPP_INVALID_PARAM;
+    }
+
+    return MPP_SUCCESS;
+}
+
+/* detection setup function */
+unsigned int elem_detection_setup(_elem_t *elem)
+{
+    unsigned int ret = MPP_SUCCESS;
+    _detection_ctx_t *ctx = NULL;
+    _elem_t *cur;
+
+    do {
+        /* sanity checks */
+        if (elem == NULL) {
+            MPP_LOGE("invalid input buffer - elem (0x%x)\n", ret);
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        if ((elem->proc_typ != MPP_ELEMENT_DETECTION) || (elem->type != MPP_TYPE_PROC))
+        {
+            MPP_LOGE("invalid element %s (expected element DETECTION)\n", elem_name(elem->proc_typ));
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        if ((elem->prev == NULL) || (elem->prev->type != MPP_TYPE_PROC)
+                || (elem->prev->proc_typ != MPP_ELEMENT_INFERENCE))
+        {
+            MPP_LOGE("DETECTION element must follow an INFERENCE element\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        ret = check_detection_params(&elem->params);
+        if (ret != MPP_SUCCESS)
+            break;
+
+        ctx = hal_malloc(sizeof(_detection_ctx_t));
+        if (ctx == NULL) {
+            MPP_LOGE("malloc failed for detection context\n");
+            ret = MPP_MALLOC_ERROR;
+            break;
+        }
+        memset(ctx, 0, sizeof(_detection_ctx_t));
+        ctx->result.width = elem->params.detection.input_width;
+        ctx->result.height = elem->params.detection.input_height;
+        /* letterbox padding is reported by the CONVERT element feeding the model */
+        for (cur = elem->prev->prev; (cur != NULL) && (cur->type == MPP_TYPE_PROC); cur = cur->prev) {
+            if (cur->proc_typ == MPP_ELEMENT_CONVERT) {
+                ctx->convert = cur;
+                break;
+            }
+        }
+        if ((ctx->convert != NULL) && (mpp_meta_enable(elem) != MPP_SUCCESS)) {
+            MPP_LOGE("No metadata for the letterbox transform\n");
+            hal_free(ctx);
+            ret = MPP_ERROR;
+            break;
+        }
+        elem->priv = ctx;
+
+        /* assign element entry/function */
+        elem->entry = detection_func;
+
+        /* element does not access the image: in-place */
+        elem->io.inplace = true;
+        elem->io.nb_in_buf = 1;
+        elem->io.in_buf[0] = elem->prev->io.out_buf[0];
+        elem->io.nb_out_buf = 1;
+        elem->io.out_buf[0] = elem->io.in_buf[0];
+        /* the image is not accessed */
+        elem->in_access = MPP_ACCESS_NONE;
+        elem->out_access = MPP_ACCESS_NONE;
+    } while (false);
+
+    return ret;
+}
+
+bool mpp_detection_get_results(_elem_t *elem, uint32_t *seq, mpp_detections_t *res, unsigned short *frame_id)
+{
+    _detection_ctx_t *ctx = elem->priv;
+
+    if ((ctx == NULL) || (ctx->seq == *seq))
+        return false;
+
+    hal_atomic_enter();
+    memcpy(res, &ctx->published,
+           offsetof(mpp_detections_t, boxes) + ctx->published.count * sizeof(mpp_detection_box_t));
+    *frame_id = ctx->published_frame;
+    *seq = ctx->seq;
+    hal_atomic_exit();
+
+    return true;
+}
+
+/* detection update function: thresholds and boxes count only */
+uint32_t mpp_detection_update(_elem_t *elem, mpp_element_params_t *params)
+{
+    uint32_t ret = MPP_SUCCESS;
+
+    do {
+        if ((elem == NULL) || (params == NULL)) {
+            MPP_LOGE("invalid input parameters\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        if (elem->proc_typ != MPP_ELEMENT_DETECTION)
+        {
+            MPP_LOGE("invalid element %s (expected element DETECTION)\n", elem_name(elem->proc_typ));
+            ret = MPP_INVALID_ELEM;
+            break;
+        }
+        if ((params->detection.decoder != elem->params.detection.decoder)
+                || (params->detection.num_classes != elem->params.detection.num_classes)) {
+            MPP_LOGE("Detection decoder cannot be changed\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        ret = check_detection_params(params);
+        if (ret != MPP_SUCCESS)
+            break;
+
+        elem->params.detection.score_threshold = params->detection.score_threshold;
+        elem->params.detection.iou_threshold = params->detection.iou_threshold;
+        elem->params.detection.max_boxes = params->detection.max_boxes;
+        elem->params.detection.class_agnostic = params->detection.class_agnostic;
+    } while (false);
+
+    return ret;
+}
@@ -23,6 +23,10 @@
 #include "string.h"
 #include "hal.h"
 #include "mpp_debug.h"
+#include "mpp_event.h"
+#include "mpp_buffer.h"
+#include "mpp_cache.h"
+#include "mpp_trace.h"
 
 static inline int display_enqueue(_mpp_t *mpp)
 {
@@ -31,17 +35,23 @@ static inline int display_enqueue(_mpp_t *mpp)
     _display_dev_t *disp = elem->dev.disp;
 
     /* check buffer status */
-    if (elem->io.in_buf[0]->status == MPP_BUFFER_WRITTING)
+    bool owned = mpp_buf_acquire_read(elem->io.in_buf[0]);
+    if (!owned)
     {
         MPP_LOGI("Warning: display may show an uncompleted frame \n");
     }
-    elem->io.in_buf[0]->status = MPP_BUFFER_READING;
 
     /* display current buffer */
+    mpp_cache_before_read(elem->io.in_buf[0], MPP_ACCESS_DEV);
+    MPP_TRACE_EVT(MPP_TRACE_HAL_BEGIN, MPP_TRACE_HAL_DISPLAY, mpp_buf_frame_id(elem->io.in_buf[0]), elem);
     ret = disp->dev.ops->blit(&disp->dev, elem->io.in_buf[0]->hw->addr, elem->io.in_buf[0]->stripe_num);
+    MPP_TRACE_EVT(MPP_TRACE_HAL_END, MPP_TRACE_HAL_DISPLAY, mpp_buf_frame_id(elem->io.in_buf[0]), elem);
+    if (ret == MPP_SUCCESS)
+        mpp_sink_latency(elem);
 
     /* update buffer status */
-    elem->io.in_buf[0]->status = MPP_BUFFER_EMPTY;
+    if (owned)
+        mpp_buf_release_read(elem->io.in_buf[0]);
     return ret;
 }
 
@@ -80,7 +90,7 @@ int mpp_display_add(mpp_t mpp, const char *name, mpp_display_params_t *params)
         return ret;
 
     /* HAL init function */
-    ret = disp->dev.ops->init(&disp->dev, &disp->params, _mpp->params.evt_callback_f, _mpp->params.cb_userdata);
+    ret = disp->dev.ops->init(&disp->dev, &disp->params, mpp_event_notify, _mpp);
     if (ret != MPP_SUCCESS)
         return ret;
 
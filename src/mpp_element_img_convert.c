@@ -23,8 +23,78 @@
 #include "string.h"
 
 #include "mpp_debug.h"
+#include "mpp_event.h"
 #include "hal_graphics_dev.h"
 #include "hal.h"
+#include "mpp_meta.h"
+#include "mpp_buffer.h"
+#include "mpp_trace.h"
+
+void HAL_DCACHE_CleanInvalidateByRange(uint32_t addr, uint32_t size);
+
+/* convert element private context */
+typedef struct {
+    mpp_area_t box;                 /* letterbox output window: image and padding */
+    mpp_convert_transform_t xform;  /* current geometric transform */
+    uint8_t pad[4];                 /* letterbox padding pixel */
+    unsigned int pad_bpp;           /* letterbox padding pixel size */
+} _convert_ctx_t;
+
+/* letterbox padding pixel in the output format, returns its size (0 if not supported) */
+static unsigned int pad_pixel(mpp_pixel_format_t format, uint8_t value, uint8_t pix[4])
+{
+    uint16_t rgb565;
+
+    switch (format)
+    {
+    case MPP_PIXEL_GRAY:
+        pix[0] = value;
+        return 1;
+    case MPP_PIXEL_RGB565:
+        rgb565 = ((value >> 3) << 11) | ((value >> 2) << 5) | (value >> 3);
+        memcpy(pix, &rgb565, sizeof(rgb565));
+        return 2;
+    case MPP_PIXEL_RGB:
+    case MPP_PIXEL_BGR:
+    case MPP_PIXEL_GRAY888:
+        memset(pix, value, 3);
+        return 3;
+    case MPP_PIXEL_GRAY888X:
+        memset(pix, value, 4);
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+/* fill the letterbox window around the image window */
+static void fill_padding(const _convert_ctx_t *ctx, buf_desc_t *obuf, const mpp_area_t *img)
+{
+    uint8_t *row = obuf->hw->addr + ctx->box.top * obuf->hw->stride;
+    unsigned int bpp = ctx->pad_bpp;
+
+    for (int y = ctx->box.top; y <= ctx->box.bottom; y++, row += obuf->hw->stride)
+    {
+        if ((y >= img->top) && (y <= img->bottom))
+        {
+            /* left and right bands only */
+            for (int x = ctx->box.left; x < img->left; x++)
+                memcpy(row + x * bpp, ctx->pad, bpp);
+            for (int x = img->right + 1; x <= ctx->box.right; x++)
+                memcpy(row + x * bpp, ctx->pad, bpp);
+        }
+        else
+        {
+            for (int x = ctx->box.left; x <= ctx->box.right; x++)
+                memcpy(row + x * bpp, ctx->pad, bpp);
+        }
+    }
+
+    /* padding written by the CPU must reach memory before the gfx device writes the image */
+    if (obuf->hw->cacheable)
+        HAL_DCACHE_CleanInvalidateByRange((uint32_t)(obuf->hw->addr + ctx->box.top * obuf->hw->stride),
+                                          (ctx->box.bottom - ctx->box.top + 1) * obuf->hw->stride);
+}
 
 /* element processing function */
 static int convert_func(_elem_t *elem)
@@ -33,6 +103,10 @@ static int convert_func(_elem_t *elem)
     gfx_dev_t *gfx = elem->dev.gfx;
     buf_desc_t *obuf = elem->io.out_buf[0];
     buf_desc_t *ibuf = elem->io.in_buf[0];
+    int top, bottom;
+
+    /* nothing written when the stripe is skipped */
+    elem->io.out_written_len[0] = 0;
 
     /* The value of following parameters are only set after
      * the pipeline graph has been constructed.
@@ -127,9 +201,36 @@ static int convert_func(_elem_t *elem)
     }
     gfx->dst.pitch = obuf->hw->stride;
 
+    if (elem->params.convert.ops & MPP_CONVERT_LETTERBOX)
+    {
+        _convert_ctx_t *ctx = elem->priv;
+
+        /* only the bands around the image are filled */
+        fill_padding(ctx, obuf, &ctx->xform.window);
+
+        /* let downstream elements map positions back to the input frame,
+         * the metadata follows the frame to the output buffer */
+        mpp_meta_add(ibuf, MPP_META_TRANSFORM, elem, &ctx->xform, sizeof(mpp_convert_transform_t));
+    }
+
+    /* output rows written: the image window and the letterbox bands */
+    top = gfx->dst.top;
+    bottom = gfx->dst.bottom;
+    if (elem->params.convert.ops & MPP_CONVERT_LETTERBOX)
+    {
+        _convert_ctx_t *ctx = elem->priv;
+
+        top = (ctx->box.top < top) ? ctx->box.top : top;
+        bottom = (ctx->box.bottom > bottom) ? ctx->box.bottom : bottom;
+    }
+    elem->io.out_written_off[0] = ((uint8_t *)gfx->dst.buf - obuf->hw->addr) + top * obuf->hw->stride;
+    elem->io.out_written_len[0] = (bottom - top + 1) * obuf->hw->stride;
+
     gfx_rotate_config_t rot = { .degree = elem->params.convert.angle, .target = kGFXRotate_DSTSurface};
 
+    MPP_TRACE_EVT(MPP_TRACE_HAL_BEGIN, MPP_TRACE_HAL_GFX, mpp_buf_frame_id(ibuf), elem);
     ret = gfx->ops->blit(gfx, &gfx->src, &gfx->dst, &rot, elem->params.convert.flip);
+    MPP_TRACE_EVT(MPP_TRACE_HAL_END, MPP_TRACE_HAL_GFX, mpp_buf_frame_id(ibuf), elem);
     return ret;
 }
 
@@ -138,6 +239,7 @@ static int check_convert_params(_elem_t *elem)
 {
     int ret = MPP_SUCCESS;
     unsigned int input_width = 0, input_height = 0;
+    _convert_ctx_t *ctx = elem->priv;
 
     /* get input parameters from previous element */
     buf_desc_t *prev_buf = elem->prev->io.out_buf[0];
@@ -193,12 +295,70 @@ static int check_convert_params(_elem_t *elem)
         elem->params.convert.out_window.left = 0;
     }
 
+    /* In case of letterbox, the scaled image keeps the input aspect ratio
+     * and is centered in the window given by struct scale, or in the
+     * output buffer from the output window position.
+     * Scale and output window are then set to the image window.
+     */
+    if (elem->params.convert.ops & MPP_CONVERT_LETTERBOX)
+    {
+        unsigned int box_w, box_h, img_w, img_h;
+        unsigned int in_w = input_width, in_h = input_height;
+
+        if ((elem->params.convert.ops & MPP_CONVERT_ROTATE)
+                && ((elem->params.convert.angle == ROTATE_90) || (elem->params.convert.angle == ROTATE_270)))
+        {   /* rotate swaps dimensions */
+            in_w = input_height;
+            in_h = input_width;
+        }
+        if (elem->params.convert.ops & MPP_CONVERT_SCALE)
+        {
+            box_w = elem->params.convert.scale.width;
+            box_h = elem->params.convert.scale.height;
+        } else {
+            box_w = elem->params.convert.out_buf.width - elem->params.convert.out_window.left;
+            box_h = elem->params.convert.out_buf.height - elem->params.convert.out_window.top;
+        }
+        if ((box_w == 0) || (box_h == 0) || (box_w > elem->params.convert.out_buf.width)
+                || (box_h > elem->params.convert.out_buf.height))
+        {
+            MPP_LOGE("Invalid letterbox window\n");
+            return MPP_INVALID_PARAM;
+        }
+        if (in_w * box_h > in_h * box_w)
+        {   /* horizontal bands */
+            img_w = box_w;
+            img_h = (in_h * box_w + in_w / 2) / in_w;
+        } else {
+            /* vertical bands */
+            img_h = box_h;
+            img_w = (in_w * box_h + in_h / 2) / in_h;
+        }
+        if (img_w == 0) img_w = 1;
+        if (img_h == 0) img_h = 1;
+
+        ctx->box.left = elem->params.convert.out_window.left;
+        ctx->box.top = elem->params.convert.out_window.top;
+        ctx->box.right = ctx->box.left + box_w - 1;
+        ctx->box.bottom = ctx->box.top + box_h - 1;
+        elem->params.convert.out_window.left += (box_w - img_w) / 2;
+        elem->params.convert.out_window.top += (box_h - img_h) / 2;
+        elem->params.convert.scale.width = img_w;
+        elem->params.convert.scale.height = img_h;
+
+        ctx->pad_bpp = pad_pixel(elem->params.convert.pixel_format, elem->params.convert.pad_value, ctx->pad);
+        if (ctx->pad_bpp == 0)
+        {
+            MPP_LOGE("Letterbox padding not supported for pixel format %d\n", elem->params.convert.pixel_format);
+            return MPP_INVALID_PARAM;
+        }
+    }
     /* In case of scaling, dimensions from struct scale
      * should be defined by user.
      * Otherwise, it will be set to:
      * - dims of input window
      */
-    if(!(elem->params.convert.ops & MPP_CONVERT_SCALE))
+    else if(!(elem->params.convert.ops & MPP_CONVERT_SCALE))
     {   /* keep source dimensions */
         if(elem->params.convert.ops & MPP_CONVERT_ROTATE)
         {   /* rotate swaps dimensions */
@@ -235,9 +395,33 @@ static int check_convert_params(_elem_t *elem)
         MPP_LOGE("Invalid output window parameter\n");
         return MPP_INVALID_PARAM;
     }
+
+    /* transform from the input frame to the output buffer */
+    ctx->xform.window.left = elem->params.convert.out_window.left;
+    ctx->xform.window.top = elem->params.convert.out_window.top;
+    ctx->xform.window.right = elem->params.convert.out_window.left + elem->params.convert.scale.width - 1;
+    ctx->xform.window.bottom = elem->params.convert.out_window.top + elem->params.convert.scale.height - 1;
+    if ((elem->params.convert.angle == ROTATE_90) || (elem->params.convert.angle == ROTATE_270))
+    {
+        ctx->xform.scale_x = (float)elem->params.convert.scale.width / input_height;
+        ctx->xform.scale_y = (float)elem->params.convert.scale.height / input_width;
+    } else {
+        ctx->xform.scale_x = (float)elem->params.convert.scale.width / input_width;
+        ctx->xform.scale_y = (float)elem->params.convert.scale.height / input_height;
+    }
+    ctx->xform.offset_x = elem->params.convert.out_window.left - elem->params.convert.crop.left * ctx->xform.scale_x;
+    ctx->xform.offset_y = elem->params.convert.out_window.top - elem->params.convert.crop.top * ctx->xform.scale_y;
+
     return ret;
 }
 
+void mpp_convert_transform(const _elem_t *elem, mpp_convert_transform_t *xform)
+{
+    const _convert_ctx_t *ctx = elem->priv;
+
+    memcpy(xform, &ctx->xform, sizeof(mpp_convert_transform_t));
+}
+
 /* fill-in the gfx source and destination structures */
 static void set_gfx_dev(gfx_dev_t *gfx, _elem_t * elem)
 {
@@ -311,6 +495,15 @@ unsigned int elem_convert_setup(_elem_t *elem)
         memset(gfx, 0, sizeof(gfx_dev_t));
         elem->dev.gfx = gfx;
 
+        elem->priv = hal_malloc(sizeof(_convert_ctx_t));
+        if (elem->priv == NULL)
+        {
+            MPP_LOGE("\nAllocation failed\n");
+            ret = MPP_MALLOC_ERROR;
+            break;
+        }
+        memset(elem->priv, 0, sizeof(_convert_ctx_t));
+
         _mpp_t *mpp = elem->mpp;
         if (!mpp)
         {
@@ -367,6 +560,14 @@ unsigned int elem_convert_setup(_elem_t *elem)
             break;
         }
 
+        if (((elem->io.in_buf[0]->stripe_num > 0) || (elem->io.out_buf[0]->stripe_num > 0))
+                && (elem->params.convert.ops & MPP_CONVERT_LETTERBOX))
+        {
+            MPP_LOGE("\nStripe mode not supported with letterbox.\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+
         if (elem->params.convert.stripe_in && (elem->io.in_buf[0]->stripe_num == 0))
         {
             MPP_LOGE("\nStripe mode not enabled in previous element.\n");
@@ -374,8 +575,8 @@ unsigned int elem_convert_setup(_elem_t *elem)
             break;
         }
 
-        gfx->callback  = mpp->params.evt_callback_f;
-        gfx->user_data = mpp->params.cb_userdata;
+        gfx->callback  = mpp_event_notify;
+        gfx->user_data = mpp;
 
         /* setup HAL gfx structure */
         ret  = hal_gfx_setup(elem->params.convert.dev_name, gfx);
@@ -394,6 +595,9 @@ unsigned int elem_convert_setup(_elem_t *elem)
         /* retrieve buffer requirements from HAL */
         ret = gfx->ops->get_buf_desc(gfx, &elem->io.in_buf[0]->hw_req_cons, &elem->io.out_buf[0]->hw_req_prod, &elem->io.mem_policy);
         if (ret != MPP_SUCCESS) break;
+        /* devices asking for cacheable buffers access them through the CPU */
+        elem->in_access = elem->io.in_buf[0]->hw_req_cons.cacheable ? MPP_ACCESS_CPU : MPP_ACCESS_DEV;
+        elem->out_access = elem->io.out_buf[0]->hw_req_prod.cacheable ? MPP_ACCESS_CPU : MPP_ACCESS_DEV;
 
         /* assign element entry/function */
         elem->entry = convert_func;
@@ -406,6 +610,8 @@ unsigned int elem_convert_setup(_elem_t *elem)
             hal_free(elem->io.out_buf[0]);
         if (gfx != NULL)
             hal_free(gfx);
+        if (elem->priv != NULL)
+            hal_free(elem->priv);
     }
 
     return ret;
@@ -464,6 +670,14 @@ unsigned int mpp_convert_update(_elem_t *elem, mpp_element_params_t *params)
             break;
         }
 
+        if (((elem->io.in_buf[0]->stripe_num > 0) || (elem->io.out_buf[0]->stripe_num > 0))
+                && (elem->params.convert.ops & MPP_CONVERT_LETTERBOX))
+        {
+            MPP_LOGE("\nStripe mode not supported with letterbox.\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+
         /* update gfx source and destination */
         gfx = elem->dev.gfx;
         set_gfx_dev(gfx, elem);
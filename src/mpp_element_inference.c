@@ -17,20 +17,297 @@
  */
 
 #include <string.h>
+#include <stdatomic.h>
 #include "mpp_api.h"
 #include "mpp_api_types_internal.h"
 
 #include "mpp_debug.h"
+#include "mpp_event.h"
+#include "mpp_buffer.h"
+#include "mpp_trace.h"
 #include "hal.h"
 #include "hal_os.h"
 
+/* each model input is read from an input port */
+#if (MPP_INFERENCE_MAX_INPUTS > MAX_INPUT_PORTS)
+#error "MPP_INFERENCE_MAX_INPUTS exceeds the element input ports"
+#endif
+
+/* output pool slot */
+typedef struct {
+    mpp_inference_cb_param_t param;     /* event data delivered to the application */
+    uint8_t *data;                      /* tensors descriptions and copy storage */
+    uint32_t data_size;
+    atomic_bool pending;                /* slot filled, waiting for delivery */
+} _inference_out_slot_t;
+
+/* output pool: the outputs are copied out of the inference arena and the
+ * event is delivered by the events dispatch task, so the next inference is
+ * not delayed by the application post-processing.
+ */
+typedef struct {
+    unsigned int nb_slots;
+    unsigned int wr_idx;    /* next slot filled by the inference */
+    unsigned int dropped;   /* outputs dropped because no slot was free */
+    _inference_out_slot_t slot[MPP_INFERENCE_MAX_OUT_POOL];
+} _inference_out_pool_t;
+
+/* element context */
+typedef struct {
+    _mpp_t *mpp;
+    mpp_inference_cb_param_t *out;  /* outputs of the last inference (arena) */
+    _inference_out_pool_t *pool;    /* NULL: outputs delivered from the arena */
+    const hal_valgo_caps_t *caps;   /* capabilities of the backend */
+    bool async;                     /* the pipeline does not wait for the outputs */
+    bool unsized;                   /* outputs dimensions unknown: the pool is not used */
+} _inference_ctx_t;
+
+/* default pool size when the pipeline has an events queue */
+#define INFERENCE_OUT_POOL_DEFAULT  2
+
+static uint32_t tensor_size(const mpp_inference_tensor_params_t *tensor)
+{
+    uint32_t size = (tensor->type == MPP_TENSOR_TYPE_FLOAT32) ? sizeof(float) :
+                    ((tensor->type == MPP_TENSOR_TYPE_INT16) ? sizeof(int16_t) : 1);
+
+    if (tensor->dims.size == 0)
+        return 0;
+    for (int i = 0; i < tensor->dims.size; i++)
+        size *= tensor->dims.data[i];
+    return size;
+}
+
+/* buffer read on input port 'port': previous element, then joined pipelines */
+static buf_desc_t *inference_port_buf(_elem_t *elem, int port)
+{
+    if (port == 0)
+        return elem->prev->io.out_buf[0];
+    return elem->join[port - 1]->io.out_buf[0];
+}
+
+/* input frames of the model: one per input port */
+static void inference_frames(_elem_t *elem, model_param_t *params)
+{
+    params->num_frames = elem->params.ml_inference.inference_params.num_inputs;
+    for (int i = 0; i < params->num_frames; i++) {
+        buf_desc_t *buf = inference_port_buf(elem, i);
+        params->frames[i].format = buf->format;
+        params->frames[i].height = buf->height;
+        params->frames[i].width = buf->width;
+    }
+}
+
+/* input ports 1.. requirements from HAL, the element owns their buffers as for port 0 */
+static int inference_ports_buf_desc(_elem_t *elem)
+{
+    vision_algo_dev_t *valgo = elem->dev.valgo;
+
+    for (int i = 1; i < elem->io.nb_in_buf; i++) {
+        if ((valgo->ops->get_input_buf_desc == NULL)
+                || (valgo->ops->get_input_buf_desc(valgo, i, &elem->io.in_buf[i]->hw_req_cons) != kStatus_HAL_ValgoSuccess)) {
+            MPP_LOGE("Inference backend cannot read model input %d\n", i);
+            return MPP_ERROR;
+        }
+    }
+    return MPP_SUCCESS;
+}
+
+/* select the inference backend of the model type, or the named one */
+static int inference_backend_setup(vision_algo_dev_t *valgo, const mpp_element_params_t *params,
+                                   const hal_valgo_caps_t **pcaps)
+{
+    const hal_valgo_caps_t *caps;
+
+    if (hal_valgo_setup(valgo, params->ml_inference.type, params->ml_inference.backend, &caps) != 0) {
+        MPP_LOGE("ML inference type %d is not supported\n", params->ml_inference.type);
+        return MPP_INVALID_PARAM;
+    }
+    if ((caps->tensor_orders & (1U << params->ml_inference.tensor_order)) == 0) {
+        MPP_LOGE("Inference backend %s does not support tensor order %d\n", caps->name, params->ml_inference.tensor_order);
+        hal_valgo_release(valgo);
+        return MPP_INVALID_PARAM;
+    }
+    if (params->ml_inference.inference_params.num_inputs > ((caps->max_inputs > 0) ? caps->max_inputs : 1)) {
+        MPP_LOGE("Inference backend %s does not support %d inputs\n", caps->name, params->ml_inference.inference_params.num_inputs);
+        hal_valgo_release(valgo);
+        return MPP_INVALID_PARAM;
+    }
+    MPP_LOGI("Inference backend %s\n", caps->name);
+    *pcaps = caps;
+    return MPP_SUCCESS;
+}
+
+/* check the initialized model against the backend capabilities, the input types are known once initialized */
+static int inference_caps_check(_elem_t *elem, const hal_valgo_caps_t *caps, const model_param_t *params)
+{
+    _inference_ctx_t *ctx = elem->priv;
+    int ret = MPP_SUCCESS;
+
+    if ((params->input_types & ~caps->tensor_types) != 0) {
+        MPP_LOGE("Inference backend %s does not support the model input types (0x%x)\n",
+                 caps->name, (unsigned int)params->input_types);
+        ret = MPP_INVALID_PARAM;
+    }
+    /* a synchronous run() delivers the outputs before returning, an async one later */
+    if (elem->params.ml_inference.async != caps->async) {
+        MPP_LOGE("Inference backend %s %s\n", caps->name, caps->async ?
+                 "runs asynchronously, 'async' must be set" : "does not support asynchronous inference");
+        ret = MPP_INVALID_PARAM;
+    }
+    /* outputs of unknown size cannot be copied: they are delivered from the arena */
+    ctx->unsized = params->outputs_unsized;
+    if (ctx->unsized && elem->params.ml_inference.async) {
+        MPP_LOGE("Inference outputs dimensions are required by asynchronous inference\n");
+        ret = MPP_INVALID_PARAM;
+    } else if (ctx->unsized && (ctx->pool != NULL)) {
+        MPP_LOGI("Inference outputs dimensions unknown, output pool not used\n");
+    }
+    if (ret != MPP_SUCCESS)
+        elem->dev.valgo->ops->deinit(elem->dev.valgo);
+    return ret;
+}
+
+/* called by the dispatch task when the application is done with the slot */
+static void inference_out_slot_release(void *arg)
+{
+    _inference_out_slot_t *slot = arg;
+
+    atomic_store_explicit(&slot->pending, false, memory_order_release);
+}
+
+/* copy the outputs to the pool and queue the event */
+static int inference_out_pool_post(_inference_ctx_t *ctx, mpp_inference_cb_param_t *out)
+{
+    _inference_out_pool_t *pool = ctx->pool;
+    _inference_out_slot_t *slot = &pool->slot[pool->wr_idx];
+    /* tensors descriptions first, then their data */
+    uint32_t desc_size = out->num_outputs * (sizeof(mpp_inference_tensor_params_t *) + sizeof(mpp_inference_tensor_params_t));
+    uint32_t size = desc_size;
+    int i;
+
+    if (atomic_load_explicit(&slot->pending, memory_order_acquire)) {
+        /* application is late: all slots are waiting for delivery */
+        pool->dropped++;
+        MPP_LOGI_IF(RLMT_CHECK(1), "Inference outputs dropped: %d\n", pool->dropped);
+        return MPP_SUCCESS;
+    }
+
+    for (i = 0; i < out->num_outputs; i++) {
+        uint32_t tsize = tensor_size(out->out_tensors[i]);
+        if (tsize == 0) {
+            /* output size unknown, cannot copy: deliver from the arena */
+            MPP_LOGE_IF(RLMT_CHECK(1), "Output tensor %d size unknown, delivering outputs synchronously\n", i);
+            return mpp_event_post(ctx->mpp, MPP_EVENT_INFERENCE_OUTPUT_READY, out, NULL, NULL);
+        }
+        size += tsize;
+    }
+
+    /* (re)allocate the slot storage on first use or model change */
+    if (slot->data_size < size) {
+        if (slot->data != NULL)
+            hal_free(slot->data);
+        slot->data = hal_malloc(size);
+        if (slot->data == NULL) {
+            slot->data_size = 0;
+            MPP_LOGE("Inference output pool allocation failed\n");
+            return MPP_MALLOC_ERROR;
+        }
+        slot->data_size = size;
+    }
+
+    /* copy the outputs */
+    memcpy(&slot->param, out, sizeof(mpp_inference_cb_param_t));
+    slot->param.out_tensors = (mpp_inference_tensor_params_t **)slot->data;
+    mpp_inference_tensor_params_t *tensors = (mpp_inference_tensor_params_t *)(slot->param.out_tensors + out->num_outputs);
+    size = desc_size;
+    for (i = 0; i < out->num_outputs; i++) {
+        memcpy(&tensors[i], out->out_tensors[i], sizeof(mpp_inference_tensor_params_t));
+        memcpy(slot->data + size, out->out_tensors[i]->data, tensor_size(out->out_tensors[i]));
+        tensors[i].data = slot->data + size;
+        slot->param.out_tensors[i] = &tensors[i];
+        size += tensor_size(out->out_tensors[i]);
+    }
+
+    atomic_store_explicit(&slot->pending, true, memory_order_release);
+    pool->wr_idx = (pool->wr_idx + 1) % pool->nb_slots;
+
+    return mpp_event_post(ctx->mpp, MPP_EVENT_INFERENCE_OUTPUT_READY, &slot->param,
+                          inference_out_slot_release, slot);
+}
+
+/* callback installed in the HAL in place of the application's one */
+static int inference_out_cb(mpp_t mpp, mpp_evt_t evt, void *evt_data, void *user_data)
+{
+    _inference_ctx_t *ctx = user_data;
+
+    if (evt != MPP_EVENT_INFERENCE_OUTPUT_READY)
+        return mpp_event_post(ctx->mpp, evt, evt_data, NULL, NULL);
+
+    /* keep the outputs for the post-processing elements, unless they no longer match the frame */
+    if (!ctx->async)
+        ctx->out = evt_data;
+
+    /* outputs are copied for the application only if it reads them */
+    if ((ctx->pool != NULL) && !ctx->unsized && mpp_event_subscribed(ctx->mpp, evt))
+        return inference_out_pool_post(ctx, evt_data);
+    return mpp_event_post(ctx->mpp, evt, evt_data, NULL, NULL);
+}
+
+const mpp_inference_cb_param_t *mpp_inference_get_outputs(_elem_t *elem)
+{
+    _inference_ctx_t *ctx = elem->priv;
+
+    if ((elem->proc_typ != MPP_ELEMENT_INFERENCE) || (ctx == NULL))
+        return NULL;
+    return ctx->out;
+}
+
+static unsigned int inference_out_pool_create(_elem_t *elem, _inference_ctx_t *ctx)
+{
+    _inference_out_pool_t *pool;
+    unsigned int nb_slots = elem->params.ml_inference.out_pool_size;
+    int ret;
+
+    if (nb_slots == 0)
+        nb_slots = INFERENCE_OUT_POOL_DEFAULT;
+    if (nb_slots > MPP_INFERENCE_MAX_OUT_POOL) {
+        MPP_LOGE("Inference output pool size cannot exceed %d\n", MPP_INFERENCE_MAX_OUT_POOL);
+        return MPP_INVALID_PARAM;
+    }
+
+    /* the pool is useless without asynchronous delivery */
+    ret = mpp_event_queue_create(elem->mpp, nb_slots);
+    if (ret != MPP_SUCCESS) {
+        MPP_LOGE("Failed to create events queue\n");
+        return ret;
+    }
+
+    pool = hal_malloc(sizeof(_inference_out_pool_t));
+    if (pool == NULL) {
+        MPP_LOGE("malloc failed for inference output pool\n");
+        return MPP_MALLOC_ERROR;
+    }
+    memset(pool, 0, sizeof(_inference_out_pool_t));
+    pool->nb_slots = nb_slots;
+    for (int i = 0; i < nb_slots; i++)
+        atomic_init(&pool->slot[i].pending, false);
+    ctx->pool = pool;
+
+    return MPP_SUCCESS;
+}
+
 /* element processing function */
 static int inference_func(_elem_t *elem)
 {
     int ret;
 
     /* data seems not to be used */
+    MPP_TRACE_EVT(MPP_TRACE_HAL_BEGIN, MPP_TRACE_HAL_INFERENCE, mpp_buf_frame_id(elem->io.in_buf[0]), elem);
     ret = elem->dev.valgo->ops->run(elem->dev.valgo, NULL);
+    MPP_TRACE_EVT(MPP_TRACE_HAL_END, MPP_TRACE_HAL_INFERENCE, mpp_buf_frame_id(elem->io.in_buf[0]), elem);
+    /* outputs have been delivered */
+    if ((ret == MPP_SUCCESS) && !((_inference_ctx_t *)elem->priv)->async && (elem->mpp->c2r_hist != NULL))
+        mpp_hist_record(elem->mpp->c2r_hist, hal_get_time_us() - elem->io.in_buf[0]->capture_ts);
     return ret;
 }
 
@@ -39,6 +316,7 @@ unsigned int elem_inference_setup(_elem_t *elem)
 {
     unsigned int ret = MPP_SUCCESS;
     vision_algo_dev_t *valgo = NULL;
+    _inference_ctx_t *ctx = NULL;
 
     do {
         /* sanity checks */
@@ -53,23 +331,24 @@ unsigned int elem_inference_setup(_elem_t *elem)
             ret = MPP_INVALID_PARAM;
             break;
         }
-        /* Check the number of inputs and outputs */
-        if (elem->params.ml_inference.inference_params.num_outputs > MPP_INFERENCE_MAX_OUTPUTS )
+        /* Check the number of inputs: one input port each, outputs are checked by the backend */
+        if (elem->params.ml_inference.inference_params.num_inputs > MPP_INFERENCE_MAX_INPUTS )
         {
-            MPP_LOGE("Inference does not support more than %d outputs\n", MPP_INFERENCE_MAX_OUTPUTS);
+            MPP_LOGE("Inference does not support more than %d inputs\n", MPP_INFERENCE_MAX_INPUTS);
             ret = MPP_INVALID_PARAM;
             break;
         }
-        if (elem->params.ml_inference.inference_params.num_inputs > MPP_INFERENCE_MAX_INPUTS )
+        if ((elem->params.ml_inference.inference_params.num_inputs == 0)
+                || (elem->params.ml_inference.inference_params.num_outputs < 0))
         {
-            MPP_LOGE("Inference does not support more than %d inputs\n", MPP_INFERENCE_MAX_INPUTS);
+            MPP_LOGE("Inference requires at least one input tensor\n");
             ret = MPP_INVALID_PARAM;
             break;
         }
-        if ((elem->params.ml_inference.inference_params.num_inputs == 0)
-                || (elem->params.ml_inference.inference_params.num_outputs == 0))
+        if (elem->params.ml_inference.inference_params.num_inputs != elem->join_cnt + 1)
         {
-            MPP_LOGE("Inference requires at least one input and one output tensor\n");
+            MPP_LOGE("Inference with %d inputs reads %d input ports, see mpp_join()\n",
+                    elem->params.ml_inference.inference_params.num_inputs, elem->join_cnt + 1);
             ret = MPP_INVALID_PARAM;
             break;
         }
@@ -103,23 +382,10 @@ unsigned int elem_inference_setup(_elem_t *elem)
         memset(valgo, 0, sizeof(vision_algo_dev_t));
         elem->dev.valgo = valgo;
 
-#ifndef EMULATOR
-        mpp_inference_type_t inference_type = elem->params.ml_inference.type;
-        switch (inference_type)
-        {
-        case MPP_INFERENCE_TYPE_TFLITE:
-            ret = hal_inference_tflite_setup(valgo);
-            break;
-        default:
-            MPP_LOGE ("ML inference type %d is not supported\n", inference_type);
-            ret = MPP_INVALID_PARAM;
+        const hal_valgo_caps_t *caps;
+        ret = inference_backend_setup(valgo, &elem->params, &caps);
+        if (ret != MPP_SUCCESS)
             break;
-        }
-        if (ret != MPP_SUCCESS) {
-            MPP_LOGE ("Setup HAL inference fails with ret=%d\n", ret);
-            break;
-        }
-#endif
 
         model_param_t params;
         memset(&params, 0, sizeof(model_param_t));
@@ -127,16 +393,39 @@ unsigned int elem_inference_setup(_elem_t *elem)
         params.model_size = elem->params.ml_inference.model_size;
         params.model_input_mean = elem->params.ml_inference.model_input_mean;
         params.model_input_std = elem->params.ml_inference.model_input_std;
-        params.evt_callback_f = mpp->params.evt_callback_f;
-        params.cb_userdata = mpp->params.cb_userdata;
+        memcpy(params.model_input_ch_mean, elem->params.ml_inference.model_input_ch_mean, sizeof(params.model_input_ch_mean));
+        memcpy(params.model_input_ch_std, elem->params.ml_inference.model_input_ch_std, sizeof(params.model_input_ch_std));
         params.tensor_order = elem->params.ml_inference.tensor_order;
         memcpy(&params.inference_params,
                         &elem->params.ml_inference.inference_params,sizeof(mpp_inference_params_t));
 
+        /* element context receives the outputs */
+        ctx = hal_malloc(sizeof(_inference_ctx_t));
+        if (ctx == NULL) {
+            MPP_LOGE("malloc failed for inference context\n");
+            ret = MPP_MALLOC_ERROR;
+            break;
+        }
+        memset(ctx, 0, sizeof(_inference_ctx_t));
+        ctx->mpp = mpp;
+        ctx->caps = caps;
+        ctx->async = elem->params.ml_inference.async;
+        elem->priv = ctx;
+        params.evt_callback_f = inference_out_cb;
+        params.cb_userdata = ctx;
+
+        /* outputs are delivered through the output pool */
+        if ((elem->params.ml_inference.out_pool_size > 0) || (mpp->evt_queue != NULL)) {
+            ret = inference_out_pool_create(elem, ctx);
+            if (ret != MPP_SUCCESS)
+                break;
+        }
+
 		/*Get resolution parameters from previous element*/
         params.format = prev_buf->format;
         params.height = prev_buf->height;
         params.width = prev_buf->width;
+        inference_frames(elem, &params);
 
         /* init HAL function */
         hal_valgo_status_t algoret = kStatus_HAL_ValgoSuccess;
@@ -146,12 +435,19 @@ unsigned int elem_inference_setup(_elem_t *elem)
             MPP_LOGE ("HAL inference init() fails with ret=%d\n", algoret);
             ret = MPP_ERROR;
         }
+        else
+        {
+            ret = inference_caps_check(elem, caps, &params);
+            if (ret != MPP_SUCCESS)
+                break;
+        }
 
         /* set operating mode */
         elem->io.inplace = true;
-        /* get input buffer from previous element */
-        elem->io.nb_in_buf = 1;
-        elem->io.in_buf[0] = prev_buf;
+        /* get input buffers from previous element and joined pipelines */
+        elem->io.nb_in_buf = elem->params.ml_inference.inference_params.num_inputs;
+        for (int i = 0; i < elem->io.nb_in_buf; i++)
+            elem->io.in_buf[i] = inference_port_buf(elem, i);
         /* create output buffer parameters to be passed to next element */
         elem->io.nb_out_buf = 1;
         elem->io.out_buf[0] = hal_malloc(sizeof(buf_desc_t));
@@ -170,17 +466,32 @@ unsigned int elem_inference_setup(_elem_t *elem)
         /* retrieve buffer requirements from HAL */
         valgo->ops->get_buf_desc(valgo, &elem->io.in_buf[0]->hw_req_cons,
                                  &elem->io.mem_policy);
+        if ((ret == MPP_SUCCESS) && (inference_ports_buf_desc(elem) != MPP_SUCCESS)) {
+            ret = MPP_ERROR;
+            break;
+        }
         /* copy consumer requirement into producer requirement */
         memcpy(&elem->io.out_buf[0]->hw_req_prod, &elem->io.in_buf[0]->hw_req_cons,
                sizeof(hw_buf_desc_t));
+        /* the engine asking for a cacheable input reads it through the CPU */
+        elem->in_access = elem->io.in_buf[0]->hw_req_cons.cacheable ? MPP_ACCESS_CPU : MPP_ACCESS_DEV;
+        elem->out_access = MPP_ACCESS_NONE;
 
     } while (false);
 
     if (ret != MPP_SUCCESS) {
         if ( (elem != NULL) && (elem->io.out_buf[0] != NULL) )
             hal_free(elem->io.out_buf[0]);
-        if (valgo != NULL)
+        if (valgo != NULL) {
+            hal_valgo_release(valgo);
             hal_free(valgo);
+        }
+        if (ctx != NULL) {
+            if (ctx->pool != NULL)
+                hal_free(ctx->pool);
+            hal_free(ctx);
+            elem->priv = NULL;
+        }
     }
 
     return ret;
@@ -190,6 +501,7 @@ uint32_t mpp_inference_update(_elem_t *elem, mpp_element_params_t *params)
 {
     unsigned int ret = MPP_SUCCESS;
     vision_algo_dev_t *valgo = NULL;
+    _inference_ctx_t *ctx = NULL;
 
     do {
         /* sanity checks */
@@ -211,23 +523,16 @@ uint32_t mpp_inference_update(_elem_t *elem, mpp_element_params_t *params)
             ret = MPP_INVALID_PARAM;
             break;
         }
-        /* Check the number of inputs and outputs */
-        if (params->ml_inference.inference_params.num_outputs > MPP_INFERENCE_MAX_OUTPUTS )
-        {
-            MPP_LOGE("Inference does not support more than %d outputs\n", MPP_INFERENCE_MAX_OUTPUTS);
-            ret = MPP_INVALID_PARAM;
-            break;
-        }
-        if (params->ml_inference.inference_params.num_inputs > MPP_INFERENCE_MAX_INPUTS )
+        /* Check the number of inputs: the input ports are set when the pipeline is built */
+        if (params->ml_inference.inference_params.num_inputs != elem->io.nb_in_buf)
         {
-            MPP_LOGE("Inference does not support more than %d inputs\n", MPP_INFERENCE_MAX_INPUTS);
+            MPP_LOGE("Inference reads %d input ports, the model must have as many inputs\n", elem->io.nb_in_buf);
             ret = MPP_INVALID_PARAM;
             break;
         }
-        if ((params->ml_inference.inference_params.num_inputs == 0)
-                || (params->ml_inference.inference_params.num_outputs == 0))
+        if (params->ml_inference.inference_params.num_outputs < 0)
         {
-            MPP_LOGE("Inference requires at least one input and one output tensor\n");
+            MPP_LOGE("Invalid number of output tensors\n");
             ret = MPP_INVALID_PARAM;
             break;
         }
@@ -264,6 +569,12 @@ uint32_t mpp_inference_update(_elem_t *elem, mpp_element_params_t *params)
             break;
         }
 
+        /* switching the backend, e.g. to compare runtimes on the same model */
+        bool new_backend = (params->ml_inference.type != elem->params.ml_inference.type)
+                || ((params->ml_inference.backend != NULL) != (elem->params.ml_inference.backend != NULL))
+                || ((params->ml_inference.backend != NULL)
+                        && (strcmp(params->ml_inference.backend, elem->params.ml_inference.backend) != 0));
+
         memcpy(&elem->params, params, sizeof(mpp_element_params_t));
 
         model_param_t hal_params;
@@ -272,17 +583,24 @@ uint32_t mpp_inference_update(_elem_t *elem, mpp_element_params_t *params)
         hal_params.model_size = elem->params.ml_inference.model_size;
         hal_params.model_input_mean = elem->params.ml_inference.model_input_mean;
         hal_params.model_input_std = elem->params.ml_inference.model_input_std;
-        hal_params.evt_callback_f = mpp->params.evt_callback_f;
-        hal_params.cb_userdata = mpp->params.cb_userdata;
+        memcpy(hal_params.model_input_ch_mean, elem->params.ml_inference.model_input_ch_mean, sizeof(hal_params.model_input_ch_mean));
+        memcpy(hal_params.model_input_ch_std, elem->params.ml_inference.model_input_ch_std, sizeof(hal_params.model_input_ch_std));
         hal_params.tensor_order = elem->params.ml_inference.tensor_order;
         memcpy(&hal_params.inference_params,
                 &elem->params.ml_inference.inference_params,
                 sizeof(mpp_inference_params_t));
 
+        /* the output pool created at setup is kept, slots are resized on next output */
+        hal_params.evt_callback_f = inference_out_cb;
+        hal_params.cb_userdata = elem->priv;
+        ctx = elem->priv;
+        ctx->out = NULL;
+
         /*Get resolution parameters from previous element*/
         hal_params.format = prev_buf->format;
         hal_params.height = prev_buf->height;
         hal_params.width = prev_buf->width;
+        inference_frames(elem, &hal_params);
 
         /* init HAL function */
         valgo = elem->dev.valgo;
@@ -294,6 +612,13 @@ uint32_t mpp_inference_update(_elem_t *elem, mpp_element_params_t *params)
             ret = MPP_ERROR;
             break;
         }
+        if (new_backend) {
+            hal_valgo_release(valgo);
+            ret = inference_backend_setup(valgo, &elem->params, &ctx->caps);
+            if (ret != MPP_SUCCESS)
+                break;
+        }
+        ctx->async = elem->params.ml_inference.async;
         algoret = valgo->ops->init(valgo, &hal_params);
         if (algoret != kStatus_HAL_ValgoSuccess)
         {
@@ -301,27 +626,39 @@ uint32_t mpp_inference_update(_elem_t *elem, mpp_element_params_t *params)
             ret = MPP_ERROR;
             break;
         }
+        ret = inference_caps_check(elem, ctx->caps, &hal_params);
+        if (ret != MPP_SUCCESS)
+            break;
 
         /* update buffer requirements from HAL */
         valgo->ops->get_buf_desc(valgo, &elem->io.in_buf[0]->hw_req_cons,
                                  &elem->io.mem_policy);
-
-        /* check if new res < prev res */
-        if (elem->io.in_buf[0]->hw_req_cons.nb_lines != prev_buf->hw->nb_lines)
+        if (inference_ports_buf_desc(elem) != MPP_SUCCESS)
         {
-            MPP_LOGE ("Input buffer height (%d) does not match model height (%d)\r\n",
-                    prev_buf->hw->nb_lines,
-                    elem->io.in_buf[0]->hw_req_cons.nb_lines);
             ret = MPP_ERROR;
             break;
         }
-        if (elem->io.in_buf[0]->hw_req_cons.stride != prev_buf->hw->stride)
+
+        /* check if new res < prev res */
+        for (int i = 0; i < elem->io.nb_in_buf; i++)
         {
-            MPP_LOGE ("Input buffer stride (%d) does not match model stride (%d)\r\n",
-                    prev_buf->hw->stride,
-                    elem->io.in_buf[0]->hw_req_cons.stride);
-            ret = MPP_ERROR;
-            break;
+            buf_desc_t *port_buf = elem->io.in_buf[i];
+            if (elem->io.in_buf[i]->hw_req_cons.nb_lines != port_buf->hw->nb_lines)
+            {
+                MPP_LOGE ("Input buffer#%d height (%d) does not match model height (%d)\r\n", i,
+                        port_buf->hw->nb_lines,
+                        elem->io.in_buf[i]->hw_req_cons.nb_lines);
+                ret = MPP_ERROR;
+                break;
+            }
+            if (elem->io.in_buf[i]->hw_req_cons.stride != port_buf->hw->stride)
+            {
+                MPP_LOGE ("Input buffer#%d stride (%d) does not match model stride (%d)\r\n", i,
+                        port_buf->hw->stride,
+                        elem->io.in_buf[i]->hw_req_cons.stride);
+                ret = MPP_ERROR;
+                break;
+            }
         }
 
     } while (false);
@@ -329,8 +666,10 @@ uint32_t mpp_inference_update(_elem_t *elem, mpp_element_params_t *params)
     if (ret != MPP_SUCCESS) {
         if ( (elem != NULL) && (elem->io.out_buf[0] != NULL) )
             hal_free(elem->io.out_buf[0]);
-        if (valgo != NULL)
+        if (valgo != NULL) {
+            hal_valgo_release(valgo);
             hal_free(valgo);
+        }
     }
 
     return ret;
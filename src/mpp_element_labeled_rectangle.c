@@ -23,13 +23,119 @@
 #include "string.h"
 
 #include "mpp_debug.h"
+#include "mpp_meta.h"
 #include "hal.h"
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <limits.h>
 
 static hal_mutex_t mutex;
 static mpp_labeled_rect_t *labeled_rectangles = NULL;
 static mpp_labeled_rect_t *labeled_rectangles_new = NULL;
+/* boxes of the frame metadata, copied as the frame may be recycled while drawing */
+static mpp_detections_t meta_boxes;
+
+/* boxes of up to this number of previous frames are drawn */
+#define META_BOXES_MAX_AGE  3
+
+/* height of the label text drawn from the rectangle top (FONT_YSize of hal_draw) */
+#define LABEL_TEXT_HEIGHT   16
+
+static inline int clamp(int v, int min, int max)
+{
+    return (v < min) ? min : ((v > max) ? max : v);
+}
+
+/* extend the rows written [*top, *bottom] with a rectangle and its label */
+static void add_written_rows(const mpp_labeled_rect_t *lr, int *top, int *bottom)
+{
+    int lr_bottom = (lr->bottom > lr->top + LABEL_TEXT_HEIGHT - 1) ? lr->bottom : lr->top + LABEL_TEXT_HEIGHT - 1;
+
+    *top = (lr->top < *top) ? lr->top : *top;
+    *bottom = (lr_bottom > *bottom) ? lr_bottom : *bottom;
+}
+
+/* report the rows written to the cache maintenance, in buffer (stripe) coordinates */
+static void set_written_rows(_elem_t *elem, int top, int bottom)
+{
+    buf_desc_t *buf = elem->io.out_buf[0];
+    int height = buf->height;
+
+    if (buf->stripe_num > 0) {
+        height = buf->height / MPP_STRIPE_NUM;
+        top -= (buf->stripe_num - 1) * height;
+        bottom -= (buf->stripe_num - 1) * height;
+    }
+    top = (top < 0) ? 0 : top;
+    bottom = (bottom >= height) ? height - 1 : bottom;
+    if (top > bottom) {
+        elem->io.out_written_len[0] = 0;
+        return;
+    }
+    elem->io.out_written_off[0] = top * buf->hw->stride;
+    elem->io.out_written_len[0] = (bottom - top + 1) * buf->hw->stride;
+}
+
+/* draw the boxes found in the frame metadata */
+static int label_meta_boxes (_elem_t *elem, int *top, int *bottom)
+{
+    int ret = MPP_SUCCESS;
+    buf_desc_t *buf = elem->io.in_buf[0];
+    const mpp_detections_t *det = &meta_boxes;
+    mpp_labeled_rect_t lr;
+    int win_w, win_h, len;
+    size_t size;
+    int count;
+
+    size = mpp_meta_copy(buf, MPP_META_DETECTIONS, NULL, META_BOXES_MAX_AGE, &meta_boxes, sizeof(meta_boxes));
+    if ((size < offsetof(mpp_detections_t, boxes)) || (det->width == 0) || (det->height == 0))
+        return ret;
+    /* only the boxes present in the entry */
+    count = (size - offsetof(mpp_detections_t, boxes)) / sizeof(mpp_detection_box_t);
+    if (count > (int)det->count)
+        count = det->count;
+    if (count > MPP_DETECTION_MAX_BOXES)
+        count = MPP_DETECTION_MAX_BOXES;
+    /* letterbox padding of the model input is not part of the frame */
+    win_w = det->window.right - det->window.left + 1;
+    win_h = det->window.bottom - det->window.top + 1;
+    if ((win_w <= 0) || (win_h <= 0))
+        return ret;
+
+    memset(&lr, 0, sizeof(lr));
+    lr.line_color = elem->params.labels.meta_color;
+    lr.line_width = elem->params.labels.meta_line_width;
+    lr.tag = MPP_LBL_RECT_TAG;
+    for (int idx = 0; idx < count; idx++) {
+        const mpp_detection_box_t *box = &det->boxes[idx];
+
+        /* boxes are in detection coordinates space */
+        lr.left = clamp((box->left - det->window.left) * (int)buf->width / win_w, 0, buf->width - 1);
+        lr.right = clamp((box->right - det->window.left) * (int)buf->width / win_w, 0, buf->width - 1);
+        lr.top = clamp((box->top - det->window.top) * (int)buf->height / win_h, 0, buf->height - 1);
+        lr.bottom = clamp((box->bottom - det->window.top) * (int)buf->height / win_h, 0, buf->height - 1);
+        if (elem->params.labels.meta_labels != NULL)
+            len = snprintf((char *)lr.label, sizeof(lr.label), "%s %d%%",
+                           elem->params.labels.meta_labels[box->label], (int)(box->score * 100));
+        else
+            len = snprintf((char *)lr.label, sizeof(lr.label), "%d %d%%", box->label, (int)(box->score * 100));
+        /* tracked boxes */
+        if ((box->id >= 0) && (len > 0) && (len < (int)sizeof(lr.label)))
+            snprintf((char *)lr.label + len, sizeof(lr.label) - len, " #%d", box->id);
+
+        add_written_rows(&lr, top, bottom);
+        ret = hal_label_rectangle (buf->hw->addr, buf->width, buf->height, buf->format,
+                                   &lr, buf->stripe_num, MPP_STRIPE_NUM);
+        if (ret != MPP_SUCCESS) {
+            MPP_LOGE ("mpp_labeled_rectangle metadata box %d failed !\n", idx);
+            break;
+        }
+    }
+
+    return ret;
+}
 
 /* element processing function */
 static int label_rectangle_func (_elem_t *elem)
@@ -37,6 +143,7 @@ static int label_rectangle_func (_elem_t *elem)
     int ret = MPP_SUCCESS;
     mpp_labeled_rect_t *lr = labeled_rectangles;
     mpp_labeled_rect_t *new_lr = labeled_rectangles_new;
+    int top = INT_MAX, bottom = -1;    /* rows written */
 
     do {
         /** swap new rectangles */
@@ -46,7 +153,7 @@ static int label_rectangle_func (_elem_t *elem)
             break;
         }
         /* check if an update occured */
-        if (new_lr[0].tag == MPP_LBL_RECT_TAG) {
+        if ((new_lr != NULL) && (new_lr[0].tag == MPP_LBL_RECT_TAG)) {
             /* new rectangles detected */
             memcpy(labeled_rectangles, labeled_rectangles_new,
                    sizeof(mpp_labeled_rect_t) * elem->params.labels.detected_count);
@@ -74,6 +181,7 @@ static int label_rectangle_func (_elem_t *elem)
             }
             /* if clear is set then rectangle should not be drawn */
             if (lr[idx].clear == 0UL) {
+                add_written_rows(&lr[idx], &top, &bottom);
                 ret = hal_label_rectangle (
                         elem->io.in_buf[0]->hw->addr,
                         elem->io.in_buf[0]->width,
@@ -92,7 +200,10 @@ static int label_rectangle_func (_elem_t *elem)
             MPP_LOGE("%s: return error %d\n", __func__, ret);
             break;
         }
+        if (elem->params.labels.from_meta)
+            ret = label_meta_boxes(elem, &top, &bottom);
     } while (false);
+    set_written_rows(elem, top, bottom);
 
     return ret;
 }
@@ -134,6 +245,9 @@ unsigned int elem_lbl_rct_setup (_elem_t *elem)
         elem->io.nb_out_buf = 1;
         /* element process in-place: means input & output point to same buffer */
         elem->io.out_buf[0] = elem->io.in_buf[0];
+        /* boxes are drawn by the CPU */
+        elem->in_access = MPP_ACCESS_CPU;
+        elem->out_access = MPP_ACCESS_CPU;
 
         if (elem->params.labels.detected_count > elem->params.labels.max_count) {
             ret = MPP_INVALID_PARAM;
@@ -144,7 +258,9 @@ unsigned int elem_lbl_rct_setup (_elem_t *elem)
         /* allocate global buffer */
         labeled_rectangles = hal_malloc(sizeof(mpp_labeled_rect_t) * elem->params.labels.max_count);
         labeled_rectangles_new = hal_malloc(sizeof(mpp_labeled_rect_t) * elem->params.labels.max_count);
-        if (labeled_rectangles == NULL || labeled_rectangles_new == NULL) {
+        /* no rectangle is needed when drawing boxes from metadata only */
+        if ((elem->params.labels.max_count > 0)
+                && (labeled_rectangles == NULL || labeled_rectangles_new == NULL)) {
             ret = MPP_MALLOC_ERROR;
             MPP_LOGE ("ERR: malloc failed for labeled_rectangles\n");
             break;
@@ -158,6 +274,15 @@ unsigned int elem_lbl_rct_setup (_elem_t *elem)
             labeled_rectangles[idx].tag = MPP_LBL_RECT_TAG;
         }
 
+        /* boxes of the upstream DETECTION elements come with the frames */
+        if (elem->params.labels.from_meta) {
+            ret = mpp_meta_enable(elem);
+            if (ret != MPP_SUCCESS) {
+                MPP_LOGE("ERR: no metadata for the labeled rectangles\n");
+                break;
+            }
+        }
+
         /* assign element entry/function */
         elem->entry = label_rectangle_func;
 
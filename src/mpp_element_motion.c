@@ -0,0 +1,387 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Motion gate element: the next processing elements of its branch skip the frames
+ * without motion, the sink of the branch still receives them.
+ *
+ * The frame is sampled into a small grayscale thumbnail which is compared to
+ * a background: the previous thumbnail, or a running average of the previous
+ * thumbnails. Motion is detected when enough pixels of the ROI mask changed
+ * more than a threshold. Comparison and background update process four
+ * thumbnail pixels per instruction on cores with the 32-bit SIMD extension.
+ * Frames are passed while motion lasts, for a few frames after it stops, and
+ * periodically to refresh the downstream results.
+ */
+
+#include <string.h>
+#include "mpp_api.h"
+#include "mpp_api_types_internal.h"
+
+#include "mpp_debug.h"
+#include "mpp_buffer.h"
+#include "hal_os.h"
+#include "hal_utils.h"
+
+#ifdef MPP_MOTION_SIMD
+#include <arm_acle.h>
+#endif
+
+#define MOTION_THUMB_WIDTH      32
+#define MOTION_THUMB_HEIGHT     24
+#define MOTION_THUMB_MAX        128
+#define MOTION_MAX_SHIFT        7
+/* samples averaged per thumbnail pixel, per direction */
+#define MOTION_SAMPLES          2
+
+typedef struct {
+    unsigned int width;         /* thumbnail */
+    unsigned int height;
+    unsigned int stride;        /* multiple of 4 */
+    uint32_t *xoff;             /* byte offset of the luminance samples in a line */
+    uint32_t *yline;            /* line of the samples */
+    uint8_t *cur;               /* thumbnail of the current frame */
+    uint8_t *bg;                /* background */
+    uint8_t *mask;              /* 1 for the monitored pixels, 0 otherwise */
+    unsigned int min_changed;   /* changed pixels detecting motion */
+    unsigned int hold;          /* frames left to pass after motion */
+    unsigned int since_pass;    /* frames gated since the last passed frame */
+    bool init;                  /* background is valid */
+} _motion_ctx_t;
+
+/* luminance approximation of the pixel at 'p' */
+static inline uint8_t luma(const uint8_t *p, mpp_pixel_format_t format)
+{
+    uint16_t rgb565;
+
+    switch (format)
+    {
+    case MPP_PIXEL_RGB:
+    case MPP_PIXEL_BGR:
+    case MPP_PIXEL_GRAY888:
+    case MPP_PIXEL_GRAY888X:
+        return (p[0] + 2 * p[1] + p[2]) >> 2;
+    case MPP_PIXEL_RGB565:
+        memcpy(&rgb565, p, sizeof(rgb565));
+        return (((rgb565 >> 11) << 3) + ((rgb565 >> 5) & 0x3f) * 8 + ((rgb565 & 0x1f) << 3)) >> 2;
+    default:
+        /* gray and YUV: sample offset points to the luminance */
+        return p[0];
+    }
+}
+
+/* byte offset of the luminance of pixel 'x' in a line, -1 if not supported */
+static int luma_offset(mpp_pixel_format_t format, unsigned int x)
+{
+    switch (format)
+    {
+    case MPP_PIXEL_GRAY:
+        return x;
+    case MPP_PIXEL_RGB565:
+        return 2 * x;
+    case MPP_PIXEL_RGB:
+    case MPP_PIXEL_BGR:
+    case MPP_PIXEL_GRAY888:
+        return 3 * x;
+    case MPP_PIXEL_GRAY888X:
+        return 4 * x;
+    case MPP_PIXEL_UYVY1P422:
+    case MPP_PIXEL_VYUY1P422:
+        return 2 * x + 1;
+    case MPP_PIXEL_YUYV:
+        return 2 * x;
+    case MPP_PIXEL_YUV1P444:
+        return 4 * x + 2;
+    default:
+        return -1;
+    }
+}
+
+/* sample the frame into the current thumbnail */
+static void make_thumbnail(_motion_ctx_t *ctx, const buf_desc_t *buf)
+{
+    const uint8_t *addr = buf->hw->addr;
+    unsigned int stride = buf->hw->stride;
+
+    for (unsigned int y = 0; y < ctx->height; y++) {
+        uint8_t *out = ctx->cur + y * ctx->stride;
+        const uint8_t *l0 = addr + ctx->yline[MOTION_SAMPLES * y] * stride;
+        const uint8_t *l1 = addr + ctx->yline[MOTION_SAMPLES * y + 1] * stride;
+
+        for (unsigned int x = 0; x < ctx->width; x++) {
+            uint32_t x0 = ctx->xoff[MOTION_SAMPLES * x];
+            uint32_t x1 = ctx->xoff[MOTION_SAMPLES * x + 1];
+
+            out[x] = (luma(l0 + x0, buf->format) + luma(l0 + x1, buf->format)
+                      + luma(l1 + x0, buf->format) + luma(l1 + x1, buf->format) + 2) >> 2;
+        }
+    }
+}
+
+unsigned int mpp_motion_compare_ref(const uint8_t *cur, uint8_t *bg, const uint8_t *mask,
+                                    unsigned int size, uint8_t thr, unsigned int shift)
+{
+    unsigned int changed = 0;
+
+    for (unsigned int i = 0; i < size; i++) {
+        int d = cur[i] - bg[i];
+        unsigned int b = cur[i];
+
+        if (((d > thr) || (-d > thr)) && mask[i])
+            changed++;
+        for (unsigned int k = 0; k < shift; k++)
+            b = (bg[i] + b) >> 1;
+        bg[i] = b;
+    }
+
+    return changed;
+}
+
+#ifdef MPP_MOTION_SIMD
+/* saturating operations only: no dependency on the GE flags */
+unsigned int mpp_motion_compare_simd(const uint8_t *cur8, uint8_t *bg8, const uint8_t *mask8,
+                                     unsigned int size, uint8_t thr, unsigned int shift)
+{
+    const uint32_t *cur = (const uint32_t *)cur8;
+    const uint32_t *mask = (const uint32_t *)mask8;
+    uint32_t *bg = (uint32_t *)bg8;
+    uint32_t thr4 = thr * 0x01010101u;
+    unsigned int changed = 0;
+
+    for (unsigned int i = 0; i < size / 4; i++) {
+        uint32_t ad = __uqsub8(cur[i], bg[i]) | __uqsub8(bg[i], cur[i]);   /* absolute difference */
+        uint32_t over = __uqsub8(ad, thr4);                 /* non-zero: difference above threshold */
+        uint32_t hit = (__uqadd8(over, 0x7f7f7f7fu) >> 7) & 0x01010101u & mask[i];
+        uint32_t b = cur[i];
+
+        changed += (hit * 0x01010101u) >> 24;
+        /* background moves by 1/2^shift toward the current thumbnail */
+        for (unsigned int k = 0; k < shift; k++)
+            b = __uhadd8(bg[i], b);
+        bg[i] = b;
+    }
+
+    return changed;
+}
+#endif
+
+static unsigned int compare(_motion_ctx_t *ctx, uint8_t thr, unsigned int shift)
+{
+#ifdef MPP_MOTION_SIMD
+    return mpp_motion_compare_simd(ctx->cur, ctx->bg, ctx->mask, ctx->stride * ctx->height, thr, shift);
+#else
+    return mpp_motion_compare_ref(ctx->cur, ctx->bg, ctx->mask, ctx->stride * ctx->height, thr, shift);
+#endif
+}
+
+/* element processing function */
+static int motion_func(_elem_t *elem)
+{
+    _motion_ctx_t *ctx = elem->priv;
+    const mpp_element_params_t *params = &elem->params;
+    unsigned int changed;
+
+    make_thumbnail(ctx, elem->io.in_buf[0]);
+    if (!ctx->init) {
+        memcpy(ctx->bg, ctx->cur, ctx->stride * ctx->height);
+        ctx->init = true;
+        return MPP_SUCCESS;
+    }
+
+    changed = compare(ctx, params->motion.pixel_threshold, params->motion.background_shift);
+    if (changed >= ctx->min_changed) {
+        ctx->hold = params->motion.hold_frames;
+    } else if (ctx->hold > 0) {
+        ctx->hold--;
+    } else if ((params->motion.refresh_period == 0)
+            || (++ctx->since_pass < params->motion.refresh_period)) {
+        MPP_LOGD("Frame %d without motion (%d changed pixels)\n", mpp_buf_frame_id(elem->io.in_buf[0]), changed);
+        return MPP_ELEM_GATED;
+    }
+    ctx->since_pass = 0;
+
+    return MPP_SUCCESS;
+}
+
+static unsigned int check_motion_params(const mpp_element_params_t *params)
+{
+    if ((params->motion.thumb_width > MOTION_THUMB_MAX) || (params->motion.thumb_height > MOTION_THUMB_MAX)) {
+        MPP_LOGE("Motion thumbnail dimensions should not exceed %d\n", MOTION_THUMB_MAX);
+        return MPP_INVALID_PARAM;
+    }
+    if ((params->motion.area_threshold < 0) || (params->motion.area_threshold > 1)) {
+        MPP_LOGE("Motion area_threshold should be in range [0..1]\n");
+        return MPP_INVALID_PARAM;
+    }
+    if (params->motion.background_shift > MOTION_MAX_SHIFT) {
+        MPP_LOGE("Motion background_shift should be in range [0..%d]\n", MOTION_MAX_SHIFT);
+        return MPP_INVALID_PARAM;
+    }
+
+    return MPP_SUCCESS;
+}
+
+/* ROI mask and motion area */
+static void set_mask(_motion_ctx_t *ctx, const mpp_element_params_t *params)
+{
+    unsigned int monitored = 0;
+
+    memset(ctx->mask, 0, ctx->stride * ctx->height);
+    for (unsigned int y = 0; y < ctx->height; y++) {
+        for (unsigned int x = 0; x < ctx->width; x++) {
+            if ((params->motion.mask == NULL) || params->motion.mask[y * ctx->width + x]) {
+                ctx->mask[y * ctx->stride + x] = 1;
+                monitored++;
+            }
+        }
+    }
+    ctx->min_changed = (unsigned int)(params->motion.area_threshold * monitored + 0.5f);
+    if (ctx->min_changed == 0)
+        ctx->min_changed = 1;
+}
+
+/* motion gate setup function */
+unsigned int elem_motion_setup(_elem_t *elem)
+{
+    unsigned int ret = MPP_SUCCESS;
+    _motion_ctx_t *ctx = NULL;
+    buf_desc_t *in_buf;
+    unsigned int w, h, stride;
+
+    do {
+        /* sanity checks */
+        if (elem == NULL) {
+            MPP_LOGE("invalid input buffer - elem (0x%x)\n", ret);
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        if ((elem->proc_typ != MPP_ELEMENT_MOTION) || (elem->type != MPP_TYPE_PROC))
+        {
+            MPP_LOGE("invalid element %s (expected element MOTION)\n", elem_name(elem->proc_typ));
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        if ((elem->prev == NULL) || (elem->prev->io.out_buf[0] == NULL)) {
+            MPP_LOGE("MOTION element requires a previous element\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        in_buf = elem->prev->io.out_buf[0];
+        if (in_buf->stripe_num > 0) {
+            MPP_LOGE("MOTION element does not support stripe mode\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        if (luma_offset(in_buf->format, 0) < 0) {
+            MPP_LOGE("MOTION element does not support pixel format %d\n", in_buf->format);
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        ret = check_motion_params(&elem->params);
+        if (ret != MPP_SUCCESS)
+            break;
+
+        w = (elem->params.motion.thumb_width > 0) ? elem->params.motion.thumb_width : MOTION_THUMB_WIDTH;
+        h = (elem->params.motion.thumb_height > 0) ? elem->params.motion.thumb_height : MOTION_THUMB_HEIGHT;
+        if ((w > in_buf->width) || (h > in_buf->height)) {
+            MPP_LOGE("Motion thumbnail larger than the frame\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        stride = (w + 3) & ~3u;
+
+        /* sample offsets and thumbnails follow the context */
+        ctx = hal_malloc(sizeof(_motion_ctx_t) + MOTION_SAMPLES * (w + h) * sizeof(uint32_t) + 3 * stride * h);
+        if (ctx == NULL) {
+            MPP_LOGE("malloc failed for motion context\n");
+            ret = MPP_MALLOC_ERROR;
+            break;
+        }
+        memset(ctx, 0, sizeof(_motion_ctx_t));
+        ctx->width = w;
+        ctx->height = h;
+        ctx->stride = stride;
+        ctx->xoff = (uint32_t *)(ctx + 1);
+        ctx->yline = ctx->xoff + MOTION_SAMPLES * w;
+        ctx->cur = (uint8_t *)(ctx->yline + MOTION_SAMPLES * h);
+        ctx->bg = ctx->cur + stride * h;
+        ctx->mask = ctx->bg + stride * h;
+        memset(ctx->cur, 0, 2 * stride * h);
+
+        /* samples at a quarter and three quarters of each thumbnail cell */
+        for (unsigned int x = 0; x < w; x++) {
+            ctx->xoff[MOTION_SAMPLES * x] = luma_offset(in_buf->format, ((4 * x + 1) * in_buf->width) / (4 * w));
+            ctx->xoff[MOTION_SAMPLES * x + 1] = luma_offset(in_buf->format, ((4 * x + 3) * in_buf->width) / (4 * w));
+        }
+        for (unsigned int y = 0; y < h; y++) {
+            ctx->yline[MOTION_SAMPLES * y] = ((4 * y + 1) * in_buf->height) / (4 * h);
+            ctx->yline[MOTION_SAMPLES * y + 1] = ((4 * y + 3) * in_buf->height) / (4 * h);
+        }
+        set_mask(ctx, &elem->params);
+        elem->priv = ctx;
+
+        /* assign element entry/function */
+        elem->entry = motion_func;
+
+        /* the frame is only read: in-place */
+        elem->io.inplace = true;
+        elem->io.nb_in_buf = 1;
+        elem->io.in_buf[0] = in_buf;
+        elem->io.nb_out_buf = 1;
+        elem->io.out_buf[0] = elem->io.in_buf[0];
+        /* the CPU reads the frame */
+        elem->in_access = MPP_ACCESS_CPU;
+        elem->out_access = MPP_ACCESS_NONE;
+    } while (false);
+
+    return ret;
+}
+
+/* motion gate update function: thresholds, mask and timings only */
+uint32_t mpp_motion_update(_elem_t *elem, mpp_element_params_t *params)
+{
+    uint32_t ret = MPP_SUCCESS;
+
+    do {
+        if ((elem == NULL) || (params == NULL)) {
+            MPP_LOGE("invalid input parameters\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        if (elem->proc_typ != MPP_ELEMENT_MOTION)
+        {
+            MPP_LOGE("invalid element %s (expected element MOTION)\n", elem_name(elem->proc_typ));
+            ret = MPP_INVALID_ELEM;
+            break;
+        }
+        if ((params->motion.thumb_width != elem->params.motion.thumb_width)
+                || (params->motion.thumb_height != elem->params.motion.thumb_height)) {
+            MPP_LOGE("Motion thumbnail dimensions cannot be changed\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        ret = check_motion_params(params);
+        if (ret != MPP_SUCCESS)
+            break;
+
+        elem->params.motion = params->motion;
+        set_mask(elem->priv, params);
+    } while (false);
+
+    return ret;
+}
@@ -18,6 +18,14 @@
 
 #include "mpp_api.h"
 #include "mpp_api_types_internal.h"
+#include "mpp_heap.h"
+
+static int nullsink_enqueue(_mpp_t *mpp)
+{
+    /* nothing to flush, the frame is done */
+    mpp_sink_latency(mpp->last_elem);
+    return MPP_SUCCESS;
+}
 
 int mpp_nullsink_add(mpp_t mpp)
 {
@@ -40,6 +48,7 @@ int mpp_nullsink_add(mpp_t mpp)
     /* store sink info */
     elem->type = MPP_TYPE_SINK;
     elem->sink_typ = MPP_SINK_NULL;
+    elem->sink_enqueue = nullsink_enqueue;
 
     /* pipeline has been closed */
     _mpp->status = MPP_CLOSED;
@@ -0,0 +1,511 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * ROI inference element: runs a second model on the regions of interest
+ * found by the previous DETECTION element, on the same frame.
+ *
+ * Each box is mapped back to the pipeline source frame through the CONVERT
+ * elements between the source and the detection model, then cropped and
+ * resized by the graphics device directly into the ROI model input tensor.
+ * The model is invoked once per ROI and each output is posted to the
+ * application. Nothing runs when the frame has no box.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "mpp_api.h"
+#include "mpp_api_types_internal.h"
+
+#include "mpp_debug.h"
+#include "mpp_event.h"
+#include "mpp_meta.h"
+#include "mpp_buffer.h"
+#include "mpp_trace.h"
+#include "hal.h"
+#include "hal_os.h"
+#include "hal_utils.h"
+#include "hal_graphics_dev.h"
+
+void HAL_DCACHE_CleanInvalidateByRange(uint32_t addr, uint32_t size);
+
+/* mapping of one axis: src = a * x + b */
+typedef struct {
+    float a;
+    float b;
+} _roi_axis_map_t;
+
+typedef struct {
+    _mpp_t *mpp;
+    gfx_dev_t gfx;
+    vision_algo_dev_t valgo;
+    hw_buf_desc_t model_in;         /* ROI model input tensor */
+    buf_desc_t *src_buf;            /* source frame */
+    buf_desc_t *det_buf;            /* detection model input */
+    _roi_axis_map_t map_x;          /* detection model input to source frame */
+    _roi_axis_map_t map_y;
+    mpp_roi_inference_out_t roi;    /* event data */
+    unsigned int batch;             /* ROIs cropped per pass over the source frame */
+    gfx_crop_t *crops;              /* crop regions of the current batch */
+    gfx_surface_t *stage;           /* crop destinations, the model input if batch is 1 */
+    const mpp_detection_box_t **boxes; /* detection boxes of the current batch */
+    uint8_t *stage_mem;             /* staging buffers of batched ROIs */
+} _roi_inference_ctx_t;
+
+/* HAL inference callback: outputs of the current ROI */
+static int roi_out_cb(mpp_t mpp, mpp_evt_t evt, void *evt_data, void *user_data)
+{
+    _roi_inference_ctx_t *ctx = user_data;
+
+    if (evt != MPP_EVENT_INFERENCE_OUTPUT_READY)
+        return mpp_event_post(ctx->mpp, evt, evt_data, NULL, NULL);
+
+    ctx->roi.out = evt_data;
+    return mpp_event_post(ctx->mpp, MPP_EVENT_ROI_INFERENCE_OUTPUT_READY, &ctx->roi, NULL, NULL);
+}
+
+static inline int clamp(int v, int min, int max)
+{
+    return (v < min) ? min : ((v > max) ? max : v);
+}
+
+/* map a detection box to a source frame window, false if empty */
+static bool roi_window(const _elem_t *elem, const _roi_inference_ctx_t *ctx,
+                       const mpp_detections_t *det, const mpp_detection_box_t *box, gfx_surface_t *src)
+{
+    /* detection coordinates to detection model input buffer */
+    float sx = (float)ctx->det_buf->width / det->width;
+    float sy = (float)ctx->det_buf->height / det->height;
+    float x0 = ctx->map_x.a * box->left * sx + ctx->map_x.b;
+    float x1 = ctx->map_x.a * box->right * sx + ctx->map_x.b;
+    float y0 = ctx->map_y.a * box->top * sy + ctx->map_y.b;
+    float y1 = ctx->map_y.a * box->bottom * sy + ctx->map_y.b;
+    float t;
+    int mx, my;
+
+    /* flips reverse the order */
+    if (x0 > x1) {
+        t = x0; x0 = x1; x1 = t;
+    }
+    if (y0 > y1) {
+        t = y0; y0 = y1; y1 = t;
+    }
+    mx = (x1 - x0) * elem->params.roi_inference.margin / 100;
+    my = (y1 - y0) * elem->params.roi_inference.margin / 100;
+
+    src->left = clamp((int)x0 - mx, 0, ctx->src_buf->width - 1);
+    src->right = clamp((int)x1 + mx, 0, ctx->src_buf->width - 1);
+    src->top = clamp((int)y0 - my, 0, ctx->src_buf->height - 1);
+    src->bottom = clamp((int)y1 + my, 0, ctx->src_buf->height - 1);
+
+    return (src->right > src->left) && (src->bottom > src->top);
+}
+
+/* crop the ROIs of the batch and run the model on each of them */
+static int roi_run_batch(const _elem_t *elem, _roi_inference_ctx_t *ctx, unsigned int nb, unsigned int first)
+{
+    gfx_rotate_config_t rot = { .degree = ROTATE_0, .target = kGFXRotate_DSTSurface };
+    uint32_t in_size = ctx->model_in.stride * ctx->model_in.nb_lines;
+    int ret;
+
+    /* all the ROIs of the batch in a single pass over the source frame */
+    if (ctx->gfx.ops->crop_and_resize != NULL) {
+        ret = ctx->gfx.ops->crop_and_resize(&ctx->gfx, &ctx->gfx.src, ctx->crops, nb);
+        if (ret != MPP_SUCCESS) {
+            MPP_LOGE_IF(RLMT_CHECK(1), "ROI crop failed %d\n", ret);
+            return MPP_ERROR;
+        }
+    }
+
+    for (unsigned int i = 0; i < nb; i++) {
+        if (ctx->gfx.ops->crop_and_resize == NULL) {
+            ctx->gfx.src.left = ctx->crops[i].left;
+            ctx->gfx.src.top = ctx->crops[i].top;
+            ctx->gfx.src.right = ctx->crops[i].right;
+            ctx->gfx.src.bottom = ctx->crops[i].bottom;
+            ret = ctx->gfx.ops->blit(&ctx->gfx, &ctx->gfx.src, &ctx->gfx.dst, &rot, FLIP_NONE);
+            if (ret != MPP_SUCCESS) {
+                MPP_LOGE_IF(RLMT_CHECK(1), "ROI %d crop failed %d\n", first + i, ret);
+                return MPP_ERROR;
+            }
+        } else if (ctx->crops[i].dst->buf != ctx->model_in.addr) {
+            memcpy(ctx->model_in.addr, ctx->crops[i].dst->buf, in_size);
+        }
+        if (ctx->model_in.cacheable)
+            HAL_DCACHE_CleanInvalidateByRange((uint32_t)ctx->model_in.addr, in_size);
+
+        ctx->roi.index = first + i;
+        memcpy(&ctx->roi.box, ctx->boxes[i], sizeof(mpp_detection_box_t));
+        MPP_TRACE_EVT(MPP_TRACE_HAL_BEGIN, MPP_TRACE_HAL_INFERENCE, mpp_buf_frame_id(elem->io.in_buf[0]), elem);
+        ret = ctx->valgo.ops->run(&ctx->valgo, NULL);
+        MPP_TRACE_EVT(MPP_TRACE_HAL_END, MPP_TRACE_HAL_INFERENCE, mpp_buf_frame_id(elem->io.in_buf[0]), elem);
+        if (ret != kStatus_HAL_ValgoSuccess) {
+            MPP_LOGE_IF(RLMT_CHECK(1), "ROI %d inference failed %d\n", first + i, ret);
+            return MPP_ERROR;
+        }
+    }
+
+    return MPP_SUCCESS;
+}
+
+/* element processing function */
+static int roi_inference_func(_elem_t *elem)
+{
+    _roi_inference_ctx_t *ctx = elem->priv;
+    const mpp_element_params_t *params = &elem->params;
+    const mpp_detections_t *det;
+    gfx_surface_t win;
+    unsigned int count = 0, nb = 0, nb_boxes;
+    int ret = MPP_SUCCESS;
+    size_t size;
+
+    /* boxes of the current frame only */
+    det = mpp_meta_find(elem->io.in_buf[0], MPP_META_DETECTIONS, elem->prev, &size);
+    if ((det == NULL) || (size < offsetof(mpp_detections_t, boxes)) || (det->width == 0) || (det->height == 0))
+        return MPP_SUCCESS;
+    /* only the boxes present in the entry */
+    nb_boxes = (size - offsetof(mpp_detections_t, boxes)) / sizeof(mpp_detection_box_t);
+    if (nb_boxes > det->count)
+        nb_boxes = det->count;
+    if (nb_boxes > MPP_DETECTION_MAX_BOXES)
+        nb_boxes = MPP_DETECTION_MAX_BOXES;
+
+    /* the source frame must not have been replaced (branch decimated or skipped meanwhile) */
+    if (mpp_buf_frame_id(ctx->src_buf) != mpp_buf_frame_id(elem->io.in_buf[0])) {
+        MPP_LOGD("Source frame %d replaced, ROIs skipped\n", mpp_buf_frame_id(elem->io.in_buf[0]));
+        return MPP_SUCCESS;
+    }
+
+    ctx->gfx.src.buf = ctx->src_buf->hw->addr;
+    ctx->gfx.src.pitch = ctx->src_buf->hw->stride;
+
+    for (unsigned int idx = 0; (idx < nb_boxes) && (count + nb < params->roi_inference.max_rois); idx++) {
+        const mpp_detection_box_t *box = &det->boxes[idx];
+
+        if ((box->score < params->roi_inference.min_score)
+                || ((params->roi_inference.label >= 0) && (box->label != params->roi_inference.label)))
+            continue;
+        if (!roi_window(elem, ctx, det, box, &win))
+            continue;
+
+        ctx->crops[nb].left = win.left;
+        ctx->crops[nb].top = win.top;
+        ctx->crops[nb].right = win.right;
+        ctx->crops[nb].bottom = win.bottom;
+        ctx->boxes[nb] = box;
+        if (++nb == ctx->batch) {
+            ret = roi_run_batch(elem, ctx, nb, count);
+            if (ret != MPP_SUCCESS)
+                break;
+            count += nb;
+            nb = 0;
+        }
+    }
+    if ((ret == MPP_SUCCESS) && (nb > 0)) {
+        ret = roi_run_batch(elem, ctx, nb, count);
+        if (ret == MPP_SUCCESS)
+            count += nb;
+    }
+    ctx->roi.count = count;
+
+    return ret;
+}
+
+/* compose the CONVERT elements mapping from the detection model input to the source frame */
+static unsigned int roi_map_setup(_roi_inference_ctx_t *ctx, _elem_t *cur)
+{
+    _roi_axis_map_t mx = { 1, 0 }, my = { 1, 0 };
+
+    for (; (cur != NULL) && (cur->type == MPP_TYPE_PROC); cur = cur->prev) {
+        const mpp_element_params_t *p = &cur->params;
+        float ax, ay, bx, by;
+        bool flip_h, flip_v;
+
+        if (cur->proc_typ != MPP_ELEMENT_CONVERT)
+            continue;
+        if ((p->convert.angle == ROTATE_90) || (p->convert.angle == ROTATE_270)) {
+            MPP_LOGE("ROI inference does not support rotated detection input\n");
+            return MPP_INVALID_PARAM;
+        }
+        flip_h = (p->convert.flip == FLIP_HORIZONTAL) || (p->convert.flip == FLIP_BOTH);
+        flip_v = (p->convert.flip == FLIP_VERTICAL) || (p->convert.flip == FLIP_BOTH);
+        if (p->convert.angle == ROTATE_180) {
+            flip_h = !flip_h;
+            flip_v = !flip_v;
+        }
+
+        /* output window to crop window, a flip mirrors the output window */
+        ax = (float)(p->convert.crop.right - p->convert.crop.left + 1) / p->convert.scale.width;
+        ay = (float)(p->convert.crop.bottom - p->convert.crop.top + 1) / p->convert.scale.height;
+        if (flip_h) {
+            bx = p->convert.crop.left + (p->convert.out_window.left + p->convert.scale.width - 1) * ax;
+            ax = -ax;
+        } else {
+            bx = p->convert.crop.left - p->convert.out_window.left * ax;
+        }
+        if (flip_v) {
+            by = p->convert.crop.top + (p->convert.out_window.top + p->convert.scale.height - 1) * ay;
+            ay = -ay;
+        } else {
+            by = p->convert.crop.top - p->convert.out_window.top * ay;
+        }
+
+        /* src = a_cvt * (a * x + b) + b_cvt */
+        mx.b = ax * mx.b + bx;
+        mx.a = ax * mx.a;
+        my.b = ay * my.b + by;
+        my.a = ay * my.a;
+    }
+
+    if ((cur == NULL) || (cur->type != MPP_TYPE_SOURCE)) {
+        MPP_LOGE("ROI inference source frame not found\n");
+        return MPP_INVALID_PARAM;
+    }
+    /* the ROIs are cropped from the source frame, which sources replace whether it is read or not:
+     * the element must run in the task of the source, before the next frame is dequeued */
+    if (cur->mpp->exec_heap != ctx->mpp->exec_heap) {
+        MPP_LOGE("ROI inference must not run in a background branch of the source\n");
+        return MPP_INVALID_PARAM;
+    }
+    ctx->src_buf = cur->io.out_buf[0];
+    if (ctx->src_buf->stripe_num > 0) {
+        MPP_LOGE("ROI inference does not support stripe mode\n");
+        return MPP_INVALID_PARAM;
+    }
+    ctx->map_x = mx;
+    ctx->map_y = my;
+
+    return MPP_SUCCESS;
+}
+
+static unsigned int check_roi_inference_params(const mpp_element_params_t *params)
+{
+    if (params->roi_inference.model_data == NULL) {
+        MPP_LOGE("ROI inference requires a model\n");
+        return MPP_INVALID_PARAM;
+    }
+    if ((params->roi_inference.inference_params.num_inputs != 1)
+            || (params->roi_inference.inference_params.num_outputs < 0)) {
+        MPP_LOGE("ROI inference requires a model with one input\n");
+        return MPP_INVALID_PARAM;
+    }
+    if (params->roi_inference.tensor_order == MPP_TENSOR_ORDER_UNKNOWN) {
+        MPP_LOGE("Input Tensor dimensions order not set\n");
+        return MPP_INVALID_PARAM;
+    }
+    if ((params->roi_inference.max_rois == 0) || (params->roi_inference.max_rois > MPP_DETECTION_MAX_BOXES)) {
+        MPP_LOGE("ROI inference max_rois should be in range [1..%d]\n", MPP_DETECTION_MAX_BOXES);
+        return MPP_INVALID_PARAM;
+    }
+    if ((params->roi_inference.min_score < 0) || (params->roi_inference.min_score > 1)
+            || (params->roi_inference.margin > 100)) {
+        MPP_LOGE("Invalid ROI inference min_score or margin\n");
+        return MPP_INVALID_PARAM;
+    }
+    if (params->roi_inference.batch > params->roi_inference.max_rois) {
+        MPP_LOGE("ROI inference batch should not exceed max_rois\n");
+        return MPP_INVALID_PARAM;
+    }
+    if (get_bitpp(params->roi_inference.pixel_format) == 0) {
+        MPP_LOGE("Invalid ROI inference pixel format\n");
+        return MPP_INVALID_PARAM;
+    }
+
+    return MPP_SUCCESS;
+}
+
+/* ROI inference setup function */
+unsigned int elem_roi_inference_setup(_elem_t *elem)
+{
+    unsigned int ret = MPP_SUCCESS;
+    _roi_inference_ctx_t *ctx = NULL;
+    _elem_t *infer;
+    mpp_memory_policy_t policy;
+    model_param_t params;
+    const hal_valgo_caps_t *caps;
+    int bpp;
+    unsigned int batch;
+    size_t size;
+
+    do {
+        /* sanity checks */
+        if (elem == NULL) {
+            MPP_LOGE("invalid input buffer - elem (0x%x)\n", ret);
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        if ((elem->proc_typ != MPP_ELEMENT_ROI_INFERENCE) || (elem->type != MPP_TYPE_PROC))
+        {
+            MPP_LOGE("invalid element %s (expected element ROI_INFERENCE)\n", elem_name(elem->proc_typ));
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        if ((elem->prev == NULL) || (elem->prev->type != MPP_TYPE_PROC)
+                || (elem->prev->proc_typ != MPP_ELEMENT_DETECTION))
+        {
+            MPP_LOGE("ROI_INFERENCE element must follow a DETECTION element\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        ret = check_roi_inference_params(&elem->params);
+        if (ret != MPP_SUCCESS)
+            break;
+
+        /* batch arrays follow the context */
+        batch = (elem->params.roi_inference.batch > 1) ? elem->params.roi_inference.batch : 1;
+        size = sizeof(_roi_inference_ctx_t)
+                + batch * (sizeof(gfx_crop_t) + sizeof(gfx_surface_t) + sizeof(mpp_detection_box_t *));
+        ctx = hal_malloc(size);
+        if (ctx == NULL) {
+            MPP_LOGE("malloc failed for ROI inference context\n");
+            ret = MPP_MALLOC_ERROR;
+            break;
+        }
+        memset(ctx, 0, size);
+        ctx->mpp = elem->mpp;
+        ctx->batch = batch;
+        ctx->crops = (gfx_crop_t *)(ctx + 1);
+        ctx->stage = (gfx_surface_t *)(ctx->crops + batch);
+        ctx->boxes = (const mpp_detection_box_t **)(ctx->stage + batch);
+
+        /* boxes are in the detection model input coordinates */
+        infer = elem->prev->prev;
+        ctx->det_buf = infer->io.in_buf[0];
+        ret = roi_map_setup(ctx, infer->prev);
+        if (ret != MPP_SUCCESS)
+            break;
+        /* boxes of the DETECTION element come with the frame */
+        ret = mpp_meta_enable(elem);
+        if (ret != MPP_SUCCESS)
+            break;
+
+        /* setup the vision device */
+        /* Glow bundles take their input shape from the frame, unknown here */
+        if ((elem->params.roi_inference.type == MPP_INFERENCE_TYPE_GLOW)
+                || (hal_valgo_setup(&ctx->valgo, elem->params.roi_inference.type,
+                        elem->params.roi_inference.backend, &caps) != 0)) {
+            MPP_LOGE ("ML inference type %d is not supported\n", elem->params.roi_inference.type);
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        memset(&params, 0, sizeof(model_param_t));
+        params.model_data = elem->params.roi_inference.model_data;
+        params.model_size = elem->params.roi_inference.model_size;
+        params.model_input_mean = elem->params.roi_inference.model_input_mean;
+        params.model_input_std = elem->params.roi_inference.model_input_std;
+        memcpy(params.model_input_ch_mean, elem->params.roi_inference.model_input_ch_mean, sizeof(params.model_input_ch_mean));
+        memcpy(params.model_input_ch_std, elem->params.roi_inference.model_input_ch_std, sizeof(params.model_input_ch_std));
+        params.tensor_order = elem->params.roi_inference.tensor_order;
+        params.format = elem->params.roi_inference.pixel_format;
+        memcpy(&params.inference_params, &elem->params.roi_inference.inference_params,
+               sizeof(mpp_inference_params_t));
+        params.evt_callback_f = roi_out_cb;
+        params.cb_userdata = ctx;
+        if (ctx->valgo.ops->init(&ctx->valgo, &params) != kStatus_HAL_ValgoSuccess) {
+            MPP_LOGE ("HAL ROI inference init() fails\n");
+            ret = MPP_ERROR;
+            break;
+        }
+        if ((params.input_types & ~caps->tensor_types) != 0) {
+            MPP_LOGE("Inference backend %s does not support the model input types (0x%x)\n",
+                     caps->name, (unsigned int)params.input_types);
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        /* the outputs of a batch are read as soon as run() returns */
+        if (caps->async) {
+            MPP_LOGE("ROI inference does not support the asynchronous backend %s\n", caps->name);
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        ctx->valgo.ops->get_buf_desc(&ctx->valgo, &ctx->model_in, &policy);
+
+        /* setup the graphics device: source frame to model input */
+        ret = hal_gfx_setup(elem->params.roi_inference.dev_name, &ctx->gfx);
+        if (ret != MPP_SUCCESS) {
+            MPP_LOGE ("Setup HAL graphics fails with ret=%d\n", ret);
+            break;
+        }
+        if (ctx->gfx.ops->init != NULL)
+            ctx->gfx.ops->init(&ctx->gfx, &elem->params);
+
+        bpp = get_bitpp(elem->params.roi_inference.pixel_format) / 8;
+        ctx->gfx.src.format = ctx->src_buf->format;
+        ctx->gfx.src.width = ctx->src_buf->width;
+        ctx->gfx.src.height = ctx->src_buf->height;
+        ctx->gfx.dst.format = elem->params.roi_inference.pixel_format;
+        ctx->gfx.dst.width = ctx->model_in.stride / bpp;
+        ctx->gfx.dst.height = ctx->model_in.nb_lines;
+        ctx->gfx.dst.left = 0;
+        ctx->gfx.dst.top = 0;
+        ctx->gfx.dst.right = ctx->gfx.dst.width - 1;
+        ctx->gfx.dst.bottom = ctx->gfx.dst.height - 1;
+        ctx->gfx.dst.pitch = ctx->model_in.stride;
+        ctx->gfx.dst.buf = ctx->model_in.addr;
+
+        if ((ctx->gfx.ops->crop_and_resize == NULL)
+                && ((batch > 1) || elem->params.roi_inference.letterbox)) {
+            MPP_LOGE("ROI batch and letterbox require a graphics device supporting crop and resize\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        /* batched ROIs are staged before being copied into the model input */
+        if (batch > 1) {
+            ctx->stage_mem = hal_malloc_placed(batch * ctx->model_in.stride * ctx->model_in.nb_lines,
+                    MPP_MEM_PLACE_FAST, NULL);
+            if (ctx->stage_mem == NULL) {
+                MPP_LOGE("malloc failed for ROI staging buffers\n");
+                ret = MPP_MALLOC_ERROR;
+                break;
+            }
+        }
+        for (unsigned int i = 0; i < batch; i++) {
+            ctx->stage[i] = ctx->gfx.dst;
+            if (ctx->stage_mem != NULL)
+                ctx->stage[i].buf = ctx->stage_mem + i * ctx->model_in.stride * ctx->model_in.nb_lines;
+            ctx->crops[i].dst = &ctx->stage[i];
+            ctx->crops[i].letterbox = elem->params.roi_inference.letterbox;
+            ctx->crops[i].pad_value = elem->params.roi_inference.pad_value;
+        }
+        elem->priv = ctx;
+
+        /* assign element entry/function */
+        elem->entry = roi_inference_func;
+
+        /* the image is read from the source frame: in-place */
+        elem->io.inplace = true;
+        elem->io.nb_in_buf = 1;
+        elem->io.in_buf[0] = elem->prev->io.out_buf[0];
+        elem->io.nb_out_buf = 1;
+        elem->io.out_buf[0] = elem->io.in_buf[0];
+        /* the frame is read by the crop device */
+        elem->in_access = MPP_ACCESS_ANY;
+        elem->out_access = MPP_ACCESS_NONE;
+    } while (false);
+
+    if ((ret != MPP_SUCCESS) && (ctx != NULL)) {
+        if (ctx->valgo.priv_data != NULL)
+            ctx->valgo.ops->deinit(&ctx->valgo);
+        hal_valgo_release(&ctx->valgo);
+        if (ctx->stage_mem != NULL)
+            hal_free_placed(ctx->stage_mem);
+        hal_free(ctx);
+    }
+
+    return ret;
+}
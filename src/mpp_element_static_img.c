@@ -20,6 +20,8 @@
 #include "mpp_api_types_internal.h"
 #include "mpp_heap.h"
 #include "mpp_debug.h"
+#include "mpp_meta.h"
+#include "mpp_buffer.h"
 #include "string.h"
 #include "hal_utils.h"
 #include "hal_os.h"
@@ -30,14 +32,20 @@ static inline int image_dequeue(_mpp_t *mpp)
     _elem_t *elem = mpp->first_elem;
     _static_image_t *img = elem->dev.img;
 
-    elem->io.out_buf[0]->status = MPP_BUFFER_WRITTING;
+    buf_desc_t *buf = elem->io.out_buf[0];
+    bool owned = mpp_buf_acquire_write(buf, NULL);
 
     /* source buffer is static image buffer */
-    ret = img->elt.ops->dequeue(&img->elt, elem->io.out_buf[0]->hw, &elem->io.out_buf[0]->stripe_num);
+    ret = img->elt.ops->dequeue(&img->elt, buf->hw, &buf->stripe_num);
+    buf->capture_ts = hal_get_time_us();
 
+    /* metadata is set before the frame is visible */
+    mpp_meta_begin(elem, mpp_buf_frame_id(buf) + 1);
     /* update buffer status */
-    elem->io.out_buf[0]->status = MPP_BUFFER_READY;
-    elem->io.out_buf[0]->frame_id++;
+    if (owned)
+        mpp_buf_publish(buf, mpp_buf_frame_id(buf) + 1);
+    else
+        mpp_buf_set_frame_id(buf, mpp_buf_frame_id(buf) + 1);
     return ret;
 }
 
@@ -0,0 +1,553 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Tracker element: follows the boxes of a DETECTION element, which may run
+ * at a lower rate in another branch, and predicts them on every frame.
+ *
+ * When new detection results are available, tracks are associated to boxes
+ * of the same class by a minimum cost assignment (Hungarian method) on their
+ * IoU, then corrected by a constant velocity Kalman filter per box coordinate
+ * (center and size). The detection latency in frames is accounted for by
+ * comparing each box with the track state at the detected frame.
+ * Tracks are dropped after max_misses detection results or max_age frames
+ * without association, the latter also when no detection results arrive.
+ * All the filtering is done in fixed point.
+ * The predicted boxes, with their track identifier, are attached to the
+ * frame metadata where a LABELED_RECTANGLE element can draw them.
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include "mpp_api.h"
+#include "mpp_api_types_internal.h"
+
+#include "mpp_debug.h"
+#include "mpp_meta.h"
+#include "mpp_buffer.h"
+#include "hal_os.h"
+
+#define TRACKER_MAX_TRACKS      MPP_DETECTION_MAX_BOXES
+/* fixed point precision of positions (pixels) and variances (pixels^2) */
+#define TRACKER_FRAC_BITS       8
+/* fixed point precision of the IoU */
+#define TRACKER_IOU_BITS        10
+/* assignment cost of a pair failing the IoU or class test */
+#define TRACKER_COST_FORBIDDEN  (1 << 20)
+/* assignment cost of a track or a box left alone */
+#define TRACKER_COST_ALONE      ((1 << TRACKER_IOU_BITS) + 1)
+/* maximum prediction step and detection latency (frames) */
+#define TRACKER_MAX_FRAMES      64
+/* default number of frames without association before a track is dropped */
+#define TRACKER_MAX_AGE         TRACKER_MAX_FRAMES
+/* upper bound of the variances, avoids overflows of lost tracks */
+#define TRACKER_VAR_MAX         (INT32_MAX / 4)
+
+/* default noises: standard deviations in pixels */
+#define TRACKER_POSITION_NOISE  1.0f
+#define TRACKER_VELOCITY_NOISE  0.25f
+#define TRACKER_MEASURE_NOISE   4.0f
+/* standard deviation of the velocity of a new track (pixels per frame) */
+#define TRACKER_INIT_VELOCITY   8.0f
+
+/* constant velocity filter of one box coordinate */
+typedef struct {
+    int32_t pos;        /* position */
+    int32_t vel;        /* velocity per frame */
+    int32_t p00;        /* covariance */
+    int32_t p01;
+    int32_t p11;
+} _kf_axis_t;
+
+enum {
+    KF_CX,
+    KF_CY,
+    KF_W,
+    KF_H,
+    KF_NUM
+};
+
+typedef struct {
+    _kf_axis_t kf[KF_NUM];
+    int16_t id;
+    int16_t label;
+    float score;
+    uint16_t hits;      /* associated detections */
+    uint16_t misses;    /* consecutive detection results without association */
+    uint16_t age;       /* frames since the last associated detection */
+} _track_t;
+
+typedef struct {
+    _elem_t *det_elem;          /* DETECTION element */
+    uint32_t det_seq;           /* last detection results processed */
+    unsigned short last_frame;  /* last frame processed */
+    bool started;
+    int32_t q_pos;              /* noise variances */
+    int32_t q_vel;
+    int32_t r;
+    int32_t v0;                 /* velocity variance of new tracks */
+    int32_t min_iou;
+    int16_t next_id;
+    unsigned int nb_tracks;
+    _track_t tracks[TRACKER_MAX_TRACKS];
+    mpp_detections_t det;       /* last detection results */
+    mpp_detections_t result;    /* predicted boxes */
+    /* assignment */
+    int32_t cost[TRACKER_MAX_TRACKS][TRACKER_MAX_TRACKS];
+    int32_t u[TRACKER_MAX_TRACKS + 1];
+    int32_t v[TRACKER_MAX_TRACKS + 1];
+    int32_t minv[TRACKER_MAX_TRACKS + 1];
+    int8_t p[TRACKER_MAX_TRACKS + 1];
+    int8_t way[TRACKER_MAX_TRACKS + 1];
+    bool used[TRACKER_MAX_TRACKS + 1];
+    int8_t match[TRACKER_MAX_TRACKS];   /* column assigned to each row */
+} _tracker_ctx_t;
+
+static inline int32_t var_clamp(int64_t v)
+{
+    return (v < 1) ? 1 : ((v > TRACKER_VAR_MAX) ? TRACKER_VAR_MAX : (int32_t)v);
+}
+
+/* covariances are signed, bounded like the variances */
+static inline int32_t cov_clamp(int64_t v)
+{
+    return (v < -TRACKER_VAR_MAX) ? -TRACKER_VAR_MAX : ((v > TRACKER_VAR_MAX) ? TRACKER_VAR_MAX : (int32_t)v);
+}
+
+/* variance in fixed point from a standard deviation, 'def' if zero */
+static int32_t fixed_var(float std, float def)
+{
+    if (std <= 0)
+        std = def;
+    return var_clamp((int64_t)(std * std * (1 << TRACKER_FRAC_BITS)));
+}
+
+static void kf_init(_kf_axis_t *kf, int32_t pos, const _tracker_ctx_t *ctx)
+{
+    kf->pos = pos;
+    kf->vel = 0;
+    kf->p00 = ctx->r;
+    kf->p01 = 0;
+    kf->p11 = ctx->v0;
+}
+
+/* move the state 'dt' frames forward */
+static void kf_predict(_kf_axis_t *kf, int dt, const _tracker_ctx_t *ctx)
+{
+    kf->pos += dt * kf->vel;
+    kf->p00 = var_clamp(kf->p00 + (int64_t)dt * (2 * (int64_t)kf->p01 + (int64_t)dt * kf->p11)
+                        + (int64_t)dt * ctx->q_pos);
+    kf->p01 = cov_clamp((int64_t)kf->p01 + (int64_t)dt * kf->p11);
+    kf->p11 = var_clamp((int64_t)kf->p11 + (int64_t)dt * ctx->q_vel);
+}
+
+/* correct the state with position 'z' measured 'lag' frames ago */
+static void kf_update(_kf_axis_t *kf, int32_t z, int lag, const _tracker_ctx_t *ctx)
+{
+    /* measurement model: z = pos - lag * vel */
+    int64_t a = kf->p00 - (int64_t)lag * kf->p01;
+    int64_t b = kf->p01 - (int64_t)lag * kf->p11;
+    int64_t s = a - (int64_t)lag * b + ctx->r;
+    int64_t y = z - (kf->pos - (int64_t)lag * kf->vel);
+
+    if (s <= 0)
+        s = 1;
+    kf->pos += (int32_t)(a * y / s);
+    kf->vel += (int32_t)(b * y / s);
+    kf->p00 = var_clamp(kf->p00 - a * a / s);
+    kf->p01 = cov_clamp(kf->p01 - a * b / s);
+    kf->p11 = var_clamp(kf->p11 - b * b / s);
+}
+
+/* box of a track 'lag' frames ago */
+static void track_box(const _track_t *t, int lag, mpp_detection_box_t *box)
+{
+    int32_t cx = t->kf[KF_CX].pos - lag * t->kf[KF_CX].vel;
+    int32_t cy = t->kf[KF_CY].pos - lag * t->kf[KF_CY].vel;
+    int32_t w = t->kf[KF_W].pos - lag * t->kf[KF_W].vel;
+    int32_t h = t->kf[KF_H].pos - lag * t->kf[KF_H].vel;
+
+    box->left = (cx - w / 2) >> TRACKER_FRAC_BITS;
+    box->right = (cx + w / 2) >> TRACKER_FRAC_BITS;
+    box->top = (cy - h / 2) >> TRACKER_FRAC_BITS;
+    box->bottom = (cy + h / 2) >> TRACKER_FRAC_BITS;
+    box->label = t->label;
+    box->id = t->id;
+    box->score = t->score;
+}
+
+/* box measurement of each filter */
+static void box_measure(const mpp_detection_box_t *box, int32_t z[KF_NUM])
+{
+    z[KF_CX] = (box->left + box->right) << (TRACKER_FRAC_BITS - 1);
+    z[KF_CY] = (box->top + box->bottom) << (TRACKER_FRAC_BITS - 1);
+    z[KF_W] = (box->right - box->left) << TRACKER_FRAC_BITS;
+    z[KF_H] = (box->bottom - box->top) << TRACKER_FRAC_BITS;
+}
+
+/* intersection over union in fixed point */
+static int32_t box_iou(const mpp_detection_box_t *a, const mpp_detection_box_t *b)
+{
+    int32_t w = ((a->right < b->right) ? a->right : b->right) - ((a->left > b->left) ? a->left : b->left);
+    int32_t h = ((a->bottom < b->bottom) ? a->bottom : b->bottom) - ((a->top > b->top) ? a->top : b->top);
+    int64_t inter, uni;
+
+    if ((w <= 0) || (h <= 0))
+        return 0;
+    inter = (int64_t)w * h;
+    uni = (int64_t)(a->right - a->left) * (a->bottom - a->top)
+            + (int64_t)(b->right - b->left) * (b->bottom - b->top) - inter;
+    if (uni <= 0)
+        return 0;
+    return (int32_t)((inter << TRACKER_IOU_BITS) / uni);
+}
+
+/* minimum cost assignment of the n x n cost matrix (Hungarian method with potentials) */
+static void assign(_tracker_ctx_t *ctx, int n)
+{
+    int32_t *u = ctx->u, *v = ctx->v, *minv = ctx->minv;
+    int8_t *p = ctx->p, *way = ctx->way;
+    bool *used = ctx->used;
+
+    for (int j = 0; j <= n; j++) {
+        u[j] = 0;
+        v[j] = 0;
+        p[j] = 0;
+        way[j] = 0;
+    }
+    for (int i = 1; i <= n; i++) {
+        int j0 = 0;
+
+        p[0] = i;
+        for (int j = 0; j <= n; j++) {
+            minv[j] = INT32_MAX;
+            used[j] = false;
+        }
+        do {
+            int i0 = p[j0], j1 = 0;
+            int32_t delta = INT32_MAX;
+
+            used[j0] = true;
+            for (int j = 1; j <= n; j++) {
+                if (used[j])
+                    continue;
+                int32_t cur = ctx->cost[i0 - 1][j - 1] - u[i0] - v[j];
+                if (cur < minv[j]) {
+                    minv[j] = cur;
+                    way[j] = j0;
+                }
+                if (minv[j] < delta) {
+                    delta = minv[j];
+                    j1 = j;
+                }
+            }
+            for (int j = 0; j <= n; j++) {
+                if (used[j]) {
+                    u[p[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (p[j0] != 0);
+        /* augment along the path */
+        do {
+            int j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+    for (int j = 1; j <= n; j++)
+        ctx->match[p[j] - 1] = j - 1;
+}
+
+/* drop the lost tracks: too many detection results or frames without association */
+static void tracks_drop(_tracker_ctx_t *ctx, const mpp_element_params_t *params)
+{
+    unsigned int max_age = (params->tracker.max_age > 0) ? params->tracker.max_age : TRACKER_MAX_AGE;
+    unsigned int kept = 0;
+
+    for (unsigned int i = 0; i < ctx->nb_tracks; i++) {
+        if ((ctx->tracks[i].misses > params->tracker.max_misses) || (ctx->tracks[i].age > max_age))
+            continue;
+        if (kept != i)
+            ctx->tracks[kept] = ctx->tracks[i];
+        kept++;
+    }
+    ctx->nb_tracks = kept;
+}
+
+/* associate the tracks with new detection results detected 'lag' frames ago */
+static void associate(_tracker_ctx_t *ctx, const mpp_element_params_t *params, int lag)
+{
+    const mpp_detections_t *det = &ctx->det;
+    int nt = ctx->nb_tracks, nd = det->count;
+    int n = (nt > nd) ? nt : nd;
+    bool det_used[MPP_DETECTION_MAX_BOXES];
+    mpp_detection_box_t box;
+    int32_t z[KF_NUM];
+
+    for (int i = 0; i < n; i++) {
+        if (i < nt)
+            track_box(&ctx->tracks[i], lag, &box);
+        for (int j = 0; j < n; j++) {
+            int32_t iou;
+
+            if ((i >= nt) || (j >= nd)) {
+                ctx->cost[i][j] = TRACKER_COST_ALONE;
+                continue;
+            }
+            iou = (box.label == det->boxes[j].label) ? box_iou(&box, &det->boxes[j]) : 0;
+            ctx->cost[i][j] = ((iou > 0) && (iou >= ctx->min_iou)) ?
+                    (1 << TRACKER_IOU_BITS) - iou : TRACKER_COST_FORBIDDEN;
+        }
+    }
+    if (n > 0)
+        assign(ctx, n);
+
+    /* correct the associated tracks */
+    memset(det_used, 0, sizeof(det_used));
+    for (int i = 0; i < nt; i++) {
+        _track_t *t = &ctx->tracks[i];
+        int j = ctx->match[i];
+
+        if ((j >= nd) || (ctx->cost[i][j] >= TRACKER_COST_FORBIDDEN)) {
+            t->misses++;
+            continue;
+        }
+        det_used[j] = true;
+        box_measure(&det->boxes[j], z);
+        for (int k = 0; k < KF_NUM; k++)
+            kf_update(&t->kf[k], z[k], lag, ctx);
+        t->score = det->boxes[j].score;
+        if (t->hits < UINT16_MAX)
+            t->hits++;
+        t->misses = 0;
+        t->age = lag;
+    }
+    tracks_drop(ctx, params);
+
+    /* new tracks, the boxes are brought to the current frame with a null velocity */
+    for (int j = 0; (j < nd) && (ctx->nb_tracks < TRACKER_MAX_TRACKS); j++) {
+        _track_t *t = &ctx->tracks[ctx->nb_tracks];
+
+        if (det_used[j])
+            continue;
+        box_measure(&det->boxes[j], z);
+        for (int k = 0; k < KF_NUM; k++)
+            kf_init(&t->kf[k], z[k], ctx);
+        t->id = ctx->next_id;
+        ctx->next_id = (ctx->next_id == INT16_MAX) ? 0 : ctx->next_id + 1;
+        t->label = det->boxes[j].label;
+        t->score = det->boxes[j].score;
+        t->hits = 1;
+        t->misses = 0;
+        t->age = lag;
+        ctx->nb_tracks++;
+    }
+}
+
+/* frames from 'from' to 'to', 0 if 'to' is older */
+static int frame_delta(unsigned short from, unsigned short to)
+{
+    unsigned short d = to - from;
+
+    if (d >= 0x8000)
+        return 0;
+    return (d > TRACKER_MAX_FRAMES) ? TRACKER_MAX_FRAMES : d;
+}
+
+/* element processing function */
+static int tracker_func(_elem_t *elem)
+{
+    _tracker_ctx_t *ctx = elem->priv;
+    const mpp_element_params_t *params = &elem->params;
+    unsigned short frame = mpp_buf_frame_id(elem->io.in_buf[0]);
+    unsigned short det_frame;
+    mpp_detections_t *res = &ctx->result;
+    unsigned int min_hits;
+    size_t size;
+    int dt;
+
+    /* tracks move to the current frame */
+    dt = ctx->started ? frame_delta(ctx->last_frame, frame) : 0;
+    ctx->last_frame = frame;
+    ctx->started = true;
+    for (unsigned int i = 0; (dt > 0) && (i < ctx->nb_tracks); i++) {
+        _track_t *t = &ctx->tracks[i];
+
+        for (int k = 0; k < KF_NUM; k++)
+            kf_predict(&t->kf[k], dt, ctx);
+        t->age = (t->age + dt > UINT16_MAX) ? UINT16_MAX : t->age + dt;
+    }
+    /* tracks also age when the detection does not deliver results */
+    if (dt > 0)
+        tracks_drop(ctx, params);
+
+    if (mpp_detection_get_results(ctx->det_elem, &ctx->det_seq, &ctx->det, &det_frame))
+        associate(ctx, params, frame_delta(det_frame, frame));
+    if ((ctx->det.width == 0) || (ctx->det.height == 0))
+        return MPP_SUCCESS; /* no detection yet */
+
+    /* predicted boxes of the confirmed tracks */
+    min_hits = (params->tracker.min_hits > 0) ? params->tracker.min_hits : 1;
+    res->width = ctx->det.width;
+    res->height = ctx->det.height;
+    res->window = ctx->det.window;
+    res->count = 0;
+    for (unsigned int i = 0; i < ctx->nb_tracks; i++) {
+        mpp_detection_box_t *box = &res->boxes[res->count];
+
+        if (ctx->tracks[i].hits < min_hits)
+            continue;
+        track_box(&ctx->tracks[i], 0, box);
+        if ((box->right <= box->left) || (box->bottom <= box->top)
+                || (box->right < 0) || (box->bottom < 0)
+                || (box->left >= (int)res->width) || (box->top >= (int)res->height))
+            continue;
+        res->count++;
+    }
+
+    /* attach the boxes to the frame for the downstream elements */
+    size = offsetof(mpp_detections_t, boxes) + res->count * sizeof(mpp_detection_box_t);
+    mpp_meta_add(elem->io.in_buf[0], MPP_META_DETECTIONS, elem, res, size);
+
+    return MPP_SUCCESS;
+}
+
+static unsigned int check_tracker_params(const mpp_element_params_t *params)
+{
+    if ((params->tracker.min_iou < 0) || (params->tracker.min_iou > 1)) {
+        MPP_LOGE("Tracker min_iou should be in range [0..1]\n");
+        return MPP_INVALID_PARAM;
+    }
+    if ((params->tracker.position_noise < 0) || (params->tracker.velocity_noise < 0)
+            || (params->tracker.measure_noise < 0)) {
+        MPP_LOGE("Tracker noises should not be negative\n");
+        return MPP_INVALID_PARAM;
+    }
+
+    return MPP_SUCCESS;
+}
+
+static void set_noises(_tracker_ctx_t *ctx, const mpp_element_params_t *params)
+{
+    ctx->q_pos = fixed_var(params->tracker.position_noise, TRACKER_POSITION_NOISE);
+    ctx->q_vel = fixed_var(params->tracker.velocity_noise, TRACKER_VELOCITY_NOISE);
+    ctx->r = fixed_var(params->tracker.measure_noise, TRACKER_MEASURE_NOISE);
+    ctx->v0 = fixed_var(TRACKER_INIT_VELOCITY, TRACKER_INIT_VELOCITY);
+    ctx->min_iou = (int32_t)(params->tracker.min_iou * (1 << TRACKER_IOU_BITS));
+}
+
+/* tracker setup function */
+unsigned int elem_tracker_setup(_elem_t *elem)
+{
+    unsigned int ret = MPP_SUCCESS;
+    _tracker_ctx_t *ctx = NULL;
+    _elem_t *det_elem;
+
+    do {
+        /* sanity checks */
+        if (elem == NULL) {
+            MPP_LOGE("invalid input buffer - elem (0x%x)\n", ret);
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        if ((elem->proc_typ != MPP_ELEMENT_TRACKER) || (elem->type != MPP_TYPE_PROC))
+        {
+            MPP_LOGE("invalid element %s (expected element TRACKER)\n", elem_name(elem->proc_typ));
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        if (elem->prev == NULL) {
+            MPP_LOGE("TRACKER element requires a previous element\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        det_elem = mpp_elem_from_handle(elem->params.tracker.detection);
+        if ((det_elem == NULL) || (det_elem->type != MPP_TYPE_PROC)
+                || (det_elem->proc_typ != MPP_ELEMENT_DETECTION)) {
+            MPP_LOGE("TRACKER element requires a DETECTION element handle\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        ret = check_tracker_params(&elem->params);
+        if (ret != MPP_SUCCESS)
+            break;
+
+        ctx = hal_malloc(sizeof(_tracker_ctx_t));
+        if (ctx == NULL) {
+            MPP_LOGE("malloc failed for tracker context\n");
+            ret = MPP_MALLOC_ERROR;
+            break;
+        }
+        memset(ctx, 0, sizeof(_tracker_ctx_t));
+        ctx->det_elem = det_elem;
+        set_noises(ctx, &elem->params);
+        elem->priv = ctx;
+
+        /* assign element entry/function */
+        elem->entry = tracker_func;
+
+        /* element does not access the image: in-place */
+        elem->io.inplace = true;
+        elem->io.nb_in_buf = 1;
+        elem->io.in_buf[0] = elem->prev->io.out_buf[0];
+        elem->io.nb_out_buf = 1;
+        elem->io.out_buf[0] = elem->io.in_buf[0];
+        /* the image is not accessed */
+        elem->in_access = MPP_ACCESS_NONE;
+        elem->out_access = MPP_ACCESS_NONE;
+    } while (false);
+
+    return ret;
+}
+
+/* tracker update function: association and filter parameters only */
+uint32_t mpp_tracker_update(_elem_t *elem, mpp_element_params_t *params)
+{
+    uint32_t ret = MPP_SUCCESS;
+
+    do {
+        if ((elem == NULL) || (params == NULL)) {
+            MPP_LOGE("invalid input parameters\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        if (elem->proc_typ != MPP_ELEMENT_TRACKER)
+        {
+            MPP_LOGE("invalid element %s (expected element TRACKER)\n", elem_name(elem->proc_typ));
+            ret = MPP_INVALID_ELEM;
+            break;
+        }
+        if (params->tracker.detection != elem->params.tracker.detection) {
+            MPP_LOGE("Tracker detection element cannot be changed\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        ret = check_tracker_params(params);
+        if (ret != MPP_SUCCESS)
+            break;
+
+        elem->params.tracker = params->tracker;
+        set_noises(elem->priv, params);
+    } while (false);
+
+    return ret;
+}
@@ -24,6 +24,11 @@ unsigned int elem_test_setup(_elem_t *elem);
 unsigned int elem_lbl_rct_setup(_elem_t *elem);
 unsigned int elem_convert_setup(_elem_t *elem);
 unsigned int elem_inference_setup(_elem_t *elem);
+unsigned int elem_detection_setup(_elem_t *elem);
+unsigned int elem_classification_setup(_elem_t *elem);
+unsigned int elem_roi_inference_setup(_elem_t *elem);
+unsigned int elem_tracker_setup(_elem_t *elem);
+unsigned int elem_motion_setup(_elem_t *elem);
 
 typedef struct _elem_func_id_pair {
     mpp_element_id_t id;
@@ -37,6 +42,11 @@ elem_func_id_pair elem_setup_funcs[] =
     {MPP_ELEMENT_INFERENCE, elem_inference_setup},
     {MPP_ELEMENT_LABELED_RECTANGLE, elem_lbl_rct_setup},
     {MPP_ELEMENT_CONVERT, elem_convert_setup},
+    {MPP_ELEMENT_DETECTION, elem_detection_setup},
+    {MPP_ELEMENT_CLASSIFICATION, elem_classification_setup},
+    {MPP_ELEMENT_ROI_INFERENCE, elem_roi_inference_setup},
+    {MPP_ELEMENT_TRACKER, elem_tracker_setup},
+    {MPP_ELEMENT_MOTION, elem_motion_setup},
 #ifdef EMULATOR
     {MPP_ELEMENT_TEST, elem_test_setup},
 #endif
@@ -0,0 +1,226 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Asynchronous events dispatch
+ *
+ * Each pipeline may own a bounded single-producer/single-consumer queue:
+ * the producer is the heap task executing the pipeline, the consumer is the
+ * events dispatch task which calls the application callbacks.
+ * With the "drop oldest" overflow policy the producer also consumes, so the
+ * read index is advanced with compare-and-swap by both sides.
+ */
+
+#include <string.h>
+#include <stdatomic.h>
+#include "mpp_api_types.h"
+#include "mpp_api_types_internal.h"
+#include "mpp_event.h"
+#include "mpp_debug.h"
+#include "hal_os.h"
+
+/* events dispatch task */
+#define EVT_DISPATCH_STACK_SZ   1200
+
+typedef struct {
+    mpp_evt_t evt;
+    void *evt_data;
+    mpp_evt_release_t release;
+    void *release_arg;
+} _mpp_evt_entry_t;
+
+struct _mpp_evt_queue_s {
+    _mpp_t *mpp;
+    unsigned int len;
+    atomic_uint head;       /* next entry written */
+    atomic_uint tail;       /* next entry read */
+    unsigned int dropped;   /* events dropped on overflow */
+    hal_sema_t space;       /* given when an entry is consumed */
+    _mpp_evt_entry_t *entries;
+    struct _mpp_evt_queue_s *next;
+};
+
+/* list of queues serviced by the dispatch task */
+static _Atomic(_mpp_evt_queue_t *) evt_queues;
+static hal_sema_t evt_wakeup;
+static hal_task_t hEvtDispatchTask;
+
+bool mpp_event_subscribed(const _mpp_t *mpp, mpp_evt_t evt)
+{
+    if (mpp->params.evt_callback_f == NULL)
+        return false;
+    return (mpp->params.mask & MPP_EVENT_MASK(evt)) != 0;
+}
+
+static void evt_deliver(_mpp_t *mpp, _mpp_evt_entry_t *entry)
+{
+    mpp->params.evt_callback_f((mpp_t)mpp, entry->evt, entry->evt_data, mpp->params.cb_userdata);
+    if (entry->release != NULL)
+        entry->release(entry->release_arg);
+}
+
+/* consumer side, also used by the producer to drop the oldest entry */
+static bool evt_queue_pop(_mpp_evt_queue_t *q, _mpp_evt_entry_t *entry)
+{
+    unsigned int tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+
+    for (;;) {
+        unsigned int head = atomic_load_explicit(&q->head, memory_order_acquire);
+        if (tail == head)
+            return false;
+        *entry = q->entries[tail % q->len];
+        /* the copy is valid only if nobody consumed the entry meanwhile */
+        if (atomic_compare_exchange_weak_explicit(&q->tail, &tail, tail + 1,
+                memory_order_acq_rel, memory_order_acquire))
+            return true;
+    }
+}
+
+static int evt_queue_push(_mpp_evt_queue_t *q, const _mpp_evt_entry_t *entry)
+{
+    unsigned int head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    _mpp_evt_entry_t oldest;
+
+    while ((head - atomic_load_explicit(&q->tail, memory_order_acquire)) >= q->len) {
+        if (q->mpp->params.evt_overflow == MPP_EVT_OVERFLOW_BLOCK) {
+            hal_sema_take(q->space, HAL_MAX_TIMEOUT);
+            continue;
+        }
+        /* drop the oldest pending event */
+        if (evt_queue_pop(q, &oldest)) {
+            q->dropped++;
+            if (oldest.release != NULL)
+                oldest.release(oldest.release_arg);
+            MPP_LOGI_IF(RLMT_CHECK(1), "mpp@%p: %d events dropped\n", q->mpp, q->dropped);
+        }
+    }
+    q->entries[head % q->len] = *entry;
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    hal_sema_give(evt_wakeup);
+
+    return MPP_SUCCESS;
+}
+
+static void evtDispatchTaskFunc(void *arg)
+{
+    _mpp_evt_entry_t entry;
+    bool delivered;
+
+    MPP_LOGI("evtDispatchTask starting\n");
+    for (;;) {
+        hal_sema_take(evt_wakeup, HAL_MAX_TIMEOUT);
+        do {
+            delivered = false;
+            for (_mpp_evt_queue_t *q = atomic_load(&evt_queues); q != NULL; q = q->next) {
+                if (!evt_queue_pop(q, &entry))
+                    continue;
+                hal_sema_give(q->space);
+                evt_deliver(q->mpp, &entry);
+                delivered = true;
+            }
+        } while (delivered);
+    }
+}
+
+int mpp_event_queue_create(_mpp_t *mpp, unsigned int len)
+{
+    _mpp_evt_queue_t *q;
+    int ret;
+
+    if ((mpp == NULL) || (len == 0))
+        return MPP_INVALID_PARAM;
+    if (mpp->evt_queue != NULL)
+        return MPP_SUCCESS;
+
+    /* dispatch task is created with the first queue */
+    if (hEvtDispatchTask == NULL) {
+        evt_wakeup = hal_sema_create_binary();
+        if (evt_wakeup == NULL)
+            return MPP_ERR_ALLOC_MUTEX;
+        /* same priority as the PR task: callbacks are time-sliced with the preemptable work */
+        ret = hal_task_create(evtDispatchTaskFunc,
+                              "evtDispatchTask",
+                              EVT_DISPATCH_STACK_SZ,
+                              NULL,
+                              mpp_get_pr_task_prio(),
+                              &hEvtDispatchTask);
+        if (ret != MPP_SUCCESS) {
+            MPP_LOGE("Failed to create evtDispatchTask\n");
+            return MPP_ERROR;
+        }
+    }
+
+    q = hal_malloc(sizeof(_mpp_evt_queue_t));
+    if (q == NULL)
+        return MPP_MALLOC_ERROR;
+    memset(q, 0, sizeof(_mpp_evt_queue_t));
+    q->entries = hal_malloc(len * sizeof(_mpp_evt_entry_t));
+    q->space = hal_sema_create_binary();
+    if ((q->entries == NULL) || (q->space == NULL)) {
+        if (q->entries != NULL)
+            hal_free(q->entries);
+        hal_sema_delete(q->space);
+        hal_free(q);
+        return MPP_MALLOC_ERROR;
+    }
+    q->mpp = mpp;
+    q->len = len;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+
+    /* publish the queue to the dispatch task */
+    q->next = atomic_load(&evt_queues);
+    while (!atomic_compare_exchange_weak(&evt_queues, &q->next, q));
+    mpp->evt_queue = q;
+
+    return MPP_SUCCESS;
+}
+
+int mpp_event_post(_mpp_t *mpp, mpp_evt_t evt, void *evt_data,
+                   mpp_evt_release_t release, void *release_arg)
+{
+    _mpp_evt_entry_t entry = {
+        .evt = evt,
+        .evt_data = evt_data,
+        .release = release,
+        .release_arg = release_arg,
+    };
+
+    if ((mpp == NULL) || (evt <= MPP_EVENT_INVALID) || (evt >= MPP_EVENT_NUM))
+        return MPP_INVALID_PARAM;
+
+    /* unsubscribed events are never queued */
+    if (!mpp_event_subscribed(mpp, evt)) {
+        if (release != NULL)
+            release(release_arg);
+        return MPP_SUCCESS;
+    }
+
+    /* event data owned by the poster may not outlive this call */
+    if ((mpp->evt_queue == NULL) || (release == NULL)) {
+        evt_deliver(mpp, &entry);
+        return MPP_SUCCESS;
+    }
+
+    return evt_queue_push(mpp->evt_queue, &entry);
+}
+
+int mpp_event_notify(mpp_t mpp, mpp_evt_t evt, void *evt_data, void *user_data)
+{
+    return mpp_event_post((_mpp_t *)user_data, evt, evt_data, NULL, NULL);
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef _MPP_EVENT_H
+#define _MPP_EVENT_H
+
+#include "mpp_api_types.h"
+#include "mpp_api_types_internal.h"
+
+/* called by the dispatch task once the application callback returned */
+typedef void (*mpp_evt_release_t)(void *arg);
+
+/* create the events queue of a pipeline (no-op if it already has one) */
+int mpp_event_queue_create(_mpp_t *mpp, unsigned int len);
+
+/* true if the application receives 'evt' from the pipeline */
+bool mpp_event_subscribed(const _mpp_t *mpp, mpp_evt_t evt);
+
+/* post an event to the application.
+ * Events whose data is released by the poster (release != NULL) are queued
+ * when the pipeline has an events queue, all other events are delivered
+ * synchronously from the calling task.
+ */
+int mpp_event_post(_mpp_t *mpp, mpp_evt_t evt, void *evt_data,
+                   mpp_evt_release_t release, void *release_arg);
+
+/* HAL callback adapter: user_data is the _mpp_t pointer */
+int mpp_event_notify(mpp_t mpp, mpp_evt_t evt, void *evt_data, void *user_data);
+
+#endif
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Load governor
+ *
+ * Per branch controller degrading the processing by steps when the filtered
+ * execution time overruns the budget, and restoring it with hysteresis when
+ * headroom returns.
+ */
+
+#include <string.h>
+#include "mpp_api.h"
+#include "mpp_api_types_internal.h"
+#include "mpp_governor.h"
+#include "mpp_buffer.h"
+#include "mpp_event.h"
+#include "mpp_debug.h"
+#include "hal_os.h"
+
+#define GOV_DEFAULT_HEADROOM_PCT    70
+#define GOV_DEFAULT_DEGRADE_FRAMES  4
+#define GOV_DEFAULT_RESTORE_FRAMES  30
+/* execution time filter: weight of new samples 1/2^GOV_FILTER_SHIFT */
+#define GOV_FILTER_SHIFT            2
+
+struct _mpp_governor_s {
+    mpp_governor_params_t params;
+    mpp_governor_level_t *levels;   /* copy of the levels declared by the application */
+    mpp_element_params_t *nominal;  /* level 0 parameters of the level elements, indexed as levels */
+    unsigned int level;             /* current degradation level */
+    int exec_us;                    /* filtered execution time (us) */
+    unsigned int over_cnt;          /* consecutive overloaded frames */
+    unsigned int under_cnt;         /* consecutive frames with headroom */
+    mpp_governor_evt_t evt[2];      /* event data, alternated while a queued event is pending */
+    unsigned int evt_idx;
+};
+
+/* event data lives in the governor */
+static void gov_evt_release(void *arg)
+{
+    (void)arg;
+}
+
+/* parameters of the element declared by levels[idx] at level 'level' */
+static const mpp_element_params_t *gov_elem_params(const _mpp_governor_t *gov, unsigned int idx, unsigned int level)
+{
+    const mpp_element_params_t *p = &gov->nominal[idx];
+
+    for (unsigned int j = 0; j < level; j++) {
+        if (gov->levels[j].elem == gov->levels[idx].elem)
+            p = gov->levels[j].elem_params;
+    }
+    return p;
+}
+
+static void gov_set_level(_mpp_t *mpp, _mpp_governor_t *gov, unsigned int level)
+{
+    unsigned int prev = gov->level;
+    unsigned int i, j;
+    int ret;
+
+    for (i = 0; i < gov->params.nb_levels; i++) {
+        if (gov->levels[i].elem == 0)
+            continue;
+        /* update each element once, from its first level */
+        for (j = 0; j < i; j++) {
+            if (gov->levels[j].elem == gov->levels[i].elem)
+                break;
+        }
+        if (j < i)
+            continue;
+        const mpp_element_params_t *from = gov_elem_params(gov, i, prev);
+        const mpp_element_params_t *to = gov_elem_params(gov, i, level);
+        if (from == to)
+            continue;
+        ret = mpp_element_update((mpp_t)mpp, gov->levels[i].elem, (mpp_element_params_t *)to);
+        if (ret != MPP_SUCCESS)
+            MPP_LOGE("governor: failed to update element at level %u (%d)\n", level, ret);
+    }
+
+    gov->level = level;
+    gov->over_cnt = 0;
+    gov->under_cnt = 0;
+    MPP_LOGI("mpp@%p: governor level %u -> %u\n", mpp, prev, level);
+
+    mpp_governor_evt_t *evt = &gov->evt[gov->evt_idx];
+    gov->evt_idx ^= 1;
+    evt->level = level;
+    evt->prev_level = prev;
+    evt->exec_time = (gov->exec_us + 500) / 1000;
+    mpp_event_post(mpp, MPP_EVENT_GOVERNOR_LEVEL, evt, gov_evt_release, NULL);
+}
+
+int mpp_governor_create(_mpp_t *mpp, const mpp_governor_params_t *params)
+{
+    _mpp_governor_t *gov = NULL;
+    unsigned int nb, i;
+    int ret = MPP_SUCCESS;
+
+    do {
+        if (mpp == NULL) {
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        if ((params == NULL) || (params->nb_levels == 0))
+            break;
+        nb = params->nb_levels;
+        if ((params->levels == NULL) || (params->budget_ms == 0) || (params->headroom_pct >= 100)) {
+            MPP_LOGE("governor: invalid levels, budget or headroom\n");
+            ret = MPP_INVALID_PARAM;
+            break;
+        }
+        for (i = 0; i < nb; i++) {
+            if (params->levels[i].elem == 0)
+                continue;
+            _elem_t *elem = mpp_elem_from_handle(params->levels[i].elem);
+            if ((elem == NULL) || (elem->mpp != mpp) || (params->levels[i].elem_params == NULL)) {
+                MPP_LOGE("governor: invalid element or parameters at level %u\n", i + 1);
+                ret = MPP_INVALID_PARAM;
+                break;
+            }
+        }
+        if (ret != MPP_SUCCESS)
+            break;
+
+        /* governor, levels and nominal parameters in one block */
+        gov = hal_malloc(sizeof(_mpp_governor_t) + nb * (sizeof(mpp_governor_level_t) + sizeof(mpp_element_params_t)));
+        if (gov == NULL) {
+            MPP_LOGE("governor: allocation failed\n");
+            ret = MPP_MALLOC_ERROR;
+            break;
+        }
+        memset(gov, 0, sizeof(_mpp_governor_t));
+        gov->params = *params;
+        if (gov->params.headroom_pct == 0)
+            gov->params.headroom_pct = GOV_DEFAULT_HEADROOM_PCT;
+        if (gov->params.degrade_frames == 0)
+            gov->params.degrade_frames = GOV_DEFAULT_DEGRADE_FRAMES;
+        if (gov->params.restore_frames == 0)
+            gov->params.restore_frames = GOV_DEFAULT_RESTORE_FRAMES;
+        gov->nominal = (mpp_element_params_t *)(gov + 1);
+        gov->levels = (mpp_governor_level_t *)(gov->nominal + nb);
+        memcpy(gov->levels, params->levels, nb * sizeof(mpp_governor_level_t));
+        gov->params.levels = gov->levels;
+        /* nominal parameters are those of the elements when the governor is set */
+        for (i = 0; i < nb; i++) {
+            if (gov->levels[i].elem != 0)
+                gov->nominal[i] = mpp_elem_from_handle(gov->levels[i].elem)->params;
+        }
+        gov->exec_us = 0;
+    } while (false);
+
+    if (ret == MPP_SUCCESS) {
+        if (mpp->gov != NULL) {
+            /* restore the nominal parameters of the previous governor elements */
+            if (mpp->gov->level > 0)
+                gov_set_level(mpp, mpp->gov, 0);
+            hal_free(mpp->gov);
+        }
+        mpp->gov = gov;
+    }
+
+    return ret;
+}
+
+bool mpp_governor_shed(const _mpp_t *mpp, const _elem_t *elem)
+{
+    const _mpp_governor_t *gov = mpp->gov;
+
+    if ((gov == NULL) || (gov->level == 0))
+        return false;
+    if ((elem->proc_typ != MPP_ELEMENT_INFERENCE) && (elem->proc_typ != MPP_ELEMENT_ROI_INFERENCE))
+        return false;
+
+    unsigned int period = gov->levels[gov->level - 1].inference_period;
+    if (period <= 1)
+        return false;
+    /* frame ids keep the decimation consistent between the inference elements of the branch */
+    return (mpp_buf_frame_id(elem->io.in_buf[0]) % period) != 0;
+}
+
+void mpp_governor_update(_mpp_t *mpp, uint32_t exec_time, bool overrun)
+{
+    _mpp_governor_t *gov = mpp->gov;
+
+    if (gov == NULL)
+        return;
+
+    gov->exec_us += ((int)exec_time - gov->exec_us) / (1 << GOV_FILTER_SHIFT);
+
+    int budget_us = gov->params.budget_ms * 1000;
+    if (overrun || (gov->exec_us > budget_us)) {
+        gov->under_cnt = 0;
+        if ((++gov->over_cnt >= gov->params.degrade_frames) && (gov->level < gov->params.nb_levels))
+            gov_set_level(mpp, gov, gov->level + 1);
+    } else if ((int64_t)gov->exec_us * 100 < (int64_t)budget_us * gov->params.headroom_pct) {
+        gov->over_cnt = 0;
+        if ((++gov->under_cnt >= gov->params.restore_frames) && (gov->level > 0))
+            gov_set_level(mpp, gov, gov->level - 1);
+    } else {
+        gov->over_cnt = 0;
+        gov->under_cnt = 0;
+    }
+}
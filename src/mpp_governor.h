@@ -0,0 +1,35 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef _MPP_GOVERNOR_H
+#define _MPP_GOVERNOR_H
+
+#include "mpp_api_types.h"
+#include "mpp_api_types_internal.h"
+
+/* set the load governor of a branch, replacing the previous one (NULL params: remove) */
+int mpp_governor_create(_mpp_t *mpp, const mpp_governor_params_t *params);
+
+/* true if the governor sheds the current frame of element 'elem' */
+bool mpp_governor_shed(const _mpp_t *mpp, const _elem_t *elem);
+
+/* feed the execution time (us) of one frame processed by the branch,
+ * 'overrun' reports a run-to-completion cycle overrun */
+void mpp_governor_update(_mpp_t *mpp, uint32_t exec_time, bool overrun);
+
+#endif
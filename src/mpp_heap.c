@@ -19,6 +19,11 @@
 #include "mpp_heap.h"
 #include "hal_os.h"
 #include "mpp_debug.h"
+#include "mpp_governor.h"
+#include "mpp_buffer.h"
+#include "mpp_cache.h"
+#include "mpp_meta.h"
+#include "mpp_trace.h"
 
 extern hal_sema_t stats_lock[];
 
@@ -67,8 +72,6 @@ void mpp_heap_move(_mpp_t *mpp, _mpp_t *prio_lst[], unsigned int dst_prio)
     mpp->prio = dst_prio;
 }
 
-void HAL_DCACHE_CleanInvalidateByRange(uint32_t addr, uint32_t size);
-
 /* ask the pipeline source for frame completion:
  * returns true when the source has finished capturing the full frame (all stripes)
  * else returns false.
@@ -98,6 +101,147 @@ static bool mpp_is_done(_mpp_t *mpp)
     return true;
 }
 
+/* true if 'buf' is also an output of the element (inplace processing) */
+static bool mpp_elem_is_output(const _elem_t *elem, const buf_desc_t *buf)
+{
+    for (int i = 0; i < elem->io.nb_out_buf; i++)
+    {
+        if (elem->io.out_buf[i] == buf)
+            return true;
+    }
+    return false;
+}
+
+/* acquire the buffers of an element: outputs for writing, inputs for reading
+ * (inputs shared with an output are covered by the write acquisition).
+ * If a buffer is busy the buffers already acquired are released and false is returned.
+ */
+static bool mpp_elem_acquire(_elem_t *elem)
+{
+    _mpp_buf_status_t prev[MAX_OUTPUT_PORTS];
+    int i, j;
+
+    for (i = 0; i < elem->io.nb_out_buf; i++)
+    {
+        if (!mpp_buf_acquire_write(elem->io.out_buf[i], &prev[i]))
+            break;
+    }
+    if (i == elem->io.nb_out_buf)
+    {
+        for (j = 0; j < elem->io.nb_in_buf; j++)
+        {
+            if (mpp_elem_is_output(elem, elem->io.in_buf[j]))
+                continue;
+            if (!mpp_buf_acquire_read(elem->io.in_buf[j]))
+                break;
+        }
+        if (j == elem->io.nb_in_buf)
+            return true;
+        /* roll back */
+        while (j-- > 0)
+        {
+            if (!mpp_elem_is_output(elem, elem->io.in_buf[j]))
+                mpp_buf_release_read(elem->io.in_buf[j]);
+        }
+    }
+    while (i-- > 0)
+        mpp_buf_abort_write(elem->io.out_buf[i], prev[i]);
+
+    return false;
+}
+
+/* release the buffers of an element after processing:
+ * outputs carry the most recent input frame id, its metadata and capture time.
+ */
+static void mpp_elem_release(_elem_t *elem)
+{
+    unsigned short latest_id = 0; /* records highest id from different inputs */
+    _mpp_meta_t *latest_meta = NULL; /* metadata of the most recent input frame */
+    uint32_t latest_ts = 0;          /* capture time of the most recent input frame */
+    int i;
+
+    for (i = 0; i < elem->io.nb_in_buf; i++)
+    {
+        /* the frame id cannot change while the buffer is held */
+        unsigned short id = mpp_buf_frame_id(elem->io.in_buf[i]);
+        /* record last input frame id processed */
+        elem->io.last_frame_id[i] = id;
+        /* output id will be most recent frame id */
+        if ((i == 0) || (id > latest_id)) {
+            latest_id = id;
+            latest_meta = elem->io.in_buf[i]->meta;
+            latest_ts = elem->io.in_buf[i]->capture_ts;
+        }
+    }
+    for (i = 0; i < elem->io.nb_out_buf; i++)
+    {
+        /* metadata follows the frame, it is visible once the buffer is published.
+         * it is referenced before the inputs are released so it cannot be reused meanwhile */
+        mpp_meta_set(elem->io.out_buf[i], latest_meta);
+        elem->io.out_buf[i]->capture_ts = latest_ts;
+    }
+    for (i = 0; i < elem->io.nb_in_buf; i++)
+    {
+        if (!mpp_elem_is_output(elem, elem->io.in_buf[i]))
+            mpp_buf_release_read(elem->io.in_buf[i]);
+    }
+    for (i = 0; i < elem->io.nb_out_buf; i++)
+        mpp_buf_publish(elem->io.out_buf[i], latest_id);
+}
+
+/* glass-to-glass latency: called by the sinks once their input frame is flushed */
+void mpp_sink_latency(_elem_t *sink)
+{
+    buf_desc_t *buf = sink->io.in_buf[0];
+    unsigned short id = mpp_buf_frame_id(buf);
+
+    /* sinks flush the same frame until a new one is produced, count it once */
+    if ((sink->mpp->g2g_hist == NULL) || (id == sink->io.last_frame_id[0]))
+        return;
+    sink->io.last_frame_id[0] = id;
+    mpp_hist_record(sink->mpp->g2g_hist, hal_get_time_us() - buf->capture_ts);
+}
+
+/* branch decimation: returns true if the new frame reaching the first element
+ * of a split/background branch is dropped, the frame is then consumed
+ * so the rest of the branch does not see it either.
+ */
+static bool mpp_decimate(_mpp_t *mpp, _elem_t *elem)
+{
+    unsigned int decimation = mpp->params.decimation;
+    unsigned int interval = mpp->params.min_interval_ms;
+    bool drop = false;
+    int i;
+
+    if ((mpp->hook == NULL) || (elem == NULL) || (elem->type != MPP_TYPE_PROC)
+            || ((decimation <= 1) && (interval == 0)))
+        return false;
+
+    /* no new frame: nothing to decide, the element will be skipped */
+    if (elem->io.last_frame_id[0] == mpp_buf_frame_id(elem->io.in_buf[0]))
+        return false;
+    if (decimation > 1)
+    {
+        drop = ((mpp->decim_cnt++ % decimation) != 0);
+    }
+    if (!drop && (interval != 0))
+    {
+        uint32_t now = hal_get_ostick();
+        /* first frame always passes */
+        if ((mpp->decim_tick != 0) && (hal_tick_to_ms(now - mpp->decim_tick) < interval))
+            drop = true;
+        else
+            mpp->decim_tick = (now != 0) ? now : 1;
+    }
+    if (drop)
+    {
+        for (i = 0; i < elem->io.nb_in_buf; i++)
+            elem->io.last_frame_id[i] = mpp_buf_frame_id(elem->io.in_buf[i]);
+        MPP_LOGD("mpp %d: frame %d decimated\n", mpp->prio, elem->io.last_frame_id[0]);
+    }
+    return drop;
+}
+
 /* MPP serial execution */
 void mpp_execute(_mpp_t *mpp)
 {
@@ -138,8 +282,18 @@ void mpp_execute(_mpp_t *mpp)
 
     bool rlmt_log_on = RLMT_CHECK(1);
     uint32_t start_time, end_time;
+    uint32_t branch_start = 0;
+    int nb_run = 0;
     mpp_stats_t *stats;
 
+    if (mpp_decimate(mpp, elem))
+    {
+        hal_sema_give(mpp->status_sema);
+        return;
+    }
+
+    if (mpp->gov || mpp->hist) branch_start = hal_get_time_us();
+
     /* loop over processing elements in mpp */
     while ((elem != NULL) && (elem->mpp == mpp) && (elem->type == MPP_TYPE_PROC))
     {
@@ -147,101 +301,79 @@ void mpp_execute(_mpp_t *mpp)
         update = false;
         MPP_LOGD_IF(rlmt_log_on, "\t\telem@%p\n", elem);
 
-        /* check and update buffer status in atomic block */
+        /* check at least one input frame is new versus last id recorded */
+        for (i = 0; i < elem->io.nb_in_buf; i++)
+        {
+            if (elem->io.last_frame_id[i] != mpp_buf_frame_id(elem->io.in_buf[i])) update = true;
+        }
+        if (!update)
+        {
+            MPP_LOGD("element %s: no input buffer update! skip processing.\n", elem_name(elem->proc_typ));
+            elem = elem->next[0];
+            continue;
+        }
+        if (mpp_governor_shed(mpp, elem))
         {
-            hal_atomic_enter();
+            /* frame consumed without processing, the element keeps its last outputs.
+             * downstream elements still run on their own updated inputs, and the sink is served */
             for (i = 0; i < elem->io.nb_in_buf; i++)
-            {
-                if (elem->io.in_buf[i]->status == MPP_BUFFER_WRITTING) busy = true;
-                /* check at least one input frame is new versus last id recorded */
-                if (elem->io.last_frame_id[i] != elem->io.in_buf[i]->frame_id) update = true;
-            }
-            for (i = 0; i < elem->io.nb_out_buf; i++)
-            {
-                if (elem->io.out_buf[i]->status == MPP_BUFFER_READING) busy = true;
-            }
-            if (busy)
-            {
-                hal_atomic_exit();
-                MPP_LOGD("element %s: input or output buffer busy! skip processing.\n", elem_name(elem->proc_typ));
-                elem = elem->next[0];
-                continue;
-            }
-            else if (!update)
-            {
-                hal_atomic_exit();
-                MPP_LOGD("element %s: no input buffer update! skip processing.\n", elem_name(elem->proc_typ));
-                elem = elem->next[0];
-                continue;
-            }
-            else
-            {
-                for (i = 0; i < elem->io.nb_in_buf; i++)
-                {
-                    elem->io.in_buf[i]->status = MPP_BUFFER_READING;
-                    MPP_LOGD("In mpp %d, Element %s starts processing input frame %d\n", mpp->prio, elem_name(elem->proc_typ), elem->io.in_buf[i]->frame_id);
-                }
-                for (i = 0; i < elem->io.nb_out_buf; i++)
-                {
-                    elem->io.out_buf[i]->status = MPP_BUFFER_WRITTING;
-                }
-                hal_atomic_exit();
-            }
+                elem->io.last_frame_id[i] = mpp_buf_frame_id(elem->io.in_buf[i]);
+            MPP_LOGD("element %s: frame %d shed by the governor\n", elem_name(elem->proc_typ), mpp_buf_frame_id(elem->io.in_buf[0]));
+            elem = elem->next[0];
+            continue;
         }
+        busy = !mpp_elem_acquire(elem);
+        if (busy)
+        {
+            MPP_LOGD("element %s: input or output buffer busy! skip processing.\n", elem_name(elem->proc_typ));
+            elem = elem->next[0];
+            continue;
+        }
+        MPP_LOGD("In mpp %d, Element %s starts processing input frame %d\n", mpp->prio, elem_name(elem->proc_typ), mpp_buf_frame_id(elem->io.in_buf[0]));
 
-        /* invalidate cache for input buffer */
+        /* cache maintenance at the CPU/device handoffs */
         for (i = 0; i < elem->io.nb_in_buf; i++)
+            mpp_cache_before_read(elem->io.in_buf[i], elem->in_access);
+        for (i = 0; i < elem->io.nb_out_buf; i++)
         {
-            /* cacheable buffer, read by CPU */
-            if (elem->io.in_buf[i]->hw->cacheable)
-            {
-                int bufsize = elem->io.in_buf[i]->hw->stride * elem->io.in_buf[i]->width;
-                HAL_DCACHE_CleanInvalidateByRange((uint32_t) elem->io.in_buf[i]->hw->heap_p, bufsize);
-            }
+            mpp_cache_before_write(elem->io.out_buf[i], elem->out_access);
+            /* elements writing part of their output narrow the range */
+            elem->io.out_written_off[i] = 0;
+            elem->io.out_written_len[i] = mpp_cache_buf_size(elem->io.out_buf[i]);
         }
 
         stats = elem->params.stats;
-        if (stats) start_time = hal_get_exec_time();
+        if (stats || elem->hist) start_time = hal_get_time_us();
 
         /* do the processing */
-        elem->entry(elem);
+        MPP_TRACE_EVT(MPP_TRACE_ELEM_BEGIN, 0, mpp_buf_frame_id(elem->io.in_buf[0]), elem);
+        ret = elem->entry(elem);
+        MPP_TRACE_EVT(MPP_TRACE_ELEM_END, 0, mpp_buf_frame_id(elem->io.in_buf[0]), elem);
+        nb_run++;
 
-        if (stats) end_time = hal_get_exec_time();
+        if (stats || elem->hist) end_time = hal_get_time_us();
+        if (elem->hist) mpp_hist_record(elem->hist, end_time - start_time);
         if (stats && hal_sema_take(stats_lock[MPP_STATS_GRP_ELEMENT], 0)) {
-            stats->elem.elem_exec_time = end_time - start_time;
+            stats->elem.elem_exec_time_us = end_time - start_time;
+            stats->elem.elem_exec_time = stats->elem.elem_exec_time_us / 1000;
             hal_sema_give(stats_lock[MPP_STATS_GRP_ELEMENT]);
         }
 
-        /* flush cache for output buffer */
+        /* record the output ranges written, cleaned when a device reads them */
         for (i = 0; i < elem->io.nb_out_buf; i++)
-        {
-            /* cacheable buffer, written by CPU */
-            if (elem->io.out_buf[i]->hw->cacheable)
-            {
-                int bufsize = elem->io.out_buf[i]->hw->stride * elem->io.out_buf[i]->width;
-                HAL_DCACHE_CleanInvalidateByRange((uint32_t) elem->io.out_buf[i]->hw->heap_p, bufsize);
-            }
-        }
+            mpp_cache_written(elem->io.out_buf[i], elem->out_access,
+                              elem->io.out_written_off[i], elem->io.out_written_len[i]);
+
+        mpp_elem_release(elem);
 
-        /* update status again in atomic block */
+        /* a gating element drops the frame for the processing elements after it,
+         * the sink is still served */
+        if (ret == MPP_ELEM_GATED)
         {
-            hal_atomic_enter();
-            unsigned short latest_id = 0; /* records highest id from different inputs */
-            for (i = 0; i < elem->io.nb_in_buf; i++)
-            {
-                elem->io.in_buf[i]->status = MPP_BUFFER_EMPTY;
-                /* record last input frame id processed */
-                elem->io.last_frame_id[i] = elem->io.in_buf[i]->frame_id;
-                /* output id will be most recent frame id */
-                if (elem->io.in_buf[i]->frame_id > latest_id) latest_id = elem->io.in_buf[i]->frame_id;
-            }
-            for (i = 0; i < elem->io.nb_out_buf; i++)
-            {
-                elem->io.out_buf[i]->status = MPP_BUFFER_READY;
-                /* update output frame id */
-                elem->io.out_buf[i]->frame_id = latest_id;
-            }
-            hal_atomic_exit();
+            MPP_LOGD("element %s gated frame %d\n", elem_name(elem->proc_typ), elem->io.last_frame_id[0]);
+            while ((elem != mpp->last_elem) && (elem->next[0] != NULL) && (elem->next[0]->mpp == mpp)
+                    && (elem->next[0]->type == MPP_TYPE_PROC))
+                elem = elem->next[0];
         }
         if (elem == mpp->last_elem)
             break;
@@ -249,9 +381,19 @@ void mpp_execute(_mpp_t *mpp)
             elem = elem->next[0];
     }
 
-    /* sink enqueue */
+    /* sink enqueue (none for a pipeline joined into another one) */
     MPP_LOGD_IF(rlmt_log_on, "Enqueue to sink @%p\n", elem);
-    if (elem->type == MPP_TYPE_SINK && elem->sink_enqueue) elem->sink_enqueue(mpp);
+    if ((elem != NULL) && (elem->type == MPP_TYPE_SINK) && elem->sink_enqueue) elem->sink_enqueue(mpp);
+
+    /* only frames processed by the branch feed the governor and histogram */
+    if ((mpp->gov || mpp->hist) && (nb_run > 0))
+    {
+        uint32_t branch_time = hal_get_time_us() - branch_start;
+        if (mpp->hist)
+            mpp_hist_record(mpp->hist, branch_time);
+        if (mpp->gov)
+            mpp_governor_update(mpp, branch_time, (mpp->exec_heap == rc_prio_lst) && mpp_rc_overrun());
+    }
 
     released = hal_sema_give(mpp->status_sema);
     if (!released)
@@ -276,13 +418,14 @@ void mpp_execute_heap(_mpp_t *prio_lst[])
                 _mpp_t *mpp = prio_lst[i];
                 /**/
                 stats = mpp->params.stats;
-                if (stats) start_time = hal_get_exec_time();
+                if (stats) start_time = hal_get_time_us();
                 mpp_execute(mpp);
-                if (stats) end_time = hal_get_exec_time();
+                if (stats) end_time = hal_get_time_us();
                 if (stats && hal_sema_take(stats_lock[MPP_STATS_GRP_MPP], 0))
                 {
                     stats->mpp.mpp = (mpp_t)mpp;
-                    stats->mpp.mpp_exec_time = end_time - start_time;
+                    stats->mpp.mpp_exec_time_us = end_time - start_time;
+                    stats->mpp.mpp_exec_time = stats->mpp.mpp_exec_time_us / 1000;
                     hal_sema_give(stats_lock[MPP_STATS_GRP_MPP]);
                 }
             }
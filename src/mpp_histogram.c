@@ -0,0 +1,120 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Latency histograms
+ *
+ * Fixed memory log-linear histograms (HDR style) recorded by the pipeline
+ * tasks and read by the application without locking: a read may miss the
+ * samples recorded meanwhile, and a window reset is applied by the writer
+ * at the next sample.
+ */
+
+#include <string.h>
+#include "mpp_api_types.h"
+#include "mpp_histogram.h"
+#include "mpp_debug.h"
+#include "hal_os.h"
+
+static unsigned int hist_index(uint32_t v)
+{
+    unsigned int e;
+
+    if (v < MPP_HIST_SUB)
+        return v;
+    e = 31 - __builtin_clz(v);
+    if (e > MPP_HIST_MAX_EXP)
+        return MPP_HIST_BUCKETS - 1;
+    return (e - MPP_HIST_SUB_BITS + 1) * MPP_HIST_SUB + ((v >> (e - MPP_HIST_SUB_BITS)) & (MPP_HIST_SUB - 1));
+}
+
+/* highest value counted in bucket 'idx' */
+static uint32_t hist_upper(unsigned int idx)
+{
+    unsigned int g = idx / MPP_HIST_SUB;
+    unsigned int m = idx % MPP_HIST_SUB;
+    unsigned int shift;
+
+    if (g == 0)
+        return m;
+    shift = g - 1;
+    return ((MPP_HIST_SUB + m + 1) << shift) - 1;
+}
+
+static void hist_clear(_mpp_hist_t *hist)
+{
+    memset(hist->counts, 0, sizeof(hist->counts));
+    hist->min = UINT32_MAX;
+    hist->max = 0;
+}
+
+_mpp_hist_t *mpp_hist_create(void)
+{
+    _mpp_hist_t *hist = hal_malloc(sizeof(_mpp_hist_t));
+
+    if (hist == NULL) {
+        MPP_LOGE("latency histogram allocation failed\n");
+        return NULL;
+    }
+    hist_clear(hist);
+    hist->reset = false;
+    return hist;
+}
+
+void mpp_hist_record(_mpp_hist_t *hist, uint32_t value_us)
+{
+    if (hist->reset) {
+        hist_clear(hist);
+        hist->reset = false;
+    }
+    hist->counts[hist_index(value_us)]++;
+    if (value_us < hist->min)
+        hist->min = value_us;
+    if (value_us > hist->max)
+        hist->max = value_us;
+}
+
+void mpp_hist_read(_mpp_hist_t *hist, mpp_latency_t *lat, bool reset)
+{
+    /* percentiles in 1/1000 */
+    static const unsigned int pct[] = { 500, 900, 990 };
+    uint32_t *res[] = { &lat->p50, &lat->p90, &lat->p99 };
+    uint32_t total = 0, cum = 0;
+    unsigned int i, p = 0;
+
+    memset(lat, 0, sizeof(mpp_latency_t));
+    for (i = 0; i < MPP_HIST_BUCKETS; i++)
+        total += hist->counts[i];
+
+    if (total != 0) {
+        lat->count = total;
+        lat->min = hist->min;
+        lat->max = hist->max;
+        for (i = 0; (i < MPP_HIST_BUCKETS) && (p < 3); i++) {
+            cum += hist->counts[i];
+            /* smallest bucket covering the percentile, reported with its highest value */
+            while ((p < 3) && ((uint64_t)cum * 1000 >= (uint64_t)total * pct[p])) {
+                uint32_t v = hist_upper(i);
+                *res[p++] = (v < lat->max) ? v : lat->max;
+            }
+        }
+    }
+
+    if (reset)
+        hist->reset = true;
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef _MPP_HISTOGRAM_H
+#define _MPP_HISTOGRAM_H
+
+#include "mpp_api_types.h"
+
+/* Log-linear latency histogram (microseconds):
+ * values under 2^MPP_HIST_SUB_BITS have exact buckets, each power of two above
+ * is split into 2^MPP_HIST_SUB_BITS linear buckets, the relative error is under 12.5%.
+ * Values beyond 2^(MPP_HIST_MAX_EXP+1) are counted in the last bucket.
+ */
+#define MPP_HIST_SUB_BITS   3
+#define MPP_HIST_SUB        (1U << MPP_HIST_SUB_BITS)
+#define MPP_HIST_MAX_EXP    26
+#define MPP_HIST_BUCKETS    (MPP_HIST_SUB * (MPP_HIST_MAX_EXP - MPP_HIST_SUB_BITS + 2))
+
+typedef struct {
+    uint32_t counts[MPP_HIST_BUCKETS];
+    uint32_t min;
+    uint32_t max;
+    volatile bool reset;    /* window reset requested by a reader, applied by the writer */
+} _mpp_hist_t;
+
+/* allocate an empty histogram, NULL if allocation failed */
+_mpp_hist_t *mpp_hist_create(void);
+
+/* add one sample: called by the task owning the histogram */
+void mpp_hist_record(_mpp_hist_t *hist, uint32_t value_us);
+
+/* percentiles of the current window, optionally starting a new window */
+void mpp_hist_read(_mpp_hist_t *hist, mpp_latency_t *lat, bool reset);
+
+#endif
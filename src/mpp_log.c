@@ -0,0 +1,174 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Deferred logs
+ *
+ * Records are reserved with an atomic increment and published with their
+ * sequence number, the formatting task skips the records overwritten before
+ * it could read them and reports how many were lost.
+ */
+
+#include <string.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include "mpp_config.h"
+#include "mpp_api_types.h"
+#include "mpp_log.h"
+#include "hal_debug.h"
+#include "hal_os.h"
+
+#ifndef HAL_LOG_LEVEL
+#define HAL_LOG_LEVEL LOG_DEFAULT_LEVEL
+#endif
+
+#if MPP_LOG_DEFERRED
+
+#if (MPP_LOG_RECORDS & (MPP_LOG_RECORDS - 1)) != 0
+#error "MPP_LOG_RECORDS must be a power of 2"
+#endif
+#if UINTPTR_MAX > 0xffffffffU
+#error "deferred logs record pointers as 32-bit words"
+#endif
+
+#define LOG_TASK_STACK_SZ   1000
+
+typedef struct {
+    atomic_uint seq;        /* record index + 1 once complete, 0 while written */
+    uint32_t tick;
+    const char *format;
+    const char *func;
+    uint16_t line;
+    uint8_t level;
+    uint8_t nargs;
+    uint32_t args[MPP_LOG_MAX_ARGS];
+} _mpp_log_rec_t;
+
+static _mpp_log_rec_t log_ring[MPP_LOG_RECORDS];
+static atomic_uint log_head;
+/* reader side, owned by the formatting task */
+static unsigned int log_tail;
+static unsigned int log_lost;
+static hal_task_t hLogTask = NULL;
+
+void mpp_log_record(int level, const char *func, int line, const char *format, unsigned int nargs, ...)
+{
+    unsigned int idx, i;
+    _mpp_log_rec_t *rec;
+    va_list args;
+
+    if (level > HAL_LOG_LEVEL)
+        return;
+
+    idx = atomic_fetch_add_explicit(&log_head, 1, memory_order_relaxed);
+    rec = &log_ring[idx & (MPP_LOG_RECORDS - 1)];
+    atomic_store_explicit(&rec->seq, 0, memory_order_relaxed);
+    rec->tick = hal_get_ostick();
+    rec->format = format;
+    rec->func = func;
+    rec->line = line;
+    rec->level = level;
+    rec->nargs = (nargs > MPP_LOG_MAX_ARGS) ? MPP_LOG_MAX_ARGS : nargs;
+    va_start(args, nargs);
+    for (i = 0; i < rec->nargs; i++)
+        rec->args[i] = va_arg(args, uint32_t);
+    va_end(args);
+    atomic_store_explicit(&rec->seq, idx + 1, memory_order_release);
+}
+
+unsigned int mpp_log_flush(void)
+{
+    unsigned int head = atomic_load_explicit(&log_head, memory_order_acquire);
+    unsigned int n = 0;
+    _mpp_log_rec_t rec;
+
+    while (log_tail != head) {
+        _mpp_log_rec_t *slot = &log_ring[log_tail & (MPP_LOG_RECORDS - 1)];
+
+        /* the writers went round the ring */
+        if ((head - log_tail) > MPP_LOG_RECORDS) {
+            log_lost += head - log_tail - MPP_LOG_RECORDS;
+            log_tail = head - MPP_LOG_RECORDS;
+            continue;
+        }
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != log_tail + 1)
+            break;  /* still being written */
+        rec.tick = slot->tick;
+        rec.format = slot->format;
+        rec.func = slot->func;
+        rec.line = slot->line;
+        rec.level = slot->level;
+        rec.nargs = slot->nargs;
+        memcpy(rec.args, slot->args, sizeof(rec.args));
+        /* overwritten while copied */
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != log_tail + 1) {
+            head = atomic_load_explicit(&log_head, memory_order_acquire);
+            continue;
+        }
+        log_tail++;
+        LOG_AT("MPP", rec.func, rec.line, rec.level, rec.tick, rec.format,
+               rec.args[0], rec.args[1], rec.args[2], rec.args[3], rec.args[4], rec.args[5]);
+        n++;
+    }
+    if (log_lost > 0) {
+        LOG_AT("MPP", __func__, __LINE__, LOG_LVL_ERR, hal_get_ostick(), "%u log records lost\n", log_lost);
+        log_lost = 0;
+    }
+
+    return n;
+}
+
+static void mpp_log_task(void *arg)
+{
+    uint32_t period = MPP_LOG_PERIOD_MS / hal_get_tick_period_ms();
+
+    for (;;) {
+        mpp_log_flush();
+        hal_task_delay((period > 0) ? period : 1);
+    }
+}
+
+int mpp_log_start(void)
+{
+    int ret;
+
+    if (hLogTask != NULL)
+        return MPP_SUCCESS;
+    ret = hal_task_create(mpp_log_task, "mppLogTask", LOG_TASK_STACK_SZ, NULL, MPP_LOG_TASK_PRIO, &hLogTask);
+    if (ret != MPP_SUCCESS)
+        LOGE("MPP", __func__, __LINE__, "Failed to create mppLogTask\n");
+    return ret;
+}
+
+#else /* MPP_LOG_DEFERRED */
+
+void mpp_log_record(int level, const char *func, int line, const char *format, unsigned int nargs, ...)
+{
+}
+
+unsigned int mpp_log_flush(void)
+{
+    return 0;
+}
+
+int mpp_log_start(void)
+{
+    return MPP_SUCCESS;
+}
+
+#endif /* MPP_LOG_DEFERRED */
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Deferred logs
+ *
+ * With MPP_LOG_DEFERRED the MPP logs do not format anything on the calling
+ * task: the format string address and up to MPP_LOG_MAX_ARGS raw 32-bit
+ * arguments are copied to a ring buffer, a low priority task formats them later.
+ * Arguments must be integers or pointers, strings must remain valid
+ * (literals, static names).
+ */
+
+#ifndef _MPP_LOG_H
+#define _MPP_LOG_H
+
+#include <stdint.h>
+
+/* build option MPP_LOG_DEFERRED defers the formatting of the MPP logs */
+#ifndef MPP_LOG_DEFERRED
+#define MPP_LOG_DEFERRED 0
+#endif
+/* number of records in the ring buffer, power of 2 */
+#ifndef MPP_LOG_RECORDS
+#define MPP_LOG_RECORDS 128
+#endif
+/* logs formatting task priority and period (ms) */
+#ifndef MPP_LOG_TASK_PRIO
+#define MPP_LOG_TASK_PRIO 1
+#endif
+#ifndef MPP_LOG_PERIOD_MS
+#define MPP_LOG_PERIOD_MS 100
+#endif
+
+#define MPP_LOG_MAX_ARGS 6
+
+/* copy a log record to the ring buffer, 'nargs' uint32_t arguments follow */
+void mpp_log_record(int level, const char *func, int line, const char *format, unsigned int nargs, ...);
+
+/* format the pending records, returns the number of records printed */
+unsigned int mpp_log_flush(void);
+
+/* start the formatting task */
+int mpp_log_start(void);
+
+/* arguments count and conversion to 32-bit words */
+#define MPP_LOG_NARGS(...) MPP_LOG_NARGS_(_, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define MPP_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, n, ...) n
+#define MPP_LOG_W(x) ((uint32_t)(uintptr_t)(x))
+#define MPP_LOG_MAP0()
+#define MPP_LOG_MAP1(a) , MPP_LOG_W(a)
+#define MPP_LOG_MAP2(a, ...) , MPP_LOG_W(a) MPP_LOG_MAP1(__VA_ARGS__)
+#define MPP_LOG_MAP3(a, ...) , MPP_LOG_W(a) MPP_LOG_MAP2(__VA_ARGS__)
+#define MPP_LOG_MAP4(a, ...) , MPP_LOG_W(a) MPP_LOG_MAP3(__VA_ARGS__)
+#define MPP_LOG_MAP5(a, ...) , MPP_LOG_W(a) MPP_LOG_MAP4(__VA_ARGS__)
+#define MPP_LOG_MAP6(a, ...) , MPP_LOG_W(a) MPP_LOG_MAP5(__VA_ARGS__)
+#define MPP_LOG_CAT(a, b) MPP_LOG_CAT_(a, b)
+#define MPP_LOG_CAT_(a, b) a##b
+#define MPP_LOG_MAP(n, ...) MPP_LOG_CAT(MPP_LOG_MAP, n)(__VA_ARGS__)
+
+#define MPP_LOG_DEFER(level, format, ...) \
+    mpp_log_record((level), __func__, __LINE__, (format), MPP_LOG_NARGS(__VA_ARGS__) \
+                   MPP_LOG_MAP(MPP_LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__))
+
+#endif
@@ -18,6 +18,8 @@
 
 #include "mpp_api.h"
 #include "mpp_api_types_internal.h"
+#include "mpp_buffer.h"
+#include "mpp_cache.h"
 #include "hal_types.h"
 #include "mpp_debug.h"
 #include "hal_utils.h"
@@ -26,63 +28,68 @@
 /* allocate input buffer
  * Note: address alignment requirement not considered here
  **/
-static int mpp_alloc_input_buf(_elem_t *elem)
+static int mpp_alloc_input_buf(buf_desc_t *buf)
 {
-    int i, ret = MPP_SUCCESS;
     int height;
-   /* allocate input buffers */
-    for(i = 0; i < elem->io.nb_in_buf; i++)
-    {
-        /* pointer sanity check */
-        if ((elem->io.in_buf[i] == NULL) || (elem->io.in_buf[i]->hw == NULL))
-        {
-            ret = MPP_ERROR;
-            break;
-        }
-        /* buffer already allocated? */
-        if (elem->io.in_buf[i]->hw->heap_p != NULL)
-            continue;   /* yes: move to next input */
+    mpp_memory_placement_t hint;
 
-        /*** buffer allocation ***/
-        /* time to set stride */
-        if (elem->io.in_buf[i]->hw->stride == 0)
-            elem->io.in_buf[i]->hw->stride = elem->io.in_buf[i]->width * get_bitpp(elem->io.in_buf[i]->format) / 8;
+    /* pointer sanity check */
+    if ((buf == NULL) || (buf->hw == NULL))
+        return MPP_ERROR;
+    /* buffer already allocated? */
+    if (buf->hw->heap_p != NULL)
+        return MPP_SUCCESS;
 
-        if (elem->io.in_buf[i]->stripe_num > 0)
-            height = elem->io.in_buf[i]->height / MPP_STRIPE_NUM;
-        else
-            height = elem->io.in_buf[i]->height;
+    /*** buffer allocation ***/
+    /* time to set stride */
+    if (buf->hw->stride == 0)
+        buf->hw->stride = buf->width * get_bitpp(buf->format) / 8;
 
-        elem->io.in_buf[i]->hw->heap_p = hal_malloc(height * elem->io.in_buf[i]->hw->stride + elem->io.in_buf[i]->hw->alignment);
+    if (buf->stripe_num > 0)
+        height = buf->height / MPP_STRIPE_NUM;
+    else
+        height = buf->height;
 
-        if (elem->io.in_buf[i]->hw->heap_p == NULL)
-        {
-            MPP_LOGE("Allocation failed\n");
-            ret = MPP_MALLOC_ERROR;
-            break;
-        }
+    /* placement: selected requirement hint, else the other side's one */
+    hint = buf->hw->placement;
+    if (hint == MPP_MEM_PLACE_ANY)
+        hint = (buf->hw == &buf->hw_req_prod) ? buf->hw_req_cons.placement : buf->hw_req_prod.placement;
 
-        /* get buffer aligned address */
-        unsigned char *heap_p = elem->io.in_buf[i]->hw->heap_p;
-        unsigned int alignment = (unsigned int)elem->io.in_buf[i]->hw->alignment;
+    /* the buffer owns its cache lines, so that invalidating them never drops other data */
+    unsigned int alignment = (unsigned int)buf->hw->alignment;
+    unsigned int size = (height * buf->hw->stride + MPP_CACHE_LINE_SIZE - 1) & ~(MPP_CACHE_LINE_SIZE - 1);
 
-        if (alignment)
-            elem->io.in_buf[i]->hw->addr = (unsigned char *)(heap_p + alignment - ((unsigned int)heap_p % alignment));
-        else    /* avoid modulo with 0 */
-            elem->io.in_buf[i]->hw->addr = heap_p;
+    if (alignment < MPP_CACHE_LINE_SIZE)
+        alignment = MPP_CACHE_LINE_SIZE;
+    buf->hw->heap_p = hal_malloc_placed(size + alignment, hint, &buf->region);
 
-        /* buffer is cacheable */
-        elem->io.in_buf[i]->hw->cacheable = true;
+    if (buf->hw->heap_p == NULL)
+    {
+        MPP_LOGE("Allocation failed\n");
+        return MPP_MALLOC_ERROR;
     }
-    return ret;
+
+    /* get buffer aligned address */
+    unsigned char *heap_p = buf->hw->heap_p;
+
+    buf->hw->addr = (unsigned char *)(heap_p + alignment - ((unsigned int)heap_p % alignment));
+
+    /* heap buffers are cacheable */
+    if (buf->region != NULL)
+        buf->hw->cacheable = buf->region->cacheable;
+    else
+        buf->hw->cacheable = true;
+
+    return MPP_SUCCESS;
 }
 
-/* browse the mpp backward to find a non-inplace element
+/* browse the mpp backward from the producer of an input port to find a non-inplace element
+ * (port 0: previous element, ports 1..: joined pipelines)
  * return the memory policy of this element
  **/
-mpp_memory_policy_t get_prev_policy(_elem_t *elem)
+static mpp_memory_policy_t get_port_policy(_elem_t *elem, int port)
 {
-    _elem_t *prevelem = elem->prev;
+    _elem_t *prevelem = (port == 0) ? elem->prev : elem->join[port - 1];
 
     do {
         if (prevelem->io.inplace && (prevelem->io.mem_policy == HAL_MEM_ALLOC_NONE))
@@ -137,6 +144,14 @@ static int solve_buf_req(buf_desc_t *buf)
     return MPP_SUCCESS;
 }
 
+/* where a buffer lives: region allocated by the pipeline, heap, or owned by an element */
+static const char *buf_placement(const buf_desc_t *buf)
+{
+    if (buf->region != NULL)
+        return buf->region->name;
+    return "heap";
+}
+
 /* check buffer address and set buffer status */
 int mpp_memory_check(_mpp_t *mpp)
 {
@@ -149,17 +164,19 @@ int mpp_memory_check(_mpp_t *mpp)
         for(i = 0; i < elem->io.nb_in_buf; i++)
         {
             /* set input buffers status */
-            elem->io.in_buf[i]->status = MPP_BUFFER_EMPTY;
+            mpp_buf_reset(elem->io.in_buf[i]);
             /* check address for input buffers */
-            MPP_LOGI("Element %s: input buffer#%d address 0x%x \n", elem_name(elem->proc_typ), i, (unsigned int)elem->io.in_buf[i]->hw->addr);
+            MPP_LOGI("Element %s: input buffer#%d address 0x%x (%s)\n", elem_name(elem->proc_typ), i,
+                    (unsigned int)elem->io.in_buf[i]->hw->addr, buf_placement(elem->io.in_buf[i]));
         }
 
         for(i = 0; i < elem->io.nb_out_buf; i++)
         {
             /* set output buffers status */
-            elem->io.out_buf[i]->status = MPP_BUFFER_EMPTY;
+            mpp_buf_reset(elem->io.out_buf[i]);
             /* check address for output buffers */
-            MPP_LOGI("Element %s: output buffer#%d address 0x%x \n", elem_name(elem->proc_typ), i, (unsigned int)elem->io.out_buf[i]->hw->addr);
+            MPP_LOGI("Element %s: output buffer#%d address 0x%x (%s)\n", elem_name(elem->proc_typ), i,
+                    (unsigned int)elem->io.out_buf[i]->hw->addr, buf_placement(elem->io.out_buf[i]));
         }
         elem = elem->next[0];
     }
@@ -190,76 +207,68 @@ int mpp_memory_alloc(_mpp_t *mpp)
             continue;
         }
 
-        /* get policy of previous element (without in-place processing) */
-        mpp_memory_policy_t prev_policy = get_prev_policy(elem);
-
-        /* assign buffers final reqts and allocate missing buffers */
-        switch (elem->io.mem_policy)
+        /* assign buffers final reqts and allocate missing buffers, port by port */
+        for(i = 0; i < elem->io.nb_in_buf; i++)
         {
-        case HAL_MEM_ALLOC_NONE:
-        case HAL_MEM_ALLOC_OUTPUT:
-            /* element does NOT provide the input buffer */
-            /* check previous element policy */
-            if ( (prev_policy == HAL_MEM_ALLOC_NONE)
-                    ||  (prev_policy == HAL_MEM_ALLOC_INPUT) )
+            buf_desc_t *buf = elem->io.in_buf[i];
+            /* get policy of the port producer (without in-place processing) */
+            mpp_memory_policy_t prev_policy = get_port_policy(elem, i);
+
+            switch (elem->io.mem_policy)
             {
-                /* take producer reqt by default. */
-                for(i = 0; i < elem->io.nb_in_buf; i++)
+            case HAL_MEM_ALLOC_NONE:
+            case HAL_MEM_ALLOC_OUTPUT:
+                /* element does NOT provide the input buffer */
+                /* check previous element policy */
+                if ( (prev_policy == HAL_MEM_ALLOC_NONE)
+                        ||  (prev_policy == HAL_MEM_ALLOC_INPUT) )
                 {
-                    if (elem->io.in_buf[i]->hw_req_prod.alignment >= elem->io.in_buf[i]->hw_req_cons.alignment) {
-                        elem->io.in_buf[i]->hw = &elem->io.in_buf[i]->hw_req_prod;
+                    /* take producer reqt by default. */
+                    if (buf->hw_req_prod.alignment >= buf->hw_req_cons.alignment) {
+                        buf->hw = &buf->hw_req_prod;
                     } else {
-                        elem->io.in_buf[i]->hw = &elem->io.in_buf[i]->hw_req_cons;
+                        buf->hw = &buf->hw_req_cons;
                     }
+                    MPP_LOGD("Element %s: Allocating missing input buffer#%d\n", elem_name(elem->proc_typ), i);
+                    /* input buffer missing: allocate it */
+                    ret = mpp_alloc_input_buf(buf);
+                    if (ret != MPP_SUCCESS)
+                        return ret;
                 }
-                MPP_LOGD("Element %s: Allocating missing input buffer\n", elem_name(elem->proc_typ));
-                /* input buffer missing: allocate it */
-                ret = mpp_alloc_input_buf(elem);
-                if (ret != MPP_SUCCESS)
-                    return ret;
-            }
-            else if ( (prev_policy == HAL_MEM_ALLOC_BOTH)
-                    || (prev_policy == HAL_MEM_ALLOC_OUTPUT) )
-            {
-                /* input buffer existing: reuse it */
-                for(i = 0; i < elem->io.nb_in_buf; i++)
+                else if ( (prev_policy == HAL_MEM_ALLOC_BOTH)
+                        || (prev_policy == HAL_MEM_ALLOC_OUTPUT) )
                 {
-                    elem->io.in_buf[i]->hw = &elem->io.in_buf[i]->hw_req_prod;
+                    /* input buffer existing: reuse it */
+                    buf->hw = &buf->hw_req_prod;
+                    MPP_LOGD("Element %s: Reusing buffer#%d from previous element\n", elem_name(elem->proc_typ), i);
                 }
-                MPP_LOGD("Element %s: Reusing buffer from previous element\n", elem_name(elem->proc_typ));
-            }
-            break;
-        case HAL_MEM_ALLOC_INPUT:
-        case HAL_MEM_ALLOC_BOTH:
-            /* element does provide the input buffer */
-            /* check previous element policy */
-            if ( (prev_policy == HAL_MEM_ALLOC_NONE)
-                    ||  (prev_policy == HAL_MEM_ALLOC_INPUT) )
-            {
-                /* input buffer owned by element: use it */
-                for(i = 0; i < elem->io.nb_in_buf; i++)
+                break;
+            case HAL_MEM_ALLOC_INPUT:
+            case HAL_MEM_ALLOC_BOTH:
+                /* element does provide the input buffer */
+                /* check previous element policy */
+                if ( (prev_policy == HAL_MEM_ALLOC_NONE)
+                        ||  (prev_policy == HAL_MEM_ALLOC_INPUT) )
                 {
-                    elem->io.in_buf[i]->hw = &elem->io.in_buf[i]->hw_req_cons;
-                }
-                MPP_LOGD("Element %s: Using its own input buffer\n", elem_name(elem->proc_typ));
+                    /* input buffer owned by element: use it */
+                    buf->hw = &buf->hw_req_cons;
+                    MPP_LOGD("Element %s: Using its own input buffer#%d\n", elem_name(elem->proc_typ), i);
 
-            } else if ( (prev_policy == HAL_MEM_ALLOC_BOTH)
-                    || (prev_policy == HAL_MEM_ALLOC_OUTPUT) )
-            {
-                /* input buffer conflict: need to resolve it! */
-                MPP_LOGD("Element %s: Buffer conflict between two elements!\n", elem_name(elem->proc_typ));
-                for(i = 0; i < elem->io.nb_in_buf; i++)
+                } else if ( (prev_policy == HAL_MEM_ALLOC_BOTH)
+                        || (prev_policy == HAL_MEM_ALLOC_OUTPUT) )
                 {
-                    ret = solve_buf_req(elem->io.in_buf[i]);
+                    /* input buffer conflict: need to resolve it! */
+                    MPP_LOGD("Element %s: Buffer#%d conflict between two elements!\n", elem_name(elem->proc_typ), i);
+                    ret = solve_buf_req(buf);
                     if (ret != MPP_SUCCESS)
                         return ret;
                 }
+                break;
+            default:
+                MPP_LOGE("Element %s: Unexpected memory policy\n", elem_name(elem->proc_typ));
+                return MPP_ERROR;
+                break;
             }
-            break;
-        default:
-            MPP_LOGE("Element %s: Unexpected memory policy\n", elem_name(elem->proc_typ));
-            return MPP_ERROR;
-            break;
         }
 
         elem = elem->next[0];
@@ -290,22 +299,24 @@ void mpp_memory_free(_mpp_t *mpp)
             continue;
         }
 
-        /* get policy of previous element (without in-place processing) */
-        mpp_memory_policy_t prev_policy = get_prev_policy(elem);
-
         /* free only the input buffers allocated by us */
-        if ( ( (elem->io.mem_policy == HAL_MEM_ALLOC_NONE) || (elem->io.mem_policy == HAL_MEM_ALLOC_OUTPUT) )
-                && ((prev_policy == HAL_MEM_ALLOC_NONE) || (prev_policy == HAL_MEM_ALLOC_INPUT) ) )
+        for(i = 0; i < elem->io.nb_in_buf; i++)
         {
-            for(i = 0; i < elem->io.nb_in_buf; i++)
+            /* get policy of the port producer (without in-place processing) */
+            mpp_memory_policy_t prev_policy = get_port_policy(elem, i);
+
+            if ( ( (elem->io.mem_policy == HAL_MEM_ALLOC_NONE) || (elem->io.mem_policy == HAL_MEM_ALLOC_OUTPUT) )
+                    && ((prev_policy == HAL_MEM_ALLOC_NONE) || (prev_policy == HAL_MEM_ALLOC_INPUT) )
+                    && (elem->io.in_buf[i]->hw != NULL) && (elem->io.in_buf[i]->hw->heap_p != NULL) )
             {
-                if (elem->io.in_buf[i]->hw != NULL)
-                {
-                    hal_free(elem->io.in_buf[i]->hw->heap_p);
-                    hal_free(elem->io.in_buf[i]->hw);
-                }
+                /* hw points into the buffer descriptor: only the memory it describes is freed */
+                hal_free_placed(elem->io.in_buf[i]->hw->heap_p);
+                elem->io.in_buf[i]->hw->heap_p = NULL;
+                elem->io.in_buf[i]->hw->addr = NULL;
+                elem->io.in_buf[i]->region = NULL;
             }
         }
+        elem = elem->next[0];
     }
 
     return;
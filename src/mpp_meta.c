@@ -0,0 +1,268 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Frame metadata
+ *
+ * Each source element read by a metadata consumer owns a pool of metadata
+ * containers, one per dequeued frame. The container is referenced by the buffer descriptors and follows
+ * the frame through the pipeline elements, so an element may read what its
+ * upstream elements produced for the same frame.
+ * A container is reused only once no buffer descriptor references it, so
+ * slow branches keep the metadata of the frame they process.
+ * Entries are allocated from a per-frame arena and are never freed: the whole
+ * container is reset when the source reuses it.
+ * Containers are shared by the tasks of the branches without critical
+ * section: the frame id and the references are packed in one atomic word,
+ * so a reader takes a reference only while the container holds its frame.
+ */
+
+#include <string.h>
+#include "mpp_api_types.h"
+#include "mpp_api_types_internal.h"
+#include "mpp_meta.h"
+#include "mpp_buffer.h"
+#include "mpp_debug.h"
+#include "hal_os.h"
+
+int mpp_meta_enable(_elem_t *elem)
+{
+    _mpp_meta_pool_t *pool;
+    _elem_t *src = elem;
+
+    while ((src != NULL) && (src->type != MPP_TYPE_SOURCE))
+        src = src->prev;
+    if (src == NULL)
+        return MPP_INVALID_PARAM;
+    if (src->priv != NULL)
+        return MPP_SUCCESS;
+
+    pool = hal_malloc(sizeof(_mpp_meta_pool_t));
+    if (pool == NULL) {
+        MPP_LOGE("malloc failed for metadata pool\n");
+        return MPP_MALLOC_ERROR;
+    }
+    memset(pool, 0, sizeof(_mpp_meta_pool_t));
+    for (int i = 0; i < MPP_META_FRAMES; i++) {
+        pool->frames[i].pool = pool;
+        atomic_init(&pool->frames[i].state, 0);
+        atomic_init(&pool->frames[i].alloc, 0);
+        atomic_init(&pool->frames[i].nb_entries, 0);
+        for (int j = 0; j < MPP_META_MAX_ENTRIES; j++)
+            atomic_init(&pool->frames[i].entries[j].ready, false);
+    }
+    src->priv = pool;
+
+    return MPP_SUCCESS;
+}
+
+/* append an entry to a container held by the caller.
+ * The entry and its arena bytes are reserved with compare-and-swap, then
+ * filled, then published: 'nb_entries' only counts complete entries.
+ */
+static bool meta_append(_mpp_meta_t *meta, _mpp_meta_type_t type, const _elem_t *producer,
+                        const void *data, size_t size)
+{
+    _mpp_meta_entry_t *entry;
+    /* keep entries word aligned */
+    size_t alloc = (size + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
+    unsigned int reserved = atomic_load_explicit(&meta->alloc, memory_order_relaxed);
+    unsigned int slot, offset, nb;
+
+    do {
+        slot = reserved >> 16;
+        offset = reserved & 0xffffU;
+        if ((slot >= MPP_META_MAX_ENTRIES) || (offset + alloc > MPP_META_ARENA_SIZE))
+            return false;
+    } while (!atomic_compare_exchange_weak_explicit(&meta->alloc, &reserved,
+                                                    ((slot + 1) << 16) | (offset + alloc),
+                                                    memory_order_relaxed, memory_order_relaxed));
+
+    entry = &meta->entries[slot];
+    entry->type = type;
+    entry->producer = producer;
+    entry->offset = offset;
+    entry->size = size;
+    memcpy((uint8_t *)meta->arena + offset, data, size);
+    atomic_store(&entry->ready, true);
+
+    /* writers of parallel branches may complete out of order:
+     * the last one to complete a run of entries publishes it */
+    nb = atomic_load(&meta->nb_entries);
+    while ((nb < MPP_META_MAX_ENTRIES) && atomic_load(&meta->entries[nb].ready)) {
+        if (atomic_compare_exchange_weak(&meta->nb_entries, &nb, nb + 1))
+            nb++;
+    }
+    return true;
+}
+
+/* take a reference on a container holding frame 'id' */
+static bool meta_hold(_mpp_meta_t *meta, unsigned short id)
+{
+    unsigned int state = atomic_load_explicit(&meta->state, memory_order_relaxed);
+
+    do {
+        if ((MPP_META_STATE_ID(state) != id) || (MPP_META_STATE_REFS(state) == 0))
+            return false;
+    } while (!atomic_compare_exchange_weak_explicit(&meta->state, &state, state + 1,
+                                                    memory_order_acquire, memory_order_relaxed));
+    return true;
+}
+
+static void meta_release(_mpp_meta_t *meta)
+{
+    unsigned int state;
+
+    if (meta == NULL)
+        return;
+    state = atomic_load_explicit(&meta->state, memory_order_relaxed);
+    do {
+        if (MPP_META_STATE_REFS(state) == 0)
+            return;
+    } while (!atomic_compare_exchange_weak_explicit(&meta->state, &state, state - 1,
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+void mpp_meta_set(buf_desc_t *buf, _mpp_meta_t *meta)
+{
+    /* the caller holds a buffer referencing 'meta': it cannot be reused */
+    if (meta != NULL)
+        atomic_fetch_add_explicit(&meta->state, 1, memory_order_relaxed);
+    meta_release(buf->meta);
+    buf->meta = meta;
+}
+
+void mpp_meta_begin(_elem_t *src, unsigned short frame_id)
+{
+    _mpp_meta_pool_t *pool = src->priv;
+    buf_desc_t *buf = src->io.out_buf[0];
+    _mpp_meta_t *meta = NULL;
+
+    if (pool == NULL)
+        return;
+
+    /* the source buffer does not hold the previous frame anymore */
+    meta_release(buf->meta);
+    buf->meta = NULL;
+    /* oldest free container first, so previous frames stay readable as long as possible.
+     * claiming it changes its frame id: readers of the previous frame cannot hold it anymore */
+    for (int i = 0; (i < MPP_META_FRAMES) && (meta == NULL); i++) {
+        _mpp_meta_t *m = &pool->frames[(pool->next + i) % MPP_META_FRAMES];
+        unsigned int state = atomic_load_explicit(&m->state, memory_order_relaxed);
+        if ((MPP_META_STATE_REFS(state) == 0)
+                && atomic_compare_exchange_strong_explicit(&m->state, &state, MPP_META_STATE(frame_id, 1),
+                                                           memory_order_acquire, memory_order_relaxed)) {
+            meta = m;
+            pool->next = (pool->next + i + 1) % MPP_META_FRAMES;
+        }
+    }
+    if (meta != NULL) {
+        /* the frame is not published yet: no other reader or writer */
+        atomic_store_explicit(&meta->nb_entries, 0, memory_order_relaxed);
+        atomic_store_explicit(&meta->alloc, 0, memory_order_relaxed);
+        for (int i = 0; i < MPP_META_MAX_ENTRIES; i++)
+            atomic_store_explicit(&meta->entries[i].ready, false, memory_order_relaxed);
+        meta_append(meta, MPP_META_TIMESTAMP, src, &buf->capture_ts, sizeof(uint32_t));
+        buf->meta = meta;
+    }
+
+    MPP_LOGD_IF((meta == NULL) && RLMT_CHECK(1), "Frame %d has no metadata, all containers in use\n", frame_id);
+}
+
+int mpp_meta_add(buf_desc_t *buf, _mpp_meta_type_t type, const _elem_t *producer,
+                 const void *data, size_t size)
+{
+    _mpp_meta_t *meta = buf->meta;
+    int ret = MPP_ERROR;
+
+    if (meta == NULL)
+        return MPP_ERROR;
+
+    /* elements of parallel branches may add entries to the same frame */
+    if ((MPP_META_STATE_ID(atomic_load_explicit(&meta->state, memory_order_relaxed)) == mpp_buf_frame_id(buf))
+            && meta_append(meta, type, producer, data, size))
+        ret = MPP_SUCCESS;
+
+    MPP_LOGD_IF((ret != MPP_SUCCESS) && RLMT_CHECK(1), "Frame %d metadata full\n", mpp_buf_frame_id(buf));
+    return ret;
+}
+
+/* last published entry of a type in a container held by the caller */
+static const _mpp_meta_entry_t *meta_lookup(const _mpp_meta_t *meta, _mpp_meta_type_t type,
+                                            const _elem_t *producer)
+{
+    int nb = atomic_load_explicit(&meta->nb_entries, memory_order_acquire);
+
+    for (int i = nb - 1; i >= 0; i--) {
+        const _mpp_meta_entry_t *entry = &meta->entries[i];
+        if ((entry->type == type) && ((producer == NULL) || (entry->producer == producer)))
+            return entry;
+    }
+    return NULL;
+}
+
+const void *mpp_meta_find(const buf_desc_t *buf, _mpp_meta_type_t type, const _elem_t *producer,
+                          size_t *size)
+{
+    const _mpp_meta_t *meta = buf->meta;
+    const _mpp_meta_entry_t *entry = NULL;
+
+    if (meta == NULL)
+        return NULL;
+
+    /* the container is held by 'buf', published entries do not change */
+    if (MPP_META_STATE_ID(atomic_load_explicit(&meta->state, memory_order_relaxed)) == mpp_buf_frame_id(buf))
+        entry = meta_lookup(meta, type, producer);
+
+    if (entry == NULL)
+        return NULL;
+    if (size != NULL)
+        *size = entry->size;
+    return (const uint8_t *)meta->arena + entry->offset;
+}
+
+size_t mpp_meta_copy(const buf_desc_t *buf, _mpp_meta_type_t type, const _elem_t *producer,
+                     unsigned int max_age, void *data, size_t max_size)
+{
+    _mpp_meta_pool_t *pool;
+    const _mpp_meta_entry_t *entry = NULL;
+    size_t size = 0;
+
+    if (buf->meta == NULL)
+        return 0;
+    pool = buf->meta->pool;
+
+    /* containers of the previous frames may be reused meanwhile:
+     * a reference is taken on each one before it is read */
+    for (unsigned int age = 0; (age <= max_age) && (entry == NULL); age++) {
+        unsigned short id = mpp_buf_frame_id(buf) - age;
+        for (int i = 0; (i < MPP_META_FRAMES) && (entry == NULL); i++) {
+            _mpp_meta_t *meta = &pool->frames[i];
+            if (!meta_hold(meta, id))
+                continue;
+            entry = meta_lookup(meta, type, producer);
+            if (entry != NULL) {
+                size = entry->size;
+                memcpy(data, (const uint8_t *)meta->arena + entry->offset, (size < max_size) ? size : max_size);
+            }
+            meta_release(meta);
+        }
+    }
+
+    return size;
+}
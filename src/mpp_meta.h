@@ -0,0 +1,122 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef _MPP_META_H
+#define _MPP_META_H
+
+#include <stdatomic.h>
+#include "mpp_api_types.h"
+#include "mpp_api_types_internal.h"
+
+/* number of metadata containers of a source element.
+ * A container is held by every buffer descriptor referencing it, so this
+ * should be larger than the number of buffers of the pipelines fed by the source.
+ */
+#ifndef MPP_META_FRAMES
+#define MPP_META_FRAMES         8
+#endif
+
+/* metadata bytes per source frame */
+#ifndef MPP_META_ARENA_SIZE
+#define MPP_META_ARENA_SIZE     1024
+#endif
+
+/* metadata entries per source frame */
+#define MPP_META_MAX_ENTRIES    8
+
+/* metadata types */
+typedef enum {
+    MPP_META_TIMESTAMP,     /* uint32_t: source frame capture time (us) */
+    MPP_META_DETECTIONS,    /* mpp_detections_t: 'count' boxes */
+    MPP_META_ROIS,          /* mpp_area_t array */
+    MPP_META_TRANSFORM,     /* mpp_convert_transform_t: letterboxing CONVERT output */
+    MPP_META_USER,          /* opaque blob */
+    MPP_META_TYPE_NUM
+} _mpp_meta_type_t;
+
+typedef struct {
+    _mpp_meta_type_t type;
+    const _elem_t *producer;
+    uint16_t offset;        /* in the arena */
+    uint16_t size;
+    atomic_bool ready;      /* entry filled */
+} _mpp_meta_entry_t;
+
+typedef struct _mpp_meta_pool_s _mpp_meta_pool_t;
+
+/* container state: source frame described and references by buffer descriptors and readers */
+#define MPP_META_STATE(id, refs)    (((uint32_t)(uint16_t)(id) << 16) | (refs))
+#define MPP_META_STATE_ID(s)        ((unsigned short)((s) >> 16))
+#define MPP_META_STATE_REFS(s)      ((s) & 0xffffU)
+
+/* metadata of one source frame */
+struct _mpp_meta_s {
+    _mpp_meta_pool_t *pool;
+    atomic_uint state;          /* packed frame id and references, see MPP_META_STATE() */
+    atomic_uint alloc;          /* packed entries and arena bytes reserved by the writers */
+    atomic_uint nb_entries;     /* entries published to the readers, all complete */
+    _mpp_meta_entry_t entries[MPP_META_MAX_ENTRIES];
+    uint32_t arena[MPP_META_ARENA_SIZE / sizeof(uint32_t)];
+};
+
+/* metadata containers of a source element */
+struct _mpp_meta_pool_s {
+    unsigned int next;          /* next container to check for reuse */
+    _mpp_meta_t frames[MPP_META_FRAMES];
+};
+
+/* allocate the metadata containers of the source feeding 'elem', if not done yet.
+ * Called by the setup of the elements reading metadata: sources without
+ * readers carry no metadata.
+ */
+int mpp_meta_enable(_elem_t *elem);
+
+/* start the metadata of the next frame of a source element.
+ * must be called before the frame is published.
+ */
+void mpp_meta_begin(_elem_t *src, unsigned short frame_id);
+
+/* make a buffer descriptor reference the metadata container 'meta' (may be NULL)
+ * and release the container it referenced.
+ */
+void mpp_meta_set(buf_desc_t *buf, _mpp_meta_t *meta);
+
+/* add a metadata entry to the frame of 'buf', 'data' is copied.
+ * The entry is visible to the readers once complete.
+ * returns MPP_ERROR if the frame has no metadata or it is full.
+ */
+int mpp_meta_add(buf_desc_t *buf, _mpp_meta_type_t type, const _elem_t *producer,
+                 const void *data, size_t size);
+
+/* find the last entry of a type in the metadata of the frame of 'buf'.
+ * If 'producer' is not NULL only its entries are considered.
+ * returns NULL if not found.
+ * The entry stays valid while the caller holds 'buf'.
+ */
+const void *mpp_meta_find(const buf_desc_t *buf, _mpp_meta_type_t type, const _elem_t *producer,
+                          size_t *size);
+
+/* copy the last entry of a type in the metadata of the frame of 'buf', or of
+ * one of the 'max_age' previous frames, to 'data' (up to 'max_size' bytes).
+ * If 'producer' is not NULL only its entries are considered.
+ * returns the size of the entry, 0 if not found.
+ */
+size_t mpp_meta_copy(const buf_desc_t *buf, _mpp_meta_type_t type, const _elem_t *producer,
+                     unsigned int max_age, void *data, size_t max_size);
+
+#endif
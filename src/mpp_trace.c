@@ -0,0 +1,228 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Execution trace
+ *
+ * Fixed-size binary events are written to a ring buffer by the pipeline
+ * tasks, the HAL wrappers and the task switch hook. Slots are reserved with
+ * an atomic increment, the oldest events are overwritten.
+ * The dump starts with a header, followed by the description of the branches
+ * and elements, the names of the traced tasks and the events, oldest first.
+ * tools/mpp_trace_decode.py converts a dump to the Chrome trace format.
+ */
+
+#include <string.h>
+#include <stdatomic.h>
+#include "mpp_api.h"
+#include "mpp_api_types_internal.h"
+#include "mpp_trace.h"
+#include "mpp_debug.h"
+#include "hal_os.h"
+
+#define TRACE_MAGIC         0x5450504dU     /* "MPPT" */
+#define TRACE_VERSION       1
+#define TRACE_MAX_TASKS     16
+#define TRACE_TASK_NAME     12
+
+/* dump header */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t evt_size;
+    uint32_t nb_events;
+    uint32_t nb_objs;
+    uint32_t nb_tasks;
+    uint32_t lost;          /* events overwritten */
+} _mpp_trace_hdr_t;
+
+/* branch or element description */
+typedef struct {
+    uint32_t obj;
+    uint8_t kind;           /* 0: branch, 1: processing, 2: source, 3: sink */
+    uint8_t type;           /* element, source or sink type */
+    uint16_t prio;          /* branch priority */
+    uint32_t mpp;           /* owning branch */
+} _mpp_trace_obj_t;
+
+/* traced task */
+typedef struct {
+    uint32_t task;
+    char name[TRACE_TASK_NAME];
+} _mpp_trace_task_t;
+
+#if MPP_TRACE
+
+#if (MPP_TRACE_EVENTS & (MPP_TRACE_EVENTS - 1)) != 0
+#error "MPP_TRACE_EVENTS must be a power of 2"
+#endif
+
+extern _mpp_t *rc_prio_lst[];
+extern _mpp_t *preempt_prio_lst[];
+
+static _mpp_trace_evt_t trace_ring[MPP_TRACE_EVENTS];
+static atomic_uint trace_head;
+static volatile bool trace_on;
+
+void mpp_trace_record(uint8_t type, uint8_t flags, unsigned short frame_id, const void *obj)
+{
+    _mpp_trace_evt_t *evt;
+
+    if (!trace_on)
+        return;
+    evt = &trace_ring[atomic_fetch_add_explicit(&trace_head, 1, memory_order_relaxed) & (MPP_TRACE_EVENTS - 1)];
+    evt->ts = hal_get_time_us();
+    evt->type = type;
+    evt->flags = flags;
+    evt->frame_id = frame_id;
+    evt->task = (uint32_t)(uintptr_t)hal_task_current();
+    evt->obj = (uint32_t)(uintptr_t)obj;
+}
+
+void mpp_trace_task_switch(void)
+{
+    mpp_trace_record(MPP_TRACE_TASK_SWITCH, 0, 0, NULL);
+}
+
+int mpp_trace_start(void)
+{
+    atomic_store(&trace_head, 0);
+    trace_on = true;
+    return MPP_SUCCESS;
+}
+
+int mpp_trace_stop(void)
+{
+    trace_on = false;
+    return MPP_SUCCESS;
+}
+
+/* describe the branches and elements of a heap, returns the number of entries */
+static unsigned int trace_heap_objs(_mpp_t *prio_lst[], _mpp_trace_obj_t *objs, unsigned int max)
+{
+    unsigned int n = 0;
+
+    for (int i = 0; i < MAX_MPP_HEAP_PRIO; i++) {
+        _mpp_t *mpp = prio_lst[i];
+        if (mpp == NULL)
+            continue;
+        if (objs != NULL && n < max)
+            objs[n] = (_mpp_trace_obj_t){ (uint32_t)(uintptr_t)mpp, 0, 0, mpp->prio, 0 };
+        n++;
+        for (_elem_t *elem = mpp->first_elem; (elem != NULL) && (elem->mpp == mpp); elem = elem->next[0]) {
+            if (objs != NULL && n < max) {
+                objs[n].obj = (uint32_t)(uintptr_t)elem;
+                objs[n].kind = (elem->type == MPP_TYPE_PROC) ? 1 : (elem->type == MPP_TYPE_SOURCE) ? 2 : 3;
+                objs[n].type = (elem->type == MPP_TYPE_PROC) ? elem->proc_typ
+                             : (elem->type == MPP_TYPE_SOURCE) ? elem->src_typ : elem->sink_typ;
+                objs[n].prio = 0;
+                objs[n].mpp = (uint32_t)(uintptr_t)mpp;
+            }
+            n++;
+        }
+    }
+    return n;
+}
+
+int mpp_trace_dump(void *dst, size_t size, size_t *used)
+{
+    _mpp_trace_hdr_t hdr;
+    _mpp_trace_task_t tasks[TRACE_MAX_TASKS];
+    unsigned int head = atomic_load(&trace_head);
+    unsigned int first = (head > MPP_TRACE_EVENTS) ? head - MPP_TRACE_EVENTS : 0;
+    unsigned int nb_objs, nb_tasks = 0, i, t;
+    size_t total;
+    uint8_t *p = dst;
+
+    if (used == NULL)
+        return MPP_INVALID_PARAM;
+
+    nb_objs = trace_heap_objs(rc_prio_lst, NULL, 0) + trace_heap_objs(preempt_prio_lst, NULL, 0);
+    /* names of the traced tasks, first ones only */
+    for (i = first; i < head; i++) {
+        uint32_t task = trace_ring[i & (MPP_TRACE_EVENTS - 1)].task;
+        for (t = 0; t < nb_tasks; t++) {
+            if (tasks[t].task == task)
+                break;
+        }
+        if ((t < nb_tasks) || (nb_tasks == TRACE_MAX_TASKS) || (task == 0))
+            continue;
+        tasks[nb_tasks].task = task;
+        strncpy(tasks[nb_tasks].name, hal_task_name((hal_task_t)(uintptr_t)task), TRACE_TASK_NAME - 1);
+        tasks[nb_tasks].name[TRACE_TASK_NAME - 1] = '\0';
+        nb_tasks++;
+    }
+
+    total = sizeof(hdr) + nb_objs * sizeof(_mpp_trace_obj_t) + nb_tasks * sizeof(_mpp_trace_task_t)
+            + (head - first) * sizeof(_mpp_trace_evt_t);
+    *used = total;
+    if ((dst == NULL) || (size < total))
+        return MPP_INVALID_PARAM;
+
+    hdr.magic = TRACE_MAGIC;
+    hdr.version = TRACE_VERSION;
+    hdr.evt_size = sizeof(_mpp_trace_evt_t);
+    hdr.nb_events = head - first;
+    hdr.nb_objs = nb_objs;
+    hdr.nb_tasks = nb_tasks;
+    hdr.lost = first;
+    memcpy(p, &hdr, sizeof(hdr));
+    p += sizeof(hdr);
+
+    i = trace_heap_objs(rc_prio_lst, (_mpp_trace_obj_t *)p, nb_objs);
+    trace_heap_objs(preempt_prio_lst, (_mpp_trace_obj_t *)p + i, nb_objs - i);
+    p += nb_objs * sizeof(_mpp_trace_obj_t);
+    memcpy(p, tasks, nb_tasks * sizeof(_mpp_trace_task_t));
+    p += nb_tasks * sizeof(_mpp_trace_task_t);
+    for (i = first; i < head; i++) {
+        memcpy(p, &trace_ring[i & (MPP_TRACE_EVENTS - 1)], sizeof(_mpp_trace_evt_t));
+        p += sizeof(_mpp_trace_evt_t);
+    }
+
+    return MPP_SUCCESS;
+}
+
+#else /* MPP_TRACE */
+
+void mpp_trace_record(uint8_t type, uint8_t flags, unsigned short frame_id, const void *obj)
+{
+}
+
+void mpp_trace_task_switch(void)
+{
+}
+
+int mpp_trace_start(void)
+{
+    MPP_LOGE("trace not available, build with MPP_TRACE\n");
+    return MPP_ERROR;
+}
+
+int mpp_trace_stop(void)
+{
+    return MPP_ERROR;
+}
+
+int mpp_trace_dump(void *dst, size_t size, size_t *used)
+{
+    if (used != NULL)
+        *used = 0;
+    return MPP_ERROR;
+}
+
+#endif /* MPP_TRACE */
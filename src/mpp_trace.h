@@ -0,0 +1,72 @@
+/*
+ * Copyright 2026 NXP.
+ *
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef _MPP_TRACE_H
+#define _MPP_TRACE_H
+
+#include "mpp_api_types.h"
+
+/* build option MPP_TRACE enables the execution trace */
+#ifndef MPP_TRACE
+#define MPP_TRACE 0
+#endif
+/* number of events in the ring buffer, power of 2 */
+#ifndef MPP_TRACE_EVENTS
+#define MPP_TRACE_EVENTS 1024
+#endif
+
+/* trace event types */
+typedef enum {
+    MPP_TRACE_NONE = 0,
+    MPP_TRACE_ELEM_BEGIN,   /* obj: element */
+    MPP_TRACE_ELEM_END,     /* obj: element */
+    MPP_TRACE_CYCLE_BEGIN,  /* flags: heap (MPP_TRACE_HEAP_RC/PR) */
+    MPP_TRACE_CYCLE_END,    /* flags: heap (MPP_TRACE_HEAP_RC/PR) */
+    MPP_TRACE_BUF_STATE,    /* obj: buffer descriptor, flags: new status */
+    MPP_TRACE_HAL_BEGIN,    /* obj: element, flags: HAL operation */
+    MPP_TRACE_HAL_END,      /* obj: element, flags: HAL operation */
+    MPP_TRACE_TASK_SWITCH,  /* task switched in */
+} _mpp_trace_type_t;
+
+#define MPP_TRACE_HEAP_RC       0
+#define MPP_TRACE_HEAP_PR       1
+
+#define MPP_TRACE_HAL_GFX       0   /* graphics blit */
+#define MPP_TRACE_HAL_DISPLAY   1   /* display blit */
+#define MPP_TRACE_HAL_INFERENCE 2   /* inference run */
+
+/* binary event, recorded in the ring buffer and dumped as is */
+typedef struct {
+    uint32_t ts;            /* time (us) */
+    uint8_t type;           /* _mpp_trace_type_t */
+    uint8_t flags;          /* type specific */
+    uint16_t frame_id;      /* frame processed */
+    uint32_t task;          /* running task */
+    uint32_t obj;           /* type specific object */
+} _mpp_trace_evt_t;
+
+void mpp_trace_record(uint8_t type, uint8_t flags, unsigned short frame_id, const void *obj);
+
+#if MPP_TRACE
+#define MPP_TRACE_EVT(type, flags, frame_id, obj) \
+    mpp_trace_record((type), (flags), (frame_id), (obj))
+#else
+#define MPP_TRACE_EVT(type, flags, frame_id, obj) do { } while (0)
+#endif
+
+#endif
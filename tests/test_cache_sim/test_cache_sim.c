@@ -0,0 +1,145 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* @brief This test application checks the buffer cache maintenance of the
+ * pipeline (mpp_cache.c) against the data cache simulator of the emulator
+ * (build with EMULATOR and HAL_CACHE_SIM defined).
+ * The CPU/device handoffs of the elements are replayed on buffers:
+ * - CPU writes, device reads (display of a CPU converted frame)
+ * - device writes, CPU reads (CPU processing of a camera frame)
+ * - device writes, CPU draws part of the frame, device reads (labeled rectangles)
+ * - device writes a buffer not aligned on cache lines, the CPU writes its neighbour meanwhile
+ * A handoff without maintenance is replayed first to check the simulator reports it.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "hal.h"
+#include "mpp_api_types_internal.h"
+#include "mpp_cache.h"
+
+#if !defined(EMULATOR) || !defined(HAL_CACHE_SIM)
+#error "test_cache_sim requires an emulator build with HAL_CACHE_SIM"
+#endif
+
+#define PRINTF printf
+#define main app_main
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define TEST_WIDTH      64
+#define TEST_HEIGHT     16
+#define TEST_BPP        2
+#define TEST_STRIDE     (TEST_WIDTH * TEST_BPP)
+#define TEST_SIZE       (TEST_STRIDE * TEST_HEIGHT)
+
+typedef struct {
+    hw_buf_desc_t hw;
+    buf_desc_t buf;
+} test_buf_t;
+
+/*******************************************************************************
+ * Variables declaration
+ ******************************************************************************/
+static uint8_t mem[4 * TEST_SIZE] __attribute__((aligned(MPP_CACHE_LINE_SIZE)));
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void buf_init(test_buf_t *t, uint8_t *addr)
+{
+    memset(t, 0, sizeof(*t));
+    t->hw.addr = addr;
+    t->hw.stride = TEST_STRIDE;
+    t->hw.cacheable = true;
+    t->buf.hw = &t->hw;
+    t->buf.width = TEST_WIDTH;
+    t->buf.height = TEST_HEIGHT;
+    t->buf.format = MPP_PIXEL_RGB565;
+}
+
+/* element writing 'len' bytes at 'off' of its output */
+static void elem_write(buf_desc_t *buf, _mpp_access_t acc, uint32_t off, uint32_t len)
+{
+    mpp_cache_before_write(buf, acc);
+    if (acc == MPP_ACCESS_CPU)
+        memset(buf->hw->addr + off, 0x5a, len);
+    mpp_cache_written(buf, acc, off, len);
+}
+
+/* element reading its input */
+static void elem_read(buf_desc_t *buf, _mpp_access_t acc)
+{
+    mpp_cache_before_read(buf, acc);
+}
+
+static bool check(const char *name, unsigned int expected)
+{
+    unsigned int errors = HAL_CACHE_SIM_Errors();
+
+    PRINTF("%-40s %s\n", name, (errors == expected) ? "OK" : "FAIL");
+    return errors == expected;
+}
+
+int main(int argc, char *argv[])
+{
+    test_buf_t a, b;
+    unsigned int expected;
+    bool pass = true;
+
+    PRINTF("****** TEST test_cache_sim ******\n");
+
+    /* the simulator reports a device read of CPU data not cleaned */
+    buf_init(&a, mem + 3 * TEST_SIZE);
+    HAL_CACHE_SIM_Access((uint32_t)(uintptr_t)a.hw.addr, TEST_SIZE, false, true);
+    HAL_CACHE_SIM_Access((uint32_t)(uintptr_t)a.hw.addr, TEST_SIZE, true, false);
+    expected = HAL_CACHE_SIM_Errors();
+    pass &= (expected > 0);
+    PRINTF("%-40s %s\n", "missing maintenance detected", (expected > 0) ? "OK" : "FAIL");
+
+    /* CPU convert -> display */
+    buf_init(&a, mem);
+    elem_write(&a.buf, MPP_ACCESS_CPU, 0, mpp_cache_buf_size(&a.buf));
+    elem_read(&a.buf, MPP_ACCESS_DEV);
+    pass &= check("CPU write, device read", expected);
+
+    /* camera -> CPU convert, over the cached lines of the previous frame */
+    elem_write(&a.buf, MPP_ACCESS_DEV, 0, mpp_cache_buf_size(&a.buf));
+    elem_read(&a.buf, MPP_ACCESS_CPU);
+    pass &= check("device write, CPU read", expected);
+
+    /* camera -> labeled rectangle (rows 4..7) -> display */
+    elem_write(&a.buf, MPP_ACCESS_DEV, 0, mpp_cache_buf_size(&a.buf));
+    elem_read(&a.buf, MPP_ACCESS_CPU);
+    elem_write(&a.buf, MPP_ACCESS_CPU, 4 * TEST_STRIDE, 4 * TEST_STRIDE);
+    elem_read(&a.buf, MPP_ACCESS_DEV);
+    pass &= check("device write, CPU partial write", expected);
+
+    /* frames following each other through the same buffer */
+    for (int i = 0; i < 4; i++) {
+        elem_write(&a.buf, (i & 1) ? MPP_ACCESS_CPU : MPP_ACCESS_DEV, 0, mpp_cache_buf_size(&a.buf));
+        elem_read(&a.buf, (i & 2) ? MPP_ACCESS_CPU : MPP_ACCESS_DEV);
+    }
+    pass &= check("alternating writers and readers", expected);
+
+    /* buffer sharing its first cache line with a neighbour written by the CPU:
+     * invalidating the buffer must not discard the neighbour data */
+    buf_init(&a, mem + TEST_SIZE);
+    buf_init(&b, mem + TEST_SIZE + MPP_CACHE_LINE_SIZE / 2);
+    b.buf.height = TEST_HEIGHT - 1;
+    elem_write(&b.buf, MPP_ACCESS_DEV, 0, mpp_cache_buf_size(&b.buf));
+    elem_write(&a.buf, MPP_ACCESS_CPU, 0, MPP_CACHE_LINE_SIZE / 2);
+    elem_read(&b.buf, MPP_ACCESS_CPU);
+    elem_read(&a.buf, MPP_ACCESS_DEV);
+    pass &= check("unaligned buffer, device write, CPU read", expected);
+
+    PRINTF(pass ? "\r\nTEST PASS\n" : "\r\nTEST FAIL\n");
+    return pass ? 0 : 1;
+}
@@ -515,6 +515,11 @@ static void app_task(void *params)
     nanodet_params.ml_inference.inference_params.outputs_offsets[0] = NANODET_M_cls_pred;
     nanodet_params.ml_inference.inference_params.outputs_offsets[1] = NANODET_M_reg_pred;
     nanodet_params.ml_inference.inference_params.model_input_tensors_type = MPP_TENSOR_TYPE_INT8;
+    /* output placeholders as described by the bundle header */
+    nanodet_params.ml_inference.inference_params.outputs_dims[0] = (mpp_tensor_dims_t){3, {1, 100, 80}};
+    nanodet_params.ml_inference.inference_params.outputs_types[0] = MPP_TENSOR_TYPE_FLOAT32;
+    nanodet_params.ml_inference.inference_params.outputs_dims[1] = (mpp_tensor_dims_t){3, {1, 100, 32}};
+    nanodet_params.ml_inference.inference_params.outputs_types[1] = MPP_TENSOR_TYPE_FLOAT32;
     nanodet_params.ml_inference.inference_params.model_entry_point = &nanodet_m;
     nanodet_params.ml_inference.type = MPP_INFERENCE_TYPE_GLOW ;
 #endif
@@ -338,6 +338,9 @@ static void app_task(void *params)
     mobilenet_params.ml_inference.inference_params.inputs_offsets[0] = MOBILENET_V1_input;
     mobilenet_params.ml_inference.inference_params.outputs_offsets[0] = MOBILENET_V1_MobilenetV1_Predictions_Reshape_1;
     mobilenet_params.ml_inference.inference_params.model_input_tensors_type = MPP_TENSOR_TYPE_INT8;
+    /* output placeholders as described by the bundle header */
+    mobilenet_params.ml_inference.inference_params.outputs_dims[0] = (mpp_tensor_dims_t){2, {1, 1001}};
+    mobilenet_params.ml_inference.inference_params.outputs_types[0] = MPP_TENSOR_TYPE_FLOAT32;
     mobilenet_params.ml_inference.inference_params.model_entry_point = &mobilenet_v1;
     mobilenet_params.ml_inference.type = MPP_INFERENCE_TYPE_GLOW ;
     mobilenet_params.stats = &glow_stats;
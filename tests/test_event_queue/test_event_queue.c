@@ -0,0 +1,290 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* @brief This test application checks the events queue of a pipeline and its
+ * overflow policies. The application callback blocks on the first event while
+ * the pipeline side posts more events than the queue holds:
+ * - MPP_EVT_OVERFLOW_DROP_OLDEST: the poster never waits, the oldest events are
+ *   dropped and released, the most recent ones are delivered in order
+ * - MPP_EVT_OVERFLOW_BLOCK: the poster waits for the dispatch task, all events
+ *   are delivered in order
+ * Every queued event is released exactly once. Events without release function
+ * are delivered synchronously, unsubscribed events are only released.
+ */
+
+/* FreeRTOS kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "string.h"
+#include "stdbool.h"
+
+#ifndef EMULATOR
+/* NXP includes. */
+#include "fsl_device_registers.h"
+#include "fsl_debug_console.h"
+#include "pin_mux.h"
+#include "clock_config.h"
+#include "board.h"
+#include "board_init.h"
+#else
+#include <stdio.h>
+#define PRINTF printf
+#define main app_main
+#endif
+
+#include "hal_os.h"
+
+/* MPP includes */
+#include "mpp_api.h"
+#include "mpp_api_types_internal.h"
+#include "mpp_event.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define TEST_QUEUE_LEN      4
+#define TEST_EVENTS         12      /* posted events, the first one blocks the callback */
+#define TEST_TIMEOUT_MS     2000
+#define TEST_EVENT          MPP_EVENT_INTERNAL_TEST_RESERVED
+
+#define APP_DEFAULT_PRIO    1
+
+typedef struct _test_ctx test_ctx_t;
+
+/* release argument of a posted event */
+typedef struct {
+    test_ctx_t *ctx;
+    int idx;
+} test_evt_t;
+
+struct _test_ctx {
+    _mpp_t mpp;
+    hal_sema_t entered;             /* given by the callback when it blocks */
+    hal_sema_t gate;                /* unblocks the callback */
+    volatile int delivered[TEST_EVENTS];
+    volatile int nb_delivered;
+    volatile int released[TEST_EVENTS];
+    volatile int nb_released;
+    volatile bool posted;           /* all events posted */
+    hal_task_t cb_task;             /* task of the last callback */
+    test_evt_t evts[TEST_EVENTS];
+};
+
+/*******************************************************************************
+ * Variables declaration
+ ******************************************************************************/
+static test_ctx_t s_drop, s_block;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+static void app_task(void *params);
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static int evt_callback(mpp_t mpp, mpp_evt_t evt, void *evt_data, void *user_data)
+{
+    test_ctx_t *ctx = (test_ctx_t *)user_data;
+    int idx = (int)(uintptr_t)evt_data;
+
+    ctx->cb_task = hal_task_current();
+    if (ctx->nb_delivered < TEST_EVENTS)
+        ctx->delivered[ctx->nb_delivered] = idx;
+    ctx->nb_delivered++;
+    if (idx == 0) {
+        hal_sema_give(ctx->entered);
+        hal_sema_take(ctx->gate, HAL_MAX_TIMEOUT);
+    }
+    return 0;
+}
+
+static void evt_release(void *arg)
+{
+    test_evt_t *e = (test_evt_t *)arg;
+
+    e->ctx->released[e->idx]++;
+    e->ctx->nb_released++;
+}
+
+static int post(test_ctx_t *ctx, int idx)
+{
+    return mpp_event_post(&ctx->mpp, TEST_EVENT, (void *)(uintptr_t)idx, evt_release, &ctx->evts[idx]);
+}
+
+static bool wait_count(volatile int *count, int expected)
+{
+    for (int ms = 0; (*count < expected) && (ms < TEST_TIMEOUT_MS); ms++)
+        vTaskDelay(1 / portTICK_PERIOD_MS);
+    return *count >= expected;
+}
+
+static bool ctx_init(test_ctx_t *ctx, mpp_evt_overflow_t policy)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->mpp.params.evt_callback_f = evt_callback;
+    ctx->mpp.params.mask = MPP_EVENT_ALL;
+    ctx->mpp.params.cb_userdata = ctx;
+    ctx->mpp.params.evt_queue_len = TEST_QUEUE_LEN;
+    ctx->mpp.params.evt_overflow = policy;
+    ctx->entered = hal_sema_create_binary();
+    ctx->gate = hal_sema_create_binary();
+    for (int i = 0; i < TEST_EVENTS; i++) {
+        ctx->evts[i].ctx = ctx;
+        ctx->evts[i].idx = i;
+    }
+    return (ctx->entered != NULL) && (ctx->gate != NULL)
+           && (mpp_event_queue_create(&ctx->mpp, TEST_QUEUE_LEN) == MPP_SUCCESS);
+}
+
+static bool check(const char *name, bool ok)
+{
+    PRINTF("%-48s %s\n", name, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+static bool all_released_once(const test_ctx_t *ctx)
+{
+    for (int i = 0; i < TEST_EVENTS; i++) {
+        if (ctx->released[i] != 1)
+            return false;
+    }
+    return ctx->nb_released == TEST_EVENTS;
+}
+
+/* poster of the blocking policy test: waits for the dispatch task */
+static void block_poster_task(void *params)
+{
+    for (int i = 1; i < TEST_EVENTS; i++)
+        post(&s_block, i);
+    s_block.posted = true;
+    vTaskSuspend(NULL);
+}
+
+static bool test_drop_oldest(void)
+{
+    bool ok, pass = true;
+    int i;
+
+    /* first event blocks the callback, the queue is empty again */
+    post(&s_drop, 0);
+    pass &= check("drop oldest: callback blocked", hal_sema_take(s_drop.entered, TEST_TIMEOUT_MS));
+
+    /* the poster does not wait: the oldest pending events are released */
+    for (i = 1; i < TEST_EVENTS; i++)
+        post(&s_drop, i);
+    ok = (s_drop.nb_released == TEST_EVENTS - 1 - TEST_QUEUE_LEN);
+    for (i = 1; (i < TEST_EVENTS - TEST_QUEUE_LEN) && ok; i++)
+        ok = (s_drop.released[i] == 1);
+    pass &= check("drop oldest: overflow released", ok && (s_drop.nb_delivered == 1));
+
+    hal_sema_give(s_drop.gate);
+    pass &= check("drop oldest: pending events delivered", wait_count(&s_drop.nb_released, TEST_EVENTS));
+    ok = (s_drop.nb_delivered == 1 + TEST_QUEUE_LEN) && (s_drop.delivered[0] == 0);
+    for (i = 1; (i <= TEST_QUEUE_LEN) && ok; i++)
+        ok = (s_drop.delivered[i] == TEST_EVENTS - 1 - TEST_QUEUE_LEN + i);
+    pass &= check("drop oldest: most recent events, in order", ok);
+    pass &= check("drop oldest: released once", all_released_once(&s_drop));
+
+    return pass;
+}
+
+static bool test_block(void)
+{
+    TaskHandle_t handle = NULL;
+    bool ok, pass = true;
+    int i;
+
+    post(&s_block, 0);
+    pass &= check("block: callback blocked", hal_sema_take(s_block.entered, TEST_TIMEOUT_MS));
+
+    /* the poster fills the queue then waits */
+    if (xTaskCreate(block_poster_task, "poster", configMINIMAL_STACK_SIZE + 500, NULL, APP_DEFAULT_PRIO, &handle) != pdPASS)
+        return check("block: poster task", false);
+    vTaskDelay(100 / portTICK_PERIOD_MS);
+    pass &= check("block: poster waits", !s_block.posted && (s_block.nb_released == 0)
+                                         && (s_block.nb_delivered == 1));
+
+    hal_sema_give(s_block.gate);
+    pass &= check("block: all events delivered", wait_count(&s_block.nb_released, TEST_EVENTS) && s_block.posted);
+    ok = (s_block.nb_delivered == TEST_EVENTS);
+    for (i = 0; (i < TEST_EVENTS) && ok; i++)
+        ok = (s_block.delivered[i] == i);
+    pass &= check("block: in order", ok);
+    pass &= check("block: released once", all_released_once(&s_block));
+
+    return pass;
+}
+
+static bool test_synchronous(void)
+{
+    bool pass = true;
+    int delivered = s_drop.nb_delivered;
+    int released = s_drop.nb_released;
+
+    /* no release function: delivered by the poster */
+    mpp_event_post(&s_drop.mpp, TEST_EVENT, (void *)1, NULL, NULL);
+    pass &= check("no release: synchronous delivery",
+                  (s_drop.nb_delivered == delivered + 1) && (s_drop.cb_task == hal_task_current()));
+
+    /* unsubscribed: released, not delivered */
+    s_drop.mpp.params.mask = MPP_EVENT_ALL & ~MPP_EVENT_MASK(TEST_EVENT);
+    post(&s_drop, 1);
+    vTaskDelay(10 / portTICK_PERIOD_MS);
+    pass &= check("unsubscribed: released only",
+                  (s_drop.nb_delivered == delivered + 1) && (s_drop.nb_released == released + 1));
+    s_drop.mpp.params.mask = MPP_EVENT_ALL;
+
+    return pass;
+}
+
+/*!
+ * @brief Application entry point.
+ */
+int main(int argc, char *argv[])
+{
+    BaseType_t ret;
+
+#ifndef EMULATOR
+    /* Init board hardware. */
+    BOARD_Init();
+#endif
+
+    PRINTF("****** TEST test_event_queue ******\n");
+
+    ret = xTaskCreate(app_task, "app_task", configMINIMAL_STACK_SIZE + 1000, NULL, APP_DEFAULT_PRIO, NULL);
+    if (pdPASS != ret)
+    {
+        PRINTF("Failed to create app_task task");
+        while (1);
+    }
+
+    vTaskStartScheduler();
+    for (;;)
+        vTaskSuspend(NULL);
+    return 0;
+}
+
+static void app_task(void *params)
+{
+    bool pass = false;
+
+    /* the dispatch task runs at the priority of the pipelines preemptable tasks */
+    if (mpp_api_init(NULL) != MPP_SUCCESS) {
+        PRINTF("Failed to init MPP\n");
+    } else if (!ctx_init(&s_drop, MPP_EVT_OVERFLOW_DROP_OLDEST) || !ctx_init(&s_block, MPP_EVT_OVERFLOW_BLOCK)) {
+        PRINTF("Failed to create the events queues\n");
+    } else {
+        pass = test_drop_oldest();
+        pass &= test_block();
+        pass &= test_synchronous();
+    }
+
+    PRINTF(pass ? "\r\nTEST PASS\n" : "\r\nTEST FAIL\n");
+    for (;;)
+        vTaskSuspend(NULL);
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* @brief This test application checks the latency histograms behind
+ * mpp_stats_get_latency(): percentiles of known distributions must be at
+ * least the exact percentile and within the 12.5% relative error, min and max
+ * are exact, values beyond the range are counted, and a window reset applies
+ * at the next sample.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#ifndef EMULATOR
+/* NXP includes. */
+#include "fsl_device_registers.h"
+#include "fsl_debug_console.h"
+#include "pin_mux.h"
+#include "clock_config.h"
+#include "board.h"
+#include "board_init.h"
+#else
+#define PRINTF printf
+#define main app_main
+#endif
+
+#include "hal_os.h"
+#include "mpp_histogram.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/* reported value 'v' of the exact value 'x': x <= v <= x * 1.125 */
+#define IN_ERROR(v, x)  (((uint64_t)(v) >= (x)) && ((uint64_t)(v) * 8 <= (uint64_t)(x) * 9))
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static bool check(const char *name, bool ok, const mpp_latency_t *lat)
+{
+    PRINTF("%-36s %s", name, ok ? "OK" : "FAIL");
+    if (!ok)
+        PRINTF(": count %u min %u p50 %u p90 %u p99 %u max %u", lat->count, (unsigned int)lat->min,
+               (unsigned int)lat->p50, (unsigned int)lat->p90, (unsigned int)lat->p99, (unsigned int)lat->max);
+    PRINTF("\n");
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    _mpp_hist_t *hist;
+    mpp_latency_t lat;
+    uint32_t v;
+    bool ok, pass = true;
+    int i;
+
+#ifndef EMULATOR
+    /* Init board hardware. */
+    BOARD_Init();
+#endif
+
+    PRINTF("****** TEST test_histogram ******\n");
+
+    hist = mpp_hist_create();
+    if (hist == NULL) {
+        PRINTF("\r\nTEST FAIL\n");
+        return 1;
+    }
+
+    /* empty window */
+    mpp_hist_read(hist, &lat, false);
+    pass &= check("empty", (lat.count == 0) && (lat.p99 == 0) && (lat.max == 0), &lat);
+
+    /* small values have exact buckets */
+    for (i = 0; i < 8; i++)
+        mpp_hist_record(hist, i);
+    mpp_hist_read(hist, &lat, true);
+    pass &= check("small values exact",
+                  (lat.count == 8) && (lat.min == 0) && (lat.p50 == 3) && (lat.p90 == 7) && (lat.max == 7), &lat);
+
+    /* uniform 1..1000 us */
+    for (i = 1; i <= 1000; i++)
+        mpp_hist_record(hist, i);
+    mpp_hist_read(hist, &lat, true);
+    pass &= check("uniform", (lat.count == 1000) && (lat.min == 1) && (lat.max == 1000)
+                  && IN_ERROR(lat.p50, 500) && IN_ERROR(lat.p90, 900) && IN_ERROR(lat.p99, 990), &lat);
+
+    /* mostly fast frames with a slow tail */
+    for (i = 0; i < 1000; i++)
+        mpp_hist_record(hist, (i % 100 < 95) ? 2000 : 40000);
+    mpp_hist_read(hist, &lat, true);
+    pass &= check("slow tail", (lat.count == 1000) && IN_ERROR(lat.p50, 2000) && IN_ERROR(lat.p90, 2000)
+                  && (lat.p99 == 40000), &lat);
+
+    /* relative error over the range: one sample 'v' and one far above */
+    ok = true;
+    for (v = 1; (v < (1U << 26)) && ok; v += (v >> 4) + 1) {
+        mpp_hist_record(hist, v);
+        mpp_hist_record(hist, 1U << 27);
+        mpp_hist_read(hist, &lat, true);
+        ok = (lat.count == 2) && (lat.min == v) && IN_ERROR(lat.p50, v);
+        /* the reset applies at the next sample */
+        if (ok)
+            mpp_hist_read(hist, &lat, false);
+        ok = ok && (lat.count == 2);
+    }
+    pass &= check("relative error", ok, &lat);
+
+    /* values beyond the range are counted, the maximum is exact */
+    mpp_hist_record(hist, 10);
+    mpp_hist_record(hist, UINT32_MAX);
+    mpp_hist_read(hist, &lat, true);
+    pass &= check("out of range", (lat.count == 2) && (lat.max == UINT32_MAX) && (lat.p99 >= (1U << 26)), &lat);
+
+    /* new window */
+    mpp_hist_record(hist, 123);
+    mpp_hist_read(hist, &lat, false);
+    pass &= check("window reset", (lat.count == 1) && (lat.min == 123) && (lat.max == 123) && (lat.p50 == 123), &lat);
+
+    hal_free(hist);
+
+    PRINTF(pass ? "\r\nTEST PASS\n" : "\r\nTEST FAIL\n");
+    return pass ? 0 : 1;
+}
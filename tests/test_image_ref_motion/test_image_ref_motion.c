@@ -0,0 +1,268 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* @brief This test application checks the motion gate element in front of a
+ * model run by the reference C backend:
+ * static image -> motion -> inference (reference) -> null sink
+ * - a still image runs the inference on the first frame only, the next frames are gated
+ * - an image change runs the inference again
+ * - refresh_period passes one still frame every refresh_period frames
+ * - hold_frames passes the frames following a change
+ * Frames are counted by the execution time histogram of the motion element.
+ */
+
+/* FreeRTOS kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "string.h"
+#include "stdbool.h"
+
+#ifndef EMULATOR
+/* NXP includes. */
+#include "fsl_device_registers.h"
+#include "fsl_debug_console.h"
+#include "pin_mux.h"
+#include "clock_config.h"
+#include "board.h"
+#include "board_init.h"
+#else
+#include <stdio.h>
+#define PRINTF printf
+#define main app_main
+#endif
+
+/* MPP includes */
+#include "mpp_api.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define IMG_WIDTH           64
+#define IMG_HEIGHT          64
+#define IMG_CHANNELS        3
+
+/* frames observed per step */
+#define STEP_FRAMES         12
+#define REFRESH_PERIOD      4
+#define HOLD_FRAMES         3
+
+#define TEST_TIMEOUT_MS     5000
+
+#define APP_DEFAULT_PRIO    1
+
+/*******************************************************************************
+ * Variables declaration
+ ******************************************************************************/
+static uint8_t s_image[IMG_WIDTH * IMG_HEIGHT * IMG_CHANNELS];
+static volatile int s_runs;
+static mpp_elem_handle_t s_motion_h;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+static void app_task(void *params);
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/* reference model function: counts the frames reaching the inference */
+static int model_run(const mpp_inference_tensor_params_t *input, mpp_inference_tensor_params_t *outputs[], void *arg)
+{
+    s_runs++;
+    ((uint8_t *)outputs[0]->data)[0] = input->data[0];
+    return 0;
+}
+
+static const mpp_ref_model_t s_model = {
+    .width = IMG_WIDTH,
+    .height = IMG_HEIGHT,
+    .channels = IMG_CHANNELS,
+    .input_type = MPP_TENSOR_TYPE_UINT8,
+    .num_outputs = 1,
+    .out_dims = { { 2, { 1, 1 } } },
+    .out_type = { MPP_TENSOR_TYPE_UINT8 },
+    .run = model_run,
+};
+
+/* frames reaching the motion element, passed or not */
+static unsigned int frames(mpp_t mp)
+{
+    mpp_latency_t lat;
+
+    if (mpp_stats_get_latency(MPP_LATENCY_ELEMENT, mp, s_motion_h, &lat, 0) != MPP_SUCCESS)
+        return 0;
+    return lat.count;
+}
+
+/* waits for 'count' more frames, returns the inference runs meanwhile */
+static int run_frames(mpp_t mp, unsigned int count, unsigned int *seen)
+{
+    unsigned int start = frames(mp);
+    int runs = s_runs;
+    int ms = 0;
+
+    while ((frames(mp) < start + count) && (ms < TEST_TIMEOUT_MS)) {
+        vTaskDelay(10 / portTICK_PERIOD_MS);
+        ms += 10;
+    }
+    runs = s_runs - runs;
+    *seen = frames(mp) - start;
+    return runs;
+}
+
+static bool check(const char *name, int runs, int min, int max, unsigned int seen, unsigned int count)
+{
+    bool ok = (runs >= min) && (runs <= max) && (seen >= count);
+
+    PRINTF("%-40s runs %2d frames %3d %s\n", name, runs, seen, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    BaseType_t ret;
+
+#ifndef EMULATOR
+    /* Init board hardware. */
+    BOARD_Init();
+#endif
+
+    PRINTF("****** TEST test_image_ref_motion ******\n");
+
+    ret = xTaskCreate(app_task, "app_task", configMINIMAL_STACK_SIZE + 1000, NULL, APP_DEFAULT_PRIO, NULL);
+    if (pdPASS != ret)
+    {
+        PRINTF("Failed to create app_task task");
+        while (1);
+    }
+
+    vTaskStartScheduler();
+    for (;;)
+        vTaskSuspend(NULL);
+    return 0;
+}
+
+static void app_task(void *params)
+{
+    mpp_api_params_t api_params;
+    mpp_params_t mpp_params;
+    mpp_img_params_t img_params;
+    mpp_element_params_t motion_params, elem_params;
+    mpp_t mp;
+    unsigned int seen;
+    bool pass = true;
+    int runs, ret;
+
+    memset(s_image, 0x80, sizeof(s_image));
+
+    memset(&api_params, 0, sizeof(api_params));
+    api_params.latency_hist = true;
+    ret = mpp_api_init(&api_params);
+    if (ret)
+        goto err;
+
+    memset(&mpp_params, 0, sizeof(mpp_params));
+    mpp_params.exec_flag = MPP_EXEC_RC;
+    mp = mpp_create(&mpp_params, &ret);
+    if (mp == MPP_INVALID)
+        goto err;
+
+    memset(&img_params, 0, sizeof(img_params));
+    img_params.format = MPP_PIXEL_RGB;
+    img_params.width = IMG_WIDTH;
+    img_params.height = IMG_HEIGHT;
+    ret = mpp_static_img_add(mp, &img_params, (void *)s_image);
+    if (ret) {
+        PRINTF("Failed to add static image\n");
+        goto err;
+    }
+
+    /* every changed thumbnail pixel detects motion, no background averaging */
+    memset(&motion_params, 0, sizeof(motion_params));
+    motion_params.motion.pixel_threshold = 16;
+    motion_params.motion.area_threshold = 0.1f;
+    motion_params.motion.background_shift = 0;
+    motion_params.motion.hold_frames = 0;
+    motion_params.motion.refresh_period = 0;
+    ret = mpp_element_add(mp, MPP_ELEMENT_MOTION, &motion_params, &s_motion_h);
+    if (ret) {
+        PRINTF("Failed to add element MOTION\n");
+        goto err;
+    }
+
+    memset(&elem_params, 0, sizeof(elem_params));
+    elem_params.ml_inference.model_data = &s_model;
+    elem_params.ml_inference.type = MPP_INFERENCE_TYPE_REFERENCE;
+    elem_params.ml_inference.model_input_mean = 0;
+    elem_params.ml_inference.model_input_std = 1;
+    elem_params.ml_inference.tensor_order = MPP_TENSOR_ORDER_NHWC;
+    elem_params.ml_inference.inference_params.num_inputs = 1;
+    elem_params.ml_inference.inference_params.num_outputs = 1;
+    ret = mpp_element_add(mp, MPP_ELEMENT_INFERENCE, &elem_params, NULL);
+    if (ret) {
+        PRINTF("Failed to add element INFERENCE\n");
+        goto err;
+    }
+
+    ret = mpp_nullsink_add(mp);
+    if (ret) {
+        PRINTF("Failed to add NULL sink\n");
+        goto err;
+    }
+
+    ret = mpp_start(mp, 1);
+    if (ret) {
+        PRINTF("Failed to start pipeline\n");
+        goto err;
+    }
+
+    /* the first frame initializes the background and is passed */
+    runs = run_frames(mp, STEP_FRAMES, &seen);
+    pass &= check("still image: first frame only", runs, 1, 1, seen, STEP_FRAMES);
+
+    /* a frame copied while the image changes may also pass */
+    memset(s_image, 0xe0, sizeof(s_image));
+    runs = run_frames(mp, STEP_FRAMES, &seen);
+    pass &= check("changed image: passed once", runs, 1, 2, seen, STEP_FRAMES);
+
+    /* the frame count and the runs are read at slightly different times */
+    motion_params.motion.refresh_period = REFRESH_PERIOD;
+    ret = mpp_element_update(mp, s_motion_h, &motion_params);
+    runs = run_frames(mp, 4 * REFRESH_PERIOD, &seen);
+    pass &= check("still image: refresh period", runs,
+                  (int)seen / REFRESH_PERIOD - 1, (int)seen / REFRESH_PERIOD + 1, seen, 4 * REFRESH_PERIOD);
+    pass &= (ret == MPP_SUCCESS);
+
+    motion_params.motion.refresh_period = 0;
+    motion_params.motion.hold_frames = HOLD_FRAMES;
+    ret = mpp_element_update(mp, s_motion_h, &motion_params);
+    runs = run_frames(mp, STEP_FRAMES, &seen);
+    pass &= check("still image: no refresh", runs, 0, 1, seen, STEP_FRAMES);
+    memset(s_image, 0x20, sizeof(s_image));
+    runs = run_frames(mp, STEP_FRAMES, &seen);
+    pass &= check("changed image: held frames passed", runs, 1 + HOLD_FRAMES, 2 + HOLD_FRAMES, seen, STEP_FRAMES);
+    pass &= (ret == MPP_SUCCESS);
+
+    /* thumbnail dimensions are fixed at setup */
+    motion_params.motion.thumb_width = 16;
+    ret = mpp_element_update(mp, s_motion_h, &motion_params);
+    PRINTF("%-40s %s\n", "thumbnail update rejected", (ret != MPP_SUCCESS) ? "OK" : "FAIL");
+    pass &= (ret != MPP_SUCCESS);
+
+    mpp_stop(mp);
+
+    PRINTF(pass ? "\r\nTEST PASS\n" : "\r\nTEST FAIL\n");
+    for (;;)
+        vTaskSuspend(NULL);
+
+err:
+    for (;;)
+    {
+        PRINTF("Error building application pipeline : ret %d\r\n", ret);
+        vTaskSuspend(NULL);
+    }
+}
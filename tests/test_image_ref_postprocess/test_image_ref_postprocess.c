@@ -0,0 +1,523 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* @brief This test application checks the post-processing elements on the
+ * scripted outputs of models run by the reference C backend:
+ * static image -> inference (reference) -> detection -> tracker -> null sink
+ * static image -> inference (reference) -> classification -> null sink
+ * - detection: quantized box decoding, score threshold, class-aware NMS, ordering
+ * - tracker: a moving box and a still box keep their identifiers, duplicates
+ *   and short-lived boxes are not reported, a lost box is dropped after max_misses
+ * - classification: top-K classes above the score threshold
+ * The tracked boxes of a frame are read from its metadata when the next frame is detected:
+ * the metadata container of the frame is held until then.
+ */
+
+/* FreeRTOS kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "string.h"
+#include "stdbool.h"
+
+#ifndef EMULATOR
+/* NXP includes. */
+#include "fsl_device_registers.h"
+#include "fsl_debug_console.h"
+#include "pin_mux.h"
+#include "clock_config.h"
+#include "board.h"
+#include "board_init.h"
+#else
+#include <stdio.h>
+#define PRINTF printf
+#define main app_main
+#endif
+
+#include "hal_os.h"
+
+/* MPP includes */
+#include "mpp_api.h"
+#include "mpp_api_types_internal.h"
+#include "mpp_buffer.h"
+#include "mpp_meta.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define IMG_WIDTH           64
+#define IMG_HEIGHT          64
+#define IMG_CHANNELS        3
+
+/* detection model: rows of class scores and box corners */
+#define DET_ROWS            8
+#define DET_CLASSES         2
+#define DET_SCORE_THRESHOLD 0.5f
+#define DET_IOU_THRESHOLD   0.45f
+
+/* tracked boxes: A moves right by DET_SPEED pixels per frame, B stays until DET_B_GONE */
+#define DET_SPEED           1
+#define DET_B_GONE          20
+#define DET_FRAMES          40
+#define TRK_MIN_HITS        2
+#define TRK_MAX_MISSES      3
+/* tracked box distance to the detected box once the velocity is estimated (pixels) */
+#define TRK_TOLERANCE       3
+#define TRK_SETTLE_FRAMES   8
+
+/* classification model */
+#define CLS_CLASSES         10
+#define CLS_TOP_K           5
+#define CLS_SCORE_THRESHOLD 0.45f
+#define CLS_FRAMES          10
+
+#define TEST_TIMEOUT_MS     10000
+
+#define APP_DEFAULT_PRIO    1
+
+typedef struct {
+    int16_t left, top, right, bottom;
+    int label;
+    float score;
+} test_box_t;
+
+/*******************************************************************************
+ * Variables declaration
+ ******************************************************************************/
+static uint8_t s_image[IMG_WIDTH * IMG_HEIGHT * IMG_CHANNELS];
+
+/* frame 0 detection rows: NMS scenario */
+static const test_box_t s_rows0[] = {
+    {  2,  8, 18, 32, 0, 0.90f },   /* A */
+    {  4,  8, 20, 32, 0, 0.80f },   /* A duplicate: suppressed */
+    {  4,  8, 20, 32, 1, 0.70f },   /* A duplicate of another class: kept */
+    { 40, 40, 60, 60, 1, 0.60f },   /* B */
+    { 20, 40, 30, 50, 0, 0.20f },   /* below threshold */
+    {  0,  0,  0,  0, 0, 0.95f },   /* empty box */
+};
+static const int s_expected0[] = { 0, 2, 3 };
+
+static const uint8_t s_cls_scores[2][CLS_CLASSES] = {
+    { 10, 200, 30, 250, 0, 120, 199, 5, 90, 60 },
+    { 255, 0, 130, 1, 140, 2, 150, 3, 160, 170 },
+};
+static const int16_t s_cls_top[2][CLS_TOP_K] = {
+    { 3, 1, 6, 5, -1 },
+    { 0, 9, 8, 6, 4 },
+};
+
+static mpp_elem_handle_t s_trk_h;
+/* holds the metadata of the previous frame */
+static buf_desc_t s_trk_frame;
+static volatile int s_det_runs, s_det_events, s_cls_runs, s_cls_events;
+static volatile bool s_det_fail, s_trk_fail, s_cls_fail;
+static int s_trk_checked, s_id_a = -1, s_id_b = -1;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+static void app_task(void *params);
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/* box A of frame 'k' */
+static test_box_t box_a(int k)
+{
+    test_box_t b = { 2 + DET_SPEED * k, 8, 18 + DET_SPEED * k, 32, 0, 0.90f };
+    return b;
+}
+
+static const test_box_t s_box_b = { 40, 40, 60, 60, 1, 0.60f };
+
+/* scores are INT8 (scale 1/256, zero point -128), corners UINT8 pixels (scale 1/IMG_WIDTH) */
+static void set_row(mpp_inference_tensor_params_t *cls, mpp_inference_tensor_params_t *reg,
+                    int row, const test_box_t *b)
+{
+    int q = (int)(b->score * 256 + 0.5f) - 128;
+
+    ((int8_t *)cls->data)[row * DET_CLASSES + b->label] = (q > 127) ? 127 : q;
+    ((uint8_t *)reg->data)[row * 4 + 0] = b->left;
+    ((uint8_t *)reg->data)[row * 4 + 1] = b->top;
+    ((uint8_t *)reg->data)[row * 4 + 2] = b->right;
+    ((uint8_t *)reg->data)[row * 4 + 3] = b->bottom;
+}
+
+/* reference model function of the detection pipeline */
+static int det_model_run(const mpp_inference_tensor_params_t *input, mpp_inference_tensor_params_t *outputs[], void *arg)
+{
+    mpp_inference_tensor_params_t *cls = outputs[0], *reg = outputs[1];
+    int k = s_det_runs++;
+
+    cls->scale = 1.0f / 256;
+    cls->zero_point = -128;
+    reg->scale = 1.0f / IMG_WIDTH;
+    reg->zero_point = 0;
+    memset((void *)cls->data, -128, DET_ROWS * DET_CLASSES);
+    memset((void *)reg->data, 0, DET_ROWS * 4);
+
+    if (k == 0) {
+        for (unsigned int i = 0; i < sizeof(s_rows0) / sizeof(s_rows0[0]); i++)
+            set_row(cls, reg, i, &s_rows0[i]);
+    } else {
+        test_box_t a = box_a(k), dup = box_a(k);
+        dup.left += 2;
+        dup.right += 2;
+        dup.score = 0.80f;
+        /* boxes in changing rows */
+        set_row(cls, reg, k % DET_ROWS, &a);
+        set_row(cls, reg, (k + 3) % DET_ROWS, &dup);
+        if (k < DET_B_GONE)
+            set_row(cls, reg, (k + 5) % DET_ROWS, &s_box_b);
+    }
+    return 0;
+}
+
+/* reference model function of the classification pipeline */
+static int cls_model_run(const mpp_inference_tensor_params_t *input, mpp_inference_tensor_params_t *outputs[], void *arg)
+{
+    outputs[0]->scale = 1.0f / 255;
+    outputs[0]->zero_point = 0;
+    memcpy((void *)outputs[0]->data, s_cls_scores[s_cls_runs++ & 1], CLS_CLASSES);
+    return 0;
+}
+
+static const mpp_ref_model_t s_det_model = {
+    .width = IMG_WIDTH,
+    .height = IMG_HEIGHT,
+    .channels = IMG_CHANNELS,
+    .input_type = MPP_TENSOR_TYPE_INT8,
+    .num_outputs = 2,
+    .out_dims = { { 3, { 1, DET_ROWS, DET_CLASSES } }, { 3, { 1, DET_ROWS, 4 } } },
+    .out_type = { MPP_TENSOR_TYPE_INT8, MPP_TENSOR_TYPE_UINT8 },
+    .run = det_model_run,
+};
+
+static const mpp_ref_model_t s_cls_model = {
+    .width = IMG_WIDTH,
+    .height = IMG_HEIGHT,
+    .channels = IMG_CHANNELS,
+    .input_type = MPP_TENSOR_TYPE_UINT8,
+    .num_outputs = 1,
+    .out_dims = { { 2, { 1, CLS_CLASSES } } },
+    .out_type = { MPP_TENSOR_TYPE_UINT8 },
+    .run = cls_model_run,
+};
+
+static bool same_box(const mpp_detection_box_t *d, const test_box_t *b, int tol)
+{
+    return (d->label == b->label)
+           && (d->left >= b->left - tol) && (d->left <= b->left + tol)
+           && (d->right >= b->right - tol) && (d->right <= b->right + tol)
+           && (d->top >= b->top - tol) && (d->top <= b->top + tol)
+           && (d->bottom >= b->bottom - tol) && (d->bottom <= b->bottom + tol);
+}
+
+static bool check_detections(const mpp_detections_t *det, int k)
+{
+    test_box_t exp[3];
+    unsigned int n = 0;
+
+    if (k == 0) {
+        for (n = 0; n < sizeof(s_expected0) / sizeof(s_expected0[0]); n++)
+            exp[n] = s_rows0[s_expected0[n]];
+    } else {
+        exp[n++] = box_a(k);
+        if (k < DET_B_GONE)
+            exp[n++] = s_box_b;
+    }
+    if ((det->count != n) || (det->width != IMG_WIDTH) || (det->height != IMG_HEIGHT))
+        return false;
+    for (unsigned int i = 0; i < n; i++) {
+        /* sorted by score, quantized with 1/256 steps */
+        if (!same_box(&det->boxes[i], &exp[i], 0) || (det->boxes[i].id != -1)
+                || (det->boxes[i].score < exp[i].score - 1.0f / 256)
+                || (det->boxes[i].score > exp[i].score + 1.0f / 256))
+            return false;
+    }
+    return true;
+}
+
+/* tracked boxes of frame 'j' */
+static bool check_tracks(const mpp_detections_t *trk, int j)
+{
+    const mpp_detection_box_t *a = NULL, *b = NULL;
+    test_box_t exp_a = box_a(j);
+    int tol = (j >= TRK_SETTLE_FRAMES) ? TRK_TOLERANCE : IMG_WIDTH;
+
+    for (unsigned int i = 0; i < trk->count; i++) {
+        if (trk->boxes[i].label == 0)
+            a = (a == NULL) ? &trk->boxes[i] : NULL;
+        else
+            b = (b == NULL) ? &trk->boxes[i] : NULL;
+    }
+    /* tracks are confirmed after min_hits associations */
+    if (j < TRK_MIN_HITS - 1)
+        return trk->count == 0;
+    if ((a == NULL) || !same_box(a, &exp_a, tol) || (a->id < 0))
+        return false;
+    if (s_id_a < 0)
+        s_id_a = a->id;
+    if (a->id != s_id_a)
+        return false;
+
+    /* B is reported while detected and max_misses results after */
+    if (j < DET_B_GONE) {
+        if ((trk->count != 2) || (b == NULL) || !same_box(b, &s_box_b, TRK_TOLERANCE) || (b->id == s_id_a))
+            return false;
+        if (s_id_b < 0)
+            s_id_b = b->id;
+        return b->id == s_id_b;
+    }
+    if (j >= DET_B_GONE + TRK_MAX_MISSES)
+        return trk->count == 1;
+    return true;
+}
+
+static int mpp_event_listener(mpp_t mpp, mpp_evt_t evt, void *evt_data, void *user_data)
+{
+    switch (evt) {
+    case MPP_EVENT_DETECTION_READY:
+    {
+        const mpp_detections_t *det = (const mpp_detections_t *)evt_data;
+        int k = s_det_events++;
+        _elem_t *trk = mpp_elem_from_handle(s_trk_h);
+        buf_desc_t *buf;
+        mpp_detections_t tracks;
+
+        if (k >= DET_FRAMES)
+            break;
+        if (!check_detections(det, k)) {
+            PRINTF("Frame %d: unexpected detections (%d boxes)\n", k, det->count);
+            s_det_fail = true;
+        }
+        /* tracker results of the previous frame: the tracker of this frame did not run yet */
+        if (trk == NULL)
+            break;
+        if (k > 0) {
+            memset(&tracks, 0, sizeof(tracks));
+            if ((mpp_meta_copy(&s_trk_frame, MPP_META_DETECTIONS, trk, 0, &tracks, sizeof(tracks)) == 0)
+                    || !check_tracks(&tracks, k - 1)) {
+                PRINTF("Frame %d: unexpected tracks (%d boxes)\n", k - 1, tracks.count);
+                s_trk_fail = true;
+            }
+            s_trk_checked++;
+        }
+        /* the frame stays readable once processed, up to the last checked frame */
+        buf = trk->io.in_buf[0];
+        atomic_store(&s_trk_frame.state, atomic_load(&buf->state));
+        mpp_meta_set(&s_trk_frame, (k + 1 < DET_FRAMES) ? buf->meta : NULL);
+        break;
+    }
+    case MPP_EVENT_CLASSIFICATION_READY:
+    {
+        const mpp_classification_t *cls = (const mpp_classification_t *)evt_data;
+        int k = s_cls_events++;
+        const int16_t *top = s_cls_top[k & 1];
+        unsigned int i;
+
+        if (k >= CLS_FRAMES)
+            break;
+        for (i = 0; (i < CLS_TOP_K) && (top[i] >= 0); i++) {
+            if ((i >= cls->count) || (cls->top[i].label != top[i])
+                    || (cls->top[i].score < s_cls_scores[k & 1][top[i]] / 255.0f - 1e-4f)
+                    || (cls->top[i].score > s_cls_scores[k & 1][top[i]] / 255.0f + 1e-4f))
+                break;
+        }
+        if ((i != cls->count) || ((i < CLS_TOP_K) && (top[i] >= 0))) {
+            PRINTF("Frame %d: unexpected classes (%d classes)\n", k, cls->count);
+            s_cls_fail = true;
+        }
+        break;
+    }
+    case MPP_EVENT_INVALID:
+    default:
+        /* nothing to do */
+        break;
+    }
+
+    return 0;
+}
+
+/*!
+ * @brief Application entry point.
+ */
+int main(int argc, char *argv[])
+{
+    BaseType_t ret;
+
+#ifndef EMULATOR
+    /* Init board hardware. */
+    BOARD_Init();
+#endif
+
+    PRINTF("****** TEST test_image_ref_postprocess ******\n");
+
+    ret = xTaskCreate(app_task, "app_task", configMINIMAL_STACK_SIZE + 1000, NULL, APP_DEFAULT_PRIO, NULL);
+    if (pdPASS != ret)
+    {
+        PRINTF("Failed to create app_task task");
+        while (1);
+    }
+
+    vTaskStartScheduler();
+    for (;;)
+        vTaskSuspend(NULL);
+    return 0;
+}
+
+static mpp_t create_pipeline(mpp_element_params_t *inf_params, const mpp_ref_model_t *model, int *ret)
+{
+    mpp_params_t mpp_params;
+    mpp_img_params_t img_params;
+    mpp_t mp;
+
+    memset(&mpp_params, 0, sizeof(mpp_params));
+    mpp_params.evt_callback_f = &mpp_event_listener;
+    mpp_params.mask = MPP_EVENT_ALL;
+    mpp_params.exec_flag = MPP_EXEC_RC;
+    mp = mpp_create(&mpp_params, ret);
+    if (mp == MPP_INVALID)
+        return MPP_INVALID;
+
+    memset(&img_params, 0, sizeof(img_params));
+    img_params.format = MPP_PIXEL_RGB;
+    img_params.width = IMG_WIDTH;
+    img_params.height = IMG_HEIGHT;
+    *ret = mpp_static_img_add(mp, &img_params, (void *)s_image);
+    if (*ret) {
+        PRINTF("Failed to add static image\n");
+        return MPP_INVALID;
+    }
+
+    memset(inf_params, 0, sizeof(mpp_element_params_t));
+    inf_params->ml_inference.model_data = model;
+    inf_params->ml_inference.type = MPP_INFERENCE_TYPE_REFERENCE;
+    inf_params->ml_inference.model_input_mean = 0;
+    inf_params->ml_inference.model_input_std = 1;
+    inf_params->ml_inference.tensor_order = MPP_TENSOR_ORDER_NHWC;
+    inf_params->ml_inference.inference_params.num_inputs = 1;
+    inf_params->ml_inference.inference_params.num_outputs = model->num_outputs;
+    *ret = mpp_element_add(mp, MPP_ELEMENT_INFERENCE, inf_params, NULL);
+    if (*ret) {
+        PRINTF("Failed to add element INFERENCE\n");
+        return MPP_INVALID;
+    }
+    return mp;
+}
+
+static void app_task(void *params)
+{
+    mpp_element_params_t elem_params;
+    mpp_elem_handle_t det_h;
+    mpp_t mp_det, mp_cls;
+    bool pass = false;
+    int ret;
+
+    memset(s_image, 0x80, sizeof(s_image));
+
+    ret = mpp_api_init(NULL);
+    if (ret)
+        goto err;
+
+    /* detection, tracker */
+    mp_det = create_pipeline(&elem_params, &s_det_model, &ret);
+    if (mp_det == MPP_INVALID)
+        goto err;
+
+    memset(&elem_params, 0, sizeof(elem_params));
+    elem_params.detection.decoder = MPP_DETECTION_DECODER_BOXES;
+    elem_params.detection.num_classes = DET_CLASSES;
+    elem_params.detection.cls_tensor = 0;
+    elem_params.detection.box_tensor = 1;
+    elem_params.detection.input_width = IMG_WIDTH;
+    elem_params.detection.input_height = IMG_HEIGHT;
+    elem_params.detection.score_threshold = DET_SCORE_THRESHOLD;
+    elem_params.detection.iou_threshold = DET_IOU_THRESHOLD;
+    elem_params.detection.max_boxes = MPP_DETECTION_MAX_BOXES;
+    elem_params.detection.class_agnostic = false;
+    ret = mpp_element_add(mp_det, MPP_ELEMENT_DETECTION, &elem_params, &det_h);
+    if (ret) {
+        PRINTF("Failed to add element DETECTION\n");
+        goto err;
+    }
+
+    memset(&elem_params, 0, sizeof(elem_params));
+    elem_params.tracker.detection = det_h;
+    elem_params.tracker.min_iou = 0.3f;
+    elem_params.tracker.min_hits = TRK_MIN_HITS;
+    elem_params.tracker.max_misses = TRK_MAX_MISSES;
+    ret = mpp_element_add(mp_det, MPP_ELEMENT_TRACKER, &elem_params, &s_trk_h);
+    if (ret) {
+        PRINTF("Failed to add element TRACKER\n");
+        goto err;
+    }
+
+    /* the tracked boxes are attached to the frame metadata, read by the test */
+    ret = mpp_meta_enable(mpp_elem_from_handle(s_trk_h));
+    if (ret) {
+        PRINTF("Failed to enable the frame metadata\n");
+        goto err;
+    }
+
+    ret = mpp_nullsink_add(mp_det);
+    if (ret) {
+        PRINTF("Failed to add NULL sink\n");
+        goto err;
+    }
+
+    /* classification */
+    mp_cls = create_pipeline(&elem_params, &s_cls_model, &ret);
+    if (mp_cls == MPP_INVALID)
+        goto err;
+
+    memset(&elem_params, 0, sizeof(elem_params));
+    elem_params.classification.out_tensor = 0;
+    elem_params.classification.num_classes = CLS_CLASSES;
+    elem_params.classification.top_k = CLS_TOP_K;
+    elem_params.classification.score_threshold = CLS_SCORE_THRESHOLD;
+    elem_params.classification.smoothing = 0;
+    ret = mpp_element_add(mp_cls, MPP_ELEMENT_CLASSIFICATION, &elem_params, NULL);
+    if (ret) {
+        PRINTF("Failed to add element CLASSIFICATION\n");
+        goto err;
+    }
+
+    ret = mpp_nullsink_add(mp_cls);
+    if (ret) {
+        PRINTF("Failed to add NULL sink\n");
+        goto err;
+    }
+
+    ret = mpp_start(mp_det, 0);
+    if (ret == MPP_SUCCESS)
+        ret = mpp_start(mp_cls, 1);
+    if (ret) {
+        PRINTF("Failed to start pipelines\n");
+        goto err;
+    }
+
+    for (int ms = 0; ((s_det_events < DET_FRAMES) || (s_cls_events < CLS_FRAMES)) && (ms < TEST_TIMEOUT_MS); ms += 10)
+        vTaskDelay(10 / portTICK_PERIOD_MS);
+    mpp_stop(mp_det);
+    mpp_stop(mp_cls);
+
+    PRINTF("detection: %d frames %s\n", s_det_events, s_det_fail ? "FAIL" : "OK");
+    PRINTF("tracker: %d frames %s\n", s_trk_checked, s_trk_fail ? "FAIL" : "OK");
+    PRINTF("classification: %d frames %s\n", s_cls_events, s_cls_fail ? "FAIL" : "OK");
+    pass = (s_det_events >= DET_FRAMES) && (s_trk_checked >= DET_FRAMES - 1) && (s_cls_events >= CLS_FRAMES)
+           && !s_det_fail && !s_trk_fail && !s_cls_fail;
+    PRINTF(pass ? "\r\nTEST PASS\n" : "\r\nTEST FAIL\n");
+    for (;;)
+        vTaskSuspend(NULL);
+
+err:
+    for (;;)
+    {
+        PRINTF("Error building application pipeline : ret %d\r\n", ret);
+        vTaskSuspend(NULL);
+    }
+}
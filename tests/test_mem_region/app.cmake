@@ -0,0 +1,2 @@
+#list app specific source files
+# intentionally void
@@ -0,0 +1,171 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* @brief This test application checks the placement of buffers in memory regions:
+ * static arrays simulate a DTCM, an OCRAM, an SDRAM and a non-cacheable region,
+ * buffers are allocated with each placement hint and the region used is checked:
+ * - FAST takes the highest bandwidth region first, then the next class
+ * - BULK takes the lowest bandwidth region first
+ * - NONCACHEABLE only takes non-cacheable regions
+ * - ANY and buffers fitting no region use the heap
+ * Freed blocks are merged so that a region can be fully allocated again.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#ifndef EMULATOR
+/* NXP includes. */
+#include "fsl_device_registers.h"
+#include "fsl_debug_console.h"
+#include "pin_mux.h"
+#include "clock_config.h"
+#include "board.h"
+#include "board_init.h"
+#else
+#define PRINTF printf
+#define main app_main
+#endif
+
+#include "hal_os.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define DTCM_SIZE       1024
+#define OCRAM_SIZE      4096
+#define SDRAM_SIZE      16384
+#define NCACHE_SIZE     2048
+
+/* per block bookkeeping, upper bound */
+#define BLK_OVERHEAD    32
+
+#define REGION(a)       ((uintptr_t)(a))
+
+/*******************************************************************************
+ * Variables declaration
+ ******************************************************************************/
+static uint8_t dtcm[DTCM_SIZE] __attribute__((aligned(8)));
+static uint8_t ocram[OCRAM_SIZE] __attribute__((aligned(8)));
+static uint8_t sdram[SDRAM_SIZE] __attribute__((aligned(8)));
+static uint8_t ncache[NCACHE_SIZE] __attribute__((aligned(8)));
+static uint8_t extra[256] __attribute__((aligned(8)));
+
+static const mpp_memory_region_t r_dtcm = { "DTCM", REGION(dtcm), DTCM_SIZE, true, MPP_MEM_BW_HIGH };
+static const mpp_memory_region_t r_ocram = { "OCRAM", REGION(ocram), OCRAM_SIZE, true, MPP_MEM_BW_MEDIUM };
+static const mpp_memory_region_t r_sdram = { "SDRAM", REGION(sdram), SDRAM_SIZE, true, MPP_MEM_BW_LOW };
+static const mpp_memory_region_t r_ncache = { "NCACHE", REGION(ncache), NCACHE_SIZE, false, MPP_MEM_BW_MEDIUM };
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static bool check(const char *name, bool ok)
+{
+    PRINTF("%-48s %s\n", name, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+static bool inside(const void *p, uint32_t size, const uint8_t *base, uint32_t region_size)
+{
+    return ((const uint8_t *)p >= base) && ((const uint8_t *)p + size <= base + region_size);
+}
+
+/* allocate with 'hint', expecting region 'exp' (NULL: heap) */
+static void *alloc(uint32_t size, mpp_memory_placement_t hint, const mpp_memory_region_t *exp, bool *ok)
+{
+    const mpp_memory_region_t *placed = &r_dtcm;
+    void *p = hal_malloc_placed(size, hint, &placed);
+
+    if ((p == NULL) || (((uintptr_t)p & 7) != 0))
+        *ok = false;
+    else if (exp == NULL)
+        *ok = (placed == NULL);
+    else
+        *ok = (placed != NULL) && (strcmp(placed->name, exp->name) == 0)
+              && inside(p, size, (const uint8_t *)exp->base, exp->size);
+    return p;
+}
+
+int main(int argc, char *argv[])
+{
+    mpp_memory_region_t r;
+    void *p[4];
+    bool ok, pass = true;
+    int i;
+
+#ifndef EMULATOR
+    /* Init board hardware. */
+    BOARD_Init();
+#endif
+
+    PRINTF("****** TEST test_mem_region ******\n");
+
+    /* without region, all buffers come from the heap */
+    p[0] = alloc(64, MPP_MEM_PLACE_FAST, NULL, &ok);
+    pass &= check("no region: heap", ok);
+    hal_free_placed(p[0]);
+
+    /* regions declaration */
+    pass &= check("add DTCM", hal_mem_region_add(&r_dtcm) == 0);
+    r = r_dtcm;
+    r.name = "overlap";
+    r.base += DTCM_SIZE / 2;
+    pass &= check("overlapping region rejected", hal_mem_region_add(&r) != 0);
+    r = r_dtcm;
+    r.base = REGION(extra);
+    r.size = 8;
+    pass &= check("too small region rejected", hal_mem_region_add(&r) != 0);
+    pass &= check("add OCRAM, SDRAM, NCACHE", (hal_mem_region_add(&r_ocram) == 0) && (hal_mem_region_add(&r_sdram) == 0)
+                                              && (hal_mem_region_add(&r_ncache) == 0));
+    r.size = sizeof(extra);
+    pass &= check("regions count bounded", hal_mem_region_add(&r) != 0);
+
+    /* placement hints */
+    p[0] = alloc(256, MPP_MEM_PLACE_FAST, &r_dtcm, &ok);
+    pass &= check("FAST: DTCM", ok);
+    p[1] = alloc(DTCM_SIZE, MPP_MEM_PLACE_FAST, &r_ocram, &ok);
+    pass &= check("FAST larger than DTCM: OCRAM", ok);
+    p[2] = alloc(1024, MPP_MEM_PLACE_BULK, &r_sdram, &ok);
+    pass &= check("BULK: SDRAM", ok);
+    p[3] = alloc(512, MPP_MEM_PLACE_NONCACHEABLE, &r_ncache, &ok);
+    pass &= check("NONCACHEABLE: NCACHE", ok);
+    for (i = 0; i < 4; i++)
+        hal_free_placed(p[i]);
+
+    p[0] = alloc(NCACHE_SIZE, MPP_MEM_PLACE_NONCACHEABLE, NULL, &ok);
+    pass &= check("NONCACHEABLE larger than NCACHE: heap", ok);
+    hal_free_placed(p[0]);
+    p[0] = alloc(SDRAM_SIZE, MPP_MEM_PLACE_BULK, NULL, &ok);
+    pass &= check("BULK larger than all regions: heap", ok);
+    hal_free_placed(p[0]);
+    p[0] = alloc(64, MPP_MEM_PLACE_ANY, NULL, &ok);
+    pass &= check("ANY: heap", ok);
+    hal_free_placed(p[0]);
+
+    /* DTCM exhausted: FAST continues in OCRAM, buffers do not overlap */
+    p[0] = alloc(DTCM_SIZE / 2 - BLK_OVERHEAD, MPP_MEM_PLACE_FAST, &r_dtcm, &ok);
+    pass &= check("FAST: first DTCM block", ok);
+    p[1] = alloc(DTCM_SIZE / 4 - BLK_OVERHEAD, MPP_MEM_PLACE_FAST, &r_dtcm, &ok);
+    pass &= check("FAST: second DTCM block after the first", ok && ((uint8_t *)p[1] >= (uint8_t *)p[0] + DTCM_SIZE / 2 - BLK_OVERHEAD));
+    p[2] = alloc(DTCM_SIZE / 4 - BLK_OVERHEAD, MPP_MEM_PLACE_FAST, &r_dtcm, &ok);
+    pass &= check("FAST: last DTCM block", ok);
+    p[3] = alloc(DTCM_SIZE / 4, MPP_MEM_PLACE_FAST, &r_ocram, &ok);
+    pass &= check("FAST, DTCM full: OCRAM", ok);
+    hal_free_placed(p[3]);
+
+    /* free the middle block first: its neighbours merge with it */
+    hal_free_placed(p[1]);
+    hal_free_placed(p[0]);
+    hal_free_placed(p[2]);
+    p[0] = alloc(DTCM_SIZE - BLK_OVERHEAD, MPP_MEM_PLACE_FAST, &r_dtcm, &ok);
+    pass &= check("freed blocks merged", ok);
+    hal_free_placed(p[0]);
+
+    PRINTF(pass ? "\r\nTEST PASS\n" : "\r\nTEST FAIL\n");
+    return pass ? 0 : 1;
+}
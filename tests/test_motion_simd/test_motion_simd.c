@@ -0,0 +1,103 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* @brief This test application checks the SIMD comparison of the motion gate
+ * element against its reference C implementation: the changed pixels count and
+ * the updated background must be identical for all pairs of current and
+ * background values, all background shifts and thresholds around the edges.
+ * On cores without the 32-bit SIMD extension the test is skipped.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#ifndef EMULATOR
+/* NXP includes. */
+#include "fsl_device_registers.h"
+#include "fsl_debug_console.h"
+#include "pin_mux.h"
+#include "clock_config.h"
+#include "board.h"
+#include "board_init.h"
+#else
+#define PRINTF printf
+#define main app_main
+#endif
+
+#include "mpp_api_types_internal.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/* one thumbnail line per current value, one pixel per background value */
+#define TEST_LINE       256
+
+/*******************************************************************************
+ * Variables declaration
+ ******************************************************************************/
+static const uint8_t thresholds[] = { 0, 1, 2, 15, 16, 127, 128, 129, 254, 255 };
+
+static uint32_t cur[TEST_LINE / 4];
+static uint32_t bg_ref[TEST_LINE / 4];
+static uint32_t bg_simd[TEST_LINE / 4];
+static uint32_t mask[TEST_LINE / 4];
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+#ifdef MPP_MOTION_SIMD
+/* compare all the background values to 'c', returns false on mismatch */
+static bool check_line(uint8_t c, uint8_t thr, unsigned int shift, unsigned int mask_phase)
+{
+    uint8_t *m = (uint8_t *)mask;
+    unsigned int n_ref, n_simd;
+
+    memset(cur, c, sizeof(cur));
+    for (unsigned int i = 0; i < TEST_LINE; i++) {
+        ((uint8_t *)bg_ref)[i] = i;
+        /* masked pixels in every lane position */
+        m[i] = ((i + mask_phase) % 3) != 0;
+    }
+    memcpy(bg_simd, bg_ref, sizeof(bg_ref));
+
+    n_ref = mpp_motion_compare_ref((uint8_t *)cur, (uint8_t *)bg_ref, m, TEST_LINE, thr, shift);
+    n_simd = mpp_motion_compare_simd((uint8_t *)cur, (uint8_t *)bg_simd, m, TEST_LINE, thr, shift);
+    if ((n_ref != n_simd) || (memcmp(bg_ref, bg_simd, sizeof(bg_ref)) != 0)) {
+        PRINTF("mismatch: cur %d thr %d shift %d: %d changed (reference %d)\n",
+               c, thr, shift, n_simd, n_ref);
+        return false;
+    }
+    return true;
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+    bool pass = true;
+
+#ifndef EMULATOR
+    /* Init board hardware. */
+    BOARD_Init();
+#endif
+
+    PRINTF("****** TEST test_motion_simd ******\n");
+
+#ifdef MPP_MOTION_SIMD
+    for (unsigned int t = 0; (t < sizeof(thresholds)) && pass; t++) {
+        for (unsigned int shift = 0; (shift <= 7) && pass; shift++) {
+            for (unsigned int c = 0; (c < 256) && pass; c++)
+                pass = check_line(c, thresholds[t], shift, c);
+        }
+    }
+#else
+    PRINTF("No SIMD extension, the reference comparison is used: skipped\n");
+#endif
+
+    PRINTF(pass ? "\r\nTEST PASS\n" : "\r\nTEST FAIL\n");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* @brief This test application checks the model input tensor conversion
+ * (hal_tensor_from_u8) against a direct computation of the normalization and
+ * quantization formula, for all tensor types and orders, scalar and per-channel
+ * normalization, and in-place NHWC conversions.
+ * The image size is not a multiple of the conversion block to cover the partial block.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#ifndef EMULATOR
+/* NXP includes. */
+#include "fsl_device_registers.h"
+#include "fsl_debug_console.h"
+#include "pin_mux.h"
+#include "clock_config.h"
+#include "board.h"
+#include "board_init.h"
+#else
+#define PRINTF printf
+#define main app_main
+#endif
+
+#include "hal_tensor.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define TEST_WIDTH      13
+#define TEST_HEIGHT     5
+#define TEST_CHANNELS   3
+#define TEST_ELEMS      (TEST_WIDTH * TEST_HEIGHT * TEST_CHANNELS)
+
+/*******************************************************************************
+ * Variables declaration
+ ******************************************************************************/
+static const float ch_mean[MPP_INFERENCE_MAX_CHANNELS] = { 123.675f, 116.28f, 103.53f };
+static const float ch_std[MPP_INFERENCE_MAX_CHANNELS] = { 58.395f, 57.12f, 57.375f };
+
+static uint8_t image[TEST_ELEMS];
+/* large enough for a FLOAT32 tensor of the image */
+static float tensor[TEST_ELEMS];
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static int elem_size(mpp_tensor_type_t type)
+{
+    return (type == MPP_TENSOR_TYPE_FLOAT32) ? 4 : ((type == MPP_TENSOR_TYPE_INT16) ? 2 : 1);
+}
+
+/* expected value of interleaved element 'i' */
+static double expected(int i, int channels, mpp_tensor_type_t type, const hal_tensor_norm_t *norm)
+{
+    int c = i % channels;
+    double std = (norm->std[c] != 0) ? norm->std[c] : 1.0;
+    double v = (image[i] - norm->mean[c]) / std;
+    double lo = (type == MPP_TENSOR_TYPE_INT16) ? -32768 : -128;
+    double hi = (type == MPP_TENSOR_TYPE_INT16) ? 32767 : 127;
+
+    if (type == MPP_TENSOR_TYPE_FLOAT32)
+        return v;
+    if (type == MPP_TENSOR_TYPE_UINT8)
+        return image[i];
+    if (norm->scale != 0)
+        v /= norm->scale;
+    v += norm->zero_point;
+    return (v < lo) ? lo : ((v > hi) ? hi : v);
+}
+
+static double tensor_read(const void *t, int idx, mpp_tensor_type_t type)
+{
+    switch (type) {
+    case MPP_TENSOR_TYPE_FLOAT32:
+        return ((const float *)t)[idx];
+    case MPP_TENSOR_TYPE_INT16:
+        return ((const int16_t *)t)[idx];
+    case MPP_TENSOR_TYPE_INT8:
+        return ((const int8_t *)t)[idx];
+    default:
+        return ((const uint8_t *)t)[idx];
+    }
+}
+
+/* integer results may differ by one step from the direct computation (rounding of the folded coefficients) */
+static bool check(const char *name, const void *t, int channels, mpp_tensor_type_t type,
+                  mpp_tensor_order_t order, const hal_tensor_norm_t *norm)
+{
+    int pixels = TEST_WIDTH * TEST_HEIGHT;
+    double tol = (type == MPP_TENSOR_TYPE_FLOAT32) ? 1e-4 : 1.0;
+    int i;
+
+    for (i = 0; i < pixels * channels; i++) {
+        int idx = (order == MPP_TENSOR_ORDER_NCHW) ? ((i % channels) * pixels + i / channels) : i;
+        double exp = expected(i, channels, type, norm);
+        double val = tensor_read(t, idx, type);
+        if ((val - exp > tol) || (exp - val > tol)) {
+            PRINTF("%-40s FAIL: element %d = %f, expected %f\n", name, i, val, exp);
+            return false;
+        }
+    }
+    PRINTF("%-40s OK\n", name);
+    return true;
+}
+
+static bool convert(const char *name, int channels, mpp_tensor_type_t type,
+                    mpp_tensor_order_t order, const hal_tensor_norm_t *norm, bool in_place)
+{
+    void *dst = tensor;
+    int size = TEST_WIDTH * TEST_HEIGHT * channels;
+
+    if (in_place) {
+        /* the image is at the start of the tensor buffer */
+        memcpy(tensor, image, size);
+        if (hal_tensor_from_u8(dst, (const uint8_t *)tensor, TEST_WIDTH, TEST_HEIGHT, channels, type, order, norm) != 0) {
+            PRINTF("%-40s FAIL: conversion error\n", name);
+            return false;
+        }
+    } else {
+        memset(tensor, 0xa5, size * elem_size(type));
+        if (hal_tensor_from_u8(dst, image, TEST_WIDTH, TEST_HEIGHT, channels, type, order, norm) != 0) {
+            PRINTF("%-40s FAIL: conversion error\n", name);
+            return false;
+        }
+    }
+    return check(name, dst, channels, type, order, norm);
+}
+
+int main(int argc, char *argv[])
+{
+    hal_tensor_norm_t norm;
+    bool pass = true;
+    int i;
+
+#ifndef EMULATOR
+    /* Init board hardware. */
+    BOARD_Init();
+#endif
+
+    PRINTF("****** TEST test_tensor_convert ******\n");
+
+    /* all pixel values, including the saturating ones */
+    for (i = 0; i < TEST_ELEMS; i++)
+        image[i] = (uint8_t)(i * 37 + (i >> 3));
+    image[0] = 0;
+    image[1] = 255;
+
+    /* scalar normalization */
+    hal_tensor_norm_init(&norm, 127.5f, 127.5f, NULL, NULL);
+    pass &= convert("float NHWC", TEST_CHANNELS, MPP_TENSOR_TYPE_FLOAT32, MPP_TENSOR_ORDER_NHWC, &norm, false);
+    pass &= convert("float NHWC in place", TEST_CHANNELS, MPP_TENSOR_TYPE_FLOAT32, MPP_TENSOR_ORDER_NHWC, &norm, true);
+    pass &= convert("float NCHW", TEST_CHANNELS, MPP_TENSOR_TYPE_FLOAT32, MPP_TENSOR_ORDER_NCHW, &norm, false);
+    pass &= convert("uint8 NHWC in place", TEST_CHANNELS, MPP_TENSOR_TYPE_UINT8, MPP_TENSOR_ORDER_NHWC, &norm, true);
+    pass &= convert("uint8 NCHW", TEST_CHANNELS, MPP_TENSOR_TYPE_UINT8, MPP_TENSOR_ORDER_NCHW, &norm, false);
+
+    /* legacy int8 conversion: mean 128, std 1, not quantized (saturates) */
+    hal_tensor_norm_init(&norm, 128.0f, 1.0f, NULL, NULL);
+    pass &= convert("int8 NHWC in place, legacy", TEST_CHANNELS, MPP_TENSOR_TYPE_INT8, MPP_TENSOR_ORDER_NHWC, &norm, true);
+
+    /* quantized integer tensors */
+    hal_tensor_norm_init(&norm, 127.5f, 127.5f, NULL, NULL);
+    norm.scale = 1.0f / 128;
+    norm.zero_point = -1;
+    pass &= convert("int8 NHWC quantized", TEST_CHANNELS, MPP_TENSOR_TYPE_INT8, MPP_TENSOR_ORDER_NHWC, &norm, false);
+    pass &= convert("int8 NCHW quantized", TEST_CHANNELS, MPP_TENSOR_TYPE_INT8, MPP_TENSOR_ORDER_NCHW, &norm, false);
+    norm.scale = 1.0f / 4096;
+    norm.zero_point = 0;
+    pass &= convert("int16 NHWC in place quantized", TEST_CHANNELS, MPP_TENSOR_TYPE_INT16, MPP_TENSOR_ORDER_NHWC, &norm, true);
+
+    /* per-channel normalization */
+    hal_tensor_norm_init(&norm, 0, 0, ch_mean, ch_std);
+    pass &= convert("float NHWC per-channel", TEST_CHANNELS, MPP_TENSOR_TYPE_FLOAT32, MPP_TENSOR_ORDER_NHWC, &norm, false);
+    pass &= convert("float NCHW per-channel", TEST_CHANNELS, MPP_TENSOR_TYPE_FLOAT32, MPP_TENSOR_ORDER_NCHW, &norm, false);
+    norm.scale = 0.02f;
+    norm.zero_point = 5;
+    pass &= convert("int8 NHWC in place per-channel", TEST_CHANNELS, MPP_TENSOR_TYPE_INT8, MPP_TENSOR_ORDER_NHWC, &norm, true);
+
+    /* single channel */
+    hal_tensor_norm_init(&norm, 0, 255.0f, NULL, NULL);
+    pass &= convert("float NHWC in place, 1 channel", 1, MPP_TENSOR_TYPE_FLOAT32, MPP_TENSOR_ORDER_NHWC, &norm, true);
+
+    /* unsupported parameters */
+    if ((hal_tensor_from_u8(tensor, image, TEST_WIDTH, TEST_HEIGHT, 0, MPP_TENSOR_TYPE_INT8, MPP_TENSOR_ORDER_NHWC, &norm) == 0)
+            || (hal_tensor_from_u8(tensor, image, TEST_WIDTH, TEST_HEIGHT, TEST_CHANNELS, MPP_TENSOR_TYPE_INT8,
+                                   MPP_TENSOR_ORDER_UNKNOWN, &norm) == 0)) {
+        PRINTF("%-40s FAIL\n", "unsupported parameters rejected");
+        pass = false;
+    } else {
+        PRINTF("%-40s OK\n", "unsupported parameters rejected");
+    }
+
+    PRINTF(pass ? "\r\nTEST PASS\n" : "\r\nTEST FAIL\n");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,231 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* @brief This test application checks the inference backends registry:
+ * - the reference C backend is built in and is the default of its type
+ * - application backends are selected by name, the type must match
+ * - duplicated names are rejected, the number of backends is bounded
+ * - single instance backends have one user at a time until released
+ * The reference backend selected by the registry then runs its default model
+ * (per-channel mean) on a frame written in its input buffer.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#ifndef EMULATOR
+/* NXP includes. */
+#include "fsl_device_registers.h"
+#include "fsl_debug_console.h"
+#include "pin_mux.h"
+#include "clock_config.h"
+#include "board.h"
+#include "board_init.h"
+#else
+#define PRINTF printf
+#define main app_main
+#endif
+
+#include "hal.h"
+#include "hal_valgo_dev.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define TEST_WIDTH      8
+#define TEST_HEIGHT     4
+#define TEST_CHANNELS   3
+
+/*******************************************************************************
+ * Variables declaration
+ ******************************************************************************/
+static int s_setup_calls;
+static float s_means[TEST_CHANNELS];
+static bool s_output_ready;
+
+static int test_backend_setup(vision_algo_dev_t *dev);
+
+static const hal_valgo_backend_t s_single_backend = {
+    .caps = {
+        .name = "test_single",
+        .type = MPP_INFERENCE_TYPE_REFERENCE,
+        .tensor_types = 1U << MPP_TENSOR_TYPE_INT8,
+        .tensor_orders = 1U << MPP_TENSOR_ORDER_NHWC,
+        .max_inputs = 1,
+        .multi_instance = false,
+        .async = true,
+    },
+    .setup = test_backend_setup,
+};
+
+/* same name as the built-in reference backend */
+static const hal_valgo_backend_t s_dup_backend = {
+    .caps = {
+        .name = "reference",
+        .type = MPP_INFERENCE_TYPE_REFERENCE,
+    },
+    .setup = test_backend_setup,
+};
+
+static const char *s_filler_names[] = { "f0", "f1", "f2", "f3", "f4", "f5", "f6", "f7" };
+static hal_valgo_backend_t s_filler[sizeof(s_filler_names) / sizeof(s_filler_names[0])];
+
+static const vision_algo_dev_operator_t s_test_ops;
+
+static const mpp_ref_model_t s_mean_model = {
+    .width = TEST_WIDTH,
+    .height = TEST_HEIGHT,
+    .channels = TEST_CHANNELS,
+    .input_type = MPP_TENSOR_TYPE_FLOAT32,
+    .num_outputs = 1,
+    .out_dims = { { 1, { TEST_CHANNELS } } },
+    .out_type = { MPP_TENSOR_TYPE_FLOAT32 },
+    .run = NULL,
+};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static int test_backend_setup(vision_algo_dev_t *dev)
+{
+    s_setup_calls++;
+    dev->ops = &s_test_ops;
+    return 0;
+}
+
+static int output_cb(mpp_t mpp, mpp_evt_t evt, void *evt_data, void *user_data)
+{
+    mpp_inference_cb_param_t *out = (mpp_inference_cb_param_t *)evt_data;
+
+    if ((evt != MPP_EVENT_INFERENCE_OUTPUT_READY) || (out->num_outputs != 1)
+            || (out->inference_type != MPP_INFERENCE_TYPE_REFERENCE))
+        return 0;
+    memcpy(s_means, out->out_tensors[0]->data, sizeof(s_means));
+    s_output_ready = true;
+    return 0;
+}
+
+static bool check(const char *name, bool ok)
+{
+    PRINTF("%-48s %s\n", name, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+/* run the default model of the reference backend on a frame of constant channels */
+static bool run_reference(vision_algo_dev_t *dev)
+{
+    static const uint8_t pixel[TEST_CHANNELS] = { 10, 128, 250 };
+    model_param_t param;
+    hw_buf_desc_t in_buf;
+    mpp_memory_policy_t policy;
+    bool ok = true;
+    int i;
+
+    memset(&param, 0, sizeof(param));
+    param.model_data = &s_mean_model;
+    param.model_input_mean = 0;
+    param.model_input_std = 1;
+    param.width = TEST_WIDTH;
+    param.height = TEST_HEIGHT;
+    param.format = MPP_PIXEL_RGB;
+    param.inputType = MPP_TENSOR_TYPE_FLOAT32;
+    param.tensor_order = MPP_TENSOR_ORDER_NHWC;
+    param.evt_callback_f = output_cb;
+
+    memset(&in_buf, 0, sizeof(in_buf));
+    if ((dev->ops->init(dev, &param) != kStatus_HAL_ValgoSuccess)
+            || (dev->ops->get_buf_desc(dev, &in_buf, &policy) != kStatus_HAL_ValgoSuccess)
+            || (in_buf.addr == NULL) || (in_buf.stride != TEST_WIDTH * TEST_CHANNELS))
+        return false;
+
+    for (i = 0; i < TEST_WIDTH * TEST_HEIGHT; i++)
+        memcpy(in_buf.addr + i * TEST_CHANNELS, pixel, TEST_CHANNELS);
+    ok = (dev->ops->run(dev, NULL) == kStatus_HAL_ValgoSuccess) && s_output_ready;
+    for (i = 0; (i < TEST_CHANNELS) && ok; i++)
+        ok = (s_means[i] == (float)pixel[i]);
+    dev->ops->deinit(dev);
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    vision_algo_dev_t dev_a, dev_b;
+    const hal_valgo_caps_t *caps = NULL;
+    unsigned int i;
+    int ret;
+    bool pass = true;
+
+#ifndef EMULATOR
+    /* Init board hardware. */
+    BOARD_Init();
+#endif
+
+    PRINTF("****** TEST test_valgo_registry ******\n");
+
+    memset(&dev_a, 0, sizeof(dev_a));
+    memset(&dev_b, 0, sizeof(dev_b));
+
+    /* the reference backend is built in */
+    ret = hal_valgo_setup(&dev_a, MPP_INFERENCE_TYPE_REFERENCE, NULL, &caps);
+    pass &= check("built-in reference backend by type",
+                  (ret == 0) && (caps != NULL) && (strcmp(caps->name, "reference") == 0)
+                  && (strcmp(dev_a.name, "reference") == 0) && (dev_a.ops != NULL));
+    if (ret == 0) {
+        pass &= check("reference backend default model", run_reference(&dev_a));
+        hal_valgo_release(&dev_a);
+        pass &= check("released device has no operations", dev_a.ops == NULL);
+    }
+
+    /* application backends */
+    pass &= check("register application backend", hal_valgo_register(&s_single_backend) == 0);
+    pass &= check("duplicated name rejected", hal_valgo_register(&s_dup_backend) != 0);
+    pass &= check("duplicated registration rejected", hal_valgo_register(&s_single_backend) != 0);
+
+    /* built-in backends stay the default of their type */
+    ret = hal_valgo_setup(&dev_a, MPP_INFERENCE_TYPE_REFERENCE, NULL, &caps);
+    pass &= check("type selects the built-in backend", (ret == 0) && (strcmp(caps->name, "reference") == 0));
+    if (ret == 0)
+        hal_valgo_release(&dev_a);
+
+    /* selection by name */
+    s_setup_calls = 0;
+    ret = hal_valgo_setup(&dev_a, MPP_INFERENCE_TYPE_REFERENCE, "test_single", &caps);
+    pass &= check("name selects the application backend",
+                  (ret == 0) && (s_setup_calls == 1) && (dev_a.ops == &s_test_ops)
+                  && (caps == &s_single_backend.caps) && caps->async);
+    pass &= check("second instance of a single instance backend",
+                  hal_valgo_setup(&dev_b, MPP_INFERENCE_TYPE_REFERENCE, "test_single", NULL) != 0);
+    hal_valgo_release(&dev_a);
+    ret = hal_valgo_setup(&dev_b, MPP_INFERENCE_TYPE_REFERENCE, "test_single", NULL);
+    pass &= check("single instance backend available after release", (ret == 0) && (s_setup_calls == 2));
+    if (ret == 0)
+        hal_valgo_release(&dev_b);
+
+    /* mismatches */
+    pass &= check("name with another type rejected",
+                  hal_valgo_setup(&dev_a, MPP_INFERENCE_TYPE_GLOW, "test_single", NULL) != 0);
+    pass &= check("unknown name rejected",
+                  hal_valgo_setup(&dev_a, MPP_INFERENCE_TYPE_REFERENCE, "unknown", NULL) != 0);
+
+    /* the registry is bounded, registered backends remain usable */
+    for (i = 0; i < sizeof(s_filler) / sizeof(s_filler[0]); i++) {
+        s_filler[i] = s_single_backend;
+        s_filler[i].caps.name = s_filler_names[i];
+        s_filler[i].caps.multi_instance = true;
+        if (hal_valgo_register(&s_filler[i]) != 0)
+            break;
+    }
+    pass &= check("registry full", i < sizeof(s_filler) / sizeof(s_filler[0]));
+    ret = (i > 0) ? hal_valgo_setup(&dev_a, MPP_INFERENCE_TYPE_REFERENCE, s_filler_names[i - 1], NULL) : -1;
+    pass &= check("last registered backend selected", (ret == 0) && (strcmp(dev_a.name, s_filler_names[i - 1]) == 0));
+    if (ret == 0)
+        hal_valgo_release(&dev_a);
+
+    PRINTF(pass ? "\r\nTEST PASS\n" : "\r\nTEST FAIL\n");
+    return pass ? 0 : 1;
+}
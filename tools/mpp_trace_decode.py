@@ -0,0 +1,158 @@
+# Copyright 2026 NXP
+# All rights reserved.
+# SPDX-License-Identifier: BSD-3-Clause
+
+"""
+This script converts an MPP execution trace into the Chrome trace event format.
+
+The input is the binary dump written by mpp_trace_dump() (build option MPP_TRACE).
+The output JSON file can be opened in https://ui.perfetto.dev or chrome://tracing.
+
+It shows:
+- one track per task, with the pipeline cycles, element runs and HAL operations
+- buffer state changes as instant events
+- the task switches on a "CPU" track (FreeRTOS traceTASK_SWITCHED_IN hook)
+
+Usage:
+  python3 mpp_trace_decode.py trace.bin -o trace.json
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+TRACE_MAGIC = 0x5450504d
+TRACE_VERSION = 1
+
+HDR_FMT = '<IHHIIII'
+OBJ_FMT = '<IBBHI'
+TASK_FMT = '<I12s'
+EVT_FMT = '<IBBHII'
+
+# _mpp_trace_type_t
+EVT_ELEM_BEGIN = 1
+EVT_ELEM_END = 2
+EVT_CYCLE_BEGIN = 3
+EVT_CYCLE_END = 4
+EVT_BUF_STATE = 5
+EVT_HAL_BEGIN = 6
+EVT_HAL_END = 7
+EVT_TASK_SWITCH = 8
+
+ELEM_NAMES = ['INVALID', 'COMPOSE', 'LABELED_RECTANGLE', 'TEST', 'INFERENCE', 'CONVERT',
+              'DETECTION', 'CLASSIFICATION', 'ROI_INFERENCE', 'TRACKER', 'MOTION']
+SRC_NAMES = ['INVALID', 'CAMERA', 'STATIC_IMAGE', 'FILE']
+SINK_NAMES = ['INVALID', 'DISPLAY', 'NULL']
+HEAP_NAMES = ['rc cycle', 'preempt cycle']
+HAL_NAMES = ['gfx blit', 'display blit', 'inference']
+BUF_STATUS = ['NONE', 'READY', 'EMPTY', 'READING', 'WRITTING']
+
+CPU_TID = 0
+
+
+def name_of(table, idx):
+  return table[idx] if idx < len(table) else str(idx)
+
+
+def parse(data):
+  off = 0
+  magic, version, evt_size, nb_events, nb_objs, nb_tasks, lost = struct.unpack_from(HDR_FMT, data, off)
+  if magic != TRACE_MAGIC:
+    sys.exit("not an MPP trace (bad magic 0x%08x)" % magic)
+  if version != TRACE_VERSION or evt_size != struct.calcsize(EVT_FMT):
+    sys.exit("unsupported trace version %d (event size %d)" % (version, evt_size))
+  off += struct.calcsize(HDR_FMT)
+
+  objs = {}
+  for _ in range(nb_objs):
+    obj, kind, typ, prio, mpp = struct.unpack_from(OBJ_FMT, data, off)
+    off += struct.calcsize(OBJ_FMT)
+    if kind == 0:
+      objs[obj] = "branch prio %d" % prio
+    elif kind == 1:
+      objs[obj] = "%s@%08x" % (name_of(ELEM_NAMES, typ), obj)
+    elif kind == 2:
+      objs[obj] = "SRC_%s@%08x" % (name_of(SRC_NAMES, typ), obj)
+    else:
+      objs[obj] = "SINK_%s@%08x" % (name_of(SINK_NAMES, typ), obj)
+
+  tasks = {}
+  for _ in range(nb_tasks):
+    task, name = struct.unpack_from(TASK_FMT, data, off)
+    off += struct.calcsize(TASK_FMT)
+    tasks[task] = name.split(b'\0')[0].decode('ascii', 'replace')
+
+  events = []
+  for _ in range(nb_events):
+    events.append(struct.unpack_from(EVT_FMT, data, off))
+    off += evt_size
+
+  return lost, objs, tasks, events
+
+
+def convert(lost, objs, tasks, events):
+  out = []
+  tids = {}
+
+  def tid_of(task):
+    if task not in tids:
+      tids[task] = len(tids) + 1
+      name = tasks.get(task, "task@%08x" % task)
+      out.append({'ph': 'M', 'name': 'thread_name', 'pid': 1, 'tid': tids[task], 'args': {'name': name}})
+    return tids[task]
+
+  out.append({'ph': 'M', 'name': 'process_name', 'pid': 1, 'args': {'name': 'MPP'}})
+  out.append({'ph': 'M', 'name': 'thread_name', 'pid': 1, 'tid': CPU_TID, 'args': {'name': 'CPU'}})
+
+  # the 32-bit timestamp wraps every 71 minutes
+  base = 0
+  prev = None
+  running = None
+  for ts, typ, flags, frame_id, task, obj in events:
+    if prev is not None and ts < prev:
+      base += 1 << 32
+    prev = ts
+    t = base + ts
+    tid = tid_of(task)
+    args = {'frame': frame_id}
+
+    if typ in (EVT_ELEM_BEGIN, EVT_ELEM_END):
+      out.append({'ph': 'B' if typ == EVT_ELEM_BEGIN else 'E', 'name': objs.get(obj, "elem@%08x" % obj),
+                  'cat': 'element', 'pid': 1, 'tid': tid, 'ts': t, 'args': args})
+    elif typ in (EVT_CYCLE_BEGIN, EVT_CYCLE_END):
+      out.append({'ph': 'B' if typ == EVT_CYCLE_BEGIN else 'E', 'name': name_of(HEAP_NAMES, flags),
+                  'cat': 'cycle', 'pid': 1, 'tid': tid, 'ts': t})
+    elif typ in (EVT_HAL_BEGIN, EVT_HAL_END):
+      args['elem'] = objs.get(obj, "elem@%08x" % obj)
+      out.append({'ph': 'B' if typ == EVT_HAL_BEGIN else 'E', 'name': name_of(HAL_NAMES, flags),
+                  'cat': 'hal', 'pid': 1, 'tid': tid, 'ts': t, 'args': args})
+    elif typ == EVT_BUF_STATE:
+      args['buffer'] = "%08x" % obj
+      out.append({'ph': 'i', 's': 't', 'name': "buf %s" % name_of(BUF_STATUS, flags),
+                  'cat': 'buffer', 'pid': 1, 'tid': tid, 'ts': t, 'args': args})
+    elif typ == EVT_TASK_SWITCH:
+      if running is not None:
+        out.append({'ph': 'X', 'name': running[0], 'cat': 'sched', 'pid': 1, 'tid': CPU_TID,
+                    'ts': running[1], 'dur': t - running[1]})
+      running = (tasks.get(task, "task@%08x" % task), t)
+
+  return {'traceEvents': out, 'displayTimeUnit': 'ms', 'otherData': {'lost_events': lost}}
+
+
+def main():
+  parser = argparse.ArgumentParser(description='Convert an MPP binary trace to Chrome trace JSON.')
+  parser.add_argument('input', help='binary trace dumped by mpp_trace_dump()')
+  parser.add_argument('-o', '--output', default='trace.json', help='output JSON file')
+  args = parser.parse_args()
+
+  with open(args.input, 'rb') as f:
+    data = f.read()
+  lost, objs, tasks, events = parse(data)
+  with open(args.output, 'w') as f:
+    json.dump(convert(lost, objs, tasks, events), f)
+  print("%d events, %d lost, written to %s" % (len(events), lost, args.output))
+
+
+if __name__ == '__main__':
+  main()